@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2026 by the XtreemFS Authors, see AUTHORS file
+ *
+ * Licensed under the BSD License, see LICENSE file for details.
+ *
+ */
+
+#ifndef CPP_INCLUDE_FUSE_FUSE_INODE_TABLE_H_
+#define CPP_INCLUDE_FUSE_FUSE_INODE_TABLE_H_
+
+#include <stdint.h>
+
+#include <boost/thread/mutex.hpp>
+#include <map>
+#include <set>
+#include <string>
+#include <utility>
+
+namespace xtreemfs {
+
+/** Inode numbers the kernel knows from the low-level Fuse API.
+ *
+ *  Every inode has a lookup count and the names it was looked up with. A name
+ *  is the parent inode and the entry in it, so the path of an inode is
+ *  resolved through its parents and renaming a directory only changes the
+ *  name of the directory itself. Hard links share their inode, which has one
+ *  name per known link.
+ *
+ *  The inode number of a file is its XtreemFS file id. Control files of the
+ *  xtfsutil tool have no file id and get inode numbers from a separate range.
+ *
+ *  All methods are thread-safe.
+ */
+class FuseInodeTable {
+ public:
+  /** Inode number of the root directory (FUSE_ROOT_ID). */
+  static const uint64_t kRootInode = 1;
+
+  FuseInodeTable();
+
+  /** Returns the path of "ino". Returns false if the kernel forgot "ino" or
+   *  all names of "ino" were removed. */
+  bool GetPath(uint64_t ino, std::string* path);
+
+  /** Records that "name" in "parent" was looked up and is the file with the
+   *  id "file_id" resp. a control file if "is_xctl_file" is true. Increases
+   *  the lookup count and returns the inode number. */
+  uint64_t AddLookup(uint64_t parent,
+                     const std::string& name,
+                     uint64_t file_id,
+                     bool is_xctl_file);
+
+  /** Decreases the lookup count of "ino" by "nlookup" and removes "ino" if
+   *  the count drops to zero. The root is never removed. */
+  void Forget(uint64_t ino, uint64_t nlookup);
+
+  /** Removes "name" in "parent" after it was unlinked. The inode stays known
+   *  until the kernel forgets it. */
+  void RemoveName(uint64_t parent, const std::string& name);
+
+  /** Moves "name" in "parent" to "new_name" in "new_parent" and removes the
+   *  name of the file which was replaced by the rename. */
+  void Rename(uint64_t parent,
+              const std::string& name,
+              uint64_t new_parent,
+              const std::string& new_name);
+
+ private:
+  /** Parent inode and the name of the entry in it. */
+  typedef std::pair<uint64_t, std::string> Name;
+
+  /** Names and lookup count of an inode known to the kernel. */
+  struct InodeEntry {
+    InodeEntry() : nlookup(0) {}
+
+    std::set<Name> names;
+    uint64_t nlookup;
+  };
+
+  /** Lets "name" refer to "ino". The name is removed from the inode it
+   *  referred to before.
+   *
+   *  @remark   Requires a lock on mutex_.
+   */
+  void AddNameUnmutexed(uint64_t ino, const Name& name);
+
+  /** @remark   Requires a lock on mutex_. */
+  void RemoveNameUnmutexed(const Name& name);
+
+  /** Protects all members. */
+  boost::mutex mutex_;
+
+  /** Inode number -> names and lookup count. */
+  std::map<uint64_t, InodeEntry> inodes_;
+
+  /** Name -> inode number. Contains the names of all entries of inodes_. */
+  std::map<Name, uint64_t> names_;
+
+  /** Name -> inode number of control files of the xtfsutil tool. */
+  std::map<Name, uint64_t> xctl_inodes_;
+
+  /** Next inode number for a control file. */
+  uint64_t next_xctl_ino_;
+};
+
+}  // namespace xtreemfs
+
+#endif  // CPP_INCLUDE_FUSE_FUSE_INODE_TABLE_H_
@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2026 by the XtreemFS Authors, see AUTHORS file
+ *
+ * Licensed under the BSD License, see LICENSE file for details.
+ *
+ */
+
+#ifndef CPP_INCLUDE_FUSE_FUSE_LOWLEVEL_ADAPTER_H_
+#define CPP_INCLUDE_FUSE_FUSE_LOWLEVEL_ADAPTER_H_
+
+#include <stdint.h>
+#include <sys/types.h>
+#define FUSE_USE_VERSION 26
+#include <fuse_lowlevel.h>
+
+#include <string>
+
+#include "fuse/fuse_inode_table.h"
+
+namespace xtreemfs {
+class FuseAdapter;
+class FuseOptions;
+
+/** Implements the inode based low-level Fuse API on top of FuseAdapter.
+ *
+ *  The kernel refers to files by inode numbers instead of paths. The inode
+ *  number of a file is its XtreemFS file id (the root directory has the file
+ *  id 1 = FUSE_ROOT_ID). A FuseInodeTable resolves the inode numbers to the
+ *  paths they were looked up with and counts the lookups until the kernel
+ *  forgets them.
+ *
+ *  Entries and attributes are cached by the kernel for metadata_cache_ttl_s
+ *  seconds. Unlike with the high-level API, this is also safe for hard links
+ *  since they share their inode.
+ */
+class FuseLowLevelAdapter {
+ public:
+  /** Uses "fuse_adapter", which must be started already, to execute the
+   *  operations. */
+  FuseLowLevelAdapter(FuseAdapter* fuse_adapter, FuseOptions* options);
+
+  // Fuse operations as called by placeholder functions in
+  // fuse_lowlevel_operations.h. All of them reply to "req".
+  void init(struct fuse_conn_info* conn);
+  void lookup(fuse_req_t req, fuse_ino_t parent, const char* name);
+  void forget(fuse_req_t req, fuse_ino_t ino, unsigned long nlookup);
+  void getattr(fuse_req_t req, fuse_ino_t ino, struct fuse_file_info* fi);
+  void setattr(fuse_req_t req, fuse_ino_t ino, struct stat* attr, int to_set,
+               struct fuse_file_info* fi);
+  void readlink(fuse_req_t req, fuse_ino_t ino);
+  void mknod(fuse_req_t req, fuse_ino_t parent, const char* name, mode_t mode,
+             dev_t rdev);
+  void mkdir(fuse_req_t req, fuse_ino_t parent, const char* name, mode_t mode);
+  void unlink(fuse_req_t req, fuse_ino_t parent, const char* name);
+  void rmdir(fuse_req_t req, fuse_ino_t parent, const char* name);
+  void symlink(fuse_req_t req, const char* link, fuse_ino_t parent,
+               const char* name);
+  void rename(fuse_req_t req, fuse_ino_t parent, const char* name,
+              fuse_ino_t newparent, const char* newname);
+  void link(fuse_req_t req, fuse_ino_t ino, fuse_ino_t newparent,
+            const char* newname);
+  void open(fuse_req_t req, fuse_ino_t ino, struct fuse_file_info* fi);
+  void read(fuse_req_t req, fuse_ino_t ino, size_t size, off_t off,
+            struct fuse_file_info* fi);
+  void write(fuse_req_t req, fuse_ino_t ino, const char* buf, size_t size,
+             off_t off, struct fuse_file_info* fi);
+  void flush(fuse_req_t req, fuse_ino_t ino, struct fuse_file_info* fi);
+  void release(fuse_req_t req, fuse_ino_t ino, struct fuse_file_info* fi);
+  void fsync(fuse_req_t req, fuse_ino_t ino, int datasync,
+             struct fuse_file_info* fi);
+  void opendir(fuse_req_t req, fuse_ino_t ino, struct fuse_file_info* fi);
+
+  /** Fills the reply with the entries of FuseAdapter::readdir(). The stats of
+   *  the entries were fetched with the entries and are cached by libxtreemfs,
+   *  so the following lookups do not reach the MRC. */
+  void readdir(fuse_req_t req, fuse_ino_t ino, size_t size, off_t off,
+               struct fuse_file_info* fi);
+
+  void releasedir(fuse_req_t req, fuse_ino_t ino, struct fuse_file_info* fi);
+  void statfs(fuse_req_t req, fuse_ino_t ino);
+  void setxattr(fuse_req_t req, fuse_ino_t ino, const char* name,
+                const char* value, size_t size, int flags);
+  void getxattr(fuse_req_t req, fuse_ino_t ino, const char* name, size_t size);
+  void listxattr(fuse_req_t req, fuse_ino_t ino, size_t size);
+  void removexattr(fuse_req_t req, fuse_ino_t ino, const char* name);
+  void access(fuse_req_t req, fuse_ino_t ino, int mask);
+  void create(fuse_req_t req, fuse_ino_t parent, const char* name,
+              mode_t mode, struct fuse_file_info* fi);
+  void getlk(fuse_req_t req, fuse_ino_t ino, struct fuse_file_info* fi,
+             struct flock* lock);
+  void setlk(fuse_req_t req, fuse_ino_t ino, struct fuse_file_info* fi,
+             struct flock* lock, int sleep);
+
+ private:
+  /** Returns the path "ino" was looked up with. Returns false if the kernel
+   *  forgot "ino" or all of its names were removed. */
+  bool GetPath(fuse_ino_t ino, std::string* path);
+
+  /** Returns the path of "name" in "parent". Returns false if the kernel
+   *  forgot "parent". */
+  bool GetChildPath(fuse_ino_t parent, const char* name, std::string* path);
+
+  /** Replies to "req" with the entry "name" in "parent" whose path is
+   *  "path", which was just looked up or created, and increases its lookup
+   *  count. If "fi" is given, the entry was created with it and a create
+   *  reply is sent. */
+  void ReplyEntry(fuse_req_t req,
+                  fuse_ino_t parent,
+                  const char* name,
+                  const std::string& path,
+                  struct fuse_file_info* fi);
+
+  /** Replies to "req" with the attributes of "ino" resp. of the open file
+   *  "fi" if given. */
+  void ReplyAttr(fuse_req_t req,
+                 fuse_ino_t ino,
+                 const std::string& path,
+                 struct fuse_file_info* fi);
+
+  /** Timeout in seconds the kernel may cache entries and attributes. */
+  double GetTimeout() const;
+
+  FuseAdapter* fuse_adapter_;
+
+  FuseOptions* options_;
+
+  /** Inode numbers known to the kernel. */
+  FuseInodeTable inodes_;
+};
+
+}  // namespace xtreemfs
+
+#endif  // CPP_INCLUDE_FUSE_FUSE_LOWLEVEL_ADAPTER_H_
@@ -0,0 +1,182 @@
+/*
+ * Copyright (c) 2026 by the XtreemFS Authors, see AUTHORS file
+ *
+ * Licensed under the BSD License, see LICENSE file for details.
+ *
+ */
+
+#ifndef CPP_INCLUDE_FUSE_FUSE_LOWLEVEL_OPERATIONS_H_
+#define CPP_INCLUDE_FUSE_FUSE_LOWLEVEL_OPERATIONS_H_
+
+#include <sys/types.h>
+
+#define FUSE_USE_VERSION 26
+#include <fuse_lowlevel.h>
+
+namespace xtreemfs {
+class FuseLowLevelAdapter;
+}
+
+/** Contains functions which are passed into fuse_lowlevel_ops struct.
+ * @file
+ *
+ * The functions in this file are merely placeholders which call the actual
+ * functions of the FuseLowLevelAdapter instance pointed to by
+ * fuse_lowlevel_adapter.
+ */
+
+/** Points to the FuseLowLevelAdapter instance created by mount.xtreemfs.cpp if
+ *  the low-level API is used. */
+extern xtreemfs::FuseLowLevelAdapter* fuse_lowlevel_adapter;
+
+extern "C" void xtreemfs_fuse_ll_init(
+    void* userdata,
+    struct fuse_conn_info* conn);
+extern "C" void xtreemfs_fuse_ll_destroy(void* userdata);
+extern "C" void xtreemfs_fuse_ll_lookup(
+    fuse_req_t req,
+    fuse_ino_t parent,
+    const char* name);
+extern "C" void xtreemfs_fuse_ll_forget(
+    fuse_req_t req,
+    fuse_ino_t ino,
+    unsigned long nlookup);
+extern "C" void xtreemfs_fuse_ll_getattr(
+    fuse_req_t req,
+    fuse_ino_t ino,
+    struct fuse_file_info* fi);
+extern "C" void xtreemfs_fuse_ll_setattr(
+    fuse_req_t req,
+    fuse_ino_t ino,
+    struct stat* attr,
+    int to_set,
+    struct fuse_file_info* fi);
+extern "C" void xtreemfs_fuse_ll_readlink(fuse_req_t req, fuse_ino_t ino);
+extern "C" void xtreemfs_fuse_ll_mknod(
+    fuse_req_t req,
+    fuse_ino_t parent,
+    const char* name,
+    mode_t mode,
+    dev_t rdev);
+extern "C" void xtreemfs_fuse_ll_mkdir(
+    fuse_req_t req,
+    fuse_ino_t parent,
+    const char* name,
+    mode_t mode);
+extern "C" void xtreemfs_fuse_ll_unlink(
+    fuse_req_t req,
+    fuse_ino_t parent,
+    const char* name);
+extern "C" void xtreemfs_fuse_ll_rmdir(
+    fuse_req_t req,
+    fuse_ino_t parent,
+    const char* name);
+extern "C" void xtreemfs_fuse_ll_symlink(
+    fuse_req_t req,
+    const char* link,
+    fuse_ino_t parent,
+    const char* name);
+extern "C" void xtreemfs_fuse_ll_rename(
+    fuse_req_t req,
+    fuse_ino_t parent,
+    const char* name,
+    fuse_ino_t newparent,
+    const char* newname);
+extern "C" void xtreemfs_fuse_ll_link(
+    fuse_req_t req,
+    fuse_ino_t ino,
+    fuse_ino_t newparent,
+    const char* newname);
+extern "C" void xtreemfs_fuse_ll_open(
+    fuse_req_t req,
+    fuse_ino_t ino,
+    struct fuse_file_info* fi);
+extern "C" void xtreemfs_fuse_ll_read(
+    fuse_req_t req,
+    fuse_ino_t ino,
+    size_t size,
+    off_t off,
+    struct fuse_file_info* fi);
+extern "C" void xtreemfs_fuse_ll_write(
+    fuse_req_t req,
+    fuse_ino_t ino,
+    const char* buf,
+    size_t size,
+    off_t off,
+    struct fuse_file_info* fi);
+extern "C" void xtreemfs_fuse_ll_flush(
+    fuse_req_t req,
+    fuse_ino_t ino,
+    struct fuse_file_info* fi);
+extern "C" void xtreemfs_fuse_ll_release(
+    fuse_req_t req,
+    fuse_ino_t ino,
+    struct fuse_file_info* fi);
+extern "C" void xtreemfs_fuse_ll_fsync(
+    fuse_req_t req,
+    fuse_ino_t ino,
+    int datasync,
+    struct fuse_file_info* fi);
+extern "C" void xtreemfs_fuse_ll_opendir(
+    fuse_req_t req,
+    fuse_ino_t ino,
+    struct fuse_file_info* fi);
+extern "C" void xtreemfs_fuse_ll_readdir(
+    fuse_req_t req,
+    fuse_ino_t ino,
+    size_t size,
+    off_t off,
+    struct fuse_file_info* fi);
+extern "C" void xtreemfs_fuse_ll_releasedir(
+    fuse_req_t req,
+    fuse_ino_t ino,
+    struct fuse_file_info* fi);
+extern "C" void xtreemfs_fuse_ll_fsyncdir(
+    fuse_req_t req,
+    fuse_ino_t ino,
+    int datasync,
+    struct fuse_file_info* fi);
+extern "C" void xtreemfs_fuse_ll_statfs(fuse_req_t req, fuse_ino_t ino);
+extern "C" void xtreemfs_fuse_ll_setxattr(
+    fuse_req_t req,
+    fuse_ino_t ino,
+    const char* name,
+    const char* value,
+    size_t size,
+    int flags);
+extern "C" void xtreemfs_fuse_ll_getxattr(
+    fuse_req_t req,
+    fuse_ino_t ino,
+    const char* name,
+    size_t size);
+extern "C" void xtreemfs_fuse_ll_listxattr(
+    fuse_req_t req,
+    fuse_ino_t ino,
+    size_t size);
+extern "C" void xtreemfs_fuse_ll_removexattr(
+    fuse_req_t req,
+    fuse_ino_t ino,
+    const char* name);
+extern "C" void xtreemfs_fuse_ll_access(
+    fuse_req_t req,
+    fuse_ino_t ino,
+    int mask);
+extern "C" void xtreemfs_fuse_ll_create(
+    fuse_req_t req,
+    fuse_ino_t parent,
+    const char* name,
+    mode_t mode,
+    struct fuse_file_info* fi);
+extern "C" void xtreemfs_fuse_ll_getlk(
+    fuse_req_t req,
+    fuse_ino_t ino,
+    struct fuse_file_info* fi,
+    struct flock* lock);
+extern "C" void xtreemfs_fuse_ll_setlk(
+    fuse_req_t req,
+    fuse_ino_t ino,
+    struct fuse_file_info* fi,
+    struct flock* lock,
+    int sleep);
+
+#endif  // CPP_INCLUDE_FUSE_FUSE_LOWLEVEL_OPERATIONS_H_
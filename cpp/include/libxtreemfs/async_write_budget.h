@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2026 by the XtreemFS Authors, see AUTHORS file
+ *
+ * Licensed under the BSD License, see LICENSE file for details.
+ *
+ */
+
+#ifndef CPP_INCLUDE_LIBXTREEMFS_ASYNC_WRITE_BUDGET_H_
+#define CPP_INCLUDE_LIBXTREEMFS_ASYNC_WRITE_BUDGET_H_
+
+#include <stddef.h>
+
+#include <boost/thread/condition.hpp>
+#include <boost/thread/mutex.hpp>
+#include <list>
+#include <map>
+
+namespace xtreemfs {
+
+/** Limits the total size of the buffered data of all async writes of a Volume.
+ *
+ *  Writers only block if the budget is exhausted. Blocked writers are queued
+ *  per owner (i.e. per file) and the owners are served round-robin, so a
+ *  single file with many pending writes cannot starve the other files.
+ */
+class AsyncWriteBudget {
+ public:
+  explicit AsyncWriteBudget(size_t max_bytes);
+
+  /** Blocks until "bytes" are available and reserves them for "owner".
+   *
+   *  A request is always granted if nothing is reserved at all, even if it
+   *  exceeds the budget.
+   *
+   *  @throws boost::thread_interrupted
+   */
+  void Acquire(const void* owner, size_t bytes);
+
+  /** Returns "bytes" previously reserved by Acquire(). */
+  void Release(size_t bytes);
+
+  /** Returns the number of currently reserved bytes. */
+  size_t used_bytes();
+
+ private:
+  struct Waiter {
+    explicit Waiter(size_t bytes) : bytes(bytes), granted(false) {}
+
+    size_t bytes;
+    bool granted;
+  };
+
+  /** Reserves space for waiting writers in round-robin order of their owners.
+   *
+   *  @remark   Requires a lock on mutex_.
+   */
+  void GrantUnmutexed();
+
+  /** Removes a not yet granted "waiter" of "owner".
+   *
+   *  @remark   Requires a lock on mutex_.
+   */
+  void RemoveWaiterUnmutexed(const void* owner, Waiter* waiter);
+
+  const size_t max_bytes_;
+
+  /** Protects all members below. */
+  boost::mutex mutex_;
+
+  size_t used_bytes_;
+
+  /** Notified whenever waiters were granted their reservation. */
+  boost::condition waiters_granted_;
+
+  /** Blocked writers per owner in FIFO order. */
+  std::map<const void*, std::list<Waiter*> > waiters_;
+
+  /** Owners with blocked writers in round-robin order. */
+  std::list<const void*> owners_;
+};
+
+}  // namespace xtreemfs
+
+#endif  // CPP_INCLUDE_LIBXTREEMFS_ASYNC_WRITE_BUDGET_H_
@@ -0,0 +1,354 @@
+/*
+ * Copyright (c) 2011-2012 by Michael Berlin, Zuse Institute Berlin
+ *
+ * Licensed under the BSD License, see LICENSE file for details.
+ *
+ */
+
+#ifndef CPP_INCLUDE_LIBXTREEMFS_CLIENT_IMPLEMENTATION_H_
+#define CPP_INCLUDE_LIBXTREEMFS_CLIENT_IMPLEMENTATION_H_
+
+#include <stdint.h>
+
+#include <boost/scoped_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+#include <gtest/gtest_prod.h>
+#include <list>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "libxtreemfs/client.h"
+#include "libxtreemfs/uuid_cache.h"
+#include "libxtreemfs/simple_uuid_iterator.h"
+#include "libxtreemfs/typedefs.h"
+#include "libxtreemfs/uuid_resolver.h"
+#include "util/mpsc_queue.h"
+#include "util/synchronized_queue.h"
+#include "libxtreemfs/async_write_handler.h"
+
+#include "xtreemfs/DIR.pb.h"
+
+namespace boost {
+class thread;
+}  // namespace boost
+
+namespace xtreemfs {
+
+class AsyncIOOperation;
+class DiskObjectCache;
+class OSDHealthRegistry;
+class Options;
+class UUIDIterator;
+class Vivaldi;
+class Volume;
+class VolumeImplementation;
+class WriteWindowController;
+
+namespace pbrpc {
+class DIRServiceClient;
+class OSDServiceClient;
+}  // namespace pbrpc
+
+namespace rpc {
+class Client;
+class SSLOptions;
+class ClientTestFastLingerTimeout_LingerTests_Test;  // see FRIEND_TEST @bottom.
+class ClientTestFastLingerTimeoutConnectTimeout_LingerTests_Test;
+class ClientTestFastTimeout_ConnectInAdvance_Test;
+}  // namespace rpc
+
+class DIRUUIDResolver : public UUIDResolver {
+ public:
+  DIRUUIDResolver(
+      SimpleUUIDIterator& dir_uuid_iterator,
+      const pbrpc::UserCredentials& user_credentials,
+      const Options& options);
+
+  void Initialize(rpc::Client* network_client);
+
+  virtual void UUIDToAddress(const std::string& uuid, std::string* address);
+  virtual void UUIDToAddressWithOptions(const std::string& uuid,
+                                        std::string* address,
+                                        const RPCOptions& options);
+  virtual void VolumeNameToMRCUUID(const std::string& volume_name,
+                                   std::string* uuid);
+  virtual void VolumeNameToMRCUUID(const std::string& volume_name,
+                                   SimpleUUIDIterator* uuid_iterator);
+  virtual std::vector<std::string> VolumeNameToMRCUUIDs(const std::string& volume_name);
+
+  /** @remark Ownership is NOT transferred to the caller. */
+  UUIDCache* GetUUIDCache() { return &uuid_cache_; }
+
+  /** Retrieves the address mappings of all services from the DIR with one
+   *  request and caches them. Returns the earliest timeout of the retrieved
+   *  mappings or 0 if there was none.
+   *
+   * @throws AddressToUUIDNotFoundException
+   * @throws IOException
+   * @throws PosixErrorException
+   */
+  time_t PrefetchAddressMappings(const RPCOptions& options);
+
+  /** Prefetches all address mappings periodically such that they are
+   *  refreshed Options::address_mappings_refresh_margin_s before they expire.
+   *  Runs until the thread is interrupted. */
+  void RunAddressMappingsRefresh();
+
+ private:
+  SimpleUUIDIterator& dir_uuid_iterator_;
+  /** The auth_type of this object will always be set to AUTH_NONE. */
+
+  // TODO(mberlin): change this when the DIR service supports real auth.
+  pbrpc::Auth dir_service_auth_;
+
+  /** These credentials will be used for messages to the DIR service. */
+  const pbrpc::UserCredentials dir_service_user_credentials_;
+
+  /** A DIRServiceClient is a wrapper for a RPC Client. */
+  boost::scoped_ptr<pbrpc::DIRServiceClient> dir_service_client_;
+
+  /** Caches service UUIDs -> (address, port, TTL). */
+  UUIDCache uuid_cache_;
+
+  /** Options class which contains the log_level string and logfile path. */
+  const Options& options_;
+
+  pbrpc::ServiceSet* GetServicesByName(const std::string& volume_name);
+};
+
+/**
+ * Default Implementation of the XtreemFS C++ client interfaces.
+ */
+class ClientImplementation : public Client {
+ public:
+  ClientImplementation(
+      const ServiceAddresses& dir_service_addresses,
+      const pbrpc::UserCredentials& user_credentials,
+      const rpc::SSLOptions* ssl_options,
+      const Options& options);
+  virtual ~ClientImplementation();
+
+  virtual void Start();
+  virtual void Shutdown();
+
+  virtual Volume* OpenVolume(
+      const std::string& volume_name,
+      const rpc::SSLOptions* ssl_options,
+      const Options& options);
+  virtual void CloseVolume(xtreemfs::Volume* volume);
+
+  virtual void CreateVolume(
+      const ServiceAddresses& mrc_address,
+      const pbrpc::Auth& auth,
+      const pbrpc::UserCredentials& user_credentials,
+      const std::string& volume_name,
+      int mode,
+      const std::string& owner_username,
+      const std::string& owner_groupname,
+      const pbrpc::AccessControlPolicyType& access_policy_type,
+      long volume_quota,
+      const pbrpc::StripingPolicyType& default_striping_policy_type,
+      int default_stripe_size,
+      int default_stripe_width,
+      const std::list<pbrpc::KeyValuePair*>& volume_attributes);
+
+  virtual void CreateVolume(
+      const ServiceAddresses& mrc_address,
+      const xtreemfs::pbrpc::Auth& auth,
+      const xtreemfs::pbrpc::UserCredentials& user_credentials,
+      const std::string& volume_name,
+      int mode,
+      const std::string& owner_username,
+      const std::string& owner_groupname,
+      const xtreemfs::pbrpc::AccessControlPolicyType& access_policy_type,
+      long quota,
+      const xtreemfs::pbrpc::StripingPolicyType& default_striping_policy_type,
+      int default_stripe_size,
+      int default_stripe_width,
+      const std::map<std::string, std::string>& volume_attributes);
+
+  virtual void CreateVolume(
+      const xtreemfs::pbrpc::Auth& auth,
+      const xtreemfs::pbrpc::UserCredentials& user_credentials,
+      const std::string& volume_name,
+      int mode,
+      const std::string& owner_username,
+      const std::string& owner_groupname,
+      const xtreemfs::pbrpc::AccessControlPolicyType& access_policy_type,
+      long volume_quota,
+      const xtreemfs::pbrpc::StripingPolicyType& default_striping_policy_type,
+      int default_stripe_size,
+      int default_stripe_width,
+      const std::map<std::string, std::string>& volume_attributes);
+
+  virtual void DeleteVolume(
+      const ServiceAddresses& mrc_address,
+      const pbrpc::Auth& auth,
+      const pbrpc::UserCredentials& user_credentials,
+      const std::string& volume_name);
+
+  virtual void DeleteVolume(
+      const xtreemfs::pbrpc::Auth& auth,
+      const xtreemfs::pbrpc::UserCredentials& user_credentials,
+      const std::string& volume_name);
+
+  virtual pbrpc::Volumes* ListVolumes(
+      const ServiceAddresses& mrc_addresses,
+      const pbrpc::Auth& auth);
+
+  virtual std::vector<std::string> ListVolumeNames();
+
+  virtual UUIDResolver* GetUUIDResolver();
+
+  virtual std::string UUIDToAddress(const std::string& uuid);
+
+  virtual void GetAsyncWriteWindows(
+      std::map<std::string, AsyncWriteWindow>* windows);
+
+  /** Returns a ServiceSet with all services of the given type.
+   *
+   * @param serviceType Type of the Service
+   *
+   * @throws IOException
+   * @throws PosixErrorException
+   *
+   * @remark Ownership of the return value is transferred to the caller. */
+  pbrpc::ServiceSet* GetServicesByType(const xtreemfs::pbrpc::ServiceType service_type);
+
+  /** Returns a ServiceSet with all services of the given name
+   *
+   * @param string Name of the Service
+   *
+   * @throws IOException
+   * @throws PosixErrorException
+   *
+   * @remark Ownership of the return value is transferred to the caller. */
+  pbrpc::ServiceSet* GetServicesByName(const std::string service_name);
+
+  const pbrpc::VivaldiCoordinates& GetVivaldiCoordinates() const;
+
+  /** Returns one of the async write callback queues. The queues are assigned
+   *  round-robin, i.e. call this only once per file to keep the callbacks of a
+   *  file in order. */
+  util::MPSCQueue<AsyncWriteHandler::CallbackEntry>& GetAsyncWriteCallbackQueue();
+
+  /** Returns the queue of ReadAsync() and WriteAsync() operations whose
+   *  responses were all received. */
+  util::SynchronizedQueue<AsyncIOOperation*>& GetAsyncIOCompletionQueue();
+
+  /** Returns the client-wide OSD health registry or NULL if disabled.
+   *
+   * @remark Ownership is NOT transferred to the caller. */
+  OSDHealthRegistry* GetOSDHealthRegistry();
+
+  /** Returns the client-wide async write window controller or NULL if the
+   *  window is not adaptive.
+   *
+   * @remark Ownership is NOT transferred to the caller. */
+  WriteWindowController* GetWriteWindowController();
+
+  /** Returns the client-wide disk cache of objects or NULL if disabled.
+   *
+   * @remark Ownership is NOT transferred to the caller. */
+  DiskObjectCache* GetDiskObjectCache();
+
+  /** Returns the cache of UUID to address mappings.
+   *
+   * @remark Ownership is NOT transferred to the caller. */
+  UUIDCache* GetUUIDCache();
+
+  /** Returns the Vivaldi instance or NULL if Vivaldi is disabled.
+   *
+   * @remark Ownership is NOT transferred to the caller. */
+  Vivaldi* GetVivaldi();
+
+ private:
+  /** True if Shutdown() was executed. */
+  bool was_shutdown_;
+
+  /** Auth of type AUTH_NONE which is required for most operations which do not
+   *  check the authentication data (except Create, Delete, ListVolume(s)). */
+  xtreemfs::pbrpc::Auth auth_bogus_;
+
+  /** The auth_type of this object will always be set to AUTH_NONE. */
+  // TODO(mberlin): change this when the DIR service supports real auth.
+  xtreemfs::pbrpc::Auth dir_service_auth_;
+
+  /** These credentials will be used for messages to the DIR service. */
+  xtreemfs::pbrpc::UserCredentials dir_service_user_credentials_;
+
+  /** Options class which contains the log_level string and logfile path. */
+  const xtreemfs::Options& options_;
+
+  std::list<VolumeImplementation*> list_open_volumes_;
+  boost::mutex list_open_volumes_mutex_;
+
+  const rpc::SSLOptions* dir_service_ssl_options_;
+
+  /** The RPC Client processes requests from a queue and executes callbacks in
+   * its thread. */
+  boost::scoped_ptr<rpc::Client> network_client_;
+  boost::scoped_ptr<boost::thread> network_client_thread_;
+
+  /** A DIRServiceClient is a wrapper for a RPC Client. */
+  boost::scoped_ptr<pbrpc::DIRServiceClient> dir_service_client_;
+
+
+  SimpleUUIDIterator dir_uuid_iterator_;
+  DIRUUIDResolver uuid_resolver_;
+
+  /** Random, non-persistent UUID to distinguish locks of different clients. */
+  std::string client_uuid_;
+
+  /** Vivaldi thread, periodically updates vivaldi-coordinates. */
+  boost::scoped_ptr<boost::thread> vivaldi_thread_;
+  boost::scoped_ptr<Vivaldi> vivaldi_;
+  boost::scoped_ptr<pbrpc::OSDServiceClient> osd_service_client_;
+
+  /** Tracks dead OSDs (NULL if osd_health_probe_interval_s is 0). */
+  boost::scoped_ptr<OSDHealthRegistry> osd_health_registry_;
+  /** Periodically probes dead OSDs to re-admit them. */
+  boost::scoped_ptr<boost::thread> osd_health_probe_thread_;
+
+  /** Refreshes the cached address mappings in the background.
+   *  NULL if Options::address_mappings_refresh_margin_s is 0. */
+  boost::scoped_ptr<boost::thread> address_mappings_refresh_thread_;
+
+  /** Adapts the number of pending async writes per OSD (NULL if disabled). */
+  boost::scoped_ptr<WriteWindowController> write_window_controller_;
+
+  /** Caches objects on a local disk (NULL if disabled). */
+  boost::scoped_ptr<DiskObjectCache> disk_object_cache_;
+
+  /** Threads that handle the callbacks for asynchronous writes, one per
+   *  queue in async_write_callback_queues_. */
+  boost::thread_group async_write_callback_threads_;
+  /** Hold the Callbacks enqueued by CallFinished() (producer). Each queue is
+   *  processed by ProcessCallbacks(consumer), running in its own thread.
+   *  A file always uses the same queue, see GetAsyncWriteCallbackQueue(). */
+  std::vector<util::MPSCQueue<AsyncWriteHandler::CallbackEntry>*>
+      async_write_callback_queues_;
+  /** Counter used to assign the queues round-robin. */
+  uint32_t next_async_write_callback_queue_;
+
+  /** Completes ReadAsync() and WriteAsync() operations, see
+   *  AsyncIOOperation::ProcessCompletions(). */
+  boost::scoped_ptr<boost::thread> async_io_completion_thread_;
+  util::SynchronizedQueue<AsyncIOOperation*> async_io_completion_queue_;
+
+  /** Retry the failed objects of ReadAsync() and WriteAsync() operations
+   *  outside of the completion thread, see AsyncIOOperation::ProcessRetries().
+   */
+  boost::thread_group async_io_retry_threads_;
+  util::SynchronizedQueue<AsyncIOOperation*> async_io_retry_queue_;
+
+  FRIEND_TEST(rpc::ClientTestFastLingerTimeout, LingerTests);
+  FRIEND_TEST(rpc::ClientTestFastLingerTimeoutConnectTimeout, LingerTests);
+  FRIEND_TEST(rpc::ClientTestFastTimeout, ConnectInAdvance);
+};
+
+}  // namespace xtreemfs
+
+#endif  // CPP_INCLUDE_LIBXTREEMFS_CLIENT_IMPLEMENTATION_H_
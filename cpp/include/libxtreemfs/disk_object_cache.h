@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) 2026 by the XtreemFS Authors, see AUTHORS file
+ *
+ * Licensed under the BSD License, see LICENSE file for details.
+ *
+ */
+
+#ifndef CPP_INCLUDE_LIBXTREEMFS_DISK_OBJECT_CACHE_H_
+#define CPP_INCLUDE_LIBXTREEMFS_DISK_OBJECT_CACHE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <boost/atomic.hpp>
+#include <boost/thread/mutex.hpp>
+#include <map>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace xtreemfs {
+
+/** Persistent cache of complete objects on a local disk.
+ *
+ *  Every cached object is stored in a file of its own in the cache
+ *  directory. The index (file "index" in the cache directory) is memory
+ *  mapped and has a fixed number of entries. It survives remounts, i.e. the
+ *  cache is warm after a restart of the client.
+ *
+ *  Objects are identified by (file id, object number) and are only valid for
+ *  the truncate epoch (XCap) and the XLocSet version they were read with.
+ *  Entries are evicted in LRU order if the size of all cached objects would
+ *  exceed the byte budget or if no index entry is free.
+ *
+ *  Writes of other clients are not detected as long as they do not change
+ *  the truncate epoch or the XLocSet. The cache is therefore meant for data
+ *  which is written once and read often.
+ *
+ *  Not available on Windows.
+ */
+class DiskObjectCache {
+ public:
+  /** Describes an object and the state of the file it was read in. */
+  struct Key {
+    Key(const std::string& file_id,
+        uint64_t object_number,
+        uint32_t truncate_epoch,
+        uint32_t xlocset_version)
+        : file_id(file_id),
+          object_number(object_number),
+          truncate_epoch(truncate_epoch),
+          xlocset_version(xlocset_version) {}
+
+    std::string file_id;
+    uint64_t object_number;
+    uint32_t truncate_epoch;
+    uint32_t xlocset_version;
+  };
+
+  /** Longest file id which can be cached. */
+  static const size_t kMaxFileIdLength = 87;
+
+  /** Opens or creates the cache in "path". The index has one entry per
+   *  128 kB (the default object size) of "max_size_bytes".
+   *
+   * @throws XtreemFSException  If the cache could not be opened.
+   */
+  DiskObjectCache(const std::string& path, uint64_t max_size_bytes);
+
+  ~DiskObjectCache();
+
+  /** Copies "length" bytes at "offset_in_object" of the cached object into
+   *  "buffer". Returns the number of copied bytes, which is less than
+   *  "length" if the object ends earlier, or -1 if the object is not cached
+   *  for the given truncate epoch and XLocSet version. */
+  int Read(const Key& key, char* buffer, int offset_in_object, int length);
+
+  /** Returns the value which has to be passed to Store(). Retrieve it before
+   *  the object is read from the OSD. */
+  uint64_t GetGeneration() const;
+
+  /** Stores "size" bytes of "data" as object "key". The object is not stored
+   *  if an invalidation happened after "generation" was retrieved because
+   *  "data" may be outdated then. */
+  void Store(const Key& key, const char* data, int size, uint64_t generation);
+
+  /** Removes all objects of "file_id" which do not belong to the given
+   *  truncate epoch and XLocSet version. Called when a file is opened. */
+  void Validate(const std::string& file_id,
+                uint32_t truncate_epoch,
+                uint32_t xlocset_version);
+
+  /** Removes all objects of "file_id", e.g. after it was written locally. */
+  void Invalidate(const std::string& file_id);
+
+  /** Returns the number of cached objects. */
+  size_t size();
+
+  /** Returns the size of all cached objects. */
+  uint64_t size_bytes();
+
+ private:
+  struct IndexHeader;
+  struct IndexEntry;
+
+  typedef std::pair<std::string, uint64_t> ObjectId;
+  typedef std::map<ObjectId, size_t> ObjectMap;
+  /** Pairs of (last access, index entry) in LRU order. */
+  typedef std::set<std::pair<uint64_t, size_t> > LRUSet;
+
+  /** Maps the index file and creates it if it does not exist or does not
+   *  match the given number of entries. */
+  void OpenIndex(size_t entries);
+
+  /** Removes the object files which are not referenced by the index. */
+  void RemoveUnreferencedFiles();
+
+  /** Removes entry "index" from all structures and deletes its file.
+   *  Requires a lock on mutex_. */
+  void RemoveEntryUnmutexed(size_t index);
+
+  /** Marks entry "index" as used now. Requires a lock on mutex_. */
+  void TouchEntryUnmutexed(size_t index);
+
+  std::string GetObjectPath(size_t index) const;
+
+  const std::string path_;
+
+  const uint64_t max_size_bytes_;
+
+  /** Open index file. Locked to prevent that two clients use the cache. */
+  int index_fd_;
+
+  /** Memory mapped index file. */
+  void* index_mapping_;
+
+  size_t index_mapping_size_;
+
+  IndexHeader* header_;
+
+  /** Array of header_->entries entries which follows the header. */
+  IndexEntry* entries_;
+
+  /** Protects all following members and the index. */
+  boost::mutex mutex_;
+
+  ObjectMap objects_;
+
+  LRUSet lru_;
+
+  std::vector<size_t> free_entries_;
+
+  uint64_t size_bytes_;
+
+  /** Incremented by every invalidation. */
+  boost::atomic<uint64_t> generation_;
+};
+
+}  // namespace xtreemfs
+
+#endif  // CPP_INCLUDE_LIBXTREEMFS_DISK_OBJECT_CACHE_H_
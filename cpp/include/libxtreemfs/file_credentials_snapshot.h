@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2026 by the XtreemFS Authors, see AUTHORS file
+ *
+ * Licensed under the BSD License, see LICENSE file for details.
+ *
+ */
+
+#ifndef CPP_INCLUDE_LIBXTREEMFS_FILE_CREDENTIALS_SNAPSHOT_H_
+#define CPP_INCLUDE_LIBXTREEMFS_FILE_CREDENTIALS_SNAPSHOT_H_
+
+#include <boost/shared_ptr.hpp>
+#include <string>
+
+#include "xtreemfs/GlobalTypes.pb.h"
+
+namespace xtreemfs {
+
+/** XCap and XLocSet of a file, shared by all reads and writes until one of
+ *  them is replaced.
+ *
+ *  The OSD requests of reads and writes (readRequest, writeRequest) start
+ *  with the FileCredentials as field 1. They are serialized once per snapshot
+ *  and sent in front of every request, which does not contain them (see
+ *  SplicingOSDServiceClient). */
+class FileCredentialsSnapshot {
+ public:
+  /** Field number of "file_credentials" in readRequest and writeRequest. */
+  static const int kFieldNumber = 1;
+
+  /** Both objects must not be modified afterwards. */
+  FileCredentialsSnapshot(boost::shared_ptr<const pbrpc::XCap> xcap,
+                          boost::shared_ptr<const pbrpc::XLocSet> xlocs);
+
+  const pbrpc::XCap& xcap() const {
+    return *xcap_;
+  }
+
+  const pbrpc::XLocSet& xlocs() const {
+    return *xlocs_;
+  }
+
+  /** Returns the FileCredentials as serialized field kFieldNumber, i.e. tag,
+   *  length and message. */
+  const std::string& serialized_field() const {
+    return serialized_field_;
+  }
+
+  /** Returns serialized_field() with "xcap" instead of xcap(). Used to retry
+   *  a request with a renewed XCap. */
+  std::string SerializeFieldWithXCap(const pbrpc::XCap& xcap) const;
+
+ private:
+  /** Serializes "file_credentials" as field kFieldNumber. */
+  static std::string SerializeField(
+      const pbrpc::FileCredentials& file_credentials);
+
+  const boost::shared_ptr<const pbrpc::XCap> xcap_;
+
+  const boost::shared_ptr<const pbrpc::XLocSet> xlocs_;
+
+  std::string serialized_field_;
+};
+
+/** FileCredentials of the requests of one read or write of an object.
+ *
+ *  ExecuteSyncRequest() copies the current XCap into mutable_xcap() before a
+ *  retry. From then on, serialized_field() contains the renewed XCap. */
+class RequestFileCredentials {
+ public:
+  /** "snapshot" has to outlive this object. */
+  explicit RequestFileCredentials(const FileCredentialsSnapshot& snapshot)
+      : snapshot_(snapshot) {}
+
+  pbrpc::XCap* mutable_xcap() {
+    return &renewed_xcap_;
+  }
+
+  /** Returns the FileCredentials to be sent with the next attempt. */
+  const std::string& serialized_field();
+
+ private:
+  const FileCredentialsSnapshot& snapshot_;
+
+  /** Empty until ExecuteSyncRequest() renewed the XCap. */
+  pbrpc::XCap renewed_xcap_;
+
+  /** Serialized FileCredentials with renewed_xcap_. */
+  std::string renewed_field_;
+};
+
+}  // namespace xtreemfs
+
+#endif  // CPP_INCLUDE_LIBXTREEMFS_FILE_CREDENTIALS_SNAPSHOT_H_
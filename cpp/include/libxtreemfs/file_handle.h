@@ -0,0 +1,353 @@
+/*
+ * Copyright (c) 2011 by Michael Berlin, Zuse Institute Berlin
+ *
+ * Licensed under the BSD License, see LICENSE file for details.
+ *
+ */
+
+#ifndef CPP_INCLUDE_LIBXTREEMFS_FILE_HANDLE_H_
+#define CPP_INCLUDE_LIBXTREEMFS_FILE_HANDLE_H_
+
+#include <stdint.h>
+
+namespace xtreemfs {
+
+namespace pbrpc {
+class Lock;
+class Stat;
+class UserCredentials;
+}  // namespace pbrpc
+
+class XtreemFSException;
+
+/** Receives the result of FileHandle::ReadAsync() and WriteAsync(). */
+class FileHandleCallbackInterface {
+ public:
+  virtual ~FileHandleCallbackInterface() {}
+
+  /** Called exactly once per operation from a libxtreemfs thread.
+   *
+   * @param result      Number of bytes read or written. Undefined if "error"
+   *                    is set.
+   * @param error       NULL on success. Otherwise the exception which the
+   *                    blocking Read() or Write() would have thrown. Only
+   *                    valid during the call.
+   * @param context     The context passed to ReadAsync() or WriteAsync().
+   *
+   * @attention Do not call FileHandle::Close() of the same file from within
+   *            the callback.
+   *
+   * @remark Exceptions thrown by the callback are logged and ignored.
+   */
+  virtual void AsyncIOFinished(int result,
+                               const XtreemFSException* error,
+                               void* context) = 0;
+};
+
+class FileHandle {
+ public:
+  virtual ~FileHandle() {}
+
+  /** Read from a file 'count' bytes starting at 'offset' into 'buf'.
+   *
+   * @param buf[out]            Buffer to be filled with read data.
+   * @param count               Number of requested bytes.
+   * @param offset              Offset in bytes.
+   *
+   * @throws AddressToUUIDNotFoundException
+   * @throws IOException
+   * @throws PosixErrorException
+   * @throws UnknownAddressSchemeException
+   *
+   * @return    Number of bytes read.
+   */
+  virtual int Read(
+      char *buf,
+      size_t count,
+      int64_t offset) = 0;
+
+  /** Write to a file 'count' bytes at file offset 'offset' from 'buf'.
+   *
+   * @attention     If asynchronous writes are enabled (which is the default
+   *                unless the file was opened with O_SYNC or async writes
+   *                were disabled globally), no possible write errors can be
+   *                returned as Write() does return immediately after putting
+   *                the write request into the send queue instead of waiting
+   *                until the result was received.
+   *                In this case, only after calling Flush() or Close() occurred
+   *                write errors are returned to the user.
+   *
+   * @param buf[in]             Buffer which contains data to be written.
+   * @param count               Number of bytes to be written from buf.
+   * @param offset              Offset in bytes.
+   *
+   * @throws AddressToUUIDNotFoundException
+   * @throws IOException
+   * @throws PosixErrorException
+   * @throws UnknownAddressSchemeException
+   *
+   * @return    Number of bytes written (see @attention above).
+   */
+  virtual int Write(
+      const char *buf,
+      size_t count,
+      int64_t offset) = 0;
+
+  /** Same as Read(), but returns after sending the requests. The result is
+   *  passed to "callback" once all requested bytes were received.
+   *
+   *  The requests of all objects are sent at once. Objects whose request
+   *  failed are read again with the error handling of Read() before the
+   *  callback is executed.
+   *
+   * @param buf[out]            Buffer to be filled with read data. Has to be
+   *                            valid until the callback was executed.
+   * @param count               Number of requested bytes.
+   * @param offset              Offset in bytes.
+   * @param callback            Receives the result of the operation.
+   * @param context             Passed to the callback.
+   *
+   * @throws AddressToUUIDNotFoundException
+   * @throws IOException
+   * @throws PosixErrorException
+   * @throws UnknownAddressSchemeException
+   *
+   * @remark If an exception is thrown, the callback will not be executed.
+   */
+  virtual void ReadAsync(
+      char *buf,
+      size_t count,
+      int64_t offset,
+      FileHandleCallbackInterface* callback,
+      void* context) = 0;
+
+  /** Same as Write(), but returns after sending the requests. The result is
+   *  passed to "callback" once all objects were acknowledged by the OSDs.
+   *
+   *  Unlike Write() with enabled asynchronous writes, errors are reported to
+   *  the callback of the failed operation. The order of overlapping
+   *  WriteAsync() operations which are pending at the same time is undefined.
+   *
+   * @param buf[in]             Buffer which contains data to be written. Has
+   *                            to be valid until the callback was executed.
+   * @param count               Number of bytes to be written from buf.
+   * @param offset              Offset in bytes.
+   * @param callback            Receives the result of the operation.
+   * @param context             Passed to the callback.
+   *
+   * @throws AddressToUUIDNotFoundException
+   * @throws IOException
+   * @throws PosixErrorException
+   * @throws UnknownAddressSchemeException
+   *
+   * @remark If an exception is thrown, the callback will not be executed.
+   */
+  virtual void WriteAsync(
+      const char *buf,
+      size_t count,
+      int64_t offset,
+      FileHandleCallbackInterface* callback,
+      void* context) = 0;
+
+  /** Flushes pending writes and file size updates (corresponds to a fsync()
+   *  system call).
+   *
+   * @throws AddressToUUIDNotFoundException
+   * @throws IOException
+   * @throws PosixErrorException
+   * @throws UnknownAddressSchemeException
+   */
+  virtual void Flush() = 0;
+
+  /** Truncates the file to "new_file_size_ bytes".
+   *
+   * @param user_credentials    Name and Groups of the user.
+   * @param new_file_size       New size of the file.
+   *
+   * @throws AddressToUUIDNotFoundException
+   * @throws IOException
+   * @throws PosixErrorException
+   * @throws UnknownAddressSchemeException
+   **/
+  virtual void Truncate(
+      const xtreemfs::pbrpc::UserCredentials& user_credentials,
+      int64_t new_file_size) = 0;
+
+  /** Retrieve the attributes of this file and writes the result in "stat".
+   *
+   * @param user_credentials    Name and Groups of the user.
+   * @param stat[out]           Pointer to Stat which will be overwritten.
+   *
+   * @throws AddressToUUIDNotFoundException
+   * @throws IOException
+   * @throws PosixErrorException
+   * @throws UnknownAddressSchemeException
+   */
+  virtual void GetAttr(
+      const xtreemfs::pbrpc::UserCredentials& user_credentials,
+      xtreemfs::pbrpc::Stat* stat) = 0;
+
+  /** Sets a lock on the specified file region and returns the resulting Lock
+   *  object.
+   *
+   * If the acquisition of the lock fails, PosixErrorException will be thrown
+   * and posix_errno() will return POSIX_ERROR_EAGAIN.
+   *
+   * Conflicts between processes of this client are resolved locally. Every
+   * granted lock is held at the OSD.
+   *
+   * @param process_id      ID of the process to which the lock belongs.
+   * @param offset          Start of the region to be locked in the file.
+   * @param length          Length of the region.
+   * @param exclusive       shared/read lock (false) or write/exclusive (true)?
+   * @param wait_for_lock   if true, blocks until lock acquired.
+   *
+   * @throws AddressToUUIDNotFoundException
+   * @throws IOException
+   * @throws PosixErrorException
+   * @throws UnknownAddressSchemeException
+   *
+   * @remark Ownership is transferred to the caller.
+   */
+  virtual xtreemfs::pbrpc::Lock* AcquireLock(
+      int process_id,
+      uint64_t offset,
+      uint64_t length,
+      bool exclusive,
+      bool wait_for_lock) = 0;
+
+  /** Checks if the requested lock does not result in conflicts. If true, the
+   *  returned Lock object contains the requested 'process_id' in 'client_pid',
+   *  otherwise the Lock object is a copy of the conflicting lock.
+   *
+   * @param process_id      ID of the process to which the lock belongs.
+   * @param offset          Start of the region to be locked in the file.
+   * @param length          Length of the region.
+   * @param exclusive       shared/read lock (false) or write/exclusive (true)?
+   *
+   * @throws AddressToUUIDNotFoundException
+   * @throws IOException
+   * @throws PosixErrorException
+   * @throws UnknownAddressSchemeException
+   *
+   * @remark Ownership is transferred to the caller.
+   */
+  virtual xtreemfs::pbrpc::Lock* CheckLock(
+      int process_id,
+      uint64_t offset,
+      uint64_t length,
+      bool exclusive) = 0;
+
+  /** Releases "lock".
+   *
+   * @param process_id      ID of the process to which the lock belongs.
+   * @param offset          Start of the region to be locked in the file.
+   * @param length          Length of the region.
+   * @param exclusive       shared/read lock (false) or write/exclusive (true)?
+   *
+   * @throws AddressToUUIDNotFoundException
+   * @throws IOException
+   * @throws PosixErrorException
+   * @throws UnknownAddressSchemeException
+   */
+  virtual void ReleaseLock(
+      int process_id,
+      uint64_t offset,
+      uint64_t length,
+      bool exclusive) = 0;
+
+  /** Releases "lock" (parameters given in Lock object).
+   *
+   * @param lock    Lock to be released.
+   *
+   * @throws AddressToUUIDNotFoundException
+   * @throws IOException
+   * @throws PosixErrorException
+   * @throws UnknownAddressSchemeException
+   */
+  virtual void ReleaseLock(
+      const xtreemfs::pbrpc::Lock& lock) = 0;
+
+  /** Releases the lock possibly hold by "process_id". Use this before closing
+   *  a file to ensure POSIX semantics:
+   *
+   * "All locks associated with a file for a given process shall be removed
+   *  when a file descriptor for that file is closed by that process or the
+   *  process holding that file descriptor terminates."
+   *  (http://pubs.opengroup.org/onlinepubs/009695399/functions/fcntl.html)
+   *
+   * @param process_id  ID of the process whose lock shall be released.
+   *
+   * @throws AddressToUUIDNotFoundException
+   * @throws IOException
+   * @throws PosixErrorException
+   * @throws UnknownAddressSchemeException
+   */
+  virtual void ReleaseLockOfProcess(int process_id) = 0;
+
+  /** Triggers the replication of the replica on the OSD with the UUID
+   *  "osd_uuid" if the replica is a full replica (and not a partial one).
+   *
+   * The Replica had to be added beforehand and "osd_uuid" has to be included
+   * in the XlocSet of the file.
+   *
+   * @param user_credentials    Name and Groups of the user.
+   * @param osd_uuid    UUID of the OSD where the replica is located.
+   *
+   * @throws AddressToUUIDNotFoundException
+   * @throws IOException
+   * @throws PosixErrorException
+   * @throws UnknownAddressSchemeException
+   * @throws UUIDNotInXlocSetException
+   */
+  virtual void PingReplica(
+      const std::string& osd_uuid) = 0;
+
+  /** Closes the open file handle (flushing any pending data).
+   *
+   * @attention The libxtreemfs implementation does NOT count the number of
+   *            pending operations (except for ReadAsync() and WriteAsync()
+   *            which are waited for). Make sure that there're no pending
+   *            operations on the FileHandle before you Close() it.
+   *
+   * @attention Please execute ReleaseLockOfProcess() first if there're multiple
+   *            open file handles for the same file and you want to ensure the
+   *            POSIX semantics that with the close of a file handle the lock
+   *            (XtreemFS allows only one per tuple (client UUID, Process ID))
+   *            of the process will be closed.
+   *            If you do not care about this, you don't have to release any
+   *            locks on your own as all locks will be automatically released if
+   *            the last open file handle of a file will be closed.
+   *
+   * @remark    If write-behind closes are enabled (Options::
+   *            enable_write_behind_close), Close() returns after the pending
+   *            writes were handed to the asynchronous write path. Errors of
+   *            the background close are thrown by the next Flush(), Close()
+   *            or Volume::OpenFile() of the same file, even if it was renamed
+   *            meanwhile.
+   *
+   * @throws AddressToUUIDNotFoundException
+   * @throws FileInfoNotFoundException
+   * @throws FileHandleNotFoundException
+   * @throws IOException
+   * @throws PosixErrorException
+   * @throws UnknownAddressSchemeException
+   */
+  virtual void Close() = 0;
+
+  /** Gets the address of the OSD that was last used for reading
+   * or writing.
+   */
+  virtual std::string GetLastOSDAddress() = 0;
+
+  /** Sets the key under which Read(), Write(), ReadAsync() and WriteAsync()
+   *  of this handle are throttled if QoS limits are configured (see
+   *  Options::qos_max_bandwidth_kb). Defaults to the username of the user
+   *  who opened the file. Must be called before the first read or write. */
+  virtual void SetQoSKey(const std::string& key) = 0;
+};
+
+}  // namespace xtreemfs
+
+
+#endif  // CPP_INCLUDE_LIBXTREEMFS_FILE_HANDLE_H_
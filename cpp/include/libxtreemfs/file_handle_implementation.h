@@ -0,0 +1,881 @@
+/*
+ * Copyright (c) 2011 by Michael Berlin,
+ *               2015 by Robert Bärhold
+ *                    Zuse Institute Berlin
+ *
+ * Licensed under the BSD License, see LICENSE file for details.
+ *
+ */
+
+#ifndef CPP_INCLUDE_LIBXTREEMFS_FILE_HANDLE_IMPLEMENTATION_H_
+#define CPP_INCLUDE_LIBXTREEMFS_FILE_HANDLE_IMPLEMENTATION_H_
+
+#include <stdint.h>
+
+#include <boost/atomic.hpp>
+#include <boost/function.hpp>
+#include <boost/thread/condition.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <boost/shared_ptr.hpp>
+#include <gtest/gtest_prod.h>
+#include <list>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "pbrpc/RPC.pb.h"
+#include "rpc/callback_interface.h"
+#include "xtreemfs/GlobalTypes.pb.h"
+#include "xtreemfs/MRC.pb.h"
+#include "xtreemfs/OSD.pb.h"
+#include "libxtreemfs/client_implementation.h"
+#include "libxtreemfs/file_handle.h"
+#include "libxtreemfs/interrupt.h"
+#include "libxtreemfs/xcap_handler.h"
+#include "libxtreemfs/xtreemfs_exception.h"
+#include "util/synchronized_queue.h"
+
+namespace xtreemfs {
+
+namespace rpc {
+class SyncCallbackBase;
+}  // namespace rpc
+
+namespace pbrpc {
+class Lock;
+class lockRequest;
+class MRCServiceClient;
+class OSDServiceClient;
+class readRequest;
+class writeRequest;
+}  // namespace pbrpc
+
+class FileCredentialsSnapshot;
+class FileHandleImplementation;
+class FileInfo;
+class IOThrottle;
+class OSDEndpointTable;
+class Options;
+class SplicingOSDServiceClient;
+class StripeTranslator;
+class UUIDContainer;
+class UUIDIterator;
+class UUIDResolver;
+class Volume;
+class WriteOperation;
+class XCapManager;
+class VoucherManager;
+class VoucherManagerCallback;
+
+class VoucherManager : public rpc::CallbackInterface<xtreemfs::pbrpc::OSDFinalizeVouchersResponse> {
+ public:
+  VoucherManager(FileInfo* file_info, XCapManager* xcap_manager,
+                 pbrpc::MRCServiceClient* mrc_service_client,
+                 pbrpc::OSDServiceClient* osd_service_client_,
+                 UUIDResolver* uuid_resolver, UUIDIterator* mrc_uuid_iterator,
+                 UUIDIterator* osd_uuid_iterator,
+                 const Options& volume_options,
+                 const pbrpc::Auth& auth_bogus,
+                 const pbrpc::UserCredentials& user_credentials_bogus);
+
+  /** Handles the overall process of the finalize and clear voucher protocol. */
+  void finalizeAndClear();
+ private:
+  /** Sends out the finalize voucher request in an asynchronous manner to all relevant OSDs. */
+  void finalizeVoucher(xtreemfs::pbrpc::xtreemfs_finalize_vouchersRequest* finalizeVouchersRequest,
+                       VoucherManagerCallback* callback);
+
+  /** Sends out the clear voucher request to the MRC containing all OSD responses. */
+  void clearVoucher(xtreemfs::pbrpc::xtreemfs_clear_vouchersRequest* clearVouchersRequest);
+
+  /** Checks the consistency of all finalize OSD responses and returns true on equality. */
+  bool checkResponseConsistency();
+
+  /** Deletes every object in the osdFinalizeVoucherResponseVector_ and clears it. */
+  void cleanupOSDResponses();
+
+  /** Implements callback for the finalize voucher requests from the OSDs,
+   * saving all responses in the osdFinalizeVoucherResponseVector_. */
+  virtual void CallFinished(xtreemfs::pbrpc::OSDFinalizeVouchersResponse* response_message,
+                            char* data,
+                            uint32_t data_length,
+                            pbrpc::RPCHeader::ErrorResponse* error,
+                            void* context);
+
+  /** Use this mutex guarantee a single call of finalize and clear. */
+  boost::mutex mutex_;
+
+  /** Used to wait on the condition. */
+  boost::mutex cond_mutex_;
+
+  /** Used to wait for finalize voucher respones of used OSDs. */
+  boost::condition osd_finalize_pending_cond;
+
+  /** number of osds, we expect a reponse of. */
+  int osdCount;
+
+  /** Used to save current finalize voucher responses from the OSDs. */
+  std::vector<xtreemfs::pbrpc::OSDFinalizeVouchersResponse*> osdFinalizeVoucherResponseVector_;
+
+
+  /** Multiple FileHandle may refer to the same File and therefore unique file
+   * properties (e.g. Path, FileId, XlocSet) are stored in a FileInfo object. */
+  FileInfo* file_info_;
+
+  /** Pointer to the XCapManager instance of the file handle. */
+  XCapManager* xcap_manager_;
+
+  /** Pointer to object owned by VolumeImplemention */
+  pbrpc::MRCServiceClient* mrc_service_client_;
+
+  /** Pointer to object owned by VolumeImplemention */
+  pbrpc::OSDServiceClient* osd_service_client_;
+
+  /** UUID resolver*/
+  UUIDResolver* uuid_resolver_;
+
+  /** UUIDIterator of the MRC. */
+  UUIDIterator* mrc_uuid_iterator_;
+
+  /** UUIDIterator which contains the UUIDs of all replicas. */
+  UUIDIterator* osd_uuid_iterator_;
+
+  /** Volume options used in the requests. */
+  const Options& volume_options_;
+
+  /** Auth needed for ServiceClients. Always set to AUTH_NONE by Volume. */
+  const pbrpc::Auth& auth_bogus_;
+
+  /** For same reason needed as auth_bogus_. Always set to user "xtreemfs". */
+  const pbrpc::UserCredentials& user_credentials_bogus_;
+};
+
+class VoucherManagerCallback : public rpc::CallbackInterface<xtreemfs::pbrpc::OSDFinalizeVouchersResponse> {
+ public:
+  VoucherManagerCallback(VoucherManager* voucherManager,
+                         const int tryNo,
+                         const int osdCount);
+
+  /** Unregisters the VoucherManager that created the Callback.
+   * If there are finalize voucher requests in flight, the Callback
+   * will be kept in memory until every response has arrived.
+   * Otherwise the Callback will destroy itself. */
+  void unregisterManager();
+
+ private:
+  /** Implements callback for the finalize voucher requests from the OSDs.
+   * Redirects every response to the registered VoucherManager CallFinished.
+   * If no VoucherManager is registered the responses are discarded/freed.
+   * If no VoucherManager is registered and every finalize voucher response
+   * has arrived, the VoucherManagerCallback destroys itself. */
+  virtual void CallFinished(xtreemfs::pbrpc::OSDFinalizeVouchersResponse* response_message,
+                            char* data,
+                            uint32_t data_length,
+                            pbrpc::RPCHeader::ErrorResponse* error,
+                            void* context);
+
+  /** Use this mutex to guard changes/checks to voucherManager_. */
+  boost::mutex mutex_;
+
+  /** The VoucherManager that created this Callback.
+   * Or NULL if it has been unregistered. */
+  rpc::CallbackInterface<xtreemfs::pbrpc::OSDFinalizeVouchersResponse>* voucherManager_;
+  /** The number of the try on which this callback was created. */
+  const int tryNo_;
+  /** The number of OSDs and respective number of requests sent for this try. */
+  const int osdCount_;
+  /** The number of responses for this try. */
+  int respCount_;
+};
+
+class XCapManager :
+    public rpc::CallbackInterface<xtreemfs::pbrpc::XCap>,
+    public XCapHandler {
+ public:
+  XCapManager(
+      const xtreemfs::pbrpc::XCap& xcap,
+      pbrpc::MRCServiceClient* mrc_service_client,
+      UUIDResolver* uuid_resolver,
+      UUIDIterator* mrc_uuid_iterator,
+      const pbrpc::Auth& auth_bogus,
+      const pbrpc::UserCredentials& user_credentials_bogus);
+
+  /** Renew xcap_ asynchronously. */
+  void RenewXCapAsync(const RPCOptions& options);
+
+  /** Renew xcap_ asynchronously. Add writeback, in case of an error */
+  void RenewXCapAsync(const RPCOptions& options, const bool increaseVoucher,
+                      PosixErrorException* writeback);
+
+  /** Blocks until the callback has completed (if an XCapRenewal is pending). */
+  void WaitForPendingXCapRenewal();
+
+  /** XCapHandler: Get current capability.*/
+  virtual void GetXCap(xtreemfs::pbrpc::XCap* xcap);
+
+  /** Returns the current capability without copying it. The returned object
+   *  is never modified, SetXCap() replaces it by a new one. */
+  boost::shared_ptr<const xtreemfs::pbrpc::XCap> GetXCapSnapshot();
+
+  /** Update the capability with the provided one. */
+  void SetXCap(const xtreemfs::pbrpc::XCap& xcap);
+
+  /** Get the file id from the capability. */
+  uint64_t GetFileId();
+
+  /** Returns the list of old expire times. */
+  std::list< ::google::protobuf::uint64>& GetOldExpireTimes();
+
+  /** Acquires the mutex related to list of old expire times. */
+  void acquireOldExpireTimesMutex();
+
+  /** Releases the mutex related to list of old expire times. */
+  void releaseOldExpireTimesMutex();
+
+ private:
+  /** Implements callback for an async xtreemfs_renew_capability request. */
+  virtual void CallFinished(xtreemfs::pbrpc::XCap* new_xcap,
+                            char* data,
+                            uint32_t data_length,
+                            pbrpc::RPCHeader::ErrorResponse* error,
+                            void* context);
+
+  /** Any modification to the object must obtain a lock first. */
+  boost::mutex mutex_;
+
+  /** Capabilitiy for the file, used to authorize against services */
+  xtreemfs::pbrpc::XCap xcap_;
+
+  /** Immutable copy of xcap_. Never modified after it was published, only
+   *  replaced with boost::atomic_store() on every update of xcap_. */
+  boost::shared_ptr<const xtreemfs::pbrpc::XCap> xcap_snapshot_;
+
+  /** True if there is an outstanding xcap_renew callback. */
+  bool xcap_renewal_pending_;
+
+  /** Used to wait for pending XCap renewal callbacks. */
+  boost::condition xcap_renewal_pending_cond_;
+
+  /** Used to keep track of possible writebacks of errros, occured at the renewal. */
+  std::list<PosixErrorException*> xcap_renewal_error_writebacks_;
+
+  /** Any modification on the xcap_renewal_error_writebacks_ list have to obtain this lock first. */
+  boost::mutex xcap_renewal_error_writebacks_mutex_;
+
+  /** Used to keep track of old expire times to finalize voucher requests. **/
+  std::list< ::google::protobuf::uint64> old_expire_times_;
+
+  /** Use this to protect old_expire_times. */
+  boost::mutex old_expire_times_mutex_;
+
+  /** UUIDIterator of the MRC. */
+  pbrpc::MRCServiceClient* mrc_service_client_;
+  UUIDResolver* uuid_resolver_;
+  UUIDIterator* mrc_uuid_iterator_;
+
+  /** Auth needed for ServiceClients. Always set to AUTH_NONE by Volume. */
+  const pbrpc::Auth auth_bogus_;
+
+  /** For same reason needed as auth_bogus_. Always set to user "xtreemfs". */
+  const pbrpc::UserCredentials user_credentials_bogus_;
+};
+
+/** State of a FileHandle::ReadAsync() or WriteAsync() operation.
+ *
+ *  The requests of all objects are sent at once using the async stubs of the
+ *  OSDServiceClient. When the last response was received, the operation is
+ *  enqueued into the client's async I/O completion queue and completed by
+ *  ProcessCompletions() outside of the network thread. Operations with failed
+ *  objects are passed on to the retry queue, whose threads retry the objects
+ *  synchronously (ProcessRetries()). This way, a blocking retry does not delay
+ *  the completion of other operations.
+ *
+ *  The operation counts as pending I/O of its file handle from its creation
+ *  until it is deleted, see FileHandleImplementation::WaitForAsyncIO().
+ */
+class AsyncIOOperation
+    : public rpc::CallbackInterface<pbrpc::ObjectData>,
+      public rpc::CallbackInterface<pbrpc::OSDWriteResponse> {
+ public:
+  /** Request and response of a single object. */
+  struct ObjectRequest {
+    ObjectRequest(int object_no, int64_t file_offset, size_t size,
+                  char* buffer)
+        : object_no(object_no),
+          file_offset(file_offset),
+          size(size),
+          buffer(buffer),
+          response_message(NULL),
+          data(NULL),
+          data_length(0),
+          error(NULL),
+          retry(false) {}
+
+    int object_no;
+    /** Offset of the requested range in the file. */
+    int64_t file_offset;
+    size_t size;
+    char* buffer;
+
+    /** Response of the OSD, NULL if the request was not sent. */
+    google::protobuf::Message* response_message;
+    char* data;
+    uint32_t data_length;
+    pbrpc::RPCHeader::ErrorResponse* error;
+
+    /** True if the object has to be read or written again synchronously. */
+    bool retry;
+  };
+
+  AsyncIOOperation(
+      FileHandleImplementation* file_handle,
+      bool is_write,
+      FileHandleCallbackInterface* callback,
+      void* context,
+      util::SynchronizedQueue<AsyncIOOperation*>* completion_queue);
+
+  /** Frees the buffers of all responses and ends the pending I/O of the file
+   *  handle. */
+  virtual ~AsyncIOOperation();
+
+  /** Adds an object request and returns the context for its async request.
+   *  All object requests have to be added before the first one is sent. */
+  void* AddObjectRequest(int object_no,
+                         int64_t file_offset,
+                         size_t size,
+                         char* buffer);
+
+  /** Has to be called before an object request is sent. */
+  void IncreasePendingResponses();
+
+  /** Has to be called once all requests were sent. Object requests which were
+   *  not sent have no response and are retried by the completion. */
+  void AllRequestsSent();
+
+  /** Completes the operations of "completion_queue" until interrupted.
+   *  Operations with failed objects are enqueued into "retry_queue". */
+  static void ProcessCompletions(
+      util::SynchronizedQueue<AsyncIOOperation*>& completion_queue,
+      util::SynchronizedQueue<AsyncIOOperation*>& retry_queue);
+
+  /** Retries the failed objects of the operations of "retry_queue" until
+   *  interrupted. */
+  static void ProcessRetries(
+      util::SynchronizedQueue<AsyncIOOperation*>& retry_queue);
+
+  /** Implements callback for the async read requests. */
+  virtual void CallFinished(pbrpc::ObjectData* response_message,
+                            char* data,
+                            uint32_t data_length,
+                            pbrpc::RPCHeader::ErrorResponse* error,
+                            void* context);
+
+  /** Implements callback for the async write requests. */
+  virtual void CallFinished(pbrpc::OSDWriteResponse* response_message,
+                            char* data,
+                            uint32_t data_length,
+                            pbrpc::RPCHeader::ErrorResponse* error,
+                            void* context);
+
+  FileHandleImplementation* file_handle() { return file_handle_; }
+
+  bool is_write() const { return is_write_; }
+
+  FileHandleCallbackInterface* callback() { return callback_; }
+
+  void* context() { return context_; }
+
+  std::vector<ObjectRequest>& object_requests() { return object_requests_; }
+
+  /** Number of bytes read or written by the completed objects. */
+  int completed_bytes() const { return completed_bytes_; }
+
+  void AddCompletedBytes(int bytes) { completed_bytes_ += bytes; }
+
+ private:
+  /** Stores the response of the request "context". */
+  void ResponseReceived(google::protobuf::Message* response_message,
+                        char* data,
+                        uint32_t data_length,
+                        pbrpc::RPCHeader::ErrorResponse* error,
+                        void* context);
+
+  /** Enqueues this operation for completion if nothing is pending anymore. */
+  void DecreasePendingResponses();
+
+  FileHandleImplementation* file_handle_;
+
+  const bool is_write_;
+
+  FileHandleCallbackInterface* callback_;
+
+  void* context_;
+
+  util::SynchronizedQueue<AsyncIOOperation*>* completion_queue_;
+
+  /** Protects pending_responses_. */
+  boost::mutex mutex_;
+
+  /** Number of outstanding responses plus one until AllRequestsSent(). */
+  int pending_responses_;
+
+  /** May not be modified after the first request was sent. */
+  std::vector<ObjectRequest> object_requests_;
+
+  /** Only accessed by the thread which completes the operation. */
+  int completed_bytes_;
+};
+
+/** Default implementation of the FileHandle Interface. */
+class FileHandleImplementation
+    : public FileHandle,
+      public XCapHandler,
+      public rpc::CallbackInterface<pbrpc::timestampResponse> {
+ public:
+  FileHandleImplementation(
+      ClientImplementation* client,
+      const std::string& client_uuid,
+      FileInfo* file_info,
+      const pbrpc::XCap& xcap,
+      UUIDIterator* mrc_uuid_iterator,
+      UUIDIterator* osd_uuid_iterator,
+      UUIDResolver* uuid_resolver,
+      pbrpc::MRCServiceClient* mrc_service_client,
+      SplicingOSDServiceClient* osd_service_client,
+      const std::map<pbrpc::StripingPolicyType,
+                     StripeTranslator*>& stripe_translators,
+      bool async_writes_enabled,
+      IOThrottle* io_throttle,
+      const Options& options,
+      const pbrpc::Auth& auth_bogus,
+      const pbrpc::UserCredentials& user_credentials_bogus);
+
+  virtual ~FileHandleImplementation();
+
+  virtual int Read(char *buf, size_t count, int64_t offset);
+
+  virtual int Write(const char *buf, size_t count, int64_t offset);
+
+  virtual void ReadAsync(char *buf,
+                         size_t count,
+                         int64_t offset,
+                         FileHandleCallbackInterface* callback,
+                         void* context);
+
+  virtual void WriteAsync(const char *buf,
+                          size_t count,
+                          int64_t offset,
+                          FileHandleCallbackInterface* callback,
+                          void* context);
+
+  /** Used by AsyncIOOperation::ProcessCompletions() to complete the objects
+   *  of "operation" which were received successfully and to execute its
+   *  callback. Returns false without executing the callback if objects have
+   *  to be retried by RetryAsyncIO().
+   *
+   *  Never blocks on a request. */
+  bool CompleteAsyncIO(AsyncIOOperation* operation);
+
+  /** Used by AsyncIOOperation::ProcessRetries() to read or write the failed
+   *  objects of "operation" synchronously and to execute its callback. */
+  void RetryAsyncIO(AsyncIOOperation* operation);
+
+  /** Used by AsyncIOOperation to count the pending async I/O. */
+  void IncreasePendingAsyncIO();
+
+  /** Counterpart of IncreasePendingAsyncIO(), called by ~AsyncIOOperation()
+   *  i.e. even if completing the operation failed. */
+  void DecreasePendingAsyncIO();
+
+  virtual void Flush();
+
+  virtual void Truncate(
+      const pbrpc::UserCredentials& user_credentials,
+      int64_t new_file_size);
+
+  /** Used by Truncate() and Volume->OpenFile() to truncate the file to
+   *  "new_file_size" on the OSD and update the file size at the MRC.
+   *
+   * @throws AddressToUUIDNotFoundException
+   * @throws IOException
+   * @throws PosixErrorException
+   * @throws UnknownAddressSchemeException
+   **/
+  void TruncatePhaseTwoAndThree(int64_t new_file_size);
+
+  virtual void GetAttr(
+      const pbrpc::UserCredentials& user_credentials,
+      pbrpc::Stat* stat);
+
+  virtual xtreemfs::pbrpc::Lock* AcquireLock(
+      int process_id,
+      uint64_t offset,
+      uint64_t length,
+      bool exclusive,
+      bool wait_for_lock);
+
+  virtual xtreemfs::pbrpc::Lock* CheckLock(
+      int process_id,
+      uint64_t offset,
+      uint64_t length,
+      bool exclusive);
+
+  virtual void ReleaseLock(
+      int process_id,
+      uint64_t offset,
+      uint64_t length,
+      bool exclusive);
+
+  /** Also used by FileInfo object to free active locks. */
+  void ReleaseLock(const pbrpc::Lock& lock);
+
+  virtual void ReleaseLockOfProcess(int process_id);
+
+  virtual void PingReplica(const std::string& osd_uuid);
+
+  virtual void Close();
+
+  /** Used by VolumeImplementation to complete a write-behind Close(): waits
+   *  for the pending async writes and sends the file size update to the MRC
+   *  in the background. */
+  void StartDeferredClose(const RPCOptions& options);
+
+  /** Flushes the file, finalizes the vouchers and deregisters the file handle.
+   *  Executed by Close() directly or, for write-behind closes, by
+   *  VolumeImplementation after StartDeferredClose().
+   *
+   * @throws AddressToUUIDNotFoundException
+   * @throws IOException
+   * @throws PosixErrorException
+   * @throws UnknownAddressSchemeException
+   */
+  void FinishClose();
+
+  virtual std::string GetLastOSDAddress();
+
+  virtual void SetQoSKey(const std::string& key);
+
+  /** Returns the StripingPolicy object for a given type (e.g. Raid0).
+   *
+   *  @remark Ownership is NOT transferred to the caller.
+   */
+  const StripeTranslator* GetStripeTranslator(
+      pbrpc::StripingPolicyType type);
+
+  /** Sets async_writes_failed_ to true. */
+  void MarkAsyncWritesAsFailed();
+  /** Thread-safe check if async_writes_failed_ */
+  bool DidAsyncWritesFail();
+  /** Thread-safe check and throw if async_writes_failed_ */
+  void ThrowIfAsyncWritesFailed();
+
+  /** Blocks until io_throttle_ admits an operation of "count" bytes. */
+  void ThrottleIO(size_t count);
+
+  /** Sends pending file size updates synchronous (needed for flush/close).
+   *
+   * @throws AddressToUUIDNotFoundException
+   * @throws IOException
+   * @throws PosixErrorException
+   * @throws UnknownAddressSchemeException
+   */
+  void WriteBackFileSize(const pbrpc::OSDWriteResponse& owr,
+                         bool close_file);
+
+  /** Sends osd_write_response_for_async_write_back_ asynchronously. */
+  void WriteBackFileSizeAsync(const RPCOptions& options);
+
+  /** Overwrites the current osd_write_response_ with "owr". */
+  void set_osd_write_response_for_async_write_back(
+      const pbrpc::OSDWriteResponse& owr);
+
+  /** Wait for all asyncronous operations to finish */
+  void WaitForAsyncOperations();
+
+  /** Execute period tasks */
+  void ExecutePeriodTasks(const RPCOptions& options);
+  
+  /** XCapHandler: Get current capability. */
+  virtual void GetXCap(xtreemfs::pbrpc::XCap* xcap);
+
+ private:
+  /**
+   * Execute the operation and check on invalid view exceptions.
+   * If the operation was executed with an outdated, the view
+   * will be renewed and the operation retried.
+   */
+  template<typename T>
+  T ExecuteViewCheckedOperation(boost::function<T()> operation);
+
+  /** Renew the xLocSet synchronously. */
+  void RenewXLocSet();
+
+  /** Implements callback for an async xtreemfs_update_file_size request. */
+  virtual void CallFinished(
+      pbrpc::timestampResponse* response_message,
+      char* data,
+      uint32_t data_length,
+      pbrpc::RPCHeader::ErrorResponse* error,
+      void* context);
+
+  /** Same as Flush(), takes special actions if called by Close(). */
+  void Flush(bool close_file);
+
+  /** Actual implementation of Flush(). */
+  void DoFlush(bool close_file);
+
+  /** Returns XCap and XLocSet of the file and, if not NULL, the
+   *  UUIDContainer and the OSDEndpointTable of the XLocSet.
+   *
+   *  The snapshot is shared. It is only rebuilt, i.e. serialized again, if
+   *  the XCap or the XLocSet was replaced since the last call. Does not take
+   *  a lock.
+   */
+  boost::shared_ptr<const FileCredentialsSnapshot> GetFileCredentialsSnapshot(
+      boost::shared_ptr<UUIDContainer>* uuid_container,
+      boost::shared_ptr<OSDEndpointTable>* osd_endpoints);
+
+  /** Actual implementation of Read(). */
+  int DoRead(
+      char *buf,
+      size_t count,
+      int64_t offset);
+
+  /** Read data from the disk cache or the OSD. If the object is not cached,
+   *  it is read completely and added to the disk cache. Objects owned by the
+   *  caller. */
+  int ReadFromOSD(
+      UUIDIterator* uuid_iterator,
+      OSDEndpointTable* osd_endpoints,
+      const FileCredentialsSnapshot& file_credentials,
+      int object_no,
+      char* buffer,
+      int offset_in_object,
+      int bytes_to_read);
+
+  /** Read data from the OSD, bypassing the disk cache. Objects owned by the
+   *  caller. */
+  int ReadFromOSDUncached(
+      UUIDIterator* uuid_iterator,
+      OSDEndpointTable* osd_endpoints,
+      const FileCredentialsSnapshot& file_credentials,
+      int object_no,
+      char* buffer,
+      int offset_in_object,
+      int bytes_to_read);
+
+  /** Removes the objects of this file from the disk cache, if enabled. */
+  void InvalidateDiskCache(const std::string& global_file_id);
+
+  /** Actual implementation of Write(). */
+  int DoWrite(
+      const char *buf,
+      size_t count,
+      int64_t offset);
+
+  /** Write data to the OSD with up to "max_tries" attempts (0 = infinite).
+   *  Objects owned by the caller. */
+  void WriteToOSD(
+      UUIDIterator* uuid_iterator,
+      OSDEndpointTable* osd_endpoints,
+      const FileCredentialsSnapshot& file_credentials,
+      int object_no,
+      int offset_in_object,
+      const char* buffer,
+      int bytes_to_write,
+      int max_tries);
+
+  /** Writes the objects of "operations" of a striped file at once: The first
+   *  attempt of every object is sent without waiting for the previous one.
+   *  Objects whose first attempt failed with a temporary error are written by
+   *  WriteToOSD() afterwards with the remaining attempts. Other errors are
+   *  thrown right away. */
+  void WriteToOSDsInParallel(
+      OSDEndpointTable* osd_endpoints,
+      const FileCredentialsSnapshot& file_credentials,
+      const std::vector<WriteOperation>& operations);
+
+  /** Fills in "write_request" for a write of "bytes_to_write" bytes at
+   *  "buffer" to the given object. The buffer is only used to compute the
+   *  checksum. The FileCredentials are not copied into "write_request", they
+   *  have to be sent in front of it (see SplicingOSDServiceClient). */
+  void PrepareWriteRequest(
+      const FileCredentialsSnapshot& file_credentials,
+      int object_no,
+      int offset_in_object,
+      const char* buffer,
+      int bytes_to_write,
+      pbrpc::writeRequest* write_request);
+
+  /** Returns false if checksums are enabled and "data" does not match the
+   *  checksum in "object_data" or the OSD reported a wrong checksum. Reports
+   *  the error then. "osd_uuid" may be empty if unknown. */
+  bool VerifyObjectData(const pbrpc::ObjectData& object_data,
+                        const char* data,
+                        int data_length,
+                        int object_no,
+                        const std::string& osd_uuid);
+
+  /** Hands a new file size of a successful write "response" to the FileInfo
+   *  and frees the buffers of "response" (but not "response" itself). */
+  void ProcessWriteResponse(rpc::SyncCallbackBase* response);
+
+  /** Hands a new file size of "write_response" to the FileInfo.
+   *
+   * @return True if the ownership of "write_response" was transferred.
+   */
+  bool UpdateOSDWriteResponse(pbrpc::OSDWriteResponse* write_response);
+
+  /** Returns the UUID of the OSD to which the request of an object with the
+   *  given "osd_offsets" is sent first. */
+  std::string GetFirstOSDUUID(
+      const pbrpc::XLocSet& xlocs,
+      const std::vector<size_t>& osd_offsets);
+
+  /** Resolves "osd_uuid" without retrying. Returns false if it's unknown. */
+  bool TryToResolveOSDUUID(OSDEndpointTable* osd_endpoints,
+                           const std::string& osd_uuid,
+                           std::string* osd_address);
+
+  /** Remembers the OSD at "osd_offsets" as the last used OSD.
+   *  GetLastOSDAddress() resolves it only when it is called. */
+  void SetLastOSD(bool striped, const std::vector<size_t>& osd_offsets);
+
+  /** Waits until all ReadAsync() and WriteAsync() operations were completed.
+   */
+  void WaitForAsyncIO();
+
+  /** Invalidates the cached data of a completed write and executes the
+   *  callback of "operation" with its result or "error". Exceptions thrown by
+   *  the callback are logged. */
+  void FinishAsyncIO(AsyncIOOperation* operation,
+                     const XtreemFSException* error);
+
+  /** Acutal implementation of TruncatePhaseTwoAndThree(). */
+  void DoTruncatePhaseTwoAndThree(int64_t new_file_size);
+
+  /** Actual implementation of AcquireLock(). */
+  xtreemfs::pbrpc::Lock* DoAcquireLock(
+      int process_id,
+      uint64_t offset,
+      uint64_t length,
+      bool exclusive,
+      bool wait_for_lock);
+
+  /** Sends "lock_request" to the OSD and returns the acquired lock.
+   *
+   * @remark Ownership of the return value is transferred to the caller. */
+  xtreemfs::pbrpc::Lock* AcquireLockAtOSD(
+      xtreemfs::pbrpc::lockRequest* lock_request,
+      const RPCOptions& options);
+
+  /** Actual implementation of CheckLock(). */
+  xtreemfs::pbrpc::Lock* DoCheckLock(
+      int process_id,
+      uint64_t offset,
+      uint64_t length,
+      bool exclusive);
+
+  /** Actual implementation of ReleaseLock(). */
+  void DoReleaseLock(const pbrpc::Lock& lock);
+
+  /** Actual implementation of PingReplica(). */
+  void DoPingReplica(const std::string& osd_uuid);
+
+  /** Any modification to the object must obtain a lock first. */
+  boost::mutex mutex_;
+
+  /** Reference to Client which did open this volume. */
+  ClientImplementation* client_;
+
+  /** UUID of the Client (needed to distinguish Locks of different clients). */
+  const std::string& client_uuid_;
+
+  /** UUIDIterator of the MRC. */
+  UUIDIterator* mrc_uuid_iterator_;
+
+  /** UUIDIterator which contains the UUIDs of all replicas. */
+  UUIDIterator* osd_uuid_iterator_;
+
+  /** Needed to resolve UUIDs. */
+  UUIDResolver* uuid_resolver_;
+
+  /** Multiple FileHandle may refer to the same File and therefore unique file
+   * properties (e.g. Path, FileId, XlocSet) are stored in a FileInfo object. */
+  FileInfo* file_info_;
+
+  // TODO(mberlin): Add flags member.
+
+  /** Contains a file size update which has to be written back (or NULL). */
+  boost::scoped_ptr<pbrpc::OSDWriteResponse>
+      osd_write_response_for_async_write_back_;
+
+  /** Pointer to object owned by VolumeImplemention */
+  pbrpc::MRCServiceClient* mrc_service_client_;
+
+  /** Pointer to object owned by VolumeImplemention */
+  SplicingOSDServiceClient* osd_service_client_;
+
+  const std::map<pbrpc::StripingPolicyType,
+                 StripeTranslator*>& stripe_translators_;
+
+  /** Set to true if async writes (max requests > 0, no O_SYNC) are enabled. */
+  const bool async_writes_enabled_;
+
+  /** Throttles reads and writes if QoS limits are set (otherwise NULL).
+   *  Owned by VolumeImplementation. */
+  IOThrottle* io_throttle_;
+
+  /** Key of this handle in io_throttle_. */
+  std::string qos_key_;
+
+  /** Set to true if an async write of this file_handle failed. If true, this
+   *  file_handle is broken and no further writes/reads/truncates are possible.
+   */
+  bool async_writes_failed_;
+
+  const Options& volume_options_;
+
+  /** Auth needed for ServiceClients. Always set to AUTH_NONE by Volume. */
+  const pbrpc::Auth& auth_bogus_;
+
+  /** For same reason needed as auth_bogus_. Always set to user "xtreemfs". */
+  const pbrpc::UserCredentials& user_credentials_bogus_;
+
+  XCapManager xcap_manager_;
+
+  /** Last result of GetFileCredentialsSnapshot(). Never modified after it
+   *  was published, only replaced with boost::atomic_store(). */
+  boost::shared_ptr<const FileCredentialsSnapshot> file_credentials_snapshot_;
+
+  /** Protects pending_async_io_. */
+  boost::mutex pending_async_io_mutex_;
+
+  /** Number of ReadAsync() and WriteAsync() operations not completed yet. */
+  int pending_async_io_;
+
+  /** Notified when pending_async_io_ dropped to 0. */
+  boost::condition all_async_io_completed_;
+
+  /** Stripe position in the first replica of the OSD that was last used for
+   *  reading or writing, or one of the kLastOSD* constants of
+   *  file_handle_implementation.cpp. */
+  boost::atomic<int> last_osd_position_;
+
+  FRIEND_TEST(VolumeImplementationTestFastPeriodicFileSizeUpdate,
+              WorkingPendingFileSizeUpdates);
+  FRIEND_TEST(VolumeImplementationTest, FileSizeUpdateAfterFlush);
+  FRIEND_TEST(VolumeImplementationTestFastPeriodicFileSizeUpdate,
+              FileSizeUpdateAfterFlushWaitsForPendingUpdates);
+  FRIEND_TEST(VolumeImplementationTestFastPeriodicXCapRenewal,
+              WorkingXCapRenewal);
+  FRIEND_TEST(VolumeImplementationTest, FilesLockingReleaseNonExistantLock);
+  FRIEND_TEST(VolumeImplementationTest, FilesLockingReleaseExistantLock);
+  FRIEND_TEST(VolumeImplementationTest, FilesLockingLastCloseReleasesAllLocks);
+  FRIEND_TEST(VolumeImplementationTest, FilesLockingReleaseLockOfProcess);
+};
+
+}  // namespace xtreemfs
+
+#endif  // CPP_INCLUDE_LIBXTREEMFS_FILE_HANDLE_IMPLEMENTATION_H_
@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2026 by the XtreemFS Authors, see AUTHORS file
+ *
+ * Licensed under the BSD License, see LICENSE file for details.
+ *
+ */
+
+#ifndef CPP_INCLUDE_LIBXTREEMFS_FILE_TASK_QUEUE_H_
+#define CPP_INCLUDE_LIBXTREEMFS_FILE_TASK_QUEUE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/thread/condition.hpp>
+#include <boost/thread/mutex.hpp>
+#include <queue>
+#include <vector>
+
+namespace xtreemfs {
+
+class FileInfo;
+
+/** Deadline ordered queue of the background tasks of open files, i.e. the
+ *  renewal of their XCaps and the write back of dirty file sizes.
+ *
+ *  Instead of periodically scanning all open files, every file schedules its
+ *  next task when it is due. Files without pending work cost nothing.
+ */
+class FileTaskQueue {
+ public:
+  enum TaskType {
+    kXCapRenewal,
+    kFileSizeUpdate
+  };
+
+  struct Task {
+    Task(const boost::posix_time::ptime& deadline,
+         TaskType type,
+         uint64_t file_id,
+         FileInfo* file_info)
+        : deadline(deadline),
+          type(type),
+          file_id(file_id),
+          file_info(file_info) {}
+
+    boost::posix_time::ptime deadline;
+    TaskType type;
+    uint64_t file_id;
+    /** Never dereferenced by the queue: the file may have been closed
+     *  meanwhile. Compare it against the open file table first. */
+    FileInfo* file_info;
+  };
+
+  /** Adds "task" to the queue. */
+  void Push(const Task& task);
+
+  /** Blocks until the deadline of at least one task has passed and moves all
+   *  due tasks, ordered by their deadline, into "due_tasks".
+   *
+   *  @throws boost::thread_interrupted
+   */
+  void WaitForDueTasks(std::vector<Task>* due_tasks);
+
+  /** Returns the number of queued tasks. */
+  size_t size();
+
+  /** Returns the current time as used for the deadlines. */
+  static boost::posix_time::ptime Now();
+
+ private:
+  /** Orders the priority queue by the earliest deadline. */
+  struct LaterDeadline {
+    bool operator()(const Task& a, const Task& b) const {
+      return a.deadline > b.deadline;
+    }
+  };
+
+  /** Protects tasks_. */
+  boost::mutex mutex_;
+
+  /** Signaled if a task was added. */
+  boost::condition task_added_;
+
+  std::priority_queue<Task, std::vector<Task>, LaterDeadline> tasks_;
+};
+
+}  // namespace xtreemfs
+
+#endif  // CPP_INCLUDE_LIBXTREEMFS_FILE_TASK_QUEUE_H_
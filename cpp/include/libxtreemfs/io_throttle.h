@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2026 by the XtreemFS Authors, see AUTHORS file
+ *
+ * Licensed under the BSD License, see LICENSE file for details.
+ *
+ */
+
+#ifndef CPP_INCLUDE_LIBXTREEMFS_IO_THROTTLE_H_
+#define CPP_INCLUDE_LIBXTREEMFS_IO_THROTTLE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/thread/mutex.hpp>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace xtreemfs {
+
+/** Statistics of the reads and writes of one key of an IOThrottle. */
+struct QoSCounters {
+  QoSCounters()
+      : weight(0),
+        operations(0),
+        bytes(0),
+        delayed_operations(0),
+        delay_ms(0) {}
+
+  int weight;
+  uint64_t operations;
+  uint64_t bytes;
+  /** Number of operations which had to wait for tokens. */
+  uint64_t delayed_operations;
+  /** Total time the operations waited for tokens. */
+  uint64_t delay_ms;
+};
+
+/** Limits the bandwidth and the number of operations per second of reads and
+ *  writes with one token bucket per key (e.g. per user).
+ *
+ *  The limits apply to all keys together and are shared by the keys which
+ *  were active during the last second in proportion to their weights. A key
+ *  which is active alone gets the full limits.
+ *
+ *  An operation is admitted as long as its bucket is not in debt, so the size
+ *  of a single operation is not bounded by the bucket size. The debt delays
+ *  the next operations of the same key.
+ */
+class IOThrottle {
+ public:
+  /** @param max_bytes_per_s       Bandwidth of all keys, 0 for unlimited.
+   *  @param max_operations_per_s  Operations of all keys, 0 for unlimited.
+   *  @param weights               Entries "key=weight" (see ParseWeight()).
+   *                               Keys without an entry have the weight 1.
+   */
+  IOThrottle(int64_t max_bytes_per_s,
+             int64_t max_operations_per_s,
+             const std::vector<std::string>& weights);
+
+  /** Blocks until "key" may execute one operation of "bytes".
+   *
+   *  @throws boost::thread_interrupted
+   */
+  void Acquire(const std::string& key, size_t bytes);
+
+  /** Returns the counters of all keys which were active during the last ten
+   *  minutes. Keys idle for longer are forgotten. */
+  void GetCounters(std::map<std::string, QoSCounters>* counters);
+
+  /** Parses "key=weight" with a weight greater 0. Returns false if "spec" is
+   *  malformed. */
+  static bool ParseWeight(const std::string& spec,
+                          std::string* key,
+                          int* weight);
+
+ private:
+  /** Token bucket and counters of a key. */
+  struct Bucket {
+    Bucket() : bytes(0), operations(0) {}
+
+    /** Available tokens, negative if in debt. */
+    double bytes;
+    double operations;
+    boost::posix_time::ptime last_refill;
+    boost::posix_time::ptime last_active;
+    QoSCounters counters;
+  };
+
+  /** Returns the weight of "key". Keys of the form "<user>:<suffix>" inherit
+   *  the weight of "<user>". */
+  int GetWeight(const std::string& key) const;
+
+  /** Adds the tokens "bucket" earned since its last refill with the fraction
+   *  "share" of the limits.
+   *
+   *  @remark   Requires a lock on mutex_.
+   */
+  void RefillUnmutexed(const boost::posix_time::ptime& now,
+                       double share,
+                       Bucket* bucket);
+
+  /** Sums the weights of the keys active during the last second and removes
+   *  idle keys.
+   *
+   *  @remark   Requires a lock on mutex_.
+   */
+  int GetActiveWeightUnmutexed(const boost::posix_time::ptime& now);
+
+  const int64_t max_bytes_per_s_;
+
+  const int64_t max_operations_per_s_;
+
+  /** Key -> weight as configured. */
+  std::map<std::string, int> weights_;
+
+  /** Protects buckets_. */
+  boost::mutex mutex_;
+
+  std::map<std::string, Bucket> buckets_;
+};
+
+}  // namespace xtreemfs
+
+#endif  // CPP_INCLUDE_LIBXTREEMFS_IO_THROTTLE_H_
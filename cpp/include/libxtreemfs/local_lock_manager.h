@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2026 by the XtreemFS Authors, see AUTHORS file
+ *
+ * Licensed under the BSD License, see LICENSE file for details.
+ *
+ */
+
+#ifndef CPP_INCLUDE_LIBXTREEMFS_LOCAL_LOCK_MANAGER_H_
+#define CPP_INCLUDE_LIBXTREEMFS_LOCAL_LOCK_MANAGER_H_
+
+#include <stddef.h>
+
+#include <boost/thread/condition.hpp>
+#include <boost/thread/mutex.hpp>
+#include <list>
+#include <map>
+
+#include "libxtreemfs/interrupt.h"
+#include "xtreemfs/OSD.pb.h"
+
+namespace xtreemfs {
+
+/** Manages the advisory locks of the local processes for one file.
+ *
+ *  Conflicts between local processes are resolved here without contacting the
+ *  OSD. Processes waiting for a conflicting local lock are woken up as soon as
+ *  it is released.
+ *
+ *  Every granted lock is held at the OSD under the PID of its process, i.e.
+ *  the client holds one OSD lock per locked range. The OSD allows only one
+ *  lock per (client UUID, PID) tuple and so does this class: a new lock of a
+ *  process replaces its current one.
+ *
+ *  Requests to the OSD are carried out by the caller: if a method returns
+ *  kAcquireAtOSD or kReleaseAtOSD, the caller has to send the request to the
+ *  OSD and report the result with FinishAcquire() or FinishRelease(). Until
+ *  then, the lock is treated as active by the other processes and further
+ *  requests of the same process are blocked.
+ */
+class LocalLockManager {
+ public:
+  enum AcquireResult {
+    /** The lock conflicts with the lock of another local process. */
+    kConflict,
+    /** The process already holds this lock. */
+    kAcquiredLocally,
+    /** The lock has to be acquired at the OSD. */
+    kAcquireAtOSD
+  };
+
+  enum ReleaseResult {
+    /** The process does not hold a lock. */
+    kNoLockFound,
+    /** The lock of the process has to be released at the OSD. */
+    kReleaseAtOSD
+  };
+
+  LocalLockManager();
+
+  /** Compares "lock" against list of active locks.
+   *
+   *  Sets conflict_found to true and copies the conflicting, active lock into
+   *  "conflicting_lock".
+   *  If no conflict was found, "lock_for_pid_cached" is set to true if there
+   *  exists already a lock for lock.client_pid(). Additionally,
+   *  "cached_lock_for_pid_equal" will be set to true, lock is equal to the lock
+   *  active for this pid. */
+  void CheckLock(const xtreemfs::pbrpc::Lock& lock,
+                 xtreemfs::pbrpc::Lock* conflicting_lock,
+                 bool* lock_for_pid_cached,
+                 bool* cached_lock_for_pid_equal,
+                 bool* conflict_found);
+
+  /** Returns true if a lock for "process_id" is known. */
+  bool CheckIfProcessHasLocks(int process_id);
+
+  /** Copies the lock of "process_id" into "lock" and returns false if there
+   *  is none. */
+  bool GetLockOfProcess(int process_id, xtreemfs::pbrpc::Lock* lock);
+
+  /** Appends a copy of every local lock to "locks". */
+  void GetLocks(std::list<xtreemfs::pbrpc::Lock>* locks);
+
+  /** Tries to acquire "lock" for lock.client_pid().
+   *
+   *  If "lock" conflicts with the lock of another local process, the call
+   *  returns kConflict and copies the conflicting lock into
+   *  "conflicting_lock" unless "wait_for_lock" is true. In that case, the
+   *  call blocks until the conflicting lock was released.
+   *
+   *  If the process already holds "lock", it is granted right away.
+   *  Otherwise, kAcquireAtOSD is returned.
+   *
+   * @throws PosixErrorException  If the wait was interrupted.
+   */
+  AcquireResult AcquireLock(const xtreemfs::pbrpc::Lock& lock,
+                            bool wait_for_lock,
+                            InterruptedCallback was_interrupted_cb,
+                            xtreemfs::pbrpc::Lock* conflicting_lock);
+
+  /** Completes an AcquireLock() which returned kAcquireAtOSD. If "success" is
+   *  true, "lock" replaces the current lock of lock.client_pid(). */
+  void FinishAcquire(const xtreemfs::pbrpc::Lock& lock, bool success);
+
+  /** Copies the lock of "process_id" into "lock" and returns kReleaseAtOSD.
+   *  The lock remains active until FinishRelease() is called. */
+  ReleaseResult ReleaseLock(int process_id, xtreemfs::pbrpc::Lock* lock);
+
+  /** Completes a ReleaseLock() which returned kReleaseAtOSD. */
+  void FinishRelease(int process_id, bool success);
+
+  /** Returns the number of local locks. */
+  size_t size();
+
+ private:
+  typedef std::map<unsigned int, xtreemfs::pbrpc::Lock> LockMap;
+
+  /** Returns the active or pending lock of another process which conflicts
+   *  with "lock" or NULL. Requires a lock on mutex_. */
+  const xtreemfs::pbrpc::Lock* FindConflictingLockUnmutexed(
+      const xtreemfs::pbrpc::Lock& lock);
+
+  /** Active locks of the local processes. Each of them is held at the OSD. */
+  LockMap active_locks_;
+
+  /** Locks of processes which currently wait for a response of the OSD. */
+  LockMap pending_locks_;
+
+  /** Use this to protect all members. */
+  boost::mutex mutex_;
+
+  /** Notified if a lock was released or an OSD request was completed. */
+  boost::condition locks_changed_;
+};
+
+}  // namespace xtreemfs
+
+#endif  // CPP_INCLUDE_LIBXTREEMFS_LOCAL_LOCK_MANAGER_H_
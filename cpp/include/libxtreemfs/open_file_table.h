@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2026 by the XtreemFS Authors, see AUTHORS file
+ *
+ * Licensed under the BSD License, see LICENSE file for details.
+ *
+ */
+
+#ifndef CPP_INCLUDE_LIBXTREEMFS_OPEN_FILE_TABLE_H_
+#define CPP_INCLUDE_LIBXTREEMFS_OPEN_FILE_TABLE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <boost/function.hpp>
+#include <boost/scoped_array.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/unordered_map.hpp>
+
+namespace xtreemfs {
+
+class FileInfo;
+
+/** Maps the file id of every open file of a Volume to its FileInfo object.
+ *
+ *  The table is split into shards with a mutex each, i.e. concurrent opens
+ *  and closes of different files do not contend for a single lock.
+ *
+ *  A FileInfo is only removed from the table (and then deleted) while the
+ *  mutex of its shard is locked. Therefore, a FileInfo found by
+ *  FindUnmutexed() stays valid as long as the shard remains locked.
+ */
+class OpenFileTable {
+ public:
+  static const size_t kDefaultNumberOfShards = 64;
+
+  explicit OpenFileTable(size_t number_of_shards);
+
+  /** Returns the mutex of the shard of "file_id". Lock it before using any of
+   *  the *Unmutexed() methods for "file_id". */
+  boost::mutex& GetMutex(uint64_t file_id);
+
+  /** Returns the FileInfo of "file_id" or NULL if the file is not open. */
+  FileInfo* FindUnmutexed(uint64_t file_id);
+
+  /** Adds "file_info" for "file_id" which must not be present yet. */
+  void InsertUnmutexed(uint64_t file_id, FileInfo* file_info);
+
+  /** Removes "file_id" and returns false if it was not found. */
+  bool EraseUnmutexed(uint64_t file_id);
+
+  /** Executes "function" for every open file. Only the shard of the current
+   *  file is locked, i.e. files opened or closed meanwhile may be missed. */
+  void ForEach(const boost::function<void(FileInfo*)>& function);
+
+  /** Returns the number of open files. */
+  size_t size();
+
+ private:
+  struct Shard {
+    boost::mutex mutex;
+    boost::unordered_map<uint64_t, FileInfo*> files;
+  };
+
+  Shard& GetShard(uint64_t file_id) {
+    return shards_[file_id % number_of_shards_];
+  }
+
+  const size_t number_of_shards_;
+
+  boost::scoped_array<Shard> shards_;
+};
+
+}  // namespace xtreemfs
+
+#endif  // CPP_INCLUDE_LIBXTREEMFS_OPEN_FILE_TABLE_H_
@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2026 by the XtreemFS Authors, see AUTHORS file
+ *
+ * Licensed under the BSD License, see LICENSE file for details.
+ *
+ */
+
+#ifndef CPP_INCLUDE_LIBXTREEMFS_OSD_ENDPOINT_TABLE_H_
+#define CPP_INCLUDE_LIBXTREEMFS_OSD_ENDPOINT_TABLE_H_
+
+#include <time.h>
+
+#include <boost/atomic.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/unordered_map.hpp>
+#include <string>
+#include <vector>
+
+#include "libxtreemfs/uuid_resolver.h"
+
+namespace xtreemfs {
+
+namespace pbrpc {
+class XLocSet;
+}  // namespace pbrpc
+
+/** Addresses of the OSDs of one XLocSet, indexed by replica and stripe
+ *  position.
+ *
+ *  The table is created by FileInfo whenever a new XLocSet is installed.
+ *  Every OSD is resolved by "uuid_resolver" on its first use only; later
+ *  lookups neither acquire a mutex nor build the address string again. The
+ *  addresses are resolved again every "address_refresh_interval_s" seconds to
+ *  pick up changed address mappings. Only one lookup per interval does so,
+ *  successful or not; concurrent lookups keep using the previous address.
+ *
+ *  As UUIDResolver, the table answers the OSDs of its XLocSet and passes all
+ *  other requests, e.g. for redirect targets, to "uuid_resolver".
+ */
+class OSDEndpointTable : public UUIDResolver {
+ public:
+  /** "uuid_resolver" has to outlive the table. Ownership is NOT
+   *  transferred. */
+  OSDEndpointTable(const pbrpc::XLocSet& xlocs,
+                   UUIDResolver* uuid_resolver,
+                   time_t address_refresh_interval_s = 60);
+
+  virtual ~OSDEndpointTable();
+
+  int replica_count() const {
+    return static_cast<int>(replicas_.size());
+  }
+
+  int osd_count(int replica) const {
+    return static_cast<int>(replicas_[replica].size());
+  }
+
+  /** Returns the UUID of the OSD at "position" of "replica". */
+  const std::string& GetUUID(int replica, int position) const;
+
+  /** Resolves the OSD at "position" of "replica".
+   *
+   * @throws AddressToUUIDNotFoundException
+   * @throws UnknownAddressSchemeException
+   */
+  void GetAddress(int replica,
+                  int position,
+                  std::string* address,
+                  const RPCOptions& options);
+
+  virtual void UUIDToAddress(const std::string& uuid, std::string* address);
+
+  virtual void UUIDToAddressWithOptions(const std::string& uuid,
+                                        std::string* address,
+                                        const RPCOptions& options);
+
+  virtual void VolumeNameToMRCUUID(const std::string& volume_name,
+                                   std::string* mrc_uuid);
+
+  virtual void VolumeNameToMRCUUID(const std::string& volume_name,
+                                   SimpleUUIDIterator* uuid_iterator);
+
+  virtual std::vector<std::string> VolumeNameToMRCUUIDs(
+      const std::string& volume_name);
+
+ private:
+  struct Endpoint {
+    explicit Endpoint(const std::string& uuid)
+        : uuid(uuid), address(NULL), resolve_attempted_at_s(0) {}
+
+    const std::string uuid;
+    /** NULL until resolved. Published strings are not modified or freed
+     *  before the table is destroyed. */
+    boost::atomic<const std::string*> address;
+    /** Time of the last successful or failed attempt to refresh "address". */
+    boost::atomic<time_t> resolve_attempted_at_s;
+  };
+
+  typedef boost::unordered_map<std::string, Endpoint*> EndpointMap;
+
+  /** Copies the address of "endpoint" to "address" and resolves it first if
+   *  required. "options" may be NULL to use the defaults of uuid_resolver_. */
+  void GetAddress(Endpoint* endpoint,
+                  std::string* address,
+                  const RPCOptions* options);
+
+  /** Resolves "endpoint" and publishes its new address. */
+  void Resolve(Endpoint* endpoint, const RPCOptions* options);
+
+  UUIDResolver* uuid_resolver_;
+
+  const time_t address_refresh_interval_s_;
+
+  /** Endpoints per replica and stripe position. An OSD used by several
+   *  positions has only one Endpoint. */
+  std::vector<std::vector<Endpoint*> > replicas_;
+
+  /** Endpoints by UUID, owns the Endpoint objects. Not modified after the
+   *  construction. */
+  EndpointMap endpoints_;
+
+  /** Protects the publication of resolved addresses and retired_addresses_.
+   *  The resolution itself is done without holding it. */
+  boost::mutex resolve_mutex_;
+
+  /** Addresses which were replaced but may still be read concurrently. */
+  std::vector<const std::string*> retired_addresses_;
+};
+
+}  // namespace xtreemfs
+
+#endif  // CPP_INCLUDE_LIBXTREEMFS_OSD_ENDPOINT_TABLE_H_
@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2026 by the XtreemFS Authors, see AUTHORS file
+ *
+ * Licensed under the BSD License, see LICENSE file for details.
+ *
+ */
+
+#ifndef CPP_INCLUDE_LIBXTREEMFS_OSD_HEALTH_REGISTRY_H_
+#define CPP_INCLUDE_LIBXTREEMFS_OSD_HEALTH_REGISTRY_H_
+
+#include <stdint.h>
+
+#include <boost/scoped_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "libxtreemfs/options.h"
+#include "pbrpc/RPC.pb.h"
+
+namespace xtreemfs {
+
+namespace pbrpc {
+class OSDServiceClient;
+}  // namespace pbrpc
+
+namespace rpc {
+class Client;
+}  // namespace rpc
+
+class UUIDResolver;
+
+/** Client-wide bookkeeping of the health of OSDs, keyed by their UUID.
+ *
+ *  Every UUIDIterator which addresses OSDs references the registry of its
+ *  Client. ExecuteSyncRequest() and the AsyncWriteHandler report the outcome
+ *  of requests to it. After "osd_health_failure_threshold" consecutive
+ *  communication errors an OSD is considered dead and all iterators skip it
+ *  immediately if another replica is available.
+ *
+ *  Dead OSDs are probed in the background with xtreemfs_ping. Once
+ *  "osd_health_readmit_probes" probes in a row succeeded (or any regular
+ *  request did succeed), the OSD is re-admitted.
+ */
+class OSDHealthRegistry {
+ public:
+  /**
+   * @remarks   Ownership is not transferred.
+   */
+  OSDHealthRegistry(UUIDResolver* uuid_resolver, const Options& options);
+
+  ~OSDHealthRegistry();
+
+  void Initialize(rpc::Client* network_client);
+
+  /** Probes all dead OSDs periodically. Runs until interrupted. */
+  void Run();
+
+  /** Records a communication error (IO_ERROR, INTERNAL_SERVER_ERROR) for
+   *  "uuid". */
+  void ReportFailure(const std::string& uuid);
+
+  /** Records a successful request and re-admits "uuid" if it was dead. */
+  void ReportSuccess(const std::string& uuid);
+
+  /** Returns true if "uuid" is currently considered dead.
+   *
+   *  @remark Does not lock the registry if no OSD is dead at all.
+   */
+  bool IsDead(const std::string& uuid);
+
+  /** Returns the UUIDs of all currently dead OSDs. */
+  void GetDeadOSDs(std::vector<std::string>* dead_osds);
+
+ private:
+  struct OSDHealth {
+    OSDHealth() : consecutive_failures(0), successful_probes(0), dead(false) {}
+
+    /** Number of failed requests since the last successful one. */
+    int consecutive_failures;
+    /** Number of successful probes in a row since the OSD was marked dead. */
+    int successful_probes;
+    bool dead;
+  };
+
+  /** Sends a single xtreemfs_ping to "uuid" and returns true on success. */
+  bool Probe(const std::string& uuid);
+
+  /** Re-admits "uuid". Assumes that mutex_ is locked. */
+  void MarkAsAliveUnmutexed(const std::string& uuid, OSDHealth* health);
+
+  UUIDResolver* uuid_resolver_;
+
+  boost::scoped_ptr<pbrpc::OSDServiceClient> osd_service_client_;
+
+  /** Shallow copy of the Client's options, with disabled retry and interrupt
+   *  functionality. */
+  Options probe_options_;
+
+  const int failure_threshold_;
+
+  const int readmit_probes_;
+
+  const int probe_interval_s_;
+
+  pbrpc::Auth auth_bogus_;
+
+  pbrpc::UserCredentials user_credentials_bogus_;
+
+  /** Protects health_. */
+  boost::mutex mutex_;
+
+  std::map<std::string, OSDHealth> health_;
+
+  /** Number of entries in health_. Read without mutex_ by ReportSuccess(). */
+  uint32_t reported_osds_count_;
+
+  /** Number of dead OSDs in health_. Read without mutex_ by IsDead(). */
+  uint32_t dead_osds_count_;
+};
+
+}  // namespace xtreemfs
+
+#endif  // CPP_INCLUDE_LIBXTREEMFS_OSD_HEALTH_REGISTRY_H_
@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2026 by the XtreemFS Authors, see AUTHORS file
+ *
+ * Licensed under the BSD License, see LICENSE file for details.
+ *
+ */
+
+#ifndef CPP_INCLUDE_LIBXTREEMFS_SPLICING_OSD_SERVICE_CLIENT_H_
+#define CPP_INCLUDE_LIBXTREEMFS_SPLICING_OSD_SERVICE_CLIENT_H_
+
+#include <stdint.h>
+
+#include <string>
+
+#include "rpc/callback_interface.h"
+#include "rpc/sync_callback.h"
+#include "xtreemfs/OSDServiceClient.h"
+
+namespace xtreemfs {
+
+namespace rpc {
+class Client;
+}  // namespace rpc
+
+/** OSDServiceClient which additionally sends reads and writes whose
+ *  FileCredentials were serialized in advance.
+ *
+ *  "request" must not contain file_credentials. Instead,
+ *  "serialized_file_credentials" (see FileCredentialsSnapshot) is sent in
+ *  front of it. The bytes on the wire are the same as if the FileCredentials
+ *  were copied into the request. */
+class SplicingOSDServiceClient : public pbrpc::OSDServiceClient {
+ public:
+  explicit SplicingOSDServiceClient(rpc::Client* client);
+
+  virtual ~SplicingOSDServiceClient();
+
+  void read_with_credentials(
+      const std::string& address,
+      const pbrpc::Auth& auth,
+      const pbrpc::UserCredentials& creds,
+      const std::string& serialized_file_credentials,
+      const pbrpc::readRequest* request,
+      rpc::CallbackInterface<pbrpc::ObjectData>* callback,
+      void* context = NULL);
+
+  rpc::SyncCallback<pbrpc::ObjectData>* read_with_credentials_sync(
+      const std::string& address,
+      const pbrpc::Auth& auth,
+      const pbrpc::UserCredentials& creds,
+      const std::string& serialized_file_credentials,
+      const pbrpc::readRequest* request);
+
+  void write_with_credentials(
+      const std::string& address,
+      const pbrpc::Auth& auth,
+      const pbrpc::UserCredentials& creds,
+      const std::string& serialized_file_credentials,
+      const pbrpc::writeRequest* request,
+      const char* data,
+      uint32_t data_length,
+      rpc::CallbackInterface<pbrpc::OSDWriteResponse>* callback,
+      void* context = NULL);
+
+  rpc::SyncCallback<pbrpc::OSDWriteResponse>* write_with_credentials_sync(
+      const std::string& address,
+      const pbrpc::Auth& auth,
+      const pbrpc::UserCredentials& creds,
+      const std::string& serialized_file_credentials,
+      const pbrpc::writeRequest* request,
+      const char* data,
+      uint32_t data_length);
+
+ private:
+  /** Not owned by this object. */
+  rpc::Client* client_;
+};
+
+}  // namespace xtreemfs
+
+#endif  // CPP_INCLUDE_LIBXTREEMFS_SPLICING_OSD_SERVICE_CLIENT_H_
@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2009-2011 by Patrick Schaefer, Zuse Institute Berlin
+ *
+ * Licensed under the BSD License, see LICENSE file for details.
+ *
+ */
+#ifndef CPP_INCLUDE_LIBXTREEMFS_UUID_CACHE_H_
+#define CPP_INCLUDE_LIBXTREEMFS_UUID_CACHE_H_
+
+#include <stdint.h>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/unordered_map.hpp>
+
+#include <string>
+#include <vector>
+
+namespace xtreemfs {
+
+/** Caches the address of service UUIDs until their TTL expires.
+ *
+ *  The cache is read much more often than it is updated. Therefore lookups
+ *  work on an immutable snapshot of all mappings and do not acquire a mutex.
+ *  Updates copy the current snapshot and replace it.
+ */
+class UUIDCache {
+ public:
+  struct UUIDMapping {
+    std::string uuid;
+    std::string address;
+    uint32_t port;
+    /** Absolute time in seconds after which the mapping is expired. */
+    time_t timeout;
+  };
+
+  UUIDCache();
+
+  void update(const std::string& uuid, const std::string& address,
+      const uint32_t port, const time_t timeout);
+
+  /** Adds or replaces all "mappings" at once, e.g. after a bulk request. The
+   *  timeouts of the mappings have to be absolute times. */
+  void Update(const std::vector<UUIDMapping>& mappings);
+
+  /** Returns "address:port" of "uuid" or an empty string if "uuid" is not
+   *  cached or expired. */
+  std::string get(const std::string& uuid);
+
+  /** Appends all mappings which have not expired yet to "mappings". */
+  void GetMappings(std::vector<UUIDMapping>* mappings);
+
+  /** Adds "mapping" with its absolute timeout, e.g. from a warm start
+   *  snapshot. Expired mappings and cached UUIDs are ignored. */
+  void Restore(const UUIDMapping& mapping);
+
+ private:
+  struct CachedMapping {
+    UUIDMapping mapping;
+    /** Precomputed "address:port". */
+    std::string address_and_port;
+  };
+
+  typedef boost::unordered_map<std::string, CachedMapping> MappingMap;
+
+  /** Returns a copy of the current mappings without the expired ones.
+   *  Requires a lock on update_mutex_. */
+  boost::shared_ptr<MappingMap> CopyMappingsUnmutexed(time_t now);
+
+  /** Adds "mapping" to "mappings" and computes its "address:port". */
+  static void AddMapping(const UUIDMapping& mapping, MappingMap* mappings);
+
+  /** Current snapshot. Never modified after it was published, only replaced
+   *  with boost::atomic_store(). */
+  boost::shared_ptr<const MappingMap> mappings_;
+
+  /** Serializes the updates of mappings_. */
+  boost::mutex update_mutex_;
+};
+
+}  // namespace xtreemfs
+
+#endif  // CPP_INCLUDE_LIBXTREEMFS_UUID_CACHE_H_
@@ -0,0 +1,672 @@
+/*
+ * Copyright (c) 2011 by Michael Berlin, Zuse Institute Berlin
+ *
+ * Licensed under the BSD License, see LICENSE file for details.
+ *
+ */
+
+#ifndef CPP_INCLUDE_LIBXTREEMFS_VOLUME_IMPLEMENTATION_H_
+#define CPP_INCLUDE_LIBXTREEMFS_VOLUME_IMPLEMENTATION_H_
+
+#include "libxtreemfs/volume.h"
+
+#include <stdint.h>
+
+#include <boost/function.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <boost/thread/condition.hpp>
+#include <boost/thread/mutex.hpp>
+#include <gtest/gtest_prod.h>
+#include <list>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "libxtreemfs/execute_sync_request.h"
+#include "libxtreemfs/file_task_queue.h"
+#include "libxtreemfs/metadata_cache.h"
+#include "libxtreemfs/open_file_table.h"
+#include "libxtreemfs/options.h"
+#include "libxtreemfs/uuid_iterator.h"
+#include "rpc/sync_callback.h"
+
+namespace boost {
+class thread;
+}  // namespace boost
+
+namespace xtreemfs {
+
+namespace pbrpc {
+class MRCServiceClient;
+class OSDServiceClient;
+}  // namespace pbrpc
+
+namespace rpc {
+class Client;
+class SSLOptions;
+}  // namespace rpc
+
+class AsyncWriteBudget;
+class ClientImplementation;
+class FileHandleImplementation;
+class FileInfo;
+class IOThrottle;
+class SplicingOSDServiceClient;
+class StripeTranslator;
+class UUIDResolver;
+
+/**
+ * Default implementation of an XtreemFS volume.
+ */
+class VolumeImplementation : public Volume {
+ public:
+  /**
+   * @remark Ownership of mrc_uuid_iterator is transferred to this object.
+   */
+  VolumeImplementation(
+      ClientImplementation* client,
+      const std::string& client_uuid,
+      UUIDIterator* mrc_uuid_iterator,
+      const std::string& volume_name,
+      const xtreemfs::rpc::SSLOptions* ssl_options,
+      const Options& options);
+  virtual ~VolumeImplementation();
+
+  virtual void Close();
+
+  virtual xtreemfs::pbrpc::StatVFS* StatFS(
+      const xtreemfs::pbrpc::UserCredentials& user_credentials);
+
+  virtual void ReadLink(
+      const xtreemfs::pbrpc::UserCredentials& user_credentials,
+      const std::string& path,
+      std::string* link_target_path);
+
+  virtual void Symlink(
+      const xtreemfs::pbrpc::UserCredentials& user_credentials,
+      const std::string& target_path,
+      const std::string& link_path);
+
+  virtual void Link(
+      const xtreemfs::pbrpc::UserCredentials& user_credentials,
+      const std::string& target_path,
+      const std::string& link_path);
+
+  virtual void Access(
+      const xtreemfs::pbrpc::UserCredentials& user_credentials,
+      const std::string& path,
+      const xtreemfs::pbrpc::ACCESS_FLAGS flags);
+
+  virtual FileHandle* OpenFile(
+      const xtreemfs::pbrpc::UserCredentials& user_credentials,
+      const std::string& path,
+      const xtreemfs::pbrpc::SYSTEM_V_FCNTL flags);
+
+  virtual FileHandle* OpenFile(
+      const xtreemfs::pbrpc::UserCredentials& user_credentials,
+      const std::string& path,
+      const xtreemfs::pbrpc::SYSTEM_V_FCNTL flags,
+      uint32_t mode);
+
+  virtual FileHandle* OpenFile(
+      const xtreemfs::pbrpc::UserCredentials& user_credentials,
+      const std::string& path,
+      const xtreemfs::pbrpc::SYSTEM_V_FCNTL flags,
+      uint32_t mode,
+      uint32_t attributes);
+
+  /** Used by Volume->Truncate(). Otherwise truncate_new_file_size = 0. */
+  FileHandle* OpenFileWithTruncateSize(
+      const xtreemfs::pbrpc::UserCredentials& user_credentials,
+      const std::string& path,
+      const xtreemfs::pbrpc::SYSTEM_V_FCNTL flags,
+      uint32_t mode,
+      uint32_t attributes,
+      int truncate_new_file_size);
+
+  virtual void Truncate(
+      const xtreemfs::pbrpc::UserCredentials& user_credentials,
+      const std::string& path,
+      off_t new_file_size);
+
+  virtual void GetAttr(
+      const xtreemfs::pbrpc::UserCredentials& user_credentials,
+      const std::string& path,
+      xtreemfs::pbrpc::Stat* stat);
+
+  virtual void GetAttr(
+      const xtreemfs::pbrpc::UserCredentials& user_credentials,
+      const std::string& path,
+      bool ignore_metadata_cache,
+      xtreemfs::pbrpc::Stat* stat);
+
+  /** If file_info is unknown and set to NULL, GetFileInfo(path) is used. */
+  void GetAttr(
+      const xtreemfs::pbrpc::UserCredentials& user_credentials,
+      const std::string& path,
+      bool ignore_metadata_cache,
+      xtreemfs::pbrpc::Stat* stat_buffer,
+      FileInfo* file_info);
+
+  virtual void SetAttr(
+      const xtreemfs::pbrpc::UserCredentials& user_credentials,
+      const std::string& path,
+      const xtreemfs::pbrpc::Stat& stat,
+      xtreemfs::pbrpc::Setattrs to_set);
+
+  virtual void Unlink(
+      const xtreemfs::pbrpc::UserCredentials& user_credentials,
+      const std::string& path);
+
+  /** Issue an unlink at the head OSD of every replica given in fc.xlocs(). */
+  void UnlinkAtOSD(
+      const xtreemfs::pbrpc::FileCredentials& fc, const std::string& path);
+
+  virtual void Rename(
+      const xtreemfs::pbrpc::UserCredentials& user_credentials,
+      const std::string& path,
+      const std::string& new_path);
+
+  virtual void MakeDirectory(
+      const xtreemfs::pbrpc::UserCredentials& user_credentials,
+      const std::string& path,
+      unsigned int mode);
+
+  virtual void DeleteDirectory(
+        const xtreemfs::pbrpc::UserCredentials& user_credentials,
+        const std::string& path);
+
+  virtual void GetAttrs(
+      const xtreemfs::pbrpc::UserCredentials& user_credentials,
+      const std::vector<std::string>& paths,
+      std::vector<xtreemfs::pbrpc::Stat>* stats,
+      std::vector<xtreemfs::pbrpc::POSIXErrno>* errors);
+
+  virtual void OpenFiles(
+      const xtreemfs::pbrpc::UserCredentials& user_credentials,
+      const std::vector<std::string>& paths,
+      const xtreemfs::pbrpc::SYSTEM_V_FCNTL flags,
+      uint32_t mode,
+      std::vector<FileHandle*>* file_handles,
+      std::vector<xtreemfs::pbrpc::POSIXErrno>* errors);
+
+  virtual void UnlinkFiles(
+      const xtreemfs::pbrpc::UserCredentials& user_credentials,
+      const std::vector<std::string>& paths,
+      std::vector<xtreemfs::pbrpc::POSIXErrno>* errors);
+
+  virtual void MakeDirectories(
+      const xtreemfs::pbrpc::UserCredentials& user_credentials,
+      const std::vector<std::string>& paths,
+      unsigned int mode,
+      std::vector<xtreemfs::pbrpc::POSIXErrno>* errors);
+
+  virtual xtreemfs::pbrpc::DirectoryEntries* ReadDir(
+      const xtreemfs::pbrpc::UserCredentials& user_credentials,
+      const std::string& path,
+      uint64_t offset,
+      uint32_t count,
+      bool names_only);
+
+  virtual xtreemfs::pbrpc::listxattrResponse* ListXAttrs(
+      const xtreemfs::pbrpc::UserCredentials& user_credentials,
+      const std::string& path);
+
+  virtual xtreemfs::pbrpc::listxattrResponse* ListXAttrs(
+      const xtreemfs::pbrpc::UserCredentials& user_credentials,
+      const std::string& path,
+      bool use_cache);
+
+  virtual void SetXAttr(
+      const xtreemfs::pbrpc::UserCredentials& user_credentials,
+      const std::string& path,
+      const std::string& name,
+      const std::string& value,
+      xtreemfs::pbrpc::XATTR_FLAGS flags);
+
+  virtual bool GetXAttr(
+      const xtreemfs::pbrpc::UserCredentials& user_credentials,
+      const std::string& path,
+      const std::string& name,
+      std::string* value);
+
+  virtual bool GetXAttrSize(
+      const xtreemfs::pbrpc::UserCredentials& user_credentials,
+      const std::string& path,
+      const std::string& name,
+      int* size);
+
+  virtual void RemoveXAttr(
+      const xtreemfs::pbrpc::UserCredentials& user_credentials,
+      const std::string& path,
+      const std::string& name);
+
+  virtual void AddReplica(
+      const xtreemfs::pbrpc::UserCredentials& user_credentials,
+      const std::string& path,
+      const xtreemfs::pbrpc::Replica& new_replica);
+
+  virtual xtreemfs::pbrpc::Replicas* ListReplicas(
+      const xtreemfs::pbrpc::UserCredentials& user_credentials,
+      const std::string& path);
+
+  void GetXLocSet(
+      const xtreemfs::pbrpc::UserCredentials& user_credentials,
+      const std::string& file_id,
+      xtreemfs::pbrpc::XLocSet* xlocset);
+
+  virtual void RemoveReplica(
+      const xtreemfs::pbrpc::UserCredentials& user_credentials,
+      const std::string& path,
+      const std::string& osd_uuid);
+
+  virtual void GetSuitableOSDs(
+      const xtreemfs::pbrpc::UserCredentials& user_credentials,
+      const std::string& path,
+      int number_of_osds,
+      std::list<std::string>* list_of_osd_uuids);
+
+  virtual void SetReplicaUpdatePolicy(
+        const xtreemfs::pbrpc::UserCredentials& user_credentials,
+        const std::string& path,
+        const std::string& policy);
+
+  virtual void GetQoSCounters(std::map<std::string, QoSCounters>* counters);
+
+  /** Starts the network client of the volume and its wrappers MRCServiceClient
+   *  and OSDServiceClient. */
+  void Start();
+
+  /** Shuts down threads, called by ClientImplementation::Shutdown(). */
+  void CloseInternal();
+
+  /** Called by FileHandle.Close() to remove file_handle from the list. */
+  void CloseFile(uint64_t file_id,
+                 FileInfo* file_info,
+                 FileHandleImplementation* file_handle);
+
+  /** Called by FileHandle.Close() if write-behind closes are enabled.
+   *  "file_handle" will be closed by deferred_close_thread_.
+   *
+   *  Blocks if Options::write_behind_close_max_pending closes are pending. */
+  void DeferCloseFileHandle(uint64_t file_id,
+                            const std::string& path,
+                            FileHandleImplementation* file_handle);
+
+  /** Called by FileInfo if its file size became dirty: writes it back after
+   *  Options::periodic_file_size_updates_interval_s. */
+  void ScheduleFileSizeUpdate(uint64_t file_id, FileInfo* file_info);
+
+  /** Throws the error of the last failed write-behind close of the file
+   *  "file_id" and forgets it.
+   *
+   * @throws PosixErrorException
+   */
+  void ThrowIfDeferredCloseFailed(uint64_t file_id);
+
+  /** Returns false if no write-behind close of the file "file_id" failed.
+   *  Otherwise, the error is moved to "error". */
+  bool PopDeferredCloseError(uint64_t file_id, std::string* error);
+
+  const std::string& client_uuid() {
+    return client_uuid_;
+  }
+
+  /**
+   * @remark    Ownership is NOT transferred to the caller.
+   */
+  UUIDIterator* mrc_uuid_iterator() {
+    return mrc_uuid_iterator_.get();
+  }
+
+  /**
+   * @remark    Ownership is NOT transferred to the caller.
+   */
+  UUIDResolver* uuid_resolver() {
+    return uuid_resolver_;
+  }
+
+  /**
+   * @remark    Ownership is NOT transferred to the caller.
+   */
+  xtreemfs::pbrpc::MRCServiceClient* mrc_service_client() {
+    return mrc_service_client_.get();
+  }
+
+  /**
+   * @remark    Ownership is NOT transferred to the caller.
+   */
+  SplicingOSDServiceClient* osd_service_client() {
+    return osd_service_client_.get();
+  }
+
+  const Options& volume_options() {
+    return volume_options_;
+  }
+
+  /** Returns the budget shared by the async writes of all files or NULL.
+   *
+   * @remark    Ownership is NOT transferred to the caller.
+   */
+  AsyncWriteBudget* async_write_budget() {
+    return async_write_budget_.get();
+  }
+
+  /** Returns the throttle of the reads and writes of all files or NULL.
+   *
+   * @remark    Ownership is NOT transferred to the caller.
+   */
+  IOThrottle* io_throttle() {
+    return io_throttle_.get();
+  }
+
+  const xtreemfs::pbrpc::Auth& auth_bogus() {
+    return auth_bogus_;
+  }
+
+  const xtreemfs::pbrpc::UserCredentials& user_credentials_bogus() {
+    return user_credentials_bogus_;
+  }
+
+  const std::map<xtreemfs::pbrpc::StripingPolicyType,
+                 StripeTranslator*>& stripe_translators() {
+    return stripe_translators_;
+  }
+
+ private:
+  /** Maximum number of pending MRC requests of a batch operation. */
+  static const size_t kMaxPendingBatchRequests = 64;
+
+  /** Retrieves the stat object for file at "path" from MRC or cache.
+   *  Does not query any open file for pending file size updates nor lock the
+   *  open_file_table_.
+   *
+   *  @remark   Ownership of stat_buffer is not transferred to the caller.
+   */
+  void GetAttrHelper(const xtreemfs::pbrpc::UserCredentials& user_credentials,
+                     const std::string& path,
+                     bool ignore_metadata_cache,
+                     xtreemfs::pbrpc::Stat* stat_buffer);
+
+  /** Stores the stat of a getattr "response" for "path" in "stat_buffer" and
+   *  updates the metadata cache. */
+  void ProcessGetAttrResponse(const std::string& path,
+                              const xtreemfs::pbrpc::getattrResponse& response,
+                              xtreemfs::pbrpc::Stat* stat_buffer);
+
+  /** Merges "stat_buffer" with the pending file size of the file at "path"
+   *  if it's open. */
+  void MergeStatWithOpenFile(
+      const xtreemfs::pbrpc::UserCredentials& user_credentials,
+      const std::string& path,
+      bool ignore_metadata_cache,
+      xtreemfs::pbrpc::Stat* stat_buffer);
+
+  /** Fills in the open request "rq". */
+  void PrepareOpenRequest(const std::string& path,
+                          const xtreemfs::pbrpc::SYSTEM_V_FCNTL flags,
+                          uint32_t mode,
+                          uint32_t attributes,
+                          xtreemfs::pbrpc::openRequest* rq);
+
+  /** Creates the FileHandle for an open "response" and executes the
+   *  remaining steps of OpenFileWithTruncateSize(). */
+  FileHandle* ProcessOpenResponse(
+      const xtreemfs::pbrpc::UserCredentials& user_credentials,
+      const std::string& path,
+      const xtreemfs::pbrpc::SYSTEM_V_FCNTL flags,
+      int truncate_new_file_size,
+      const xtreemfs::pbrpc::openResponse& response);
+
+  /** Resolves the addresses of all OSDs of "file_info" and lets
+   *  network_client_ connect to them in the background. Errors are ignored,
+   *  they will be reported by the first request instead. */
+  void PrewarmOSDConnections(FileInfo* file_info);
+
+  /** Updates the caches after "path" was unlinked and deletes the objects
+   *  of the file. */
+  void ProcessUnlinkResponse(const std::string& path,
+                             const xtreemfs::pbrpc::unlinkResponse& response);
+
+  /** Updates the caches after the directory "path" was created. */
+  void ProcessMakeDirectoryResponse(
+      const std::string& path,
+      const xtreemfs::pbrpc::timestampResponse& response);
+
+  /** Sends "requests" to the MRC without waiting for the previous responses
+   *  (at most kMaxPendingBatchRequests at once) and passes every response to
+   *  "complete_item" together with the index of the item in "items".
+   *
+   *  If a request was not sent or failed with another error than an errno,
+   *  "complete_item" is called with NULL to execute the item with the
+   *  blocking operation, i.e. with the usual retry and redirect handling.
+   *  Its last argument is true if the request was sent, i.e. if the MRC may
+   *  have executed it already. Errors of an item are stored in "errors".
+   *
+   *  If the thread is interrupted, all sent requests are completed before the
+   *  exception is rethrown.
+   */
+  template<typename RequestType>
+  void ExecuteBatch(
+      const std::vector<RequestType>& requests,
+      const std::vector<size_t>& items,
+      boost::function<rpc::SyncCallbackBase*(
+          const std::string&, const RequestType*)> send_request,
+      boost::function<void(size_t, rpc::SyncCallbackBase*, bool)>
+          complete_item,
+      std::vector<xtreemfs::pbrpc::POSIXErrno>* errors);
+
+  /** Completes item "i" of GetAttrs(). */
+  void CompleteBatchGetAttr(
+      const xtreemfs::pbrpc::UserCredentials* user_credentials,
+      const std::vector<std::string>* paths,
+      std::vector<xtreemfs::pbrpc::Stat>* stats,
+      size_t i,
+      rpc::SyncCallbackBase* response,
+      bool was_sent);
+
+  /** Completes item "i" of OpenFiles(). If the blocking retry of a sent
+   *  request with O_CREAT and O_EXCL fails with EEXIST, the file is opened
+   *  without O_EXCL since the sent request may have created it. */
+  void CompleteBatchOpen(
+      const xtreemfs::pbrpc::UserCredentials* user_credentials,
+      const std::vector<std::string>* paths,
+      const xtreemfs::pbrpc::SYSTEM_V_FCNTL flags,
+      uint32_t mode,
+      std::vector<FileHandle*>* file_handles,
+      size_t i,
+      rpc::SyncCallbackBase* response,
+      bool was_sent);
+
+  /** Completes item "i" of UnlinkFiles(). If the blocking retry of a sent
+   *  request fails with ENOENT, the item succeeded since the sent request may
+   *  have removed the file. */
+  void CompleteBatchUnlink(
+      const xtreemfs::pbrpc::UserCredentials* user_credentials,
+      const std::vector<std::string>* paths,
+      size_t i,
+      rpc::SyncCallbackBase* response,
+      bool was_sent);
+
+  /** Completes item "i" of MakeDirectories(). If the blocking retry of a
+   *  sent request fails with EEXIST, the item succeeded since the sent
+   *  request may have created the directory. */
+  void CompleteBatchMakeDirectory(
+      const xtreemfs::pbrpc::UserCredentials* user_credentials,
+      const std::vector<std::string>* paths,
+      unsigned int mode,
+      size_t i,
+      rpc::SyncCallbackBase* response,
+      bool was_sent);
+
+  /** Obtain or create a new FileInfo object in the open_file_table_.
+   *  Requires a lock on the mutex of the shard of "file_id".
+   *
+   * @remark Ownership is NOT transferred to the caller. The object will be
+   *         deleted by DecreaseFileInfoReferenceCount() if no further
+   *         FileHandle references it. */
+  FileInfo* GetFileInfoOrCreateUnmutexed(
+      uint64_t file_id,
+      const std::string& path,
+      bool replicate_on_close,
+      const xtreemfs::pbrpc::XLocSet& xlocset);
+
+  /** Deregisters file_id from open_file_table_. Requires a lock on the mutex
+   *  of the shard of "file_id". */
+  void RemoveFileInfoUnmutexed(uint64_t file_id, FileInfo* file_info);
+
+  /** Schedules the next renewal of the XCaps of "file_info" after
+   *  Options::periodic_xcap_renewal_interval_s. Requires a lock on the mutex
+   *  of the shard of "file_id" in open_file_table_. */
+  void ScheduleXCapRenewalUnmutexed(uint64_t file_id, FileInfo* file_info);
+
+  /** Executes the due tasks of file_task_queue_, i.e. renews the XCaps of
+   *  open files before they expire and writes back dirty file sizes. */
+  void ProcessFileTasks();
+
+  /** Complete the write-behind closes of deferred_closes_ until
+   *  stop_deferred_closes_ is set and no close is pending. */
+  void ProcessDeferredCloses();
+
+  /** Restores the UUID cache, the Vivaldi coordinates and metadata_cache_
+   *  from the warm start snapshot of this volume, if there is one. */
+  void RestoreWarmStartSnapshot();
+
+  /** Writes the warm start snapshot of this volume. */
+  void WriteWarmStartSnapshot();
+
+  void WaitForXLocSetInstallation(
+      const xtreemfs::pbrpc::UserCredentials& user_credentials,
+      const std::string& file_id,
+      int expected_version,
+      xtreemfs::pbrpc::XLocSet* xlocset);
+
+  /** Reference to Client which did open this volume. */
+  ClientImplementation* client_;
+
+  /** UUID Resolver (usually points to the client_) */
+  UUIDResolver* uuid_resolver_;
+
+  /** UUID of the Client (needed to distinguish Locks of different clients). */
+  const std::string& client_uuid_;
+
+  /** UUID Iterator which contains the UUIDs of all MRC replicas of this
+   *  volume. */
+  boost::scoped_ptr<UUIDIterator> mrc_uuid_iterator_;
+
+  /** Name of the corresponding Volume. */
+  const std::string volume_name_;
+
+  /** SSL options used for connections to the MRC and OSDs. */
+  const xtreemfs::rpc::SSLOptions* volume_ssl_options_;
+
+  /** libxtreemfs Options object which includes all program options */
+  const Options& volume_options_;
+
+  /** Disabled retry and interrupt functionality. */
+  RPCOptions periodic_threads_options_;
+
+  /** The PBRPC protocol requires an Auth & UserCredentials object in every
+   *  request. However there are many operations which do not check the content
+   *  of this operation and therefore we use bogus objects then.
+   *  auth_bogus_ will always be set to the type AUTH_NONE.
+   *
+   *  @remark Cannot be set to const because it's modified inside the
+   *          constructor VolumeImplementation(). */
+  xtreemfs::pbrpc::Auth auth_bogus_;
+
+  /** The PBRPC protocol requires an Auth & UserCredentials object in every
+   *  request. However there are many operations which do not check the content
+   *  of this operation and therefore we use bogus objects then.
+   *  user_credentials_bogus will only contain a user "xtreemfs".
+   *
+   *  @remark Cannot be set to const because it's modified inside the
+   *          constructor VolumeImplementation(). */
+  xtreemfs::pbrpc::UserCredentials user_credentials_bogus_;
+
+  /** The RPC Client processes requests from a queue and executes callbacks in
+   *  its thread. */
+  boost::scoped_ptr<xtreemfs::rpc::Client> network_client_;
+  boost::scoped_ptr<boost::thread> network_client_thread_;
+
+  /** An MRCServiceClient is a wrapper for an RPC Client. */
+  boost::scoped_ptr<xtreemfs::pbrpc::MRCServiceClient> mrc_service_client_;
+
+  /** A OSDServiceClient is a wrapper for an RPC Client. */
+  boost::scoped_ptr<SplicingOSDServiceClient> osd_service_client_;
+
+  /** Limits the memory of the async writes of all files (NULL if disabled). */
+  boost::scoped_ptr<AsyncWriteBudget> async_write_budget_;
+
+  /** Limits the reads and writes of all files per QoS key (NULL if
+   *  disabled). */
+  boost::scoped_ptr<IOThrottle> io_throttle_;
+
+  /** Maps file_id -> FileInfo* for every open file.
+   *
+   * @attention If a function uses the mutex of a shard of open_file_table_
+   *            and file_handle_list_mutex_, file_handle_list_mutex_ has to be
+   *            locked first to avoid a deadlock.
+   */
+  OpenFileTable open_file_table_;
+
+  /** Metadata cache (stat, dir_entries, xattrs) by path. */
+  MetadataCache metadata_cache_;
+
+  /** Available Striping policies. */
+  std::map<xtreemfs::pbrpc::StripingPolicyType,
+           StripeTranslator*> stripe_translators_;
+
+  /** XCap renewals and file size updates of the open files, ordered by their
+   *  deadline. */
+  FileTaskQueue file_task_queue_;
+
+  /** Executes the tasks of file_task_queue_. */
+  boost::scoped_ptr<boost::thread> file_task_thread_;
+
+  /** Completes write-behind closes (NULL if disabled). */
+  boost::scoped_ptr<boost::thread> deferred_close_thread_;
+
+  /** Protects deferred_closes_, pending_deferred_closes_,
+   *  stop_deferred_closes_ and deferred_close_errors_. */
+  boost::mutex deferred_closes_mutex_;
+
+  /** Signaled if a close was queued or completed. */
+  boost::condition deferred_closes_changed_;
+
+  /** A write-behind closed file handle. */
+  struct DeferredClose {
+    DeferredClose(uint64_t file_id,
+                  const std::string& path,
+                  FileHandleImplementation* file_handle)
+        : file_id(file_id), path(path), file_handle(file_handle) {}
+
+    uint64_t file_id;
+    /** Path at the time of the close, only used for logging. */
+    std::string path;
+    FileHandleImplementation* file_handle;
+  };
+
+  /** Write-behind closed file handles which were not picked up by
+   *  deferred_close_thread_ yet. */
+  std::list<DeferredClose> deferred_closes_;
+
+  /** Number of queued and currently processed write-behind closes. */
+  int pending_deferred_closes_;
+
+  /** Set by CloseInternal(): deferred_close_thread_ exits once all pending
+   *  closes are completed. */
+  bool stop_deferred_closes_;
+
+  /** Maps file id -> error of the failed write-behind closes which were not
+   *  reported yet. The path may have changed since, e.g. by a rename. */
+  std::map<uint64_t, std::string> deferred_close_errors_;
+
+  FRIEND_TEST(VolumeImplementationTest,
+              StatCacheCorrectlyUpdatedAfterRenameWriteAndClose);
+};
+
+}  // namespace xtreemfs
+
+#endif  // CPP_INCLUDE_LIBXTREEMFS_VOLUME_IMPLEMENTATION_H_
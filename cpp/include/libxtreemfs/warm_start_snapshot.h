@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2026 by the XtreemFS Authors, see AUTHORS file
+ *
+ * Licensed under the BSD License, see LICENSE file for details.
+ *
+ */
+
+#ifndef CPP_INCLUDE_LIBXTREEMFS_WARM_START_SNAPSHOT_H_
+#define CPP_INCLUDE_LIBXTREEMFS_WARM_START_SNAPSHOT_H_
+
+#include <string>
+
+namespace xtreemfs {
+
+namespace pbrpc {
+class VivaldiCoordinates;
+}  // namespace pbrpc
+
+class MetadataCache;
+class UUIDCache;
+
+/** Returns the path of the warm start snapshot of "volume_name" in
+ *  "directory". */
+std::string GetWarmStartSnapshotPath(const std::string& directory,
+                                     const std::string& volume_name);
+
+/** Writes the entries of "uuid_cache" and "metadata_cache" which did not
+ *  expire yet and "vivaldi_coordinates" (may be NULL) to the file "path".
+ *
+ *  The file is replaced atomically, i.e. a crash does not leave a partially
+ *  written snapshot behind.
+ *
+ * @throws XtreemFSException  If the snapshot could not be written.
+ */
+void SaveWarmStartSnapshot(
+    const std::string& path,
+    UUIDCache* uuid_cache,
+    const pbrpc::VivaldiCoordinates* vivaldi_coordinates,
+    MetadataCache* metadata_cache);
+
+/** Restores the entries of the snapshot "path" which did not expire since the
+ *  snapshot was written. The caches are only modified if the whole snapshot
+ *  is valid.
+ *
+ *  Returns false if there is no snapshot. "vivaldi_coordinates" is cleared if
+ *  the snapshot does not contain coordinates.
+ *
+ * @throws XtreemFSException  If the snapshot could not be read or is invalid.
+ */
+bool LoadWarmStartSnapshot(const std::string& path,
+                           UUIDCache* uuid_cache,
+                           pbrpc::VivaldiCoordinates* vivaldi_coordinates,
+                           MetadataCache* metadata_cache);
+
+}  // namespace xtreemfs
+
+#endif  // CPP_INCLUDE_LIBXTREEMFS_WARM_START_SNAPSHOT_H_
@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2026 by the XtreemFS Authors, see AUTHORS file
+ *
+ * Licensed under the BSD License, see LICENSE file for details.
+ *
+ */
+
+#ifndef CPP_INCLUDE_LIBXTREEMFS_WRITE_WINDOW_CONTROLLER_H_
+#define CPP_INCLUDE_LIBXTREEMFS_WRITE_WINDOW_CONTROLLER_H_
+
+#include <stdint.h>
+
+#include <boost/thread/condition.hpp>
+#include <boost/thread/mutex.hpp>
+#include <map>
+#include <string>
+
+namespace xtreemfs {
+
+class Options;
+
+/** Current state of the async write window of one OSD. */
+struct AsyncWriteWindow {
+  AsyncWriteWindow() : window(0), in_flight(0) {}
+
+  /** Number of allowed pending requests. */
+  int window;
+  /** Number of pending requests of all files. */
+  int in_flight;
+};
+
+/** Client-wide, adaptive limit of the pending async write requests per OSD.
+ *
+ *  The window of an OSD grows additively by one request per window of
+ *  successful writes, as long as the observed latency does not exceed
+ *  "kLatencyThresholdFactor" times the lowest latency of the last
+ *  "kLatencySamplesPerPeriod" to 2 * "kLatencySamplesPerPeriod" writes. It is
+ *  halved if the latency exceeds this threshold (at most once per window)
+ *  or if a write failed with a communication error.
+ *
+ *  The window is bounded by [1, async_writes_adaptive_max_requests] and starts
+ *  at async_writes_max_requests. It limits the writes in flight to an OSD
+ *  across all files, see Acquire() and Release().
+ */
+class WriteWindowController {
+ public:
+  explicit WriteWindowController(const Options& options);
+
+  WriteWindowController(int initial_window, int max_window);
+
+  /** Returns the current number of allowed pending requests for "osd_uuid". */
+  int GetWindow(const std::string& osd_uuid);
+
+  /** Blocks until fewer writes to "osd_uuid" are in flight than its window
+   *  allows and counts one more.
+   *
+   *  @throws boost::thread_interrupted
+   */
+  void Acquire(const std::string& osd_uuid);
+
+  /** Counts a write to "osd_uuid", started by Acquire(), as completed. */
+  void Release(const std::string& osd_uuid);
+
+  /** Records a successful write to "osd_uuid" which took "latency_us". */
+  void ReportSuccess(const std::string& osd_uuid, uint64_t latency_us);
+
+  /** Records a write to "osd_uuid" which failed with a communication error. */
+  void ReportFailure(const std::string& osd_uuid);
+
+  /** Copies the current window and the writes in flight of every known OSD
+   *  into "windows". */
+  void GetWindows(std::map<std::string, AsyncWriteWindow>* windows);
+
+ private:
+  struct OSDWindow {
+    OSDWindow(int initial_window)
+        : window(initial_window),
+          in_flight(0),
+          acked_requests(0),
+          latency_samples(0),
+          min_latency_us(0),
+          previous_min_latency_us(0) {}
+
+    /** Number of allowed pending requests. */
+    int window;
+    /** Number of writes between Acquire() and Release(). */
+    int in_flight;
+    /** Successful writes since the last change of "window". */
+    int acked_requests;
+    /** Latency samples of the current period. */
+    int latency_samples;
+    /** Lowest latency of the current period (0 if unknown). */
+    uint64_t min_latency_us;
+    /** Lowest latency of the previous period (0 if unknown). */
+    uint64_t previous_min_latency_us;
+  };
+
+  /** Latency samples above this multiple of the lowest latency count as
+   *  queueing delay and shrink the window. */
+  static const int kLatencyThresholdFactor = 2;
+
+  /** Number of latency samples after which the lowest latency is tracked
+   *  anew. */
+  static const int kLatencySamplesPerPeriod = 100;
+
+  /** Returns the entry for "osd_uuid". Assumes that mutex_ is locked. */
+  OSDWindow& GetOSDWindowUnmutexed(const std::string& osd_uuid);
+
+  /** Halves the window. Assumes that mutex_ is locked. */
+  void DecreaseUnmutexed(const std::string& osd_uuid, OSDWindow* osd_window);
+
+  const int initial_window_;
+
+  const int max_window_;
+
+  /** Protects windows_. */
+  boost::mutex mutex_;
+
+  /** Notified when a write was released or a window grew. */
+  boost::condition window_available_;
+
+  std::map<std::string, OSDWindow> windows_;
+};
+
+}  // namespace xtreemfs
+
+#endif  // CPP_INCLUDE_LIBXTREEMFS_WRITE_WINDOW_CONTROLLER_H_
@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2026 by the XtreemFS Authors, see AUTHORS file
+ *
+ * Licensed under the BSD License, see LICENSE file for details.
+ *
+ */
+
+#ifndef CPP_INCLUDE_RPC_KERNEL_TLS_H_
+#define CPP_INCLUDE_RPC_KERNEL_TLS_H_
+
+#ifdef HAS_OPENSSL
+
+#include <openssl/ssl.h>
+
+#include <string>
+
+namespace xtreemfs {
+namespace rpc {
+
+/** Returns true if this build supports OffloadTLSTransmit(), i.e. it was
+ *  compiled on Linux with the kernel TLS headers and OpenSSL 1.1.1 or newer.
+ *  The running kernel may still lack the "tls" module. */
+bool KernelTLSSupported();
+
+/** Lets the connections of "context" record their client application traffic
+ *  secret, see RecordTLSSecret(). */
+void EnableTLSSecretRecording(SSL_CTX* context);
+
+/** Must be called before the handshake of "ssl". After the handshake,
+ *  "secret" contains the client application traffic secret if TLS 1.3 was
+ *  negotiated.
+ *
+ *  @remarks "secret" must remain valid as long as "ssl" exists.
+ */
+void RecordTLSSecret(SSL* ssl, std::string* secret);
+
+/** Lets the kernel encrypt all data which is written to "socket" from now on
+ *  (Linux kTLS). Must be called right after the handshake of "ssl" and
+ *  afterwards no data must be written through "ssl" anymore. The receive
+ *  direction is not affected and still decrypted by "ssl".
+ *
+ *  Records which OpenSSL itself sends later, e.g. the reply to a KeyUpdate
+ *  request or an alert, would be written unencrypted by the kernel. Therefore
+ *  they are discarded instead, see OpenSSLWroteAfterOffload().
+ *
+ *  Returns false and leaves the connection unchanged if it cannot be
+ *  offloaded, i.e. it does not use TLS 1.3 with AES-GCM or the kernel does not
+ *  support it.
+ */
+bool OffloadTLSTransmit(SSL* ssl, int socket, const std::string& secret);
+
+/** Returns true if OpenSSL tried to send a record on "ssl" after
+ *  OffloadTLSTransmit() succeeded. The state of the connection is unknown to
+ *  the kernel then and the connection has to be closed. */
+bool OpenSSLWroteAfterOffload(SSL* ssl);
+
+}  // namespace rpc
+}  // namespace xtreemfs
+
+#endif  // HAS_OPENSSL
+
+#endif  // CPP_INCLUDE_RPC_KERNEL_TLS_H_
@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2026 by the XtreemFS Authors, see AUTHORS file
+ *
+ * Licensed under the BSD License, see LICENSE file for details.
+ *
+ */
+
+#ifndef CPP_INCLUDE_RPC_REQUEST_HEADER_CACHE_H_
+#define CPP_INCLUDE_RPC_REQUEST_HEADER_CACHE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/unordered_map.hpp>
+#include <string>
+
+#include "pbrpc/RPC.pb.h"
+
+namespace xtreemfs {
+
+namespace rpc {
+
+/** Caches the serialized RPCHeader of requests per UserCredentials and Auth.
+ *
+ *  All variable fields of a request header (call_id, interface_id and
+ *  proc_id) are fixed32 values. Therefore, the header of a request can be
+ *  created by copying a cached template and patching these fields in place,
+ *  instead of building and serializing a new RPCHeader for every request.
+ *
+ *  Lookups compare the fields of the credentials with a copy stored next to
+ *  the template, i.e. the Auth is only serialized once per template. They
+ *  work on an immutable snapshot of all templates and do not acquire a
+ *  mutex (see UUIDCache).
+ */
+class RequestHeaderCache {
+ public:
+  /** Number of cached templates after which the cache is cleared. */
+  static const size_t kDefaultMaxEntries = 1024;
+
+  explicit RequestHeaderCache(size_t max_entries);
+
+  /** Returns the serialized RPCHeader of a request from "user_credentials"
+   *  with "auth". The ids in the returned template are not set, use
+   *  SetIds() on a copy. */
+  boost::shared_ptr<const std::string> GetTemplate(
+      const xtreemfs::pbrpc::UserCredentials& user_credentials,
+      const xtreemfs::pbrpc::Auth& auth);
+
+  /** Sets the ids of the copy of a template "header" of size "header_length".
+   */
+  static void SetIds(uint32_t call_id,
+                     uint32_t interface_id,
+                     uint32_t proc_id,
+                     char* header,
+                     size_t header_length);
+
+ private:
+  struct Entry {
+    xtreemfs::pbrpc::UserCredentials user_credentials;
+    xtreemfs::pbrpc::Auth auth;
+    boost::shared_ptr<const std::string> header_template;
+  };
+
+  /** Maps the hash of credentials and auth to all templates with that hash. */
+  typedef boost::unordered_multimap<size_t, Entry> TemplateMap;
+
+  /** Serializes a header template for the given credentials. */
+  static std::string CreateTemplate(
+      const xtreemfs::pbrpc::UserCredentials& user_credentials,
+      const xtreemfs::pbrpc::Auth& auth);
+
+  /** Hashes every field which ends up in the template. */
+  static size_t Hash(const xtreemfs::pbrpc::UserCredentials& user_credentials,
+                     const xtreemfs::pbrpc::Auth& auth);
+
+  /** Returns the template of "user_credentials" and "auth" in "templates" or
+   *  NULL if there is none. */
+  static const boost::shared_ptr<const std::string>* Find(
+      const TemplateMap& templates,
+      size_t hash,
+      const xtreemfs::pbrpc::UserCredentials& user_credentials,
+      const xtreemfs::pbrpc::Auth& auth);
+
+  const size_t max_entries_;
+
+  /** Current snapshot. Never modified after it was published, only replaced
+   *  with boost::atomic_store(). */
+  boost::shared_ptr<const TemplateMap> templates_;
+
+  /** Serializes the updates of templates_. */
+  boost::mutex update_mutex_;
+};
+
+}  // namespace rpc
+}  // namespace xtreemfs
+
+#endif  // CPP_INCLUDE_RPC_REQUEST_HEADER_CACHE_H_
@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2026 by the XtreemFS Authors, see AUTHORS file
+ *
+ * Licensed under the BSD License, see LICENSE file for details.
+ *
+ */
+
+#ifndef CPP_INCLUDE_RPC_SSL_SESSION_CACHE_H_
+#define CPP_INCLUDE_RPC_SSL_SESSION_CACHE_H_
+
+#ifdef HAS_OPENSSL
+
+#include <openssl/ssl.h>
+
+#include <boost/thread/mutex.hpp>
+#include <map>
+#include <string>
+
+namespace xtreemfs {
+namespace rpc {
+
+/** Stores the last TLS session (session ID or ticket) per server, so that a
+ *  reconnect to the server resumes the session instead of doing a full
+ *  handshake.
+ *
+ *  Sessions are stored when OpenSSL reports them (for TLS 1.3 that is after
+ *  the handshake, when the server sent a ticket). */
+class SSLSessionCache {
+ public:
+  /** Enables the client session cache of "context" and lets it report new
+   *  sessions to this object. */
+  explicit SSLSessionCache(SSL_CTX* context);
+
+  ~SSLSessionCache();
+
+  /** Must be called before the handshake of "ssl" with the server "address".
+   *  The cached session of the server, if any, is offered for resumption.
+   *
+   *  @remarks "address" must remain valid as long as "ssl" exists.
+   */
+  void PrepareHandshake(SSL* ssl, const std::string* address);
+
+  /** Forgets the session of "address", e.g. after a failed handshake. */
+  void Remove(const std::string& address);
+
+  /** Returns the number of servers for which a session is cached. */
+  size_t size();
+
+ private:
+  /** Called by OpenSSL for every new session of a connection. */
+  static int NewSessionCallback(SSL* ssl, SSL_SESSION* session);
+
+  /** Replaces the session of "address" by "session".
+   *
+   *  @remarks Ownership of "session" is transferred.
+   */
+  void Store(const std::string& address, SSL_SESSION* session);
+
+  /** Guards sessions_. */
+  boost::mutex mutex_;
+
+  /** Server address ("host:port") to last session. Owns the sessions. */
+  std::map<std::string, SSL_SESSION*> sessions_;
+};
+
+}  // namespace rpc
+}  // namespace xtreemfs
+
+#endif  // HAS_OPENSSL
+
+#endif  // CPP_INCLUDE_RPC_SSL_SESSION_CACHE_H_
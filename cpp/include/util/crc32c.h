@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) 2026 by the XtreemFS Authors, see AUTHORS file
+ *
+ * Licensed under the BSD License, see LICENSE file for details.
+ *
+ */
+
+#ifndef CPP_INCLUDE_UTIL_CRC32C_H_
+#define CPP_INCLUDE_UTIL_CRC32C_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace xtreemfs {
+namespace util {
+
+/** Returns the CRC32C (Castagnoli polynomial, as used by iSCSI and ext4) of
+ *  "length" bytes at "data".
+ *
+ *  On x86-64 CPUs with SSE4.2 the crc32 instruction is used on three
+ *  interleaved streams, otherwise a table based implementation
+ *  (slicing-by-8).
+ */
+uint32_t CRC32C(const char* data, size_t length);
+
+/** Returns the CRC32C of the data whose CRC32C is "crc" followed by
+ *  "length" bytes at "data". CRC32CExtend(0, ...) equals CRC32C(...). */
+uint32_t CRC32CExtend(uint32_t crc, const char* data, size_t length);
+
+/** Same as CRC32CExtend(), but always uses the table based implementation. */
+uint32_t CRC32CExtendPortable(uint32_t crc, const char* data, size_t length);
+
+/** Returns true if CRC32C() uses the crc32 instruction of the CPU. */
+bool CRC32CIsHardwareAccelerated();
+
+}  // namespace util
+}  // namespace xtreemfs
+
+#endif  // CPP_INCLUDE_UTIL_CRC32C_H_
@@ -0,0 +1,205 @@
+/*
+ * Copyright (c) 2026 by the XtreemFS Authors, see AUTHORS file
+ *
+ * Licensed under the BSD License, see LICENSE file for details.
+ *
+ */
+
+#ifndef CPP_INCLUDE_UTIL_LATENCY_HISTOGRAM_H_
+#define CPP_INCLUDE_UTIL_LATENCY_HISTOGRAM_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <boost/atomic.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/scoped_array.hpp>
+#include <boost/thread/mutex.hpp>
+#include <map>
+#include <string>
+
+namespace xtreemfs {
+namespace util {
+
+/** Histogram of latencies in microseconds with logarithmic buckets which are
+ *  divided linearly (like HdrHistogram), i.e. the relative error of the
+ *  reported percentiles is below 1 / kSubBuckets.
+ *
+ *  Record() is lock-free: every thread increments the counters of one of
+ *  kStripes stripes selected by its thread id. Readers add up all stripes
+ *  and may therefore miss concurrent records.
+ */
+class LatencyHistogram {
+ public:
+  /** Aggregated values of a histogram. All values in microseconds. */
+  struct Summary {
+    Summary()
+        : count(0), mean(0), max(0), p50(0), p90(0), p99(0), p999(0) {}
+
+    uint64_t count;
+    uint64_t mean;
+    uint64_t max;
+    uint64_t p50;
+    uint64_t p90;
+    uint64_t p99;
+    uint64_t p999;
+  };
+
+  LatencyHistogram();
+
+  /** Adds a latency of "latency_us" microseconds. */
+  void Record(uint64_t latency_us);
+
+  /** Adds the time passed since "start". */
+  void RecordSince(const boost::posix_time::ptime& start);
+
+  void GetSummary(Summary* summary);
+
+  void Reset();
+
+  /** Returns the current time as expected by RecordSince(). */
+  static boost::posix_time::ptime Now() {
+    return boost::posix_time::microsec_clock::universal_time();
+  }
+
+ private:
+  static const int kSubBucketBits = 4;
+  static const int kSubBuckets = 1 << kSubBucketBits;
+  /** Larger latencies (more than an hour) are counted in the last bucket. */
+  static const int kMaxLatencyBits = 32;
+  static const int kNumberOfBuckets
+      = (kMaxLatencyBits - kSubBucketBits + 1) * kSubBuckets;
+  static const int kStripes = 8;
+
+  struct Stripe {
+    boost::atomic<uint64_t> buckets[kNumberOfBuckets];
+    boost::atomic<uint64_t> sum;
+    boost::atomic<uint64_t> max;
+  };
+
+  static int GetBucketIndex(uint64_t latency_us);
+
+  /** Returns the largest latency counted in bucket "index". */
+  static uint64_t GetBucketUpperBound(int index);
+
+  Stripe& GetStripeOfCurrentThread();
+
+  boost::scoped_array<Stripe> stripes_;
+};
+
+/** Measures the time between its construction and destruction and records it
+ *  in "histogram" unless it is NULL. */
+class ScopedLatencyRecorder {
+ public:
+  explicit ScopedLatencyRecorder(LatencyHistogram* histogram)
+      : histogram_(histogram) {
+    if (histogram_) {
+      start_ = LatencyHistogram::Now();
+    }
+  }
+
+  ~ScopedLatencyRecorder() {
+    if (histogram_) {
+      histogram_->RecordSince(start_);
+    }
+  }
+
+ private:
+  LatencyHistogram* histogram_;
+  boost::posix_time::ptime start_;
+};
+
+/** Process-wide collection of latency histograms: one per libxtreemfs
+ *  operation, one per phase of an RPC and one per server. Exposed through
+ *  the xctl pseudo-file of the mounted volume. */
+class LatencyStatistics {
+ public:
+  enum Operation {
+    kGetAttr,
+    kSetAttr,
+    kOpen,
+    kClose,
+    kRead,
+    kWrite,
+    kFlush,
+    kTruncate,
+    kReadDir,
+    kMakeDirectory,
+    kDeleteDirectory,
+    kUnlink,
+    kRename,
+    kStatFS,
+    kGetXAttr,
+    kSetXAttr,
+    kListXAttr,
+    kAcquireLock,
+    /** Time between sending an RPC and picking it up by the network thread. */
+    kRPCQueue,
+    /** Time between picking up an RPC and the arrival of its response. */
+    kRPCNetwork,
+    /** Duration of the callback of an RPC. */
+    kRPCCallback,
+    kNumberOfOperations
+  };
+
+  static LatencyStatistics* latency_statistics;
+
+  LatencyStatistics() : init_count_(1) {}
+  ~LatencyStatistics();
+
+  /** Returns the histogram of "operation" if the statistics are initialized
+   *  and NULL otherwise. */
+  static LatencyHistogram* GetHistogram(Operation operation) {
+    return latency_statistics
+        ? &latency_statistics->operations_[operation] : NULL;
+  }
+
+  /** Returns the name used for "operation" in the exported statistics. */
+  static const char* GetOperationName(Operation operation);
+
+  /** Returns the histogram of the server "address" if the statistics are
+   *  initialized and NULL otherwise. The histogram stays valid until the
+   *  statistics are shut down. */
+  static LatencyHistogram* GetServerHistogram(const std::string& address);
+
+  void GetOperationSummary(Operation operation,
+                           LatencyHistogram::Summary* summary);
+
+  void GetServerSummaries(
+      std::map<std::string, LatencyHistogram::Summary>* summaries);
+
+  /** Resets all histograms. */
+  void Reset();
+
+  void register_init() {
+    ++init_count_;
+  }
+
+  bool register_shutdown() {
+    if (init_count_ > 0) {
+      return (--init_count_ == 0);
+    }
+    return false;
+  }
+
+ private:
+  /** Contains the number of possible instances, by counting inits and
+   *  shutdowns. */
+  int init_count_;
+
+  LatencyHistogram operations_[kNumberOfOperations];
+
+  /** Protects servers_. The histograms themselves are not protected. */
+  boost::mutex servers_mutex_;
+
+  std::map<std::string, LatencyHistogram*> servers_;
+};
+
+void initialize_latency_statistics();
+
+void shutdown_latency_statistics();
+
+}  // namespace util
+}  // namespace xtreemfs
+
+#endif  // CPP_INCLUDE_UTIL_LATENCY_HISTOGRAM_H_
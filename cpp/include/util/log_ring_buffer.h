@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2026 by the XtreemFS Authors, see AUTHORS file
+ *
+ * Licensed under the BSD License, see LICENSE file for details.
+ *
+ */
+
+#ifndef CPP_INCLUDE_UTIL_LOG_RING_BUFFER_H_
+#define CPP_INCLUDE_UTIL_LOG_RING_BUFFER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <boost/atomic.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/scoped_array.hpp>
+#include <boost/thread/thread.hpp>
+#include <string>
+
+#include "util/logging.h"
+
+namespace xtreemfs {
+namespace util {
+
+/** Bounded single-producer single-consumer queue of log messages.
+ *
+ *  Every thread which logs owns one buffer and is its only producer. The
+ *  writer thread of Logging is the only consumer. Both sides are wait-free.
+ *  If the buffer is full, new messages are dropped and counted instead of
+ *  blocking the logging thread.
+ *
+ *  The strings of the entries are swapped in and out, i.e. their memory is
+ *  reused and no allocations are required once the buffer was filled once.
+ */
+class LogRingBuffer {
+ public:
+  struct Entry {
+    LogLevel level;
+    boost::posix_time::ptime time;
+    std::string message;
+  };
+
+  explicit LogRingBuffer(size_t capacity);
+
+  /** Appends a message and swaps its text with an unused string, i.e.
+   *  "message" is empty afterwards. Must be called by the owning thread only.
+   *
+   *  Returns false and counts the message as dropped if the buffer is full. */
+  bool TryPush(LogLevel level,
+               const boost::posix_time::ptime& time,
+               std::string* message);
+
+  /** Returns the oldest entry or NULL if the buffer is empty. The entry stays
+   *  valid until Pop() is called. Must be called by the consumer only. */
+  Entry* Front();
+
+  /** Removes the entry returned by Front(). */
+  void Pop();
+
+  bool empty() const;
+
+  /** Returns the number of dropped messages since the last call. */
+  uint64_t TakeDroppedCount();
+
+  /** Id of the thread which owns this buffer. */
+  const boost::thread::id& thread_id() const {
+    return thread_id_;
+  }
+
+ private:
+  boost::scoped_array<Entry> entries_;
+
+  const size_t capacity_;
+
+  const boost::thread::id thread_id_;
+
+  /** Number of pushed entries. Written by the producer only. */
+  boost::atomic<size_t> head_;
+
+  /** Number of popped entries. Written by the consumer only. */
+  boost::atomic<size_t> tail_;
+
+  boost::atomic<uint64_t> dropped_;
+};
+
+}  // namespace util
+}  // namespace xtreemfs
+
+#endif  // CPP_INCLUDE_UTIL_LOG_RING_BUFFER_H_
@@ -0,0 +1,173 @@
+/*
+ * Copyright (c) 2009-2010 by Bjoern Kolbeck, Zuse Institute Berlin
+ *
+ * Licensed under the BSD License, see LICENSE file for details.
+ *
+ */
+
+#ifndef CPP_INCLUDE_UTIL_LOGGING_H_
+#define CPP_INCLUDE_UTIL_LOGGING_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <boost/atomic.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/condition.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+#include <list>
+#include <ostream>
+#include <string>
+
+namespace xtreemfs {
+namespace util {
+
+enum LogLevel {
+  LEVEL_EMERG = 0,
+  LEVEL_ALERT = 1,
+  LEVEL_CRIT = 2,
+  LEVEL_ERROR = 3,
+  LEVEL_WARN = 4,
+  LEVEL_NOTICE = 5,
+  LEVEL_INFO = 6,
+  LEVEL_DEBUG = 7
+};
+
+class LogRingBuffer;
+
+/** Asynchronous logger.
+ *
+ *  getLog() returns a stream which belongs to the calling thread. A message
+ *  is complete once the stream is flushed (e.g. by std::endl) or getLog() is
+ *  called again. Complete messages are put into a ring buffer of the thread
+ *  without any locking. A background thread adds the header (level, time and
+ *  thread id) and writes them to the log. It sleeps while all buffers are
+ *  empty and is woken up by the next message.
+ *
+ *  If a thread logs faster than the background thread can write, i.e. its
+ *  ring buffer is full, further messages are dropped. The number of dropped
+ *  messages is written to the log instead.
+ */
+class Logging {
+ public:
+  static Logging* log;
+
+  explicit Logging(LogLevel level = LEVEL_ERROR);
+  Logging(LogLevel level, std::ostream* stream);
+  virtual ~Logging();
+
+  std::ostream& getLog(LogLevel level) {
+    return getLog(level, "?", 0);
+  }
+
+  std::ostream& getLog(LogLevel level, const char* file, int line);
+
+  bool loggingActive(LogLevel level) {
+    return (level <= level_);
+  }
+
+  /** Blocks until all messages logged so far were written. */
+  void Flush();
+
+  /** Returns the total number of dropped messages. */
+  uint64_t dropped_messages() {
+    return dropped_messages_.load(boost::memory_order_relaxed);
+  }
+
+  void register_init();
+  bool register_shutdown();
+
+ private:
+  /** Starts the writer thread. */
+  void Start();
+
+  /** Creates and registers the ring buffer of the calling thread. */
+  boost::shared_ptr<LogRingBuffer> RegisterThread();
+
+  /** Loop of the writer thread. */
+  void Run();
+
+  /** Wakes up the writer thread if it sleeps. Called after a message was
+   *  put into a ring buffer. */
+  void WakeUpWriter();
+
+  /** Returns true if no thread has buffered messages. */
+  bool AllRingBuffersEmpty();
+
+  /** Writes the buffered messages of all threads and returns their number.
+   *  Must be called by the writer thread only. */
+  size_t WriteBufferedMessages();
+
+  void WriteHeader(LogLevel level,
+                   const boost::posix_time::ptime& time,
+                   const boost::thread::id& thread_id);
+
+  /** Log stream. */
+  std::ostream& log_stream_;
+
+  /** Contains the pointer to the stream which has to be freed by the shutdown
+   *  method. */
+  std::ostream* log_file_stream_;
+
+  LogLevel level_;
+
+  /** Contains the number of possible instances, by counting inits and shutdowns. */
+  int init_count_;
+
+  /** Distinguishes the per thread state of this instance from the one of
+   *  earlier instances. */
+  const uint64_t instance_id_;
+
+  /** Ring buffers of all threads which did log. Buffers of exited threads are
+   *  removed once they were emptied. */
+  std::list<boost::shared_ptr<LogRingBuffer> > ring_buffers_;
+
+  /** Protects ring_buffers_. */
+  boost::mutex ring_buffers_mutex_;
+
+  boost::scoped_ptr<boost::thread> writer_thread_;
+
+  /** Protects stop_writer_, flush_requests_ and completed_flushes_. */
+  boost::mutex writer_mutex_;
+
+  /** Notified if a message was logged, Flush() was called or the writer
+   *  thread has to stop. */
+  boost::condition writer_wakeup_;
+
+  /** Notified if the writer thread completed flush requests. */
+  boost::condition flush_completed_;
+
+  bool stop_writer_;
+
+  /** True while the writer thread waits for writer_wakeup_. */
+  boost::atomic<bool> writer_sleeping_;
+
+  /** Number of Flush() calls so far. */
+  uint64_t flush_requests_;
+
+  /** Number of Flush() calls whose messages were written. */
+  uint64_t completed_flushes_;
+
+  boost::atomic<uint64_t> dropped_messages_;
+
+  char levelToChar(LogLevel level);
+
+  friend class ThreadLog;
+};
+
+LogLevel stringToLevel(std::string stringLevel, LogLevel defaultLevel);
+
+void initialize_logger(LogLevel level);
+void initialize_logger(LogLevel level, std::string logfilePath);
+void initialize_logger(std::string stringLevel,
+                       std::string logfilePath,
+                       LogLevel defaultLevel);
+void shutdown_logger();
+
+}  // namespace util
+}  // namespace xtreemfs
+
+#endif  // CPP_INCLUDE_UTIL_LOGGING_H_
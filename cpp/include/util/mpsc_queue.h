@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2026 by the XtreemFS Authors, see AUTHORS file
+ *
+ * Licensed under the BSD License, see LICENSE file for details.
+ *
+ */
+
+#ifndef CPP_INCLUDE_UTIL_MPSC_QUEUE_H_
+#define CPP_INCLUDE_UTIL_MPSC_QUEUE_H_
+
+#include <boost/atomic.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+
+namespace xtreemfs {
+namespace util {
+
+/** Unbounded queue for any number of producers and exactly one consumer.
+ *
+ *  Enqueue() is lock-free: it links a new node with a single atomic exchange
+ *  (D. Vyukov's intrusive MPSC algorithm with a stub node). The consumer only
+ *  takes mutex_ when the queue is empty and it has to sleep; a producer takes
+ *  it only to wake up a sleeping consumer.
+ *
+ *  Dequeue() has the same interface as SynchronizedQueue::Dequeue() and is an
+ *  interruption point while it waits.
+ *
+ *  T must be copyable and default constructible. */
+template <typename T>
+class MPSCQueue {
+ public:
+  MPSCQueue() : consumer_waiting_(false) {
+    Node* stub = new Node();
+    head_.store(stub, boost::memory_order_relaxed);
+    tail_ = stub;
+  }
+
+  ~MPSCQueue() {
+    while (tail_) {
+      Node* next = tail_->next.load(boost::memory_order_relaxed);
+      delete tail_;
+      tail_ = next;
+    }
+  }
+
+  /** Adds data to the queue. Never blocks. May be called by any thread. */
+  void Enqueue(const T& data) {
+    Node* node = new Node(data);
+    Node* previous = head_.exchange(node, boost::memory_order_acq_rel);
+    // Until this store, the consumer sees the queue end at "previous".
+    previous->next.store(node, boost::memory_order_release);
+
+    // Pairs with the fence in Dequeue(): either the consumer sees the new node
+    // or we see that it is about to sleep.
+    boost::atomic_thread_fence(boost::memory_order_seq_cst);
+    if (consumer_waiting_.load(boost::memory_order_relaxed)) {
+      boost::mutex::scoped_lock lock(mutex_);
+      queue_not_empty_cond_.notify_one();
+    }
+  }
+
+  /** Gets data from the queue. Blocks if no data is available.
+   *
+   *  @remark Must only be called by one thread at a time. */
+  T Dequeue() {
+    Node* node = TryDequeue();
+    if (node) {
+      return node->data;
+    }
+
+    boost::mutex::scoped_lock lock(mutex_);
+    while (true) {
+      consumer_waiting_.store(true, boost::memory_order_relaxed);
+      boost::atomic_thread_fence(boost::memory_order_seq_cst);
+      node = TryDequeue();
+      if (node) {
+        consumer_waiting_.store(false, boost::memory_order_relaxed);
+        return node->data;
+      }
+      try {
+        // A producer notifies only while holding mutex_, i.e. not before we
+        // are waiting.
+        queue_not_empty_cond_.wait(lock);
+      } catch (...) {
+        // wait() is an interruption point.
+        consumer_waiting_.store(false, boost::memory_order_relaxed);
+        throw;
+      }
+    }
+  }
+
+ private:
+  struct Node {
+    Node() : next(NULL), data() {}
+    explicit Node(const T& data) : next(NULL), data(data) {}
+
+    boost::atomic<Node*> next;
+    T data;
+  };
+
+  /** Removes the oldest element and returns its node, which becomes the new
+   *  stub node, i.e. it is valid until the next call. Returns NULL if the
+   *  queue is empty or the newest producer has not linked its node yet. */
+  Node* TryDequeue() {
+    Node* next = tail_->next.load(boost::memory_order_acquire);
+    if (next == NULL) {
+      return NULL;
+    }
+    delete tail_;
+    tail_ = next;
+    return next;
+  }
+
+  /** Last linked node, swapped by producers. */
+  boost::atomic<Node*> head_;
+
+  /** Stub node in front of the oldest element. Only used by the consumer. */
+  Node* tail_;
+
+  /** True while the consumer is (about to be) blocked in Dequeue(). */
+  boost::atomic<bool> consumer_waiting_;
+
+  /** Protects the sleep and the wake-up of the consumer. */
+  boost::mutex mutex_;
+
+  /** The condition to wait for if the queue is empty. */
+  boost::condition_variable queue_not_empty_cond_;
+
+  // Non-copyable.
+  MPSCQueue(const MPSCQueue&);
+  MPSCQueue& operator=(const MPSCQueue&);
+};
+
+}  // namespace util
+}  // namespace xtreemfs
+
+#endif  // CPP_INCLUDE_UTIL_MPSC_QUEUE_H_
@@ -11,6 +11,7 @@
 #include <cstring>
 #define FUSE_USE_VERSION 26
 #include <fuse.h>
+#include <fuse_lowlevel.h>
 #include <stdint.h>
 #include <sys/errno.h>
 #include <sys/types.h>
@@ -18,6 +19,7 @@
 
 #include <algorithm>
 #include <boost/lexical_cast.hpp>
+#include <boost/thread/tss.hpp>
 #include <fstream>
 #include <list>
 #include <string>
@@ -59,7 +61,35 @@ using namespace xtreemfs::util;
 
 namespace xtreemfs {
 
+namespace {
+
+/** Request of the low-level API currently processed by a thread. */
+struct LowLevelRequest {
+  LowLevelRequest() : req(NULL) {}
+
+  fuse_req_t req;
+  /** Caller of "req" in the format of the high-level API. */
+  struct fuse_context context;
+};
+
+boost::thread_specific_ptr<LowLevelRequest> current_low_level_request;
+
+/** Returns the caller of the current operation. */
+struct fuse_context* GetFuseContext() {
+  LowLevelRequest* request = current_low_level_request.get();
+  if (request && request->req) {
+    return &request->context;
+  }
+  return fuse_get_context();
+}
+
+}  // namespace
+
 int CheckIfOperationInterrupted() {
+  LowLevelRequest* request = current_low_level_request.get();
+  if (request && request->req) {
+    return fuse_req_interrupted(request->req);
+  }
   // TODO(mberlin): Test for other plattforms that it's safe to call this.
   return fuse_interrupted();
 }
@@ -306,9 +336,13 @@ void FuseAdapter::Start(std::list<char*>* required_fuse_options) {
   // Unfortunately Fuse does also cache the stat entries of hard links and
   // therefore returns incorrect results if hard links are "chained".
   // In consequence, we have to disable the Fuse stat cache at all.
-  required_fuse_options->push_back(strdup("-oattr_timeout=0"));
-  required_fuse_options->push_back(
-      strdup("-ouse_ino,readdir_ino"));
+  // The low-level API does not know these options: It uses the file ids as
+  // inode numbers and returns the timeouts per entry instead.
+  if (!options_->use_lowlevel_api) {
+    required_fuse_options->push_back(strdup("-oattr_timeout=0"));
+    required_fuse_options->push_back(
+        strdup("-ouse_ino,readdir_ino"));
+  }
   #ifndef __sun
   if (!options_->enable_atime) {
     required_fuse_options->push_back(strdup("-onoatime"));
@@ -359,6 +393,49 @@ void FuseAdapter::GenerateUserCredentials(
   }
 }
 
+void FuseAdapter::SetQoSKey(
+    struct fuse_context* fuse_context,
+    const xtreemfs::pbrpc::UserCredentials& user_credentials,
+    FileHandle* file_handle) {
+  if (options_->qos_key != "pgid") {
+    return;
+  }
+
+  pid_t pid = fuse_context ? fuse_context->pid : getpid();
+  pid_t pgid = getpgid(pid);
+  // The process may have exited in the meantime.
+  if (pgid < 0) {
+    pgid = pid;
+  }
+  // The username prefix lets the key inherit the weight of the user.
+  file_handle->SetQoSKey(user_credentials.username() + ":"
+                         + boost::lexical_cast<string>(pgid));
+}
+
+void FuseAdapter::SetLowLevelRequest(fuse_req_t req) {
+  LowLevelRequest* request = current_low_level_request.get();
+  if (request == NULL) {
+    if (req == NULL) {
+      return;
+    }
+    request = new LowLevelRequest();
+    current_low_level_request.reset(request);
+  }
+
+  request->req = req;
+  if (req != NULL) {
+    const struct fuse_ctx* ctx = fuse_req_ctx(req);
+    memset(&request->context, 0, sizeof(request->context));
+    request->context.uid = ctx->uid;
+    request->context.gid = ctx->gid;
+    request->context.pid = ctx->pid;
+  }
+}
+
+bool FuseAdapter::IsXctlFile(const std::string& path) {
+  return xctl_.checkXctlFile(path);
+}
+
 void FuseAdapter::SetInterruptQueryFunction() const {
   options_->was_interrupted_function = &CheckIfOperationInterrupted;
 }
@@ -459,7 +536,7 @@ int FuseAdapter::ConvertXtreemFSErrnoToFuse(
 
 int FuseAdapter::statfs(const char *path, struct statvfs *statv) {
   UserCredentials user_credentials;
-  GenerateUserCredentials(fuse_get_context(), &user_credentials);
+  GenerateUserCredentials(GetFuseContext(), &user_credentials);
 
   try {
     boost::scoped_ptr<StatVFS> stat_vfs(
@@ -520,7 +597,7 @@ int FuseAdapter::getattr(const char *path, struct stat *statbuf) {
   if (!xctl_.checkXctlFile(path_str)) {
     Stat stat;
     UserCredentials user_credentials;
-    GenerateUserCredentials(fuse_get_context(), &user_credentials);
+    GenerateUserCredentials(GetFuseContext(), &user_credentials);
 
     try {
       volume_->GetAttr(user_credentials, path_str, &stat);
@@ -537,7 +614,7 @@ int FuseAdapter::getattr(const char *path, struct stat *statbuf) {
     ConvertXtreemFSStatToFuse(stat, statbuf);
     return 0;
   } else {
-    fuse_context* ctx = fuse_get_context();
+    fuse_context* ctx = GetFuseContext();
     return xctl_.getattr(ctx->uid, ctx->gid, path_str, statbuf);
   }
 }
@@ -560,7 +637,7 @@ int FuseAdapter::getxattr(
   }
 
   UserCredentials user_credentials;
-  GenerateUserCredentials(fuse_get_context(), &user_credentials);
+  GenerateUserCredentials(GetFuseContext(), &user_credentials);
 
   try {
     if (size == 0) {
@@ -608,7 +685,7 @@ int FuseAdapter::opendir(const char *path, struct fuse_file_info *fi) {
   // No default POSIX permissions: Check if it's allowed to enter the dir.
   if (!options_->use_fuse_permission_checks) {
     UserCredentials user_credentials;
-    GenerateUserCredentials(fuse_get_context(), &user_credentials);
+    GenerateUserCredentials(GetFuseContext(), &user_credentials);
 
     // TODO(mberlin): Wait for change of access method and check for X_OK.
     try {
@@ -689,7 +766,7 @@ int FuseAdapter::readdir(const char *path, void *buf, fuse_fill_dir_t filler,
   // Fetch entries from MRC.
   if (dir_entries == NULL) {
     UserCredentials user_credentials;
-    GenerateUserCredentials(fuse_get_context(), &user_credentials);
+    GenerateUserCredentials(GetFuseContext(), &user_credentials);
 
     try {
       // libxtreemfs itself may have cached the readdir response, too.
@@ -789,7 +866,7 @@ int FuseAdapter::utime(const char *path, struct utimbuf *ubuf) {
   Stat stat;
   InitializeStat(&stat);
   UserCredentials user_credentials;
-  GenerateUserCredentials(fuse_get_context(), &user_credentials);
+  GenerateUserCredentials(GetFuseContext(), &user_credentials);
 
   // Convert seconds to nanoseconds.
   if (ubuf != NULL) {
@@ -822,7 +899,7 @@ int FuseAdapter::utimens(const char *path, const struct timespec tv[2]) {
   Stat stat;
   InitializeStat(&stat);
   UserCredentials user_credentials;
-  GenerateUserCredentials(fuse_get_context(), &user_credentials);
+  GenerateUserCredentials(GetFuseContext(), &user_credentials);
 
   // Convert seconds to nanoseconds.
   if (tv != NULL) {
@@ -857,7 +934,7 @@ int FuseAdapter::utimens(const char *path, const struct timespec tv[2]) {
 int FuseAdapter::access(const char *path, int mask) {
   if (!options_->use_fuse_permission_checks) {
     UserCredentials user_credentials;
-    GenerateUserCredentials(fuse_get_context(), &user_credentials);
+    GenerateUserCredentials(GetFuseContext(), &user_credentials);
 
     try {
       volume_->Access(user_credentials,
@@ -892,8 +969,9 @@ int FuseAdapter::create(const char *path, mode_t mode,
     struct fuse_file_info *fi) {
   const string path_str(path);
   if (!xctl_.checkXctlFile(path_str)) {
+    fuse_context* ctx = GetFuseContext();
     UserCredentials user_credentials;
-    GenerateUserCredentials(fuse_get_context(), &user_credentials);
+    GenerateUserCredentials(ctx, &user_credentials);
 
     try {
       // Open FileHandle and register it in fuse_file_info.
@@ -902,6 +980,7 @@ int FuseAdapter::create(const char *path, mode_t mode,
           string(path),
           ConvertFlagsUnixToXtreemFS(fi->flags),
           mode);
+      SetQoSKey(ctx, user_credentials, file_handle);
       // @note The uint64_t cast is needed as Fuse does use a uint64_t instead of
       //       a void* to store a pointer.
       fi->fh = reinterpret_cast<uint64_t>(file_handle);
@@ -915,7 +994,7 @@ int FuseAdapter::create(const char *path, mode_t mode,
       return -1 * EIO;
     }
   } else {
-    fuse_context* ctx = fuse_get_context();
+    fuse_context* ctx = GetFuseContext();
     return xctl_.create(ctx->uid, ctx->gid, path_str);
   }
 
@@ -926,7 +1005,7 @@ int FuseAdapter::mknod(const char *path, mode_t mode, dev_t device) {
   const string path_str(path);
   if (!xctl_.checkXctlFile(path_str)) {
     UserCredentials user_credentials;
-    GenerateUserCredentials(fuse_get_context(), &user_credentials);
+    GenerateUserCredentials(GetFuseContext(), &user_credentials);
 
     try {
       // Open a temporary filehandle with O_CREAT and close it again.
@@ -947,7 +1026,7 @@ int FuseAdapter::mknod(const char *path, mode_t mode, dev_t device) {
       return -1 * EIO;
     }
   } else {
-    fuse_context* ctx = fuse_get_context();
+    fuse_context* ctx = GetFuseContext();
     return xctl_.create(ctx->uid, ctx->gid, path_str);
   }
 
@@ -956,7 +1035,7 @@ int FuseAdapter::mknod(const char *path, mode_t mode, dev_t device) {
 
 int FuseAdapter::mkdir(const char *path, mode_t mode) {
   UserCredentials user_credentials;
-  GenerateUserCredentials(fuse_get_context(), &user_credentials);
+  GenerateUserCredentials(GetFuseContext(), &user_credentials);
 
   try {
     volume_->MakeDirectory(user_credentials, string(path), mode);
@@ -987,8 +1066,9 @@ int FuseAdapter::open(const char *path, struct fuse_file_info *fi) {
     return 0;
   }
 
+  fuse_context* ctx = GetFuseContext();
   UserCredentials user_credentials;
-  GenerateUserCredentials(fuse_get_context(), &user_credentials);
+  GenerateUserCredentials(ctx, &user_credentials);
 
   try {
     // Open FileHandle and register it in fuse_file_info.
@@ -996,6 +1076,7 @@ int FuseAdapter::open(const char *path, struct fuse_file_info *fi) {
         user_credentials,
         path_str,
         ConvertFlagsUnixToXtreemFS(fi->flags));
+    SetQoSKey(ctx, user_credentials, file_handle);
     // @note The uint64_t cast is needed as Fuse does use a uint64_t instead of
     //       a void* to store a pointer.
     fi->fh = reinterpret_cast<uint64_t>(file_handle);
@@ -1014,7 +1095,7 @@ int FuseAdapter::open(const char *path, struct fuse_file_info *fi) {
 
 int FuseAdapter::truncate(const char *path, off_t new_file_size) {
   UserCredentials user_credentials;
-  GenerateUserCredentials(fuse_get_context(), &user_credentials);
+  GenerateUserCredentials(GetFuseContext(), &user_credentials);
 
   try {
     volume_->Truncate(user_credentials, string(path), new_file_size);
@@ -1037,7 +1118,7 @@ int FuseAdapter::ftruncate(const char *path,
   const string path_str(path);
   if (!xctl_.checkXctlFile(path_str)) {
     UserCredentials user_credentials;
-    GenerateUserCredentials(fuse_get_context(), &user_credentials);
+    GenerateUserCredentials(GetFuseContext(), &user_credentials);
 
     try {
       FileHandle* file_handle = reinterpret_cast<FileHandle*>(fi->fh);
@@ -1090,7 +1171,7 @@ int FuseAdapter::write(
 
     return result;
   } else {
-    fuse_context* ctx = fuse_get_context();
+    fuse_context* ctx = GetFuseContext();
     UserCredentials user_credentials;
     GenerateUserCredentials(ctx, &user_credentials);
 
@@ -1152,7 +1233,7 @@ int FuseAdapter::read(const char *path, char *buf, size_t size, off_t offset,
       return -1 * EIO;
     }
   } else {
-    fuse_context* ctx = fuse_get_context();
+    fuse_context* ctx = GetFuseContext();
     UserCredentials user_credentials;
     GenerateUserCredentials(ctx, &user_credentials);
 
@@ -1167,7 +1248,7 @@ int FuseAdapter::unlink(const char *path) {
 
   if (!xctl_.checkXctlFile(path_str)) {
     UserCredentials user_credentials;
-    GenerateUserCredentials(fuse_get_context(), &user_credentials);
+    GenerateUserCredentials(GetFuseContext(), &user_credentials);
 
     try {
       volume_->Unlink(user_credentials, path);
@@ -1183,7 +1264,7 @@ int FuseAdapter::unlink(const char *path) {
 
     return 0;
   } else {
-    fuse_context* ctx = fuse_get_context();
+    fuse_context* ctx = GetFuseContext();
     return xctl_.unlink(ctx->uid, ctx->gid, path_str);
   }
 }
@@ -1194,7 +1275,7 @@ int FuseAdapter::fgetattr(
   if (!xctl_.checkXctlFile(path_str)) {
     Stat stat;
     UserCredentials user_credentials;
-    GenerateUserCredentials(fuse_get_context(), &user_credentials);
+    GenerateUserCredentials(GetFuseContext(), &user_credentials);
 
     try {
       FileHandle* file_handle = reinterpret_cast<FileHandle*>(fi->fh);
@@ -1218,7 +1299,7 @@ int FuseAdapter::fgetattr(
     ConvertXtreemFSStatToFuse(stat, statbuf);
     return 0;
   } else {
-    fuse_context* ctx = fuse_get_context();
+    fuse_context* ctx = GetFuseContext();
     return xctl_.getattr(ctx->uid, ctx->gid, path_str, statbuf);
   }
 }
@@ -1236,7 +1317,7 @@ int FuseAdapter::release(const char *path, struct fuse_file_info *fi) {
 
     // Ensure POSIX semantics and release all locks of the filehandle's process.
     try {
-      file_handle->ReleaseLockOfProcess(fuse_get_context()->pid);
+      file_handle->ReleaseLockOfProcess(GetFuseContext()->pid);
     } catch(const XtreemFSException& e) {
       // We dont care if errors occurred.
     }
@@ -1262,7 +1343,7 @@ int FuseAdapter::release(const char *path, struct fuse_file_info *fi) {
 
 int FuseAdapter::readlink(const char *path, char *buf, size_t size) {
   UserCredentials user_credentials;
-  GenerateUserCredentials(fuse_get_context(), &user_credentials);
+  GenerateUserCredentials(GetFuseContext(), &user_credentials);
 
   try {
     string target_path = "";
@@ -1286,7 +1367,7 @@ int FuseAdapter::readlink(const char *path, char *buf, size_t size) {
 
 int FuseAdapter::rmdir(const char *path) {
   UserCredentials user_credentials;
-  GenerateUserCredentials(fuse_get_context(), &user_credentials);
+  GenerateUserCredentials(GetFuseContext(), &user_credentials);
 
   try {
     volume_->DeleteDirectory(user_credentials, string(path));
@@ -1305,7 +1386,7 @@ int FuseAdapter::rmdir(const char *path) {
 
 int FuseAdapter::symlink(const char *path, const char *link) {
   UserCredentials user_credentials;
-  GenerateUserCredentials(fuse_get_context(), &user_credentials);
+  GenerateUserCredentials(GetFuseContext(), &user_credentials);
 
   try {
     volume_->Symlink(user_credentials, string(path), string(link));
@@ -1324,7 +1405,7 @@ int FuseAdapter::symlink(const char *path, const char *link) {
 
 int FuseAdapter::rename(const char *path, const char *newpath) {
   UserCredentials user_credentials;
-  GenerateUserCredentials(fuse_get_context(), &user_credentials);
+  GenerateUserCredentials(GetFuseContext(), &user_credentials);
 
   try {
     volume_->Rename(user_credentials, string(path), string(newpath));
@@ -1343,7 +1424,7 @@ int FuseAdapter::rename(const char *path, const char *newpath) {
 
 int FuseAdapter::link(const char *path, const char *newpath) {
   UserCredentials user_credentials;
-  GenerateUserCredentials(fuse_get_context(), &user_credentials);
+  GenerateUserCredentials(GetFuseContext(), &user_credentials);
 
   try {
     volume_->Link(user_credentials, string(path), string(newpath));
@@ -1362,7 +1443,7 @@ int FuseAdapter::link(const char *path, const char *newpath) {
 
 int FuseAdapter::chmod(const char *path, mode_t mode) {
   UserCredentials user_credentials;
-  GenerateUserCredentials(fuse_get_context(), &user_credentials);
+  GenerateUserCredentials(GetFuseContext(), &user_credentials);
 
   Stat stat;
   InitializeStat(&stat);
@@ -1386,7 +1467,7 @@ int FuseAdapter::chmod(const char *path, mode_t mode) {
 
 int FuseAdapter::chown(const char *path, uid_t uid, gid_t gid) {
   UserCredentials user_credentials;
-  GenerateUserCredentials(fuse_get_context(), &user_credentials);
+  GenerateUserCredentials(GetFuseContext(), &user_credentials);
 
   Setattrs to_set = static_cast<Setattrs>(0);
   if (uid != static_cast<uid_t>(-1)) {
@@ -1440,7 +1521,7 @@ int FuseAdapter::setxattr(
   }
 
   UserCredentials user_credentials;
-  GenerateUserCredentials(fuse_get_context(), &user_credentials);
+  GenerateUserCredentials(GetFuseContext(), &user_credentials);
 
   // Ignore system attributes to avoid warnings while copying files (e.g. on OS X)
   if (string(name) == string("xtreemfs.file_id") ||
@@ -1505,7 +1586,7 @@ int FuseAdapter::setxattr(
 
 int FuseAdapter::listxattr(const char *path, char *list, size_t size) {
   UserCredentials user_credentials;
-  GenerateUserCredentials(fuse_get_context(), &user_credentials);
+  GenerateUserCredentials(GetFuseContext(), &user_credentials);
 
   try {
     boost::scoped_ptr<listxattrResponse> xattrs(
@@ -1555,7 +1636,7 @@ int FuseAdapter::removexattr(const char *path, const char *name) {
   }
 
   UserCredentials user_credentials;
-  GenerateUserCredentials(fuse_get_context(), &user_credentials);
+  GenerateUserCredentials(GetFuseContext(), &user_credentials);
 
   try {
     volume_->RemoveXAttr(user_credentials, path, string(name));
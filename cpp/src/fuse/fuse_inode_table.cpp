@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2026 by the XtreemFS Authors, see AUTHORS file
+ *
+ * Licensed under the BSD License, see LICENSE file for details.
+ *
+ */
+
+#include "fuse/fuse_inode_table.h"
+
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace xtreemfs {
+
+const uint64_t FuseInodeTable::kRootInode;
+
+FuseInodeTable::FuseInodeTable()
+    : next_xctl_ino_(static_cast<uint64_t>(1) << 63) {
+  // The kernel knows the root without a lookup and never forgets it.
+  inodes_[kRootInode].nlookup = 1;
+}
+
+bool FuseInodeTable::GetPath(uint64_t ino, std::string* path) {
+  boost::mutex::scoped_lock lock(mutex_);
+  vector<const string*> components;
+  while (ino != kRootInode) {
+    map<uint64_t, InodeEntry>::const_iterator it = inodes_.find(ino);
+    // Parents cannot be their own descendants, so a longer chain is broken.
+    if (it == inodes_.end()
+        || it->second.names.empty()
+        || components.size() >= inodes_.size()) {
+      return false;
+    }
+    // Hard links share the inode. Any of their names will do.
+    const Name& name = *it->second.names.begin();
+    components.push_back(&name.second);
+    ino = name.first;
+  }
+
+  if (components.empty()) {
+    *path = "/";
+    return true;
+  }
+  path->clear();
+  for (vector<const string*>::reverse_iterator it = components.rbegin();
+       it != components.rend();
+       ++it) {
+    *path += "/";
+    *path += **it;
+  }
+  return true;
+}
+
+uint64_t FuseInodeTable::AddLookup(uint64_t parent,
+                                   const std::string& name,
+                                   uint64_t file_id,
+                                   bool is_xctl_file) {
+  const Name entry_name(parent, name);
+  boost::mutex::scoped_lock lock(mutex_);
+  uint64_t ino = file_id;
+  if (is_xctl_file) {
+    map<Name, uint64_t>::const_iterator it = xctl_inodes_.find(entry_name);
+    if (it == xctl_inodes_.end()) {
+      ino = next_xctl_ino_++;
+      xctl_inodes_[entry_name] = ino;
+    } else {
+      ino = it->second;
+    }
+  }
+
+  AddNameUnmutexed(ino, entry_name);
+  inodes_[ino].nlookup++;
+  return ino;
+}
+
+void FuseInodeTable::Forget(uint64_t ino, uint64_t nlookup) {
+  boost::mutex::scoped_lock lock(mutex_);
+  map<uint64_t, InodeEntry>::iterator it = inodes_.find(ino);
+  if (it == inodes_.end()) {
+    return;
+  }
+  if (it->second.nlookup > nlookup) {
+    it->second.nlookup -= nlookup;
+    return;
+  }
+  if (ino == kRootInode) {
+    return;
+  }
+
+  for (set<Name>::const_iterator name = it->second.names.begin();
+       name != it->second.names.end();
+       ++name) {
+    names_.erase(*name);
+    map<Name, uint64_t>::iterator xctl = xctl_inodes_.find(*name);
+    if (xctl != xctl_inodes_.end() && xctl->second == ino) {
+      xctl_inodes_.erase(xctl);
+    }
+  }
+  inodes_.erase(it);
+}
+
+void FuseInodeTable::RemoveName(uint64_t parent, const std::string& name) {
+  boost::mutex::scoped_lock lock(mutex_);
+  RemoveNameUnmutexed(Name(parent, name));
+}
+
+void FuseInodeTable::Rename(uint64_t parent,
+                            const std::string& name,
+                            uint64_t new_parent,
+                            const std::string& new_name) {
+  const Name old_entry_name(parent, name);
+  const Name new_entry_name(new_parent, new_name);
+  boost::mutex::scoped_lock lock(mutex_);
+  map<Name, uint64_t>::const_iterator it = names_.find(old_entry_name);
+  if (it == names_.end()) {
+    // The kernel does not know the renamed file, but maybe the replaced one.
+    RemoveNameUnmutexed(new_entry_name);
+    return;
+  }
+  const uint64_t ino = it->second;
+  RemoveNameUnmutexed(old_entry_name);
+  AddNameUnmutexed(ino, new_entry_name);
+}
+
+void FuseInodeTable::AddNameUnmutexed(uint64_t ino, const Name& name) {
+  map<Name, uint64_t>::const_iterator it = names_.find(name);
+  if (it != names_.end() && it->second == ino) {
+    return;
+  }
+  // The entry was replaced, e.g. by another client.
+  RemoveNameUnmutexed(name);
+  names_[name] = ino;
+  inodes_[ino].names.insert(name);
+}
+
+void FuseInodeTable::RemoveNameUnmutexed(const Name& name) {
+  map<Name, uint64_t>::iterator it = names_.find(name);
+  if (it == names_.end()) {
+    return;
+  }
+  map<uint64_t, InodeEntry>::iterator inode = inodes_.find(it->second);
+  if (inode != inodes_.end()) {
+    inode->second.names.erase(name);
+  }
+  names_.erase(it);
+}
+
+}  // namespace xtreemfs
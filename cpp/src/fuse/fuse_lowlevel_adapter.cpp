@@ -0,0 +1,734 @@
+/*
+ * Copyright (c) 2026 by the XtreemFS Authors, see AUTHORS file
+ *
+ * Licensed under the BSD License, see LICENSE file for details.
+ *
+ */
+
+#include "fuse/fuse_lowlevel_adapter.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <sys/stat.h>
+#include <sys/statvfs.h>
+#include <time.h>
+
+#include <boost/scoped_array.hpp>
+#include <cstring>
+#include <string>
+
+#include "fuse/fuse_adapter.h"
+#include "fuse/fuse_options.h"
+
+using namespace std;
+
+namespace xtreemfs {
+
+namespace {
+
+/** Makes the FuseAdapter operations of the current thread use "req". */
+class ScopedLowLevelRequest {
+ public:
+  explicit ScopedLowLevelRequest(fuse_req_t req) {
+    FuseAdapter::SetLowLevelRequest(req);
+  }
+
+  ~ScopedLowLevelRequest() {
+    FuseAdapter::SetLowLevelRequest(NULL);
+  }
+};
+
+/** Reply buffer of a readdir request. */
+struct DirectoryBuffer {
+  DirectoryBuffer(fuse_req_t req, size_t size)
+      : req(req), data(new char[size]), size(size), used(0) {}
+
+  fuse_req_t req;
+  boost::scoped_array<char> data;
+  size_t size;
+  size_t used;
+};
+
+/** fuse_fill_dir_t which adds the entries to a DirectoryBuffer. Returns 1 if
+ *  the buffer is full. */
+int FillDirectoryBuffer(void* buf,
+                        const char* name,
+                        const struct stat* stbuf,
+                        off_t off) {
+  DirectoryBuffer* buffer = static_cast<DirectoryBuffer*>(buf);
+  size_t entry_size = fuse_add_direntry(buffer->req, NULL, 0, name, NULL, 0);
+  if (buffer->used + entry_size > buffer->size) {
+    return 1;
+  }
+
+  // Only st_ino and st_mode are used, but the stat is required.
+  struct stat empty_stat;
+  if (stbuf == NULL) {
+    memset(&empty_stat, 0, sizeof(empty_stat));
+    stbuf = &empty_stat;
+  }
+  fuse_add_direntry(buffer->req,
+                    buffer->data.get() + buffer->used,
+                    buffer->size - buffer->used,
+                    name,
+                    stbuf,
+                    off);
+  buffer->used += entry_size;
+  return 0;
+}
+
+/** Sets the access and modification times of "path" as requested by the
+ *  FUSE_SET_ATTR_* flags "to_set". A time which is not set is preserved. */
+int SetTimes(FuseAdapter* fuse_adapter,
+             const string& path,
+             const struct stat* attr,
+             int to_set) {
+  struct stat current;
+  int result = fuse_adapter->getattr(path.c_str(), &current);
+  if (result < 0) {
+    return result;
+  }
+
+  struct timespec tv[2];
+#ifdef __APPLE__
+  tv[0] = (to_set & FUSE_SET_ATTR_ATIME) ? attr->st_atimespec
+                                         : current.st_atimespec;
+  tv[1] = (to_set & FUSE_SET_ATTR_MTIME) ? attr->st_mtimespec
+                                         : current.st_mtimespec;
+#else
+  tv[0] = (to_set & FUSE_SET_ATTR_ATIME) ? attr->st_atim : current.st_atim;
+  tv[1] = (to_set & FUSE_SET_ATTR_MTIME) ? attr->st_mtim : current.st_mtim;
+#endif  // __APPLE__
+#ifdef FUSE_SET_ATTR_ATIME_NOW
+  // Like FuseAdapter::utimens() without times, use the current time.
+  if (to_set & FUSE_SET_ATTR_ATIME_NOW) {
+    tv[0].tv_sec = time(NULL);
+    tv[0].tv_nsec = 0;
+  }
+  if (to_set & FUSE_SET_ATTR_MTIME_NOW) {
+    tv[1].tv_sec = time(NULL);
+    tv[1].tv_nsec = 0;
+  }
+#endif  // FUSE_SET_ATTR_ATIME_NOW
+  return fuse_adapter->utimens(path.c_str(), tv);
+}
+
+}  // namespace
+
+FuseLowLevelAdapter::FuseLowLevelAdapter(FuseAdapter* fuse_adapter,
+                                         FuseOptions* options)
+    : fuse_adapter_(fuse_adapter),
+      options_(options) {}
+
+void FuseLowLevelAdapter::init(struct fuse_conn_info* conn) {
+  // Same settings as xtreemfs_fuse_init() of the high-level API.
+  conn->async_read = 5;
+  conn->max_readahead = 10 * 128 * 1024;
+  conn->max_write = 128 * 1024;
+
+#if FUSE_MAJOR_VERSION > 2 || (FUSE_MAJOR_VERSION == 2 && FUSE_MINOR_VERSION >= 8)  // NOLINT
+  conn->capable
+    = FUSE_CAP_ASYNC_READ | FUSE_CAP_BIG_WRITES
+      | FUSE_CAP_ATOMIC_O_TRUNC | FUSE_CAP_POSIX_LOCKS;
+  conn->want
+    = FUSE_CAP_ASYNC_READ | FUSE_CAP_BIG_WRITES
+      | FUSE_CAP_ATOMIC_O_TRUNC | FUSE_CAP_POSIX_LOCKS;
+#endif
+}
+
+void FuseLowLevelAdapter::lookup(fuse_req_t req,
+                                 fuse_ino_t parent,
+                                 const char* name) {
+  ScopedLowLevelRequest scoped_request(req);
+  string path;
+  if (!GetChildPath(parent, name, &path)) {
+    fuse_reply_err(req, ESTALE);
+    return;
+  }
+  ReplyEntry(req, parent, name, path, NULL);
+}
+
+void FuseLowLevelAdapter::forget(fuse_req_t req,
+                                 fuse_ino_t ino,
+                                 unsigned long nlookup) {
+  inodes_.Forget(ino, nlookup);
+  fuse_reply_none(req);
+}
+
+void FuseLowLevelAdapter::getattr(fuse_req_t req,
+                                  fuse_ino_t ino,
+                                  struct fuse_file_info* fi) {
+  ScopedLowLevelRequest scoped_request(req);
+  string path;
+  // Open files stay accessible after their last name was removed.
+  if (!GetPath(ino, &path) && fi == NULL) {
+    fuse_reply_err(req, ESTALE);
+    return;
+  }
+  ReplyAttr(req, ino, path, fi);
+}
+
+void FuseLowLevelAdapter::setattr(fuse_req_t req,
+                                  fuse_ino_t ino,
+                                  struct stat* attr,
+                                  int to_set,
+                                  struct fuse_file_info* fi) {
+  ScopedLowLevelRequest scoped_request(req);
+  string path;
+  if (!GetPath(ino, &path)) {
+    fuse_reply_err(req, ESTALE);
+    return;
+  }
+
+  int result = 0;
+  if (to_set & FUSE_SET_ATTR_MODE) {
+    result = fuse_adapter_->chmod(path.c_str(), attr->st_mode);
+  }
+  if (result == 0 && (to_set & (FUSE_SET_ATTR_UID | FUSE_SET_ATTR_GID))) {
+    result = fuse_adapter_->chown(
+        path.c_str(),
+        (to_set & FUSE_SET_ATTR_UID) ? attr->st_uid : static_cast<uid_t>(-1),
+        (to_set & FUSE_SET_ATTR_GID) ? attr->st_gid : static_cast<gid_t>(-1));
+  }
+  if (result == 0 && (to_set & FUSE_SET_ATTR_SIZE)) {
+    result = fi ? fuse_adapter_->ftruncate(path.c_str(), attr->st_size, fi)
+                : fuse_adapter_->truncate(path.c_str(), attr->st_size);
+  }
+  int times = FUSE_SET_ATTR_ATIME | FUSE_SET_ATTR_MTIME;
+#ifdef FUSE_SET_ATTR_ATIME_NOW
+  times |= FUSE_SET_ATTR_ATIME_NOW | FUSE_SET_ATTR_MTIME_NOW;
+#endif  // FUSE_SET_ATTR_ATIME_NOW
+  if (result == 0 && (to_set & times)) {
+    result = SetTimes(fuse_adapter_, path, attr, to_set);
+  }
+
+  if (result < 0) {
+    fuse_reply_err(req, -result);
+    return;
+  }
+  ReplyAttr(req, ino, path, fi);
+}
+
+void FuseLowLevelAdapter::readlink(fuse_req_t req, fuse_ino_t ino) {
+  ScopedLowLevelRequest scoped_request(req);
+  string path;
+  if (!GetPath(ino, &path)) {
+    fuse_reply_err(req, ESTALE);
+    return;
+  }
+
+  char target[PATH_MAX + 1];
+  int result = fuse_adapter_->readlink(path.c_str(), target, sizeof(target));
+  if (result < 0) {
+    fuse_reply_err(req, -result);
+    return;
+  }
+  fuse_reply_readlink(req, target);
+}
+
+void FuseLowLevelAdapter::mknod(fuse_req_t req,
+                                fuse_ino_t parent,
+                                const char* name,
+                                mode_t mode,
+                                dev_t rdev) {
+  ScopedLowLevelRequest scoped_request(req);
+  string path;
+  if (!GetChildPath(parent, name, &path)) {
+    fuse_reply_err(req, ESTALE);
+    return;
+  }
+
+  int result = fuse_adapter_->mknod(path.c_str(), mode, rdev);
+  if (result < 0) {
+    fuse_reply_err(req, -result);
+    return;
+  }
+  ReplyEntry(req, parent, name, path, NULL);
+}
+
+void FuseLowLevelAdapter::mkdir(fuse_req_t req,
+                                fuse_ino_t parent,
+                                const char* name,
+                                mode_t mode) {
+  ScopedLowLevelRequest scoped_request(req);
+  string path;
+  if (!GetChildPath(parent, name, &path)) {
+    fuse_reply_err(req, ESTALE);
+    return;
+  }
+
+  int result = fuse_adapter_->mkdir(path.c_str(), mode);
+  if (result < 0) {
+    fuse_reply_err(req, -result);
+    return;
+  }
+  ReplyEntry(req, parent, name, path, NULL);
+}
+
+void FuseLowLevelAdapter::unlink(fuse_req_t req,
+                                 fuse_ino_t parent,
+                                 const char* name) {
+  ScopedLowLevelRequest scoped_request(req);
+  string path;
+  if (!GetChildPath(parent, name, &path)) {
+    fuse_reply_err(req, ESTALE);
+    return;
+  }
+  int result = fuse_adapter_->unlink(path.c_str());
+  if (result == 0) {
+    inodes_.RemoveName(parent, name);
+  }
+  fuse_reply_err(req, -result);
+}
+
+void FuseLowLevelAdapter::rmdir(fuse_req_t req,
+                                fuse_ino_t parent,
+                                const char* name) {
+  ScopedLowLevelRequest scoped_request(req);
+  string path;
+  if (!GetChildPath(parent, name, &path)) {
+    fuse_reply_err(req, ESTALE);
+    return;
+  }
+  int result = fuse_adapter_->rmdir(path.c_str());
+  if (result == 0) {
+    inodes_.RemoveName(parent, name);
+  }
+  fuse_reply_err(req, -result);
+}
+
+void FuseLowLevelAdapter::symlink(fuse_req_t req,
+                                  const char* link,
+                                  fuse_ino_t parent,
+                                  const char* name) {
+  ScopedLowLevelRequest scoped_request(req);
+  string path;
+  if (!GetChildPath(parent, name, &path)) {
+    fuse_reply_err(req, ESTALE);
+    return;
+  }
+
+  int result = fuse_adapter_->symlink(link, path.c_str());
+  if (result < 0) {
+    fuse_reply_err(req, -result);
+    return;
+  }
+  ReplyEntry(req, parent, name, path, NULL);
+}
+
+void FuseLowLevelAdapter::rename(fuse_req_t req,
+                                 fuse_ino_t parent,
+                                 const char* name,
+                                 fuse_ino_t newparent,
+                                 const char* newname) {
+  ScopedLowLevelRequest scoped_request(req);
+  string path;
+  string new_path;
+  if (!GetChildPath(parent, name, &path)
+      || !GetChildPath(newparent, newname, &new_path)) {
+    fuse_reply_err(req, ESTALE);
+    return;
+  }
+
+  int result = fuse_adapter_->rename(path.c_str(), new_path.c_str());
+  if (result == 0) {
+    inodes_.Rename(parent, name, newparent, newname);
+  }
+  fuse_reply_err(req, -result);
+}
+
+void FuseLowLevelAdapter::link(fuse_req_t req,
+                               fuse_ino_t ino,
+                               fuse_ino_t newparent,
+                               const char* newname) {
+  ScopedLowLevelRequest scoped_request(req);
+  string path;
+  string new_path;
+  if (!GetPath(ino, &path) || !GetChildPath(newparent, newname, &new_path)) {
+    fuse_reply_err(req, ESTALE);
+    return;
+  }
+
+  int result = fuse_adapter_->link(path.c_str(), new_path.c_str());
+  if (result < 0) {
+    fuse_reply_err(req, -result);
+    return;
+  }
+  ReplyEntry(req, newparent, newname, new_path, NULL);
+}
+
+void FuseLowLevelAdapter::open(fuse_req_t req,
+                               fuse_ino_t ino,
+                               struct fuse_file_info* fi) {
+  ScopedLowLevelRequest scoped_request(req);
+  string path;
+  if (!GetPath(ino, &path)) {
+    fuse_reply_err(req, ESTALE);
+    return;
+  }
+
+  int result = fuse_adapter_->open(path.c_str(), fi);
+  if (result < 0) {
+    fuse_reply_err(req, -result);
+    return;
+  }
+  // The kernel does not call release() if the open was interrupted.
+  if (fuse_reply_open(req, fi) != 0) {
+    fuse_adapter_->release(path.c_str(), fi);
+  }
+}
+
+void FuseLowLevelAdapter::read(fuse_req_t req,
+                               fuse_ino_t ino,
+                               size_t size,
+                               off_t off,
+                               struct fuse_file_info* fi) {
+  ScopedLowLevelRequest scoped_request(req);
+  string path;
+  // Open files stay accessible after their last name was removed.
+  GetPath(ino, &path);
+
+  boost::scoped_array<char> buf(new char[size]);
+  int result = fuse_adapter_->read(path.c_str(), buf.get(), size, off, fi);
+  if (result < 0) {
+    fuse_reply_err(req, -result);
+    return;
+  }
+  fuse_reply_buf(req, buf.get(), result);
+}
+
+void FuseLowLevelAdapter::write(fuse_req_t req,
+                                fuse_ino_t ino,
+                                const char* buf,
+                                size_t size,
+                                off_t off,
+                                struct fuse_file_info* fi) {
+  ScopedLowLevelRequest scoped_request(req);
+  string path;
+  // Open files stay accessible after their last name was removed.
+  GetPath(ino, &path);
+
+  int result = fuse_adapter_->write(path.c_str(), buf, size, off, fi);
+  if (result < 0) {
+    fuse_reply_err(req, -result);
+    return;
+  }
+  fuse_reply_write(req, result);
+}
+
+void FuseLowLevelAdapter::flush(fuse_req_t req,
+                                fuse_ino_t ino,
+                                struct fuse_file_info* fi) {
+  ScopedLowLevelRequest scoped_request(req);
+  string path;
+  // Open files stay accessible after their last name was removed.
+  GetPath(ino, &path);
+  fuse_reply_err(req, -fuse_adapter_->flush(path.c_str(), fi));
+}
+
+void FuseLowLevelAdapter::release(fuse_req_t req,
+                                  fuse_ino_t ino,
+                                  struct fuse_file_info* fi) {
+  ScopedLowLevelRequest scoped_request(req);
+  string path;
+  // The file handle has to be closed even if the path is unknown.
+  GetPath(ino, &path);
+  fuse_reply_err(req, -fuse_adapter_->release(path.c_str(), fi));
+}
+
+void FuseLowLevelAdapter::fsync(fuse_req_t req,
+                                fuse_ino_t ino,
+                                int datasync,
+                                struct fuse_file_info* fi) {
+  // We ignore the datasync parameter as all metadata operations are
+  // synchronous and therefore never have to be flushed.
+  flush(req, ino, fi);
+}
+
+void FuseLowLevelAdapter::opendir(fuse_req_t req,
+                                  fuse_ino_t ino,
+                                  struct fuse_file_info* fi) {
+  ScopedLowLevelRequest scoped_request(req);
+  string path;
+  if (!GetPath(ino, &path)) {
+    fuse_reply_err(req, ESTALE);
+    return;
+  }
+
+  int result = fuse_adapter_->opendir(path.c_str(), fi);
+  if (result < 0) {
+    fuse_reply_err(req, -result);
+    return;
+  }
+  if (fuse_reply_open(req, fi) != 0) {
+    fuse_adapter_->releasedir(path.c_str(), fi);
+  }
+}
+
+void FuseLowLevelAdapter::readdir(fuse_req_t req,
+                                  fuse_ino_t ino,
+                                  size_t size,
+                                  off_t off,
+                                  struct fuse_file_info* fi) {
+  ScopedLowLevelRequest scoped_request(req);
+  string path;
+  if (!GetPath(ino, &path)) {
+    fuse_reply_err(req, ESTALE);
+    return;
+  }
+
+  DirectoryBuffer buffer(req, size);
+  int result = fuse_adapter_->readdir(path.c_str(),
+                                      &buffer,
+                                      &FillDirectoryBuffer,
+                                      off,
+                                      fi);
+  if (result < 0) {
+    fuse_reply_err(req, -result);
+    return;
+  }
+  fuse_reply_buf(req, buffer.data.get(), buffer.used);
+}
+
+void FuseLowLevelAdapter::releasedir(fuse_req_t req,
+                                     fuse_ino_t ino,
+                                     struct fuse_file_info* fi) {
+  ScopedLowLevelRequest scoped_request(req);
+  string path;
+  GetPath(ino, &path);
+  fuse_reply_err(req, -fuse_adapter_->releasedir(path.c_str(), fi));
+}
+
+void FuseLowLevelAdapter::statfs(fuse_req_t req, fuse_ino_t ino) {
+  ScopedLowLevelRequest scoped_request(req);
+  string path;
+  if (!GetPath(ino, &path)) {
+    path = "/";
+  }
+
+  struct statvfs statv;
+  memset(&statv, 0, sizeof(statv));
+  int result = fuse_adapter_->statfs(path.c_str(), &statv);
+  if (result < 0) {
+    fuse_reply_err(req, -result);
+    return;
+  }
+  fuse_reply_statfs(req, &statv);
+}
+
+void FuseLowLevelAdapter::setxattr(fuse_req_t req,
+                                   fuse_ino_t ino,
+                                   const char* name,
+                                   const char* value,
+                                   size_t size,
+                                   int flags) {
+  ScopedLowLevelRequest scoped_request(req);
+  string path;
+  if (!GetPath(ino, &path)) {
+    fuse_reply_err(req, ESTALE);
+    return;
+  }
+  fuse_reply_err(
+      req, -fuse_adapter_->setxattr(path.c_str(), name, value, size, flags));
+}
+
+void FuseLowLevelAdapter::getxattr(fuse_req_t req,
+                                   fuse_ino_t ino,
+                                   const char* name,
+                                   size_t size) {
+  ScopedLowLevelRequest scoped_request(req);
+  string path;
+  if (!GetPath(ino, &path)) {
+    fuse_reply_err(req, ESTALE);
+    return;
+  }
+
+  boost::scoped_array<char> value(size > 0 ? new char[size] : NULL);
+  int result = fuse_adapter_->getxattr(path.c_str(), name, value.get(), size);
+  if (result < 0) {
+    fuse_reply_err(req, -result);
+  } else if (size == 0) {
+    fuse_reply_xattr(req, result);
+  } else {
+    fuse_reply_buf(req, value.get(), result);
+  }
+}
+
+void FuseLowLevelAdapter::listxattr(fuse_req_t req,
+                                    fuse_ino_t ino,
+                                    size_t size) {
+  ScopedLowLevelRequest scoped_request(req);
+  string path;
+  if (!GetPath(ino, &path)) {
+    fuse_reply_err(req, ESTALE);
+    return;
+  }
+
+  boost::scoped_array<char> list(size > 0 ? new char[size] : NULL);
+  int result = fuse_adapter_->listxattr(path.c_str(), list.get(), size);
+  if (result < 0) {
+    fuse_reply_err(req, -result);
+  } else if (size == 0) {
+    fuse_reply_xattr(req, result);
+  } else {
+    fuse_reply_buf(req, list.get(), result);
+  }
+}
+
+void FuseLowLevelAdapter::removexattr(fuse_req_t req,
+                                      fuse_ino_t ino,
+                                      const char* name) {
+  ScopedLowLevelRequest scoped_request(req);
+  string path;
+  if (!GetPath(ino, &path)) {
+    fuse_reply_err(req, ESTALE);
+    return;
+  }
+  fuse_reply_err(req, -fuse_adapter_->removexattr(path.c_str(), name));
+}
+
+void FuseLowLevelAdapter::access(fuse_req_t req, fuse_ino_t ino, int mask) {
+  ScopedLowLevelRequest scoped_request(req);
+  string path;
+  if (!GetPath(ino, &path)) {
+    fuse_reply_err(req, ESTALE);
+    return;
+  }
+  fuse_reply_err(req, -fuse_adapter_->access(path.c_str(), mask));
+}
+
+void FuseLowLevelAdapter::create(fuse_req_t req,
+                                 fuse_ino_t parent,
+                                 const char* name,
+                                 mode_t mode,
+                                 struct fuse_file_info* fi) {
+  ScopedLowLevelRequest scoped_request(req);
+  string path;
+  if (!GetChildPath(parent, name, &path)) {
+    fuse_reply_err(req, ESTALE);
+    return;
+  }
+
+  int result = fuse_adapter_->create(path.c_str(), mode, fi);
+  if (result < 0) {
+    fuse_reply_err(req, -result);
+    return;
+  }
+  ReplyEntry(req, parent, name, path, fi);
+}
+
+void FuseLowLevelAdapter::getlk(fuse_req_t req,
+                                fuse_ino_t ino,
+                                struct fuse_file_info* fi,
+                                struct flock* lock) {
+  ScopedLowLevelRequest scoped_request(req);
+  string path;
+  if (!GetPath(ino, &path)) {
+    fuse_reply_err(req, ESTALE);
+    return;
+  }
+
+  int result = fuse_adapter_->lock(path.c_str(), fi, F_GETLK, lock);
+  if (result < 0) {
+    fuse_reply_err(req, -result);
+    return;
+  }
+  fuse_reply_lock(req, lock);
+}
+
+void FuseLowLevelAdapter::setlk(fuse_req_t req,
+                                fuse_ino_t ino,
+                                struct fuse_file_info* fi,
+                                struct flock* lock,
+                                int sleep) {
+  ScopedLowLevelRequest scoped_request(req);
+  string path;
+  if (!GetPath(ino, &path)) {
+    fuse_reply_err(req, ESTALE);
+    return;
+  }
+  fuse_reply_err(req, -fuse_adapter_->lock(path.c_str(),
+                                           fi,
+                                           sleep ? F_SETLKW : F_SETLK,
+                                           lock));
+}
+
+bool FuseLowLevelAdapter::GetPath(fuse_ino_t ino, std::string* path) {
+  return inodes_.GetPath(ino, path);
+}
+
+bool FuseLowLevelAdapter::GetChildPath(fuse_ino_t parent,
+                                       const char* name,
+                                       std::string* path) {
+  if (!GetPath(parent, path)) {
+    return false;
+  }
+  if (*path != "/") {
+    *path += "/";
+  }
+  *path += name;
+  return true;
+}
+
+void FuseLowLevelAdapter::ReplyEntry(fuse_req_t req,
+                                     fuse_ino_t parent,
+                                     const char* name,
+                                     const std::string& path,
+                                     struct fuse_file_info* fi) {
+  struct fuse_entry_param entry;
+  memset(&entry, 0, sizeof(entry));
+  int result = fi ? fuse_adapter_->fgetattr(path.c_str(), &entry.attr, fi)
+                  : fuse_adapter_->getattr(path.c_str(), &entry.attr);
+  if (result < 0) {
+    if (fi) {
+      fuse_adapter_->release(path.c_str(), fi);
+    }
+    fuse_reply_err(req, -result);
+    return;
+  }
+
+  entry.ino = inodes_.AddLookup(parent,
+                                name,
+                                entry.attr.st_ino,
+                                fuse_adapter_->IsXctlFile(path));
+  entry.attr.st_ino = entry.ino;
+  entry.attr_timeout = GetTimeout();
+  entry.entry_timeout = GetTimeout();
+
+  int reply_result = fi ? fuse_reply_create(req, &entry, fi)
+                        : fuse_reply_entry(req, &entry);
+  // The request was interrupted and the kernel did not get the entry.
+  if (reply_result != 0) {
+    if (fi) {
+      fuse_adapter_->release(path.c_str(), fi);
+    }
+    inodes_.Forget(entry.ino, 1);
+  }
+}
+
+void FuseLowLevelAdapter::ReplyAttr(fuse_req_t req,
+                                    fuse_ino_t ino,
+                                    const std::string& path,
+                                    struct fuse_file_info* fi) {
+  struct stat attr;
+  memset(&attr, 0, sizeof(attr));
+  int result = fi ? fuse_adapter_->fgetattr(path.c_str(), &attr, fi)
+                  : fuse_adapter_->getattr(path.c_str(), &attr);
+  if (result < 0) {
+    fuse_reply_err(req, -result);
+    return;
+  }
+  attr.st_ino = ino;
+  fuse_reply_attr(req, &attr, GetTimeout());
+}
+
+double FuseLowLevelAdapter::GetTimeout() const {
+  // Without the metadata cache every operation shall reach the MRC.
+  if (options_->metadata_cache_size == 0) {
+    return 0;
+  }
+  return static_cast<double>(options_->metadata_cache_ttl_s);
+}
+
+}  // namespace xtreemfs
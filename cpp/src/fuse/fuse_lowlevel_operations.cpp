@@ -0,0 +1,388 @@
+/*
+ * Copyright (c) 2026 by the XtreemFS Authors, see AUTHORS file
+ *
+ * Licensed under the BSD License, see LICENSE file for details.
+ *
+ */
+
+#include "fuse/fuse_lowlevel_operations.h"
+
+#include "fuse/fuse_lowlevel_adapter.h"
+#include "util/logging.h"
+
+using namespace std;
+using namespace xtreemfs::util;
+
+xtreemfs::FuseLowLevelAdapter* fuse_lowlevel_adapter = NULL;
+
+void xtreemfs_fuse_ll_init(void* userdata, struct fuse_conn_info* conn) {
+  if (Logging::log->loggingActive(LEVEL_DEBUG)) {
+    Logging::log->getLog(LEVEL_DEBUG) << "xtreemfs_fuse_ll_init" << endl;
+  }
+  fuse_lowlevel_adapter->init(conn);
+}
+
+void xtreemfs_fuse_ll_destroy(void* userdata) {
+  if (Logging::log->loggingActive(LEVEL_DEBUG)) {
+    Logging::log->getLog(LEVEL_DEBUG) << "xtreemfs_fuse_ll_destroy" << endl;
+  }
+}
+
+void xtreemfs_fuse_ll_lookup(
+    fuse_req_t req,
+    fuse_ino_t parent,
+    const char* name) {
+  if (Logging::log->loggingActive(LEVEL_DEBUG)) {
+    Logging::log->getLog(LEVEL_DEBUG)
+        << "xtreemfs_fuse_ll_lookup of " << name << " in " << parent << endl;
+  }
+  fuse_lowlevel_adapter->lookup(req, parent, name);
+}
+
+void xtreemfs_fuse_ll_forget(
+    fuse_req_t req,
+    fuse_ino_t ino,
+    unsigned long nlookup) {
+  if (Logging::log->loggingActive(LEVEL_DEBUG)) {
+    Logging::log->getLog(LEVEL_DEBUG)
+        << "xtreemfs_fuse_ll_forget " << ino << " n:" << nlookup << endl;
+  }
+  fuse_lowlevel_adapter->forget(req, ino, nlookup);
+}
+
+void xtreemfs_fuse_ll_getattr(
+    fuse_req_t req,
+    fuse_ino_t ino,
+    struct fuse_file_info* fi) {
+  if (Logging::log->loggingActive(LEVEL_DEBUG)) {
+    Logging::log->getLog(LEVEL_DEBUG)
+        << "xtreemfs_fuse_ll_getattr " << ino << endl;
+  }
+  fuse_lowlevel_adapter->getattr(req, ino, fi);
+}
+
+void xtreemfs_fuse_ll_setattr(
+    fuse_req_t req,
+    fuse_ino_t ino,
+    struct stat* attr,
+    int to_set,
+    struct fuse_file_info* fi) {
+  if (Logging::log->loggingActive(LEVEL_DEBUG)) {
+    Logging::log->getLog(LEVEL_DEBUG)
+        << "xtreemfs_fuse_ll_setattr " << ino << " to_set:" << to_set << endl;
+  }
+  fuse_lowlevel_adapter->setattr(req, ino, attr, to_set, fi);
+}
+
+void xtreemfs_fuse_ll_readlink(fuse_req_t req, fuse_ino_t ino) {
+  if (Logging::log->loggingActive(LEVEL_DEBUG)) {
+    Logging::log->getLog(LEVEL_DEBUG)
+        << "xtreemfs_fuse_ll_readlink " << ino << endl;
+  }
+  fuse_lowlevel_adapter->readlink(req, ino);
+}
+
+void xtreemfs_fuse_ll_mknod(
+    fuse_req_t req,
+    fuse_ino_t parent,
+    const char* name,
+    mode_t mode,
+    dev_t rdev) {
+  if (Logging::log->loggingActive(LEVEL_DEBUG)) {
+    Logging::log->getLog(LEVEL_DEBUG)
+        << "xtreemfs_fuse_ll_mknod " << name << " in " << parent << endl;
+  }
+  fuse_lowlevel_adapter->mknod(req, parent, name, mode, rdev);
+}
+
+void xtreemfs_fuse_ll_mkdir(
+    fuse_req_t req,
+    fuse_ino_t parent,
+    const char* name,
+    mode_t mode) {
+  if (Logging::log->loggingActive(LEVEL_DEBUG)) {
+    Logging::log->getLog(LEVEL_DEBUG)
+        << "xtreemfs_fuse_ll_mkdir " << name << " in " << parent << endl;
+  }
+  fuse_lowlevel_adapter->mkdir(req, parent, name, mode);
+}
+
+void xtreemfs_fuse_ll_unlink(
+    fuse_req_t req,
+    fuse_ino_t parent,
+    const char* name) {
+  if (Logging::log->loggingActive(LEVEL_DEBUG)) {
+    Logging::log->getLog(LEVEL_DEBUG)
+        << "xtreemfs_fuse_ll_unlink " << name << " in " << parent << endl;
+  }
+  fuse_lowlevel_adapter->unlink(req, parent, name);
+}
+
+void xtreemfs_fuse_ll_rmdir(
+    fuse_req_t req,
+    fuse_ino_t parent,
+    const char* name) {
+  if (Logging::log->loggingActive(LEVEL_DEBUG)) {
+    Logging::log->getLog(LEVEL_DEBUG)
+        << "xtreemfs_fuse_ll_rmdir " << name << " in " << parent << endl;
+  }
+  fuse_lowlevel_adapter->rmdir(req, parent, name);
+}
+
+void xtreemfs_fuse_ll_symlink(
+    fuse_req_t req,
+    const char* link,
+    fuse_ino_t parent,
+    const char* name) {
+  if (Logging::log->loggingActive(LEVEL_DEBUG)) {
+    Logging::log->getLog(LEVEL_DEBUG)
+        << "xtreemfs_fuse_ll_symlink " << name << " in " << parent << " to "
+        << link << endl;
+  }
+  fuse_lowlevel_adapter->symlink(req, link, parent, name);
+}
+
+void xtreemfs_fuse_ll_rename(
+    fuse_req_t req,
+    fuse_ino_t parent,
+    const char* name,
+    fuse_ino_t newparent,
+    const char* newname) {
+  if (Logging::log->loggingActive(LEVEL_DEBUG)) {
+    Logging::log->getLog(LEVEL_DEBUG)
+        << "xtreemfs_fuse_ll_rename " << name << " in " << parent << " to "
+        << newname << " in " << newparent << endl;
+  }
+  fuse_lowlevel_adapter->rename(req, parent, name, newparent, newname);
+}
+
+void xtreemfs_fuse_ll_link(
+    fuse_req_t req,
+    fuse_ino_t ino,
+    fuse_ino_t newparent,
+    const char* newname) {
+  if (Logging::log->loggingActive(LEVEL_DEBUG)) {
+    Logging::log->getLog(LEVEL_DEBUG)
+        << "xtreemfs_fuse_ll_link " << ino << " to " << newname << " in "
+        << newparent << endl;
+  }
+  fuse_lowlevel_adapter->link(req, ino, newparent, newname);
+}
+
+void xtreemfs_fuse_ll_open(
+    fuse_req_t req,
+    fuse_ino_t ino,
+    struct fuse_file_info* fi) {
+  if (Logging::log->loggingActive(LEVEL_DEBUG)) {
+    Logging::log->getLog(LEVEL_DEBUG)
+        << "xtreemfs_fuse_ll_open " << ino << endl;
+  }
+  fuse_lowlevel_adapter->open(req, ino, fi);
+}
+
+void xtreemfs_fuse_ll_read(
+    fuse_req_t req,
+    fuse_ino_t ino,
+    size_t size,
+    off_t off,
+    struct fuse_file_info* fi) {
+  if (Logging::log->loggingActive(LEVEL_DEBUG)) {
+    Logging::log->getLog(LEVEL_DEBUG)
+        << "xtreemfs_fuse_ll_read " << ino << " s:" << size << " o:" << off
+        << endl;
+  }
+  fuse_lowlevel_adapter->read(req, ino, size, off, fi);
+}
+
+void xtreemfs_fuse_ll_write(
+    fuse_req_t req,
+    fuse_ino_t ino,
+    const char* buf,
+    size_t size,
+    off_t off,
+    struct fuse_file_info* fi) {
+  if (Logging::log->loggingActive(LEVEL_DEBUG)) {
+    Logging::log->getLog(LEVEL_DEBUG)
+        << "xtreemfs_fuse_ll_write " << ino << " s:" << size << " o:" << off
+        << endl;
+  }
+  fuse_lowlevel_adapter->write(req, ino, buf, size, off, fi);
+}
+
+void xtreemfs_fuse_ll_flush(
+    fuse_req_t req,
+    fuse_ino_t ino,
+    struct fuse_file_info* fi) {
+  if (Logging::log->loggingActive(LEVEL_DEBUG)) {
+    Logging::log->getLog(LEVEL_DEBUG)
+        << "xtreemfs_fuse_ll_flush " << ino << endl;
+  }
+  fuse_lowlevel_adapter->flush(req, ino, fi);
+}
+
+void xtreemfs_fuse_ll_release(
+    fuse_req_t req,
+    fuse_ino_t ino,
+    struct fuse_file_info* fi) {
+  if (Logging::log->loggingActive(LEVEL_DEBUG)) {
+    Logging::log->getLog(LEVEL_DEBUG)
+        << "xtreemfs_fuse_ll_release " << ino << endl;
+  }
+  fuse_lowlevel_adapter->release(req, ino, fi);
+}
+
+void xtreemfs_fuse_ll_fsync(
+    fuse_req_t req,
+    fuse_ino_t ino,
+    int datasync,
+    struct fuse_file_info* fi) {
+  if (Logging::log->loggingActive(LEVEL_DEBUG)) {
+    Logging::log->getLog(LEVEL_DEBUG)
+        << "xtreemfs_fuse_ll_fsync " << ino << endl;
+  }
+  fuse_lowlevel_adapter->fsync(req, ino, datasync, fi);
+}
+
+void xtreemfs_fuse_ll_opendir(
+    fuse_req_t req,
+    fuse_ino_t ino,
+    struct fuse_file_info* fi) {
+  if (Logging::log->loggingActive(LEVEL_DEBUG)) {
+    Logging::log->getLog(LEVEL_DEBUG)
+        << "xtreemfs_fuse_ll_opendir " << ino << endl;
+  }
+  fuse_lowlevel_adapter->opendir(req, ino, fi);
+}
+
+void xtreemfs_fuse_ll_readdir(
+    fuse_req_t req,
+    fuse_ino_t ino,
+    size_t size,
+    off_t off,
+    struct fuse_file_info* fi) {
+  if (Logging::log->loggingActive(LEVEL_DEBUG)) {
+    Logging::log->getLog(LEVEL_DEBUG)
+        << "xtreemfs_fuse_ll_readdir " << ino << " s:" << size << " o:" << off
+        << endl;
+  }
+  fuse_lowlevel_adapter->readdir(req, ino, size, off, fi);
+}
+
+void xtreemfs_fuse_ll_releasedir(
+    fuse_req_t req,
+    fuse_ino_t ino,
+    struct fuse_file_info* fi) {
+  if (Logging::log->loggingActive(LEVEL_DEBUG)) {
+    Logging::log->getLog(LEVEL_DEBUG)
+        << "xtreemfs_fuse_ll_releasedir " << ino << endl;
+  }
+  fuse_lowlevel_adapter->releasedir(req, ino, fi);
+}
+
+void xtreemfs_fuse_ll_fsyncdir(
+    fuse_req_t req,
+    fuse_ino_t ino,
+    int datasync,
+    struct fuse_file_info* fi) {
+  // Like fsync, but for directories - not required for XtreemFS.
+  fuse_reply_err(req, 0);
+}
+
+void xtreemfs_fuse_ll_statfs(fuse_req_t req, fuse_ino_t ino) {
+  if (Logging::log->loggingActive(LEVEL_DEBUG)) {
+    Logging::log->getLog(LEVEL_DEBUG)
+        << "xtreemfs_fuse_ll_statfs " << ino << endl;
+  }
+  fuse_lowlevel_adapter->statfs(req, ino);
+}
+
+void xtreemfs_fuse_ll_setxattr(
+    fuse_req_t req,
+    fuse_ino_t ino,
+    const char* name,
+    const char* value,
+    size_t size,
+    int flags) {
+  if (Logging::log->loggingActive(LEVEL_DEBUG)) {
+    Logging::log->getLog(LEVEL_DEBUG)
+        << "xtreemfs_fuse_ll_setxattr " << ino << " " << name << endl;
+  }
+  fuse_lowlevel_adapter->setxattr(req, ino, name, value, size, flags);
+}
+
+void xtreemfs_fuse_ll_getxattr(
+    fuse_req_t req,
+    fuse_ino_t ino,
+    const char* name,
+    size_t size) {
+  if (Logging::log->loggingActive(LEVEL_DEBUG)) {
+    Logging::log->getLog(LEVEL_DEBUG)
+        << "xtreemfs_fuse_ll_getxattr " << ino << " " << name << endl;
+  }
+  fuse_lowlevel_adapter->getxattr(req, ino, name, size);
+}
+
+void xtreemfs_fuse_ll_listxattr(fuse_req_t req, fuse_ino_t ino, size_t size) {
+  if (Logging::log->loggingActive(LEVEL_DEBUG)) {
+    Logging::log->getLog(LEVEL_DEBUG)
+        << "xtreemfs_fuse_ll_listxattr " << ino << endl;
+  }
+  fuse_lowlevel_adapter->listxattr(req, ino, size);
+}
+
+void xtreemfs_fuse_ll_removexattr(
+    fuse_req_t req,
+    fuse_ino_t ino,
+    const char* name) {
+  if (Logging::log->loggingActive(LEVEL_DEBUG)) {
+    Logging::log->getLog(LEVEL_DEBUG)
+        << "xtreemfs_fuse_ll_removexattr " << ino << " " << name << endl;
+  }
+  fuse_lowlevel_adapter->removexattr(req, ino, name);
+}
+
+void xtreemfs_fuse_ll_access(fuse_req_t req, fuse_ino_t ino, int mask) {
+  if (Logging::log->loggingActive(LEVEL_DEBUG)) {
+    Logging::log->getLog(LEVEL_DEBUG)
+        << "xtreemfs_fuse_ll_access " << ino << endl;
+  }
+  fuse_lowlevel_adapter->access(req, ino, mask);
+}
+
+void xtreemfs_fuse_ll_create(
+    fuse_req_t req,
+    fuse_ino_t parent,
+    const char* name,
+    mode_t mode,
+    struct fuse_file_info* fi) {
+  if (Logging::log->loggingActive(LEVEL_DEBUG)) {
+    Logging::log->getLog(LEVEL_DEBUG)
+        << "xtreemfs_fuse_ll_create " << name << " in " << parent << endl;
+  }
+  fuse_lowlevel_adapter->create(req, parent, name, mode, fi);
+}
+
+void xtreemfs_fuse_ll_getlk(
+    fuse_req_t req,
+    fuse_ino_t ino,
+    struct fuse_file_info* fi,
+    struct flock* lock) {
+  if (Logging::log->loggingActive(LEVEL_DEBUG)) {
+    Logging::log->getLog(LEVEL_DEBUG)
+        << "xtreemfs_fuse_ll_getlk " << ino << endl;
+  }
+  fuse_lowlevel_adapter->getlk(req, ino, fi, lock);
+}
+
+void xtreemfs_fuse_ll_setlk(
+    fuse_req_t req,
+    fuse_ino_t ino,
+    struct fuse_file_info* fi,
+    struct flock* lock,
+    int sleep) {
+  if (Logging::log->loggingActive(LEVEL_DEBUG)) {
+    Logging::log->getLog(LEVEL_DEBUG)
+        << "xtreemfs_fuse_ll_setlk " << ino << " sleep:" << sleep << endl;
+  }
+  fuse_lowlevel_adapter->setlk(req, ino, fi, lock, sleep);
+}
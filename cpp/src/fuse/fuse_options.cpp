@@ -62,12 +62,17 @@ FuseOptions::FuseOptions() : Options(), fuse_descriptions_("Fuse Options") {
   enable_xattrs = false;
 #endif  // __APPLE__
   foreground = false;
+  use_lowlevel_api = false;
   use_fuse_permission_checks = true;
   fuse_permission_checks_explicitly_disabled = false;
 
   fuse_descriptions_.add_options()
     ("foreground,f", po::value(&foreground)->zero_tokens(),
         "Do not fork into background.")
+    ("lowlevel-fuse", po::value(&use_lowlevel_api)->zero_tokens(),
+        "Use the inode based low-level Fuse API. Avoids resolving full paths"
+        " for every operation and lets the kernel cache entries and"
+        " attributes for --metadata-cache-ttl-s seconds.")
     ("fuse_option,o",
         po::value< vector<string> >(&fuse_options),
         "Passes -o=<option> to Fuse if not recognized by mount.xtreemfs, "
@@ -13,6 +13,7 @@
 #include <cstdio>
 #include <cstring>
 #include <fuse.h>
+#include <fuse_lowlevel.h>
 #include <sys/stat.h>
 #include <unistd.h>
 
@@ -25,6 +26,8 @@
 #include "util/logging.h"
 
 #include "fuse/fuse_adapter.h"
+#include "fuse/fuse_lowlevel_adapter.h"
+#include "fuse/fuse_lowlevel_operations.h"
 #include "fuse/fuse_operations.h"
 #include "fuse/fuse_options.h"
 #include "libxtreemfs/xtreemfs_exception.h"
@@ -122,6 +125,7 @@ int main(int argc, char **argv) {
   // Setup fuse and pass client and volume objects.
   struct fuse_chan* fuse_channel = NULL;
   struct fuse* fuse_ = NULL;
+  struct fuse_session* fuse_session = NULL;
   char* mount_point = NULL;
   // Fill in operations.
   struct fuse_operations xtreemfs_fuse_ops = {0};
@@ -171,6 +175,43 @@ int main(int argc, char **argv) {
   xtreemfs_fuse_ops.flag_nopath = 0;
 #endif  // >= FUSE 2.8
 
+  // Fill in operations of the low-level API.
+  struct fuse_lowlevel_ops xtreemfs_fuse_ll_ops;
+  memset(&xtreemfs_fuse_ll_ops, 0, sizeof(xtreemfs_fuse_ll_ops));
+  xtreemfs_fuse_ll_ops.init = xtreemfs_fuse_ll_init;
+  xtreemfs_fuse_ll_ops.destroy = xtreemfs_fuse_ll_destroy;
+  xtreemfs_fuse_ll_ops.lookup = xtreemfs_fuse_ll_lookup;
+  xtreemfs_fuse_ll_ops.forget = xtreemfs_fuse_ll_forget;
+  xtreemfs_fuse_ll_ops.getattr = xtreemfs_fuse_ll_getattr;
+  xtreemfs_fuse_ll_ops.setattr = xtreemfs_fuse_ll_setattr;
+  xtreemfs_fuse_ll_ops.readlink = xtreemfs_fuse_ll_readlink;
+  xtreemfs_fuse_ll_ops.mknod = xtreemfs_fuse_ll_mknod;
+  xtreemfs_fuse_ll_ops.mkdir = xtreemfs_fuse_ll_mkdir;
+  xtreemfs_fuse_ll_ops.unlink = xtreemfs_fuse_ll_unlink;
+  xtreemfs_fuse_ll_ops.rmdir = xtreemfs_fuse_ll_rmdir;
+  xtreemfs_fuse_ll_ops.symlink = xtreemfs_fuse_ll_symlink;
+  xtreemfs_fuse_ll_ops.rename = xtreemfs_fuse_ll_rename;
+  xtreemfs_fuse_ll_ops.link = xtreemfs_fuse_ll_link;
+  xtreemfs_fuse_ll_ops.open = xtreemfs_fuse_ll_open;
+  xtreemfs_fuse_ll_ops.read = xtreemfs_fuse_ll_read;
+  xtreemfs_fuse_ll_ops.write = xtreemfs_fuse_ll_write;
+  xtreemfs_fuse_ll_ops.flush = xtreemfs_fuse_ll_flush;
+  xtreemfs_fuse_ll_ops.release = xtreemfs_fuse_ll_release;
+  xtreemfs_fuse_ll_ops.fsync = xtreemfs_fuse_ll_fsync;
+  xtreemfs_fuse_ll_ops.opendir = xtreemfs_fuse_ll_opendir;
+  xtreemfs_fuse_ll_ops.readdir = xtreemfs_fuse_ll_readdir;
+  xtreemfs_fuse_ll_ops.releasedir = xtreemfs_fuse_ll_releasedir;
+  xtreemfs_fuse_ll_ops.fsyncdir = xtreemfs_fuse_ll_fsyncdir;
+  xtreemfs_fuse_ll_ops.statfs = xtreemfs_fuse_ll_statfs;
+  xtreemfs_fuse_ll_ops.setxattr = xtreemfs_fuse_ll_setxattr;
+  xtreemfs_fuse_ll_ops.getxattr = xtreemfs_fuse_ll_getxattr;
+  xtreemfs_fuse_ll_ops.listxattr = xtreemfs_fuse_ll_listxattr;
+  xtreemfs_fuse_ll_ops.removexattr = xtreemfs_fuse_ll_removexattr;
+  xtreemfs_fuse_ll_ops.access = xtreemfs_fuse_ll_access;
+  xtreemfs_fuse_ll_ops.create = xtreemfs_fuse_ll_create;
+  xtreemfs_fuse_ll_ops.getlk = xtreemfs_fuse_ll_getlk;
+  xtreemfs_fuse_ll_ops.setlk = xtreemfs_fuse_ll_setlk;
+
   // Forward args.
   vector<char*> fuse_opts;
   // Fuse does not parse the first parameter, thus set it to "mount.xtreemfs".
@@ -219,20 +260,34 @@ int main(int argc, char **argv) {
     return errno;
   }
   // Create Fuse filesystem.
-  fuse_ = fuse_new(
-      fuse_channel,
-      &fuse_args,
-      &xtreemfs_fuse_ops,
-      sizeof(xtreemfs_fuse_ops),
-      NULL);
+  if (options.use_lowlevel_api) {
+    fuse_lowlevel_adapter
+        = new xtreemfs::FuseLowLevelAdapter(fuse_adapter, &options);
+    fuse_session = fuse_lowlevel_new(
+        &fuse_args,
+        &xtreemfs_fuse_ll_ops,
+        sizeof(xtreemfs_fuse_ll_ops),
+        NULL);
+    if (fuse_session != NULL) {
+      fuse_session_add_chan(fuse_session, fuse_channel);
+    }
+  } else {
+    fuse_ = fuse_new(
+        fuse_channel,
+        &fuse_args,
+        &xtreemfs_fuse_ops,
+        sizeof(xtreemfs_fuse_ops),
+        NULL);
+  }
   fuse_opt_free_args(&fuse_args);
-  if (fuse_ == NULL) {
+  if (fuse_ == NULL && fuse_session == NULL) {
     // Avoid "Transport endpoint is not connected" in case fuse_new failed.
     fuse_unmount(mount_point, fuse_channel);
     for (int i = 0; i < fuse_opts.size(); i++) {
       free(fuse_opts[i]);
     }
     free(mount_point);
+    delete fuse_lowlevel_adapter;
     // Stop FuseAdapter.
     fuse_adapter->Stop();
     delete fuse_adapter;
@@ -264,11 +319,24 @@ int main(int argc, char **argv) {
   }
 
   // Run fuse.
-  fuse_set_signal_handlers(fuse_get_session(fuse_));
-  fuse_adapter->SetInterruptQueryFunction();
-  fuse_loop_mt(fuse_);
-  // Cleanup
-  fuse_teardown(fuse_, mount_point);
+  if (fuse_session != NULL) {
+    fuse_set_signal_handlers(fuse_session);
+    fuse_adapter->SetInterruptQueryFunction();
+    fuse_session_loop_mt(fuse_session);
+    // Cleanup
+    fuse_remove_signal_handlers(fuse_session);
+    fuse_session_remove_chan(fuse_channel);
+    fuse_session_destroy(fuse_session);
+    fuse_unmount(mount_point, fuse_channel);
+    free(mount_point);
+    delete fuse_lowlevel_adapter;
+  } else {
+    fuse_set_signal_handlers(fuse_get_session(fuse_));
+    fuse_adapter->SetInterruptQueryFunction();
+    fuse_loop_mt(fuse_);
+    // Cleanup
+    fuse_teardown(fuse_, mount_point);
+  }
   for (int i = 0; i < fuse_opts.size(); i++) {
     free(fuse_opts[i]);
   }
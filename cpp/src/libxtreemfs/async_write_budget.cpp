@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2026 by the XtreemFS Authors, see AUTHORS file
+ *
+ * Licensed under the BSD License, see LICENSE file for details.
+ *
+ */
+
+#include "libxtreemfs/async_write_budget.h"
+
+#include <cassert>
+
+#include <boost/thread/thread.hpp>
+
+using namespace std;
+
+namespace xtreemfs {
+
+AsyncWriteBudget::AsyncWriteBudget(size_t max_bytes)
+    : max_bytes_(max_bytes),
+      used_bytes_(0) {}
+
+void AsyncWriteBudget::Acquire(const void* owner, size_t bytes) {
+  boost::mutex::scoped_lock lock(mutex_);
+
+  // Fast path: Do not overtake blocked writers.
+  if (owners_.empty() &&
+      (used_bytes_ == 0 || used_bytes_ + bytes <= max_bytes_)) {
+    used_bytes_ += bytes;
+    return;
+  }
+
+  Waiter waiter(bytes);
+  list<Waiter*>& owner_waiters = waiters_[owner];
+  if (owner_waiters.empty()) {
+    owners_.push_back(owner);
+  }
+  owner_waiters.push_back(&waiter);
+
+  try {
+    while (!waiter.granted) {
+      waiters_granted_.wait(lock);
+    }
+  } catch (const boost::thread_interrupted&) {
+    if (waiter.granted) {
+      used_bytes_ -= bytes;
+    } else {
+      RemoveWaiterUnmutexed(owner, &waiter);
+    }
+    GrantUnmutexed();
+    throw;
+  }
+}
+
+void AsyncWriteBudget::Release(size_t bytes) {
+  boost::mutex::scoped_lock lock(mutex_);
+  assert(used_bytes_ >= bytes);
+
+  used_bytes_ -= bytes;
+  GrantUnmutexed();
+}
+
+size_t AsyncWriteBudget::used_bytes() {
+  boost::mutex::scoped_lock lock(mutex_);
+  return used_bytes_;
+}
+
+void AsyncWriteBudget::GrantUnmutexed() {
+  bool granted_any = false;
+
+  while (!owners_.empty()) {
+    const void* owner = owners_.front();
+    list<Waiter*>& owner_waiters = waiters_[owner];
+    Waiter* waiter = owner_waiters.front();
+    if (used_bytes_ != 0 && used_bytes_ + waiter->bytes > max_bytes_) {
+      break;
+    }
+
+    used_bytes_ += waiter->bytes;
+    waiter->granted = true;
+    granted_any = true;
+
+    // Move the owner to the end of the round-robin list.
+    owner_waiters.pop_front();
+    owners_.pop_front();
+    if (owner_waiters.empty()) {
+      waiters_.erase(owner);
+    } else {
+      owners_.push_back(owner);
+    }
+  }
+
+  if (granted_any) {
+    waiters_granted_.notify_all();
+  }
+}
+
+void AsyncWriteBudget::RemoveWaiterUnmutexed(const void* owner,
+                                             Waiter* waiter) {
+  list<Waiter*>& owner_waiters = waiters_[owner];
+  owner_waiters.remove(waiter);
+  if (owner_waiters.empty()) {
+    waiters_.erase(owner);
+    owners_.remove(owner);
+  }
+}
+
+}  // namespace xtreemfs
@@ -10,34 +10,41 @@
 #include <cassert>
 #include <cstring>
 
+#include "libxtreemfs/file_credentials_snapshot.h"
 #include "xtreemfs/OSD.pb.h"
 
 namespace xtreemfs {
 
-AsyncWriteBuffer::AsyncWriteBuffer(xtreemfs::pbrpc::writeRequest* write_request,
-                                   const char* data,
-                                   size_t data_length,
-                                   FileHandleImplementation* file_handle,
-                                   XCapHandler* xcap_handler)
+AsyncWriteBuffer::AsyncWriteBuffer(
+    xtreemfs::pbrpc::writeRequest* write_request,
+    const boost::shared_ptr<const FileCredentialsSnapshot>& file_credentials,
+    const char* data,
+    size_t data_length,
+    FileHandleImplementation* file_handle,
+    XCapHandler* xcap_handler)
     : write_request(write_request),
+      file_credentials(file_credentials),
       data_length(data_length),
       file_handle(file_handle),
       xcap_handler_(xcap_handler),
       use_uuid_iterator(true),
       state_(PENDING),
       retry_count_(0) {
-  assert(write_request && data && file_handle);
+  assert(write_request && file_credentials && data && file_handle);
   this->data = new char[data_length];
   memcpy(this->data, data, data_length);
 }
 
-AsyncWriteBuffer::AsyncWriteBuffer(xtreemfs::pbrpc::writeRequest* write_request,
-                                   const char* data,
-                                   size_t data_length,
-                                   FileHandleImplementation* file_handle,
-                                   XCapHandler* xcap_handler,
-                                   const std::string& osd_uuid)
+AsyncWriteBuffer::AsyncWriteBuffer(
+    xtreemfs::pbrpc::writeRequest* write_request,
+    const boost::shared_ptr<const FileCredentialsSnapshot>& file_credentials,
+    const char* data,
+    size_t data_length,
+    FileHandleImplementation* file_handle,
+    XCapHandler* xcap_handler,
+    const std::string& osd_uuid)
     : write_request(write_request),
+      file_credentials(file_credentials),
       data_length(data_length),
       file_handle(file_handle),
       xcap_handler_(xcap_handler),
@@ -45,7 +52,7 @@ AsyncWriteBuffer::AsyncWriteBuffer(xtreemfs::pbrpc::writeRequest* write_request,
       osd_uuid(osd_uuid),
       state_(PENDING),
       retry_count_(0) {
-  assert(write_request && data && file_handle);
+  assert(write_request && file_credentials && data && file_handle);
   this->data = new char[data_length];
   memcpy(this->data, data, data_length);
 }
@@ -7,24 +7,30 @@
 
 #include "libxtreemfs/async_write_handler.h"
 
+#include <algorithm>
 #include <cassert>
 
 #include <boost/lexical_cast.hpp>
 #include <google/protobuf/descriptor.h>
 #include <string>
 
+#include "libxtreemfs/async_write_budget.h"
 #include "libxtreemfs/async_write_buffer.h"
+#include "libxtreemfs/disk_object_cache.h"
+#include "libxtreemfs/file_credentials_snapshot.h"
 #include "libxtreemfs/file_handle_implementation.h"
 #include "libxtreemfs/file_info.h"
 #include "libxtreemfs/interrupt.h"
+#include "libxtreemfs/osd_health_registry.h"
+#include "libxtreemfs/splicing_osd_service_client.h"
 #include "libxtreemfs/uuid_iterator.h"
 #include "libxtreemfs/uuid_resolver.h"
+#include "libxtreemfs/write_window_controller.h"
 #include "libxtreemfs/xtreemfs_exception.h"
 #include "pbrpc/RPC.pb.h"
 #include "util/error_log.h"
 #include "util/logging.h"
 #include "util/synchronized_queue.h"
-#include "xtreemfs/OSDServiceClient.h"
 
 using namespace std;
 using namespace xtreemfs::util;
@@ -36,11 +42,14 @@ AsyncWriteHandler::AsyncWriteHandler(
     FileInfo* file_info,
     UUIDIterator* uuid_iterator,
     UUIDResolver* uuid_resolver,
-    xtreemfs::pbrpc::OSDServiceClient* osd_service_client,
+    SplicingOSDServiceClient* osd_service_client,
     const xtreemfs::pbrpc::Auth& auth_bogus,
     const xtreemfs::pbrpc::UserCredentials& user_credentials_bogus,
     const Options& volume_options,
-    util::SynchronizedQueue<CallbackEntry>& callback_queue)
+    util::MPSCQueue<CallbackEntry>& callback_queue,
+    WriteWindowController* write_window_controller,
+    AsyncWriteBudget* write_budget,
+    DiskObjectCache* disk_cache)
     : state_(IDLE),
       pending_bytes_(0),
       pending_writes_(0),
@@ -60,6 +69,10 @@ AsyncWriteHandler::AsyncWriteHandler(
       max_writeahead_(volume_options.async_writes_max_requests *
           volume_options.async_writes_max_request_size_kb * 1024),
       max_requests_(volume_options.async_writes_max_requests),
+      max_request_size_(volume_options.async_writes_max_request_size_kb * 1024),
+      write_window_controller_(write_window_controller),
+      write_budget_(write_budget),
+      disk_cache_(disk_cache),
       max_write_tries_(volume_options.max_write_tries),
       redirected_(false),
       fast_redirect_(false),
@@ -116,23 +129,61 @@ void AsyncWriteHandler::Write(AsyncWriteBuffer* write_buffer) {
         + boost::lexical_cast<string>(write_buffer->data_length));
   }
 
+  // Reserve the memory in the Volume-wide budget first. mutex_ must not be
+  // held meanwhile as callbacks of this file may be required to free it.
+  if (write_budget_) {
+    write_budget_->Acquire(this, write_buffer->data_length);
+  }
+
   // Append to list of writes in flight.
   {
-    boost::mutex::scoped_lock lock(mutex_);
-
-    while ((state_ != FINALLY_FAILED) && (writing_paused_ ||
-           (pending_bytes_ + write_buffer->data_length) >
-                static_cast<size_t>(max_writeahead_) ||
-            writes_in_flight_.size() == max_requests_)) {
-      // TODO(mberlin): Allow interruption and set the write status of the
-      //                FileHandle of the interrupted write to an error state.
-      pending_bytes_were_decreased_.wait(lock);
+    boost::mutex::scoped_lock lock(mutex_, boost::defer_lock);
+    for (;;) {
+      // The number of requests in flight to an OSD is limited across all
+      // files. Wait for a free slot in its window without holding mutex_,
+      // too.
+      if (write_window_controller_) {
+        string osd_uuid;
+        GetOSDUUIDHelper(write_buffer, &osd_uuid);
+        try {
+          write_window_controller_->Acquire(osd_uuid);
+        } catch (const boost::thread_interrupted&) {
+          if (write_budget_) {
+            write_budget_->Release(write_buffer->data_length);
+          }
+          throw;
+        }
+        write_buffer->window_osd_uuid = osd_uuid;
+      }
+
+      lock.lock();
+      if (!IsWriteBlockedHelper(write_buffer)) {
+        break;
+      }
+      // Other files must not wait for the slot while this file is paused or
+      // exceeds its own limits.
+      ReleaseWindowHelper(write_buffer);
+      while (IsWriteBlockedHelper(write_buffer)) {
+        // TODO(mberlin): Allow interruption and set the write status of the
+        //                FileHandle of the interrupted write to an error
+        //                state.
+        pending_bytes_were_decreased_.wait(lock);
+      }
+      if (state_ == FINALLY_FAILED || !write_window_controller_) {
+        break;
+      }
+      lock.unlock();
     }
-    assert(writes_in_flight_.size() <= static_cast<size_t>(max_requests_));
+    assert(write_window_controller_ ||
+           writes_in_flight_.size() <= static_cast<size_t>(max_requests_));
 
     // NOTE: the following is done here to reach all threads that started
     //       waiting before the final failure
     if (state_ == FINALLY_FAILED) {
+      if (write_budget_) {
+        write_budget_->Release(write_buffer->data_length);
+      }
+      ReleaseWindowHelper(write_buffer);
       string error =
           "Tried to asynchronously write to a finally failed write handler.";
       Logging::log->getLog(LEVEL_ERROR) << error << endl;
@@ -146,6 +197,46 @@ void AsyncWriteHandler::Write(AsyncWriteBuffer* write_buffer) {
   WriteCommon(write_buffer, NULL, false);
 }
 
+int AsyncWriteHandler::GetMaxRequestsHelper(AsyncWriteBuffer* write_buffer) {
+  if (!write_window_controller_) {
+    return max_requests_;
+  }
+
+  string osd_uuid;
+  GetOSDUUIDHelper(write_buffer, &osd_uuid);
+  return write_window_controller_->GetWindow(osd_uuid);
+}
+
+bool AsyncWriteHandler::IsWriteBlockedHelper(AsyncWriteBuffer* write_buffer) {
+  if (state_ == FINALLY_FAILED) {
+    return false;
+  }
+  // The window may have changed since the last call.
+  int max_requests = GetMaxRequestsHelper(write_buffer);
+  return writing_paused_ ||
+      (pending_bytes_ + write_buffer->data_length) >
+          static_cast<size_t>(
+              max(max_writeahead_, max_requests * max_request_size_)) ||
+      (!write_window_controller_ &&
+       writes_in_flight_.size() >= static_cast<size_t>(max_requests));
+}
+
+void AsyncWriteHandler::GetOSDUUIDHelper(AsyncWriteBuffer* write_buffer,
+                                         std::string* osd_uuid) {
+  if (write_buffer->use_uuid_iterator) {
+    uuid_iterator_->GetUUID(osd_uuid);
+  } else {
+    *osd_uuid = write_buffer->osd_uuid;
+  }
+}
+
+void AsyncWriteHandler::ReleaseWindowHelper(AsyncWriteBuffer* write_buffer) {
+  if (!write_buffer->window_osd_uuid.empty()) {
+    write_window_controller_->Release(write_buffer->window_osd_uuid);
+    write_buffer->window_osd_uuid.clear();
+  }
+}
+
 void AsyncWriteHandler::ReWrite(AsyncWriteBuffer* write_buffer,
                                 boost::mutex::scoped_lock* lock) {
   assert(write_buffer && lock && lock->owns_lock() &&
@@ -183,6 +274,7 @@ void AsyncWriteHandler::WriteCommon(AsyncWriteBuffer* write_buffer,
     } else {
       // In case of errors, remove write again and throw exception.
       boost::mutex::scoped_lock lock(mutex_);
+      ReleaseWindowHelper(write_buffer);
       DecreasePendingBytesHelper(write_buffer, &lock, true);
       --pending_writes_;
     }
@@ -192,31 +284,39 @@ void AsyncWriteHandler::WriteCommon(AsyncWriteBuffer* write_buffer,
   // save the resolved uuid in the buffer (used for logging)
   write_buffer->service_address = osd_address;
 
-  // make sure to use the potentially renewed XCap
-  write_buffer->xcap_handler_->GetXCap(write_buffer->write_request
-      ->mutable_file_credentials()->mutable_xcap());
+  // The first attempt uses the XCap of the FileCredentials snapshot taken by
+  // the write. Make sure rewrites use the potentially renewed XCap.
+  XCap renewed_xcap;
+  string renewed_file_credentials;
+  if (is_rewrite) {
+    write_buffer->xcap_handler_->GetXCap(&renewed_xcap);
+    renewed_file_credentials =
+        write_buffer->file_credentials->SerializeFieldWithXCap(renewed_xcap);
+  }
+  const XCap& xcap =
+      is_rewrite ? renewed_xcap : write_buffer->file_credentials->xcap();
 
   if (Logging::log->loggingActive(LEVEL_DEBUG)) {
     Logging::log->getLog(LEVEL_DEBUG)
-        << "AsyncWriteHandler::(Re)Write for file_id: "
-        << write_buffer->write_request->mutable_file_credentials()
-            ->xcap().file_id()
-        << ", XCap Expiration in: " << (write_buffer->write_request
-            ->mutable_file_credentials()->xcap().expire_time_s() - time(NULL))
+        << "AsyncWriteHandler::(Re)Write for file_id: " << xcap.file_id()
+        << ", XCap Expiration in: " << (xcap.expire_time_s() - time(NULL))
         << endl;
   }
 
   // Send out request.
   write_buffer->request_sent_time =
       boost::posix_time::microsec_clock::local_time();
-  osd_service_client_->write(osd_address,
-                             auth_bogus_,
-                             user_credentials_bogus_,
-                             write_buffer->write_request,
-                             write_buffer->data,
-                             write_buffer->data_length,
-                             this,
-                             reinterpret_cast<void*>(write_buffer));
+  osd_service_client_->write_with_credentials(
+      osd_address,
+      auth_bogus_,
+      user_credentials_bogus_,
+      is_rewrite ? renewed_file_credentials
+                 : write_buffer->file_credentials->serialized_field(),
+      write_buffer->write_request,
+      write_buffer->data,
+      write_buffer->data_length,
+      this,
+      reinterpret_cast<void*>(write_buffer));
 }
 
 void AsyncWriteHandler::WaitForPendingWrites() {
@@ -264,7 +364,7 @@ bool AsyncWriteHandler::WaitForPendingWritesNonBlocking(
   }
 }
 
-void AsyncWriteHandler::ProcessCallbacks(util::SynchronizedQueue<CallbackEntry>& callback_queue) {
+void AsyncWriteHandler::ProcessCallbacks(util::MPSCQueue<CallbackEntry>& callback_queue) {
   while (!(boost::this_thread::interruption_requested() &&
            boost::this_thread::interruption_enabled())) {
     const CallbackEntry& entry = callback_queue.Dequeue();
@@ -311,6 +411,9 @@ void AsyncWriteHandler::HandleCallback(
 
   --pending_writes_;  // we received some answer we were waiting for
 
+  // Retries are not counted in the window, only the first attempt.
+  ReleaseWindowHelper(reinterpret_cast<AsyncWriteBuffer*>(context));
+
   // do nothing in case a write has finally failed
   if (state_ !=  FINALLY_FAILED) {
     AsyncWriteBuffer* write_buffer = reinterpret_cast<AsyncWriteBuffer*>(context);
@@ -383,6 +486,12 @@ void AsyncWriteHandler::HandleCallback(
           }
         } else {
           // Communication error or Internal Server Error.
+          if (uuid_iterator_->health_registry() != NULL) {
+            uuid_iterator_->health_registry()->ReportFailure(service_uuid);
+          }
+          if (write_window_controller_) {
+            write_window_controller_->ReportFailure(service_uuid);
+          }
 
           // set the current error as new worst error if it is worse:
           // a non-REDIRECT error is worse than another non-REDIRECT error
@@ -435,6 +544,20 @@ void AsyncWriteHandler::HandleCallback(
       }
     } else { // if (error)
       // Write was successful.
+      if (uuid_iterator_->health_registry() != NULL) {
+        uuid_iterator_->health_registry()->ReportSuccess(
+            write_buffer->osd_uuid);
+      }
+      if (write_window_controller_) {
+        write_window_controller_->ReportSuccess(
+            write_buffer->osd_uuid,
+            (boost::posix_time::microsec_clock::local_time()
+                - write_buffer->request_sent_time).total_microseconds());
+      }
+      if (disk_cache_) {
+        disk_cache_->Invalidate(write_buffer->file_credentials->xcap()
+                                    .file_id());
+      }
       if (state_ != HAS_FAILED_WRITES) {
         // Tell FileInfo about the OSDWriteResponse.
         if (response_message->has_size_in_bytes()) {
@@ -459,6 +582,7 @@ void AsyncWriteHandler::HandleCallback(
       // NOTE: only handle-able errors with enough retries can make it
       //       until here
 
+      bool fast_failover = false;
       if (worst_error_.error_type() == xtreemfs::pbrpc::REDIRECT) {
         uuid_iterator_->SetCurrentUUID(worst_error_.redirect_to_server_uuid());
         // first fast reconnect
@@ -469,6 +593,17 @@ void AsyncWriteHandler::HandleCallback(
       } else {
         // Mark the current UUID as failed and get the next one.
         uuid_iterator_->MarkUUIDAsFailed(worst_write_buffer_->osd_uuid);
+
+        // Do not delay if the OSD is known to be dead and another replica
+        // is available.
+        OSDHealthRegistry* health_registry = uuid_iterator_->health_registry();
+        if (health_registry != NULL &&
+            worst_write_buffer_->use_uuid_iterator &&
+            health_registry->IsDead(worst_write_buffer_->osd_uuid)) {
+          string next_uuid;
+          uuid_iterator_->GetUUID(&next_uuid);
+          fast_failover = next_uuid != worst_write_buffer_->osd_uuid;
+        }
       }
 
       // delay retries to avoid flooding.
@@ -479,7 +614,7 @@ void AsyncWriteHandler::HandleCallback(
            worst_write_buffer_->request_sent_time);
 
 
-      if (!(fast_redirect_ || delay_time_left.is_negative())) {
+      if (!(fast_redirect_ || fast_failover || delay_time_left.is_negative())) {
         try {
           // Log time left
           if (xtreemfs::util::Logging::log->loggingActive(
@@ -554,7 +689,8 @@ void AsyncWriteHandler::IncreasePendingBytesHelper(
 
   pending_bytes_ += write_buffer->data_length;
   writes_in_flight_.push_back(write_buffer);
-  assert(writes_in_flight_.size() <= static_cast<size_t>(max_requests_));
+  assert(write_window_controller_ ||
+         writes_in_flight_.size() <= static_cast<size_t>(max_requests_));
 
   state_ = WRITES_PENDING;
 }
@@ -566,6 +702,9 @@ void AsyncWriteHandler::DecreasePendingBytesHelper(
   assert(write_buffer && lock && lock->owns_lock());
 
   pending_bytes_ -= write_buffer->data_length;
+  if (write_budget_) {
+    write_budget_->Release(write_buffer->data_length);
+  }
 
   if (delete_buffer) {
     // the buffer is deleted
@@ -643,6 +782,10 @@ void AsyncWriteHandler::CleanUp(boost::mutex::scoped_lock* lock) {
   std::list<AsyncWriteBuffer*>::iterator it = writes_in_flight_.begin();
   while (it != writes_in_flight_.end()) {
     (*it)->file_handle->MarkAsyncWritesAsFailed();  // mark all file handles
+    if (write_budget_) {
+      write_budget_->Release((*it)->data_length);
+    }
+    ReleaseWindowHelper(*it);
     delete *it;  // delete buffers
     it = writes_in_flight_.erase(it);  // delete pointer to buffer in list
   }
@@ -9,22 +9,33 @@
 
 #include "libxtreemfs/client_implementation.h"
 
+#include <algorithm>
 #include <cstdlib>
+#include <map>
+#include <utility>
+#include <vector>
 
 #include <boost/bind.hpp>
+#include <boost/interprocess/detail/atomic.hpp>
 #include <boost/thread/thread.hpp>
+#include <boost/version.hpp>
 
 #include "libxtreemfs/async_write_handler.h"
+#include "libxtreemfs/disk_object_cache.h"
 #include "libxtreemfs/execute_sync_request.h"
+#include "libxtreemfs/file_handle_implementation.h"
 #include "libxtreemfs/helper.h"
 #include "libxtreemfs/options.h"
+#include "libxtreemfs/osd_health_registry.h"
 #include "libxtreemfs/pbrpc_url.h"
 #include "libxtreemfs/uuid_iterator.h"
 #include "libxtreemfs/vivaldi.h"
 #include "libxtreemfs/volume_implementation.h"
+#include "libxtreemfs/write_window_controller.h"
 #include "libxtreemfs/xtreemfs_exception.h"
 #include "util/logging.h"
 #include "util/error_log.h"
+#include "util/latency_histogram.h"
 #include "xtreemfs/DIRServiceClient.h"
 #include "xtreemfs/MRCServiceClient.h"
 #include "xtreemfs/OSDServiceClient.h"
@@ -33,8 +44,24 @@ using namespace std;
 using namespace xtreemfs::pbrpc;
 using namespace xtreemfs::util;
 
+#if (BOOST_VERSION < 104800)
+using boost::interprocess::detail::atomic_inc32;
+#else
+using boost::interprocess::ipcdetail::atomic_inc32;
+#endif  // BOOST_VERSION < 104800
+
 namespace xtreemfs {
 
+namespace {
+
+/** Shortest interval between two bulk refreshes of the address mappings. */
+const int kAddressMappingsMinRefreshIntervalS = 10;
+
+/** Wait time after a failed bulk refresh of the address mappings. */
+const int kAddressMappingsRetryIntervalS = 60;
+
+}  // namespace
+
 DIRUUIDResolver::DIRUUIDResolver(
     SimpleUUIDIterator& dir_uuid_iterator,
     const pbrpc::UserCredentials& user_credentials,
@@ -138,6 +165,114 @@ void DIRUUIDResolver::UUIDToAddressWithOptions(const std::string& uuid,
   }
 }
 
+time_t DIRUUIDResolver::PrefetchAddressMappings(const RPCOptions& options) {
+  // An empty UUID requests the mappings of all services.
+  addressMappingGetRequest rq = addressMappingGetRequest();
+  rq.set_uuid("");
+
+  boost::scoped_ptr<rpc::SyncCallbackBase> response(
+      ExecuteSyncRequest(
+          boost::bind(
+              &xtreemfs::pbrpc::DIRServiceClient::
+                  xtreemfs_address_mappings_get_sync,
+              dir_service_client_.get(),
+              _1,
+              boost::cref(dir_service_auth_),
+              boost::cref(dir_service_user_credentials_),
+              &rq),
+          &dir_uuid_iterator_,
+          NULL,
+          options,
+          true));
+
+  // Select one mapping per UUID like UUIDToAddressWithOptions() does: the
+  // mapping of a local network is preferred over the default one.
+  boost::unordered_set<string> local_networks = GetNetworks();
+  AddressMappingSet* set = static_cast<AddressMappingSet*>(
+      response->response());
+  map<string, pair<const AddressMapping*, bool> > selected_mappings;
+  for (int i = 0; i < set->mappings_size(); i++) {
+    const AddressMapping& am = set->mappings(i);
+    if (am.uuid().empty() || !am.IsInitialized() ||
+        (am.protocol() != PBRPCURL::GetSchemePBRPC()
+         && am.protocol() != PBRPCURL::GetSchemePBRPCS()
+         && am.protocol() != PBRPCURL::GetSchemePBRPCG()
+         && am.protocol() != PBRPCURL::GetSchemePBRPCU())) {
+      // Mappings of other protocols are not used by the client.
+      continue;
+    }
+
+    const string& network = am.match_network();
+    pair<const AddressMapping*, bool>& selected = selected_mappings[am.uuid()];
+    if (network == "*") {
+      if (!selected.second) {
+        selected.first = &am;
+      }
+    } else if (!selected.second &&
+               local_networks.find(network) != local_networks.end()) {
+      selected.first = &am;
+      selected.second = true;
+    }
+  }
+
+  time_t now = time(NULL);
+  time_t earliest_timeout = 0;
+  vector<UUIDCache::UUIDMapping> mappings;
+  for (map<string, pair<const AddressMapping*, bool> >::const_iterator it
+           = selected_mappings.begin();
+       it != selected_mappings.end();
+       ++it) {
+    if (it->second.first == NULL) {
+      continue;  // No mapping for the networks of this host.
+    }
+    const AddressMapping& am = *it->second.first;
+    UUIDCache::UUIDMapping mapping;
+    mapping.uuid = am.uuid();
+    mapping.address = am.address();
+    mapping.port = am.port();
+    mapping.timeout = now + am.ttl_s();
+    mappings.push_back(mapping);
+    if (earliest_timeout == 0 || mapping.timeout < earliest_timeout) {
+      earliest_timeout = mapping.timeout;
+    }
+  }
+  response->DeleteBuffers();
+
+  uuid_cache_.Update(mappings);
+  if (Logging::log->loggingActive(LEVEL_DEBUG)) {
+    Logging::log->getLog(LEVEL_DEBUG) << "Prefetched the address mappings of "
+        << mappings.size() << " services." << endl;
+  }
+  return earliest_timeout;
+}
+
+void DIRUUIDResolver::RunAddressMappingsRefresh() {
+  // Failures are retried by the next refresh.
+  RPCOptions rpc_options(1, options_.retry_delay_s, NULL);
+
+  while (true) {
+    int wait_s = kAddressMappingsRetryIntervalS;
+    try {
+      time_t earliest_timeout = PrefetchAddressMappings(rpc_options);
+      if (earliest_timeout > 0) {
+        wait_s = max(kAddressMappingsMinRefreshIntervalS,
+                     static_cast<int>(
+                         earliest_timeout - time(NULL)
+                         - options_.address_mappings_refresh_margin_s));
+      }
+    } catch (const XtreemFSException& e) {
+      if (Logging::log->loggingActive(LEVEL_INFO)) {
+        Logging::log->getLog(LEVEL_INFO) << "Failed to prefetch the address"
+            " mappings from the DIR, retrying in "
+            << kAddressMappingsRetryIntervalS << " s. Error: " << e.what()
+            << endl;
+      }
+    }
+
+    boost::this_thread::sleep(boost::posix_time::seconds(wait_s));
+  }
+}
+
 string parse_volume_name(const std::string& volume_name) {
   // Check if there is a @ in the volume_name.
   // Everything behind the @ has to be removed as it identifies the snapshot.
@@ -307,7 +442,8 @@ ClientImplementation::ClientImplementation(
       dir_uuid_iterator_(dir_service_addresses),
       uuid_resolver_(dir_uuid_iterator_,
                      user_credentials,
-                     options) {
+                     options),
+      next_async_write_callback_queue_(0) {
 
   // Set bogus auth object.
   auth_bogus_.set_auth_type(AUTH_NONE);
@@ -319,6 +455,7 @@ ClientImplementation::ClientImplementation(
                     options.log_file_path,
                     LEVEL_WARN);
   initialize_error_log(20);
+  initialize_latency_statistics();
 
   if (options_.vivaldi_enable) {
     vivaldi_.reset(new Vivaldi(dir_uuid_iterator_,
@@ -326,6 +463,39 @@ ClientImplementation::ClientImplementation(
                                options_));
   }
 
+  if (options_.osd_health_probe_interval_s > 0) {
+    osd_health_registry_.reset(new OSDHealthRegistry(GetUUIDResolver(),
+                                                     options_));
+  }
+
+  if (options_.enable_async_writes &&
+      options_.async_writes_adaptive_max_requests > 0) {
+    write_window_controller_.reset(new WriteWindowController(options_));
+  }
+
+  if (!options_.disk_cache_path.empty()) {
+#ifdef WIN32
+    Logging::log->getLog(LEVEL_WARN) << "The disk cache is not supported on"
+        " Windows and therefore disabled." << endl;
+#else
+    try {
+      disk_object_cache_.reset(new DiskObjectCache(
+          options_.disk_cache_path,
+          static_cast<uint64_t>(options_.disk_cache_size_mb) * 1024 * 1024));
+    } catch (const XtreemFSException& e) {
+      // Continue without the cache.
+      string error = "Failed to open the disk cache: " + string(e.what());
+      Logging::log->getLog(LEVEL_ERROR) << error << endl;
+      ErrorLog::error_log->AppendError(error);
+    }
+#endif  // WIN32
+  }
+
+  for (int i = 0; i < options_.async_writes_callback_threads; i++) {
+    async_write_callback_queues_.push_back(
+        new MPSCQueue<AsyncWriteHandler::CallbackEntry>());
+  }
+
   if (Logging::log->loggingActive(LEVEL_DEBUG)) {
     Logging::log->getLog(LEVEL_DEBUG) << "Created a new libxtreemfs Client "
         "object (version " << options.version_string << ")" << endl;
@@ -351,11 +521,23 @@ ClientImplementation::~ClientImplementation() {
   if (vivaldi_thread_.get() && vivaldi_thread_->joinable()) {
     vivaldi_thread_->join();
   }
+  if (osd_health_probe_thread_.get() && osd_health_probe_thread_->joinable()) {
+    osd_health_probe_thread_->join();
+  }
+  if (address_mappings_refresh_thread_.get() &&
+      address_mappings_refresh_thread_->joinable()) {
+    address_mappings_refresh_thread_->join();
+  }
+
+  for (size_t i = 0; i < async_write_callback_queues_.size(); i++) {
+    delete async_write_callback_queues_[i];
+  }
 
   atexit(google::protobuf::ShutdownProtobufLibrary);
 
   shutdown_logger();
   shutdown_error_log();
+  shutdown_latency_statistics();
 }
 
 void ClientImplementation::Start() {
@@ -387,9 +569,35 @@ void ClientImplementation::Start() {
                                                         vivaldi_.get())));
   }
 
-  async_write_callback_thread_.reset(
-      new boost::thread(&xtreemfs::AsyncWriteHandler::ProcessCallbacks, 
-                        boost::ref(async_write_callback_queue_)));
+  // Fetch the addresses of all services before the first request needs them.
+  if (options_.address_mappings_refresh_margin_s > 0) {
+    address_mappings_refresh_thread_.reset(new boost::thread(boost::bind(
+        &xtreemfs::DIRUUIDResolver::RunAddressMappingsRefresh,
+        &uuid_resolver_)));
+  }
+
+  if (osd_health_registry_.get()) {
+    osd_health_registry_->Initialize(network_client_.get());
+    osd_health_probe_thread_.reset(new boost::thread(boost::bind(
+        &xtreemfs::OSDHealthRegistry::Run, osd_health_registry_.get())));
+  }
+
+  for (size_t i = 0; i < async_write_callback_queues_.size(); i++) {
+    async_write_callback_threads_.create_thread(boost::bind(
+        &xtreemfs::AsyncWriteHandler::ProcessCallbacks,
+        boost::ref(*async_write_callback_queues_[i])));
+  }
+
+  async_io_completion_thread_.reset(new boost::thread(boost::bind(
+      &xtreemfs::AsyncIOOperation::ProcessCompletions,
+      boost::ref(async_io_completion_queue_),
+      boost::ref(async_io_retry_queue_))));
+
+  for (int i = 0; i < options_.async_io_retry_threads; i++) {
+    async_io_retry_threads_.create_thread(boost::bind(
+        &xtreemfs::AsyncIOOperation::ProcessRetries,
+        boost::ref(async_io_retry_queue_)));
+  }
 }
 
 void ClientImplementation::Shutdown() {
@@ -406,15 +614,33 @@ void ClientImplementation::Shutdown() {
       it = list_open_volumes_.erase(it);
     }
 
-    if (async_write_callback_thread_->joinable()) {
-      async_write_callback_thread_->interrupt();
-      async_write_callback_thread_->join();
+    async_write_callback_threads_.interrupt_all();
+    async_write_callback_threads_.join_all();
+
+    if (async_io_completion_thread_.get() &&
+        async_io_completion_thread_->joinable()) {
+      async_io_completion_thread_->interrupt();
+      async_io_completion_thread_->join();
     }
+    async_io_retry_threads_.interrupt_all();
+    async_io_retry_threads_.join_all();
 
     // Stop vivaldi thread if running
     if (vivaldi_thread_.get() && vivaldi_thread_->joinable()) {
       vivaldi_thread_->interrupt();
     }
+
+    // Stop OSD health probing. Joined in the destructor after the network
+    // client was shut down, see Vivaldi thread.
+    if (osd_health_probe_thread_.get() &&
+        osd_health_probe_thread_->joinable()) {
+      osd_health_probe_thread_->interrupt();
+    }
+
+    if (address_mappings_refresh_thread_.get() &&
+        address_mappings_refresh_thread_->joinable()) {
+      address_mappings_refresh_thread_->interrupt();
+    }
   }
 }
 
@@ -756,12 +982,45 @@ std::string ClientImplementation::UUIDToAddress(const std::string& uuid) {
   return result;
 }
 
+void ClientImplementation::GetAsyncWriteWindows(
+    std::map<std::string, AsyncWriteWindow>* windows) {
+  if (write_window_controller_.get()) {
+    write_window_controller_->GetWindows(windows);
+  }
+}
+
 const VivaldiCoordinates& ClientImplementation::GetVivaldiCoordinates() const {
   return vivaldi_->GetVivaldiCoordinates();
 }
 
-util::SynchronizedQueue<AsyncWriteHandler::CallbackEntry>& ClientImplementation::GetAsyncWriteCallbackQueue() {
-  return async_write_callback_queue_;
+util::MPSCQueue<AsyncWriteHandler::CallbackEntry>& ClientImplementation::GetAsyncWriteCallbackQueue() {
+  uint32_t i = atomic_inc32(&next_async_write_callback_queue_);
+  return *async_write_callback_queues_[i % async_write_callback_queues_.size()];
+}
+
+util::SynchronizedQueue<AsyncIOOperation*>&
+ClientImplementation::GetAsyncIOCompletionQueue() {
+  return async_io_completion_queue_;
+}
+
+OSDHealthRegistry* ClientImplementation::GetOSDHealthRegistry() {
+  return osd_health_registry_.get();
+}
+
+WriteWindowController* ClientImplementation::GetWriteWindowController() {
+  return write_window_controller_.get();
+}
+
+DiskObjectCache* ClientImplementation::GetDiskObjectCache() {
+  return disk_object_cache_.get();
+}
+
+UUIDCache* ClientImplementation::GetUUIDCache() {
+  return uuid_resolver_.GetUUIDCache();
+}
+
+Vivaldi* ClientImplementation::GetVivaldi() {
+  return vivaldi_.get();
 }
 
 }  // namespace xtreemfs
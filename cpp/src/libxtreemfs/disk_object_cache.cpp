@@ -0,0 +1,425 @@
+/*
+ * Copyright (c) 2026 by the XtreemFS Authors, see AUTHORS file
+ *
+ * Licensed under the BSD License, see LICENSE file for details.
+ *
+ */
+
+#ifndef WIN32
+#include "libxtreemfs/disk_object_cache.h"
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <boost/lexical_cast.hpp>
+#include <vector>
+
+#include "libxtreemfs/xtreemfs_exception.h"
+#include "util/logging.h"
+
+using namespace std;
+using namespace xtreemfs::util;
+
+namespace xtreemfs {
+
+static const char kIndexMagic[8] = { 'X', 'T', 'F', 'S', 'O', 'B', 'J', 'C' };
+static const uint32_t kIndexVersion = 1;
+
+/** Size of the cache per index entry. */
+static const uint64_t kBytesPerIndexEntry = 128 * 1024;
+static const size_t kMinIndexEntries = 64;
+
+static const uint32_t kEntryFree = 0;
+static const uint32_t kEntryValid = 1;
+
+static const char kIndexFileName[] = "index";
+static const char kObjectFileSuffix[] = ".obj";
+static const char kTemporaryFilePrefix[] = "tmp.";
+
+struct DiskObjectCache::IndexHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t reserved1;
+  uint64_t entries;
+  /** Incremented by every access, used as timestamp for the LRU order. */
+  uint64_t access_clock;
+  char reserved2[32];
+};
+
+struct DiskObjectCache::IndexEntry {
+  uint32_t state;
+  int32_t size;
+  uint64_t object_number;
+  uint32_t truncate_epoch;
+  uint32_t xlocset_version;
+  uint64_t last_access;
+  char file_id[kMaxFileIdLength + 1];
+};
+
+DiskObjectCache::DiskObjectCache(const std::string& path,
+                                 uint64_t max_size_bytes)
+    : path_(path),
+      max_size_bytes_(max_size_bytes),
+      index_fd_(-1),
+      index_mapping_(NULL),
+      index_mapping_size_(0),
+      header_(NULL),
+      entries_(NULL),
+      size_bytes_(0),
+      generation_(0) {
+  if (mkdir(path_.c_str(), 0700) != 0 && errno != EEXIST) {
+    throw XtreemFSException("Failed to create the directory of the disk"
+        " cache: " + path_ + " (" + strerror(errno) + ")");
+  }
+
+  OpenIndex(max(kMinIndexEntries,
+                static_cast<size_t>(max_size_bytes_ / kBytesPerIndexEntry)));
+  RemoveUnreferencedFiles();
+
+  // The budget may have been reduced since the last start.
+  boost::mutex::scoped_lock lock(mutex_);
+  while (size_bytes_ > max_size_bytes_ && !lru_.empty()) {
+    RemoveEntryUnmutexed(lru_.begin()->second);
+  }
+
+  if (Logging::log->loggingActive(LEVEL_INFO)) {
+    Logging::log->getLog(LEVEL_INFO) << "Opened the disk cache " << path_
+        << " with " << objects_.size() << " objects (" << size_bytes_
+        << " bytes)." << endl;
+  }
+}
+
+DiskObjectCache::~DiskObjectCache() {
+  if (index_mapping_) {
+    munmap(index_mapping_, index_mapping_size_);
+  }
+  if (index_fd_ >= 0) {
+    // Also releases the lock.
+    close(index_fd_);
+  }
+}
+
+void DiskObjectCache::OpenIndex(size_t entries) {
+  string index_path = path_ + "/" + kIndexFileName;
+  index_fd_ = open(index_path.c_str(), O_RDWR | O_CREAT, 0600);
+  if (index_fd_ < 0) {
+    throw XtreemFSException("Failed to open the index of the disk cache: "
+        + index_path + " (" + strerror(errno) + ")");
+  }
+  if (flock(index_fd_, LOCK_EX | LOCK_NB) != 0) {
+    close(index_fd_);
+    index_fd_ = -1;
+    throw XtreemFSException("The disk cache " + path_ + " is already used by"
+        " another client.");
+  }
+
+  index_mapping_size_ = sizeof(IndexHeader) + entries * sizeof(IndexEntry);
+  struct stat index_stat;
+  bool size_matches = fstat(index_fd_, &index_stat) == 0 &&
+      static_cast<size_t>(index_stat.st_size) == index_mapping_size_;
+  if (!size_matches &&
+      (ftruncate(index_fd_, 0) != 0 ||
+       ftruncate(index_fd_, index_mapping_size_) != 0)) {
+    close(index_fd_);
+    index_fd_ = -1;
+    throw XtreemFSException("Failed to resize the index of the disk cache: "
+        + index_path + " (" + strerror(errno) + ")");
+  }
+
+  index_mapping_ = mmap(NULL,
+                        index_mapping_size_,
+                        PROT_READ | PROT_WRITE,
+                        MAP_SHARED,
+                        index_fd_,
+                        0);
+  if (index_mapping_ == MAP_FAILED) {
+    index_mapping_ = NULL;
+    close(index_fd_);
+    index_fd_ = -1;
+    throw XtreemFSException("Failed to map the index of the disk cache: "
+        + index_path + " (" + strerror(errno) + ")");
+  }
+  header_ = static_cast<IndexHeader*>(index_mapping_);
+  entries_ = reinterpret_cast<IndexEntry*>(header_ + 1);
+
+  if (!size_matches ||
+      memcmp(header_->magic, kIndexMagic, sizeof(kIndexMagic)) != 0 ||
+      header_->version != kIndexVersion ||
+      header_->entries != entries) {
+    // New or incompatible index: start with an empty cache.
+    memset(index_mapping_, 0, index_mapping_size_);
+    memcpy(header_->magic, kIndexMagic, sizeof(kIndexMagic));
+    header_->version = kIndexVersion;
+    header_->entries = entries;
+  }
+
+  boost::mutex::scoped_lock lock(mutex_);
+  // Use the entries with the lowest index first.
+  for (size_t i = entries; i-- > 0;) {
+    IndexEntry& entry = entries_[i];
+    entry.file_id[kMaxFileIdLength] = '\0';
+    if (entry.state != kEntryValid) {
+      entry.state = kEntryFree;
+      free_entries_.push_back(i);
+      continue;
+    }
+
+    ObjectId object_id(entry.file_id, entry.object_number);
+    if (entry.size < 0 || objects_.find(object_id) != objects_.end()) {
+      entry.state = kEntryFree;
+      free_entries_.push_back(i);
+      continue;
+    }
+    objects_[object_id] = i;
+    lru_.insert(make_pair(entry.last_access, i));
+    size_bytes_ += entry.size;
+  }
+}
+
+void DiskObjectCache::RemoveUnreferencedFiles() {
+  DIR* directory = opendir(path_.c_str());
+  if (directory == NULL) {
+    return;
+  }
+
+  const size_t suffix_length = strlen(kObjectFileSuffix);
+  const size_t prefix_length = strlen(kTemporaryFilePrefix);
+  struct dirent* directory_entry;
+  while ((directory_entry = readdir(directory)) != NULL) {
+    string name = directory_entry->d_name;
+    bool remove = false;
+    if (name.compare(0, prefix_length, kTemporaryFilePrefix) == 0) {
+      // Left over by a crashed Store().
+      remove = true;
+    } else if (name.size() > suffix_length &&
+               name.compare(name.size() - suffix_length,
+                            suffix_length,
+                            kObjectFileSuffix) == 0) {
+      try {
+        size_t index = boost::lexical_cast<size_t>(
+            name.substr(0, name.size() - suffix_length));
+        remove = index >= header_->entries ||
+                 entries_[index].state != kEntryValid;
+      } catch (const boost::bad_lexical_cast&) {
+        // Not created by us.
+      }
+    }
+    if (remove) {
+      unlink((path_ + "/" + name).c_str());
+    }
+  }
+  closedir(directory);
+}
+
+int DiskObjectCache::Read(const Key& key,
+                          char* buffer,
+                          int offset_in_object,
+                          int length) {
+  int fd;
+  int object_size;
+  {
+    boost::mutex::scoped_lock lock(mutex_);
+    ObjectMap::iterator it
+        = objects_.find(ObjectId(key.file_id, key.object_number));
+    if (it == objects_.end()) {
+      return -1;
+    }
+    size_t index = it->second;
+    const IndexEntry& entry = entries_[index];
+    if (entry.truncate_epoch != key.truncate_epoch ||
+        entry.xlocset_version != key.xlocset_version) {
+      RemoveEntryUnmutexed(index);
+      return -1;
+    }
+
+    // Open the file while holding the lock: it may be replaced afterwards,
+    // but an open file descriptor still refers to the old content.
+    fd = open(GetObjectPath(index).c_str(), O_RDONLY);
+    if (fd < 0) {
+      RemoveEntryUnmutexed(index);
+      return -1;
+    }
+    object_size = entry.size;
+    TouchEntryUnmutexed(index);
+  }
+
+  int bytes_to_read = max(0, min(length, object_size - offset_in_object));
+  ssize_t bytes_read = 0;
+  if (bytes_to_read > 0) {
+    bytes_read = pread(fd, buffer, bytes_to_read, offset_in_object);
+  }
+  close(fd);
+
+  if (bytes_read != bytes_to_read) {
+    // The file is damaged, e.g. after a crash. Read from the OSD instead.
+    return -1;
+  }
+  return bytes_to_read;
+}
+
+uint64_t DiskObjectCache::GetGeneration() const {
+  return generation_.load();
+}
+
+void DiskObjectCache::Store(const Key& key,
+                            const char* data,
+                            int size,
+                            uint64_t generation) {
+  if (key.file_id.size() > kMaxFileIdLength ||
+      size < 0 ||
+      static_cast<uint64_t>(size) > max_size_bytes_) {
+    return;
+  }
+
+  // Write the data outside of the lock into a temporary file.
+  string temporary_path = path_ + "/" + kTemporaryFilePrefix + "XXXXXX";
+  vector<char> temporary_path_buffer(temporary_path.begin(),
+                                     temporary_path.end());
+  temporary_path_buffer.push_back('\0');
+  int fd = mkstemp(&temporary_path_buffer[0]);
+  if (fd < 0) {
+    if (Logging::log->loggingActive(LEVEL_WARN)) {
+      Logging::log->getLog(LEVEL_WARN) << "Failed to create a file in the"
+          " disk cache " << path_ << ": " << strerror(errno) << endl;
+    }
+    return;
+  }
+  temporary_path = &temporary_path_buffer[0];
+
+  ssize_t written = 0;
+  while (written < size) {
+    ssize_t result = write(fd, data + written, size - written);
+    if (result < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      break;
+    }
+    written += result;
+  }
+  close(fd);
+  if (written != size) {
+    if (Logging::log->loggingActive(LEVEL_WARN)) {
+      Logging::log->getLog(LEVEL_WARN) << "Failed to write an object to the"
+          " disk cache " << path_ << ": " << strerror(errno) << endl;
+    }
+    unlink(temporary_path.c_str());
+    return;
+  }
+
+  boost::mutex::scoped_lock lock(mutex_);
+  if (generation_.load() != generation) {
+    unlink(temporary_path.c_str());
+    return;
+  }
+
+  ObjectId object_id(key.file_id, key.object_number);
+  ObjectMap::iterator it = objects_.find(object_id);
+  if (it != objects_.end()) {
+    RemoveEntryUnmutexed(it->second);
+  }
+  while ((size_bytes_ + size > max_size_bytes_ || free_entries_.empty()) &&
+         !lru_.empty()) {
+    RemoveEntryUnmutexed(lru_.begin()->second);
+  }
+
+  size_t index = free_entries_.back();
+  if (rename(temporary_path.c_str(), GetObjectPath(index).c_str()) != 0) {
+    unlink(temporary_path.c_str());
+    return;
+  }
+  free_entries_.pop_back();
+
+  IndexEntry& entry = entries_[index];
+  entry.size = size;
+  entry.object_number = key.object_number;
+  entry.truncate_epoch = key.truncate_epoch;
+  entry.xlocset_version = key.xlocset_version;
+  entry.last_access = ++header_->access_clock;
+  memset(entry.file_id, 0, sizeof(entry.file_id));
+  memcpy(entry.file_id, key.file_id.data(), key.file_id.size());
+  // Mark the entry as valid only after all other fields were written.
+  entry.state = kEntryValid;
+
+  objects_[object_id] = index;
+  lru_.insert(make_pair(entry.last_access, index));
+  size_bytes_ += size;
+}
+
+void DiskObjectCache::Validate(const std::string& file_id,
+                               uint32_t truncate_epoch,
+                               uint32_t xlocset_version) {
+  boost::mutex::scoped_lock lock(mutex_);
+
+  vector<size_t> outdated_entries;
+  for (ObjectMap::iterator it = objects_.lower_bound(ObjectId(file_id, 0));
+       it != objects_.end() && it->first.first == file_id;
+       ++it) {
+    const IndexEntry& entry = entries_[it->second];
+    if (entry.truncate_epoch != truncate_epoch ||
+        entry.xlocset_version != xlocset_version) {
+      outdated_entries.push_back(it->second);
+    }
+  }
+  for (size_t i = 0; i < outdated_entries.size(); i++) {
+    RemoveEntryUnmutexed(outdated_entries[i]);
+  }
+}
+
+void DiskObjectCache::Invalidate(const std::string& file_id) {
+  boost::mutex::scoped_lock lock(mutex_);
+  ++generation_;
+
+  vector<size_t> file_entries;
+  for (ObjectMap::iterator it = objects_.lower_bound(ObjectId(file_id, 0));
+       it != objects_.end() && it->first.first == file_id;
+       ++it) {
+    file_entries.push_back(it->second);
+  }
+  for (size_t i = 0; i < file_entries.size(); i++) {
+    RemoveEntryUnmutexed(file_entries[i]);
+  }
+}
+
+size_t DiskObjectCache::size() {
+  boost::mutex::scoped_lock lock(mutex_);
+  return objects_.size();
+}
+
+uint64_t DiskObjectCache::size_bytes() {
+  boost::mutex::scoped_lock lock(mutex_);
+  return size_bytes_;
+}
+
+void DiskObjectCache::RemoveEntryUnmutexed(size_t index) {
+  IndexEntry& entry = entries_[index];
+  lru_.erase(make_pair(entry.last_access, index));
+  objects_.erase(ObjectId(entry.file_id, entry.object_number));
+  size_bytes_ -= entry.size;
+  entry.state = kEntryFree;
+  unlink(GetObjectPath(index).c_str());
+  free_entries_.push_back(index);
+}
+
+void DiskObjectCache::TouchEntryUnmutexed(size_t index) {
+  IndexEntry& entry = entries_[index];
+  lru_.erase(make_pair(entry.last_access, index));
+  entry.last_access = ++header_->access_clock;
+  lru_.insert(make_pair(entry.last_access, index));
+}
+
+std::string DiskObjectCache::GetObjectPath(size_t index) const {
+  return path_ + "/" + boost::lexical_cast<string>(index) + kObjectFileSuffix;
+}
+
+}  // namespace xtreemfs
+#endif  // !WIN32
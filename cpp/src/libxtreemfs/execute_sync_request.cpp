@@ -22,6 +22,7 @@
 
 #include "libxtreemfs/interrupt.h"
 #include "libxtreemfs/options.h"
+#include "libxtreemfs/osd_health_registry.h"
 #include "libxtreemfs/uuid_iterator.h"
 #include "libxtreemfs/uuid_resolver.h"
 #include "libxtreemfs/xcap_handler.h"
@@ -247,8 +248,20 @@ rpc::SyncCallbackBase* ExecuteSyncRequest(
          uuid_iterator->MarkUUIDAsFailed(service_address);
          uuid_iterator->GetUUID(&service_address);
         } else {
+         OSDHealthRegistry* health_registry = uuid_iterator->health_registry();
+         const string failed_uuid = service_uuid;
+         if (health_registry != NULL) {
+           health_registry->ReportFailure(failed_uuid);
+         }
          uuid_iterator->MarkUUIDAsFailed(service_uuid);
          uuid_iterator->GetUUID(&service_uuid);
+         // Fail over immediately if the server is known to be dead and
+         // another replica is available.
+         if (health_registry != NULL &&
+             service_uuid != failed_uuid &&
+             health_registry->IsDead(failed_uuid)) {
+           delayRetry = false;
+         }
         }
       }
 
@@ -349,6 +362,10 @@ rpc::SyncCallbackBase* ExecuteSyncRequest(
 
   // Request was successful.
   if (response && !response->HasFailed()) {
+    if (!uuid_iterator_has_addresses &&
+        uuid_iterator->health_registry() != NULL) {
+      uuid_iterator->health_registry()->ReportSuccess(service_uuid);
+    }
     if (attempt > 1 || max_redirects_in_a_row_exceeded) {
       string msg = "After retrying the client succeeded to receive a response"
           " at attempt " + boost::lexical_cast<string>(attempt)
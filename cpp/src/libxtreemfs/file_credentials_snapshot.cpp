@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2026 by the XtreemFS Authors, see AUTHORS file
+ *
+ * Licensed under the BSD License, see LICENSE file for details.
+ *
+ */
+
+#include "libxtreemfs/file_credentials_snapshot.h"
+
+#include <cassert>
+
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
+#include <google/protobuf/wire_format_lite.h>
+#include <string>
+
+#include "xtreemfs/OSD.pb.h"
+
+using namespace std;
+using namespace xtreemfs::pbrpc;
+using google::protobuf::internal::WireFormatLite;
+using google::protobuf::io::CodedOutputStream;
+using google::protobuf::io::StringOutputStream;
+
+namespace xtreemfs {
+
+FileCredentialsSnapshot::FileCredentialsSnapshot(
+    boost::shared_ptr<const pbrpc::XCap> xcap,
+    boost::shared_ptr<const pbrpc::XLocSet> xlocs)
+    : xcap_(xcap),
+      xlocs_(xlocs) {
+  // Splicing relies on the same field number in all requests.
+  assert(readRequest::kFileCredentialsFieldNumber == kFieldNumber);
+  assert(writeRequest::kFileCredentialsFieldNumber == kFieldNumber);
+
+  FileCredentials file_credentials;
+  file_credentials.mutable_xcap()->CopyFrom(*xcap_);
+  file_credentials.mutable_xlocs()->CopyFrom(*xlocs_);
+  serialized_field_ = SerializeField(file_credentials);
+}
+
+std::string FileCredentialsSnapshot::SerializeFieldWithXCap(
+    const pbrpc::XCap& xcap) const {
+  FileCredentials file_credentials;
+  file_credentials.mutable_xcap()->CopyFrom(xcap);
+  file_credentials.mutable_xlocs()->CopyFrom(*xlocs_);
+  return SerializeField(file_credentials);
+}
+
+std::string FileCredentialsSnapshot::SerializeField(
+    const pbrpc::FileCredentials& file_credentials) {
+  string field;
+  {
+    StringOutputStream output(&field);
+    CodedOutputStream coded_output(&output);
+    coded_output.WriteTag(WireFormatLite::MakeTag(
+        kFieldNumber, WireFormatLite::WIRETYPE_LENGTH_DELIMITED));
+    coded_output.WriteVarint32(file_credentials.ByteSize());
+    file_credentials.SerializeWithCachedSizes(&coded_output);
+  }
+  return field;
+}
+
+const std::string& RequestFileCredentials::serialized_field() {
+  if (!renewed_xcap_.has_file_id()) {
+    return snapshot_.serialized_field();
+  }
+  renewed_field_ = snapshot_.SerializeFieldWithXCap(renewed_xcap_);
+  return renewed_field_;
+}
+
+}  // namespace xtreemfs
@@ -8,7 +8,9 @@
 
 #include "libxtreemfs/file_handle_implementation.h"
 
+#include <algorithm>
 #include <boost/bind.hpp>
+#include <google/protobuf/descriptor.h>
 #include <map>
 #include <memory>
 #include <string>
@@ -16,16 +18,26 @@
 
 #include "libxtreemfs/async_write_buffer.h"
 #include "libxtreemfs/execute_sync_request.h"
+#include "libxtreemfs/file_credentials_snapshot.h"
 #include "libxtreemfs/file_info.h"
 #include "libxtreemfs/helper.h"
+#include "libxtreemfs/interrupt.h"
+#include "libxtreemfs/io_throttle.h"
+#include "libxtreemfs/local_lock_manager.h"
 #include "libxtreemfs/options.h"
+#include "libxtreemfs/osd_endpoint_table.h"
+#include "libxtreemfs/osd_health_registry.h"
 #include "libxtreemfs/stripe_translator.h"
 #include "libxtreemfs/container_uuid_iterator.h"
+#include "libxtreemfs/disk_object_cache.h"
 #include "libxtreemfs/simple_uuid_iterator.h"
+#include "libxtreemfs/splicing_osd_service_client.h"
 #include "libxtreemfs/uuid_resolver.h"
 #include "libxtreemfs/volume.h"
 #include "libxtreemfs/xtreemfs_exception.h"
+#include "util/crc32c.h"
 #include "util/error_log.h"
+#include "util/latency_histogram.h"
 #include "util/logging.h"
 #include "xtreemfs/MRCServiceClient.h"
 #include "xtreemfs/OSD.pb.h"
@@ -41,6 +53,54 @@ using std::map;
 
 namespace xtreemfs {
 
+/** Initial delay between two attempts to acquire a lock at the OSD. */
+static const int kMinLockRetryDelayMs = 10;
+
+/** No OSD was used yet. */
+static const int kLastOSDNone = -2;
+
+/** The last used OSD is the current one of the FileInfo's UUIDIterator. */
+static const int kLastOSDOfUUIDIterator = -1;
+
+/** Throws the exception for "error" which ExecuteSyncRequest() would throw
+ *  if the write to "osd_uuid" finally failed with it. */
+static void ThrowWriteError(const RPCHeader::ErrorResponse& error,
+                            const std::string& osd_uuid) {
+  string error_message = error.error_message();
+  if (error_message.empty()) {
+    error_message = "none given";
+  }
+  const ::google::protobuf::EnumValueDescriptor* enum_desc =
+      ErrorType_descriptor()->FindValueByNumber(error.error_type());
+  string message = "The write to the server " + osd_uuid + " failed: "
+      + (enum_desc ? enum_desc->name()
+                   : boost::lexical_cast<string>(error.error_type()))
+      + " Error: " + error_message;
+  switch (error.error_type()) {
+    case ERRNO:
+      if (Logging::log->loggingActive(LEVEL_INFO)) {
+        Logging::log->getLog(LEVEL_INFO) << message << endl;
+      }
+      throw PosixErrorException(error.posix_errno(), message);
+    case IO_ERROR:
+      Logging::log->getLog(LEVEL_ERROR) << message << endl;
+      ErrorLog::error_log->AppendError(message);
+      throw IOException(error_message);
+    case INTERNAL_SERVER_ERROR:
+      Logging::log->getLog(LEVEL_ERROR) << message << endl;
+      ErrorLog::error_log->AppendError(message);
+      throw InternalServerErrorException(error_message);
+    case INVALID_VIEW:
+      Logging::log->getLog(LEVEL_ERROR) << message << endl;
+      ErrorLog::error_log->AppendError(message);
+      throw InvalidViewException(message);
+    default:
+      Logging::log->getLog(LEVEL_ERROR) << message << endl;
+      ErrorLog::error_log->AppendError(message);
+      throw XtreemFSException(message);
+  }
+}
+
 /** Constructor called by FileInfo.CreateFileHandle().
  *
  * @remark The ownership of all parameters will not be transferred. For every
@@ -55,10 +115,11 @@ FileHandleImplementation::FileHandleImplementation(
     UUIDIterator* osd_uuid_iterator,
     UUIDResolver* uuid_resolver,
     xtreemfs::pbrpc::MRCServiceClient* mrc_service_client,
-    xtreemfs::pbrpc::OSDServiceClient* osd_service_client,
+    SplicingOSDServiceClient* osd_service_client,
     const std::map<xtreemfs::pbrpc::StripingPolicyType,
                    StripeTranslator*>& stripe_translators,
     bool async_writes_enabled,
+    IOThrottle* io_throttle,
     const Options& options,
     const xtreemfs::pbrpc::Auth& auth_bogus,
     const xtreemfs::pbrpc::UserCredentials& user_credentials_bogus)
@@ -73,6 +134,7 @@ FileHandleImplementation::FileHandleImplementation(
       osd_service_client_(osd_service_client),
       stripe_translators_(stripe_translators),
       async_writes_enabled_(async_writes_enabled),
+      io_throttle_(io_throttle),
       async_writes_failed_(false),
       volume_options_(options),
       auth_bogus_(auth_bogus),
@@ -83,7 +145,8 @@ FileHandleImplementation::FileHandleImplementation(
                     mrc_uuid_iterator,
                     auth_bogus_,
                     user_credentials_bogus_),
-      last_osd_address_("") {
+      pending_async_io_(0),
+      last_osd_position_(kLastOSDNone) {
 }
 
 FileHandleImplementation::~FileHandleImplementation() {}
@@ -138,12 +201,37 @@ T FileHandleImplementation::ExecuteViewCheckedOperation(
 }
 
 int FileHandleImplementation::Read(char *buf, size_t count, int64_t offset) {
+  ScopedLatencyRecorder latency(
+      LatencyStatistics::GetHistogram(LatencyStatistics::kRead));
+  ThrottleIO(count);
   boost::function<int()> operation(
       boost::bind(&FileHandleImplementation::DoRead, this,
                   buf, count, offset));
   return ExecuteViewCheckedOperation(operation);
 }
 
+boost::shared_ptr<const FileCredentialsSnapshot>
+FileHandleImplementation::GetFileCredentialsSnapshot(
+    boost::shared_ptr<UUIDContainer>* uuid_container,
+    boost::shared_ptr<OSDEndpointTable>* osd_endpoints) {
+  boost::shared_ptr<const XCap> xcap = xcap_manager_.GetXCapSnapshot();
+  boost::shared_ptr<const XLocSet> xlocset =
+      file_info_->GetXLocSetSnapshot(uuid_container, osd_endpoints);
+
+  // The snapshot keeps its XCap and XLocSet alive, i.e. equal addresses mean
+  // equal objects.
+  boost::shared_ptr<const FileCredentialsSnapshot> snapshot =
+      boost::atomic_load(&file_credentials_snapshot_);
+  if (!snapshot ||
+      &snapshot->xcap() != xcap.get() ||
+      &snapshot->xlocs() != xlocset.get()) {
+    // Concurrent callers may build equal snapshots. Any of them may win.
+    snapshot.reset(new FileCredentialsSnapshot(xcap, xlocset));
+    boost::atomic_store(&file_credentials_snapshot_, snapshot);
+  }
+  return snapshot;
+}
+
 int FileHandleImplementation::DoRead(
     char *buf,
     size_t count,
@@ -155,12 +243,12 @@ int FileHandleImplementation::DoRead(
   }
 
   // Prepare request object.
-  FileCredentials file_credentials;
-  xcap_manager_.GetXCap(file_credentials.mutable_xcap());
-  boost::shared_ptr<UUIDContainer> osd_uuid_container =
-      file_info_->GetXLocSetAndUUIDContainer(file_credentials.mutable_xlocs());
+  boost::shared_ptr<UUIDContainer> osd_uuid_container;
+  boost::shared_ptr<OSDEndpointTable> osd_endpoints;
+  boost::shared_ptr<const FileCredentialsSnapshot> file_credentials =
+      GetFileCredentialsSnapshot(&osd_uuid_container, &osd_endpoints);
   // Use a reference for shorter code.
-  const XLocSet& xlocs = file_credentials.xlocs();
+  const XLocSet& xlocs = file_credentials->xlocs();
 
   size_t received_data = 0;
 
@@ -202,6 +290,8 @@ int FileHandleImplementation::DoRead(
       temp_uuid_iterator_for_striping.reset(
           new ContainerUUIDIterator(osd_uuid_container,
                                     operations[j].osd_offsets));
+      temp_uuid_iterator_for_striping->set_health_registry(
+          client_->GetOSDHealthRegistry());
       uuid_iterator = temp_uuid_iterator_for_striping.get();
     } else {
       // TODO(mberlin): Enhance UUIDIterator to read from different replicas.
@@ -209,20 +299,14 @@ int FileHandleImplementation::DoRead(
     }
 
     received_data +=
-        ReadFromOSD(uuid_iterator, file_credentials, operations[j].obj_number,
-        operations[j].data, operations[j].req_offset,
+        ReadFromOSD(uuid_iterator, osd_endpoints.get(), *file_credentials,
+        operations[j].obj_number, operations[j].data, operations[j].req_offset,
         operations[j].req_size);
+  }
 
-
-    boost::mutex::scoped_try_lock last_osd_lock(last_osd_mutex_);
-    if (last_osd_lock.owns_lock()) {
-     std::string last_osd_uuid = "";
-     uuid_iterator->GetUUID(&last_osd_uuid);
-     uuid_resolver_->UUIDToAddressWithOptions(
-         last_osd_uuid, &last_osd_address_, RPCOptions(
-             volume_options_.max_read_tries, volume_options_.retry_delay_s,
-             false, volume_options_.was_interrupted_function));
-     }
+  if (!operations.empty()) {
+    SetLastOSD(xlocs.replicas(0).osd_uuids_size() > 1,
+               operations.back().osd_offsets);
   }
 
   return received_data;
@@ -230,34 +314,116 @@ int FileHandleImplementation::DoRead(
 
 int FileHandleImplementation::ReadFromOSD(
     UUIDIterator* uuid_iterator,
-    const FileCredentials& file_credentials,
+    OSDEndpointTable* osd_endpoints,
+    const FileCredentialsSnapshot& file_credentials,
+    int object_no, char* buffer, int offset_in_object,
+    int bytes_to_read) {
+  DiskObjectCache* disk_cache = client_->GetDiskObjectCache();
+  if (disk_cache == NULL) {
+    return ReadFromOSDUncached(uuid_iterator, osd_endpoints, file_credentials,
+                               object_no, buffer, offset_in_object,
+                               bytes_to_read);
+  }
+
+  DiskObjectCache::Key key(file_credentials.xcap().file_id(),
+                           object_no,
+                           file_credentials.xcap().truncate_epoch(),
+                           file_credentials.xlocs().version());
+  int cached_bytes = disk_cache->Read(key, buffer, offset_in_object,
+                                      bytes_to_read);
+  if (cached_bytes >= 0) {
+    return cached_bytes;
+  }
+
+  // Read the complete object to cache it.
+  const int object_size = file_credentials.xlocs().replicas(0)
+      .striping_policy().stripe_size() * 1024;
+  uint64_t generation = disk_cache->GetGeneration();
+  boost::scoped_array<char> object(new char[object_size]);
+  int object_bytes = ReadFromOSDUncached(uuid_iterator, osd_endpoints,
+                                         file_credentials, object_no,
+                                         object.get(), 0, object_size);
+  // The last object of a file is not cached: other clients may still append
+  // to it without changing the truncate epoch.
+  if (object_bytes == object_size) {
+    disk_cache->Store(key, object.get(), object_bytes, generation);
+  }
+
+  int received_data = max(0, min(bytes_to_read,
+                                 object_bytes - offset_in_object));
+  if (received_data > 0) {
+    memcpy(buffer, object.get() + offset_in_object, received_data);
+  }
+  return received_data;
+}
+
+int FileHandleImplementation::ReadFromOSDUncached(
+    UUIDIterator* uuid_iterator,
+    OSDEndpointTable* osd_endpoints,
+    const FileCredentialsSnapshot& file_credentials,
     int object_no, char* buffer, int offset_in_object,
     int bytes_to_read) {
   readRequest rq;
   rq.set_file_id(file_credentials.xcap().file_id());
-  rq.mutable_file_credentials()->CopyFrom(file_credentials);
   rq.set_object_number(object_no);
   rq.set_object_version(0);
   rq.set_offset(offset_in_object);
   rq.set_length(bytes_to_read);
 
-  boost::scoped_ptr<rpc::SyncCallbackBase> response(
-      ExecuteSyncRequest(
-          boost::bind(&xtreemfs::pbrpc::OSDServiceClient::read_sync,
-                      osd_service_client_,
-                      _1,
-                      boost::cref(auth_bogus_),
-                      boost::cref(user_credentials_bogus_),
-                      &rq),
-          uuid_iterator,
-          uuid_resolver_,
-          RPCOptions(volume_options_.max_read_tries,
-                     volume_options_.retry_delay_s,
-                     false,
-                     volume_options_.was_interrupted_function),
-          false,
-          &xcap_manager_,
-          rq.mutable_file_credentials()->mutable_xcap()));
+  // Objects with a wrong checksum are read again from every replica at most
+  // once, even if the number of read attempts is unlimited.
+  int max_checksum_attempts = file_credentials.xlocs().replicas_size() + 1;
+  if (volume_options_.max_read_tries > 0) {
+    max_checksum_attempts =
+        min(max_checksum_attempts, volume_options_.max_read_tries);
+  }
+
+  RequestFileCredentials request_credentials(file_credentials);
+  boost::scoped_ptr<rpc::SyncCallbackBase> response;
+  for (int attempt = 1; ; attempt++) {
+    // The inner bind is evaluated for every attempt, i.e. after
+    // ExecuteSyncRequest() possibly renewed the XCap.
+    response.reset(ExecuteSyncRequest(
+        boost::bind(&SplicingOSDServiceClient::read_with_credentials_sync,
+                    osd_service_client_,
+                    _1,
+                    boost::cref(auth_bogus_),
+                    boost::cref(user_credentials_bogus_),
+                    boost::bind(&RequestFileCredentials::serialized_field,
+                                &request_credentials),
+                    &rq),
+        uuid_iterator,
+        osd_endpoints,
+        RPCOptions(volume_options_.max_read_tries,
+                   volume_options_.retry_delay_s,
+                   false,
+                   volume_options_.was_interrupted_function),
+        false,
+        &xcap_manager_,
+        request_credentials.mutable_xcap()));
+    if (!volume_options_.object_checksums) {
+      break;
+    }
+
+    string osd_uuid;
+    uuid_iterator->GetUUID(&osd_uuid);
+    if (VerifyObjectData(
+            *static_cast<ObjectData*>(response->response()),
+            response->data(),
+            response->data_length(),
+            object_no,
+            osd_uuid)) {
+      break;
+    }
+    response->DeleteBuffers();
+    if (attempt >= max_checksum_attempts) {
+      throw PosixErrorException(POSIX_ERROR_EIO, "The data of object "
+          + boost::lexical_cast<string>(object_no) + " had a wrong checksum"
+          " in all " + boost::lexical_cast<string>(attempt) + " attempts.");
+    }
+    // Read the object again, from the next replica if there is one.
+    uuid_iterator->MarkUUIDAsFailed(osd_uuid);
+  }
 
   xtreemfs::pbrpc::ObjectData* data =
       static_cast<xtreemfs::pbrpc::ObjectData*>(response->response());
@@ -274,6 +440,9 @@ int FileHandleImplementation::ReadFromOSD(
 
 int FileHandleImplementation::Write(const char *buf, size_t count,
                                     int64_t offset) {
+  ScopedLatencyRecorder latency(
+      LatencyStatistics::GetHistogram(LatencyStatistics::kWrite));
+  ThrottleIO(count);
   boost::function<int()> operation(
       boost::bind(&FileHandleImplementation::DoWrite, this,
                   buf, count, offset));
@@ -287,13 +456,15 @@ int FileHandleImplementation::DoWrite(
   if (async_writes_enabled_) {
     ThrowIfAsyncWritesFailed();
   }
-  // Create copies of required data.
-  FileCredentials file_credentials;
-  xcap_manager_.GetXCap(file_credentials.mutable_xcap());
-  file_info_->GetXLocSet(file_credentials.mutable_xlocs());
+  // Get a consistent view on the required data.
+  boost::shared_ptr<OSDEndpointTable> osd_endpoints;
+  boost::shared_ptr<const FileCredentialsSnapshot> file_credentials =
+      GetFileCredentialsSnapshot(NULL, &osd_endpoints);
   // Use references for shorter code.
-  const string& global_file_id = file_credentials.xcap().file_id();
-  const XLocSet& xlocs = file_credentials.xlocs();
+  const string& global_file_id = file_credentials->xcap().file_id();
+  const XLocSet& xlocs = file_credentials->xlocs();
+  // Concurrent reads must not add the old data to the disk cache.
+  InvalidateDiskCache(global_file_id);
 
   if (xlocs.replicas_size() == 0) {
     string path;
@@ -327,18 +498,12 @@ int FileHandleImplementation::DoWrite(
     // Write all objects.
     for (size_t j = 0; j < operations.size(); j++) {
       write_request = new writeRequest();
-      write_request->mutable_file_credentials()->CopyFrom(file_credentials);
-      write_request->set_file_id(global_file_id);
-
-      write_request->set_object_number(operations[j].obj_number);
-      write_request->set_object_version(0);
-      write_request->set_offset(operations[j].req_offset);
-      write_request->set_lease_timeout(0);
-
-      ObjectData* data = write_request->mutable_object_data();
-      data->set_checksum(0);
-      data->set_invalid_checksum_on_osd(false);
-      data->set_zero_padding(0);
+      PrepareWriteRequest(*file_credentials,
+                          operations[j].obj_number,
+                          operations[j].req_offset,
+                          operations[j].data,
+                          operations[j].req_size,
+                          write_request);
 
       // Create new WriteBuffer and differ between striping and the rest (
       // (replication = use UUIDIterator, no replication = set specific UUID).
@@ -347,6 +512,7 @@ int FileHandleImplementation::DoWrite(
         // Replica is striped. Pick UUID from xlocset.
         write_buffer = new AsyncWriteBuffer(
             write_request,
+            file_credentials,
             operations[j].data,
             operations[j].req_size,
             this,
@@ -356,6 +522,7 @@ int FileHandleImplementation::DoWrite(
                                   operations[j].osd_offsets[0]));
       } else {
         write_buffer = new AsyncWriteBuffer(write_request,
+                                            file_credentials,
                                             operations[j].data,
                                             operations[j].req_size,
                                             this,
@@ -367,6 +534,9 @@ int FileHandleImplementation::DoWrite(
       // Processing of file size updates is handled by the FileInfo's
       // AsyncWriteHandler.
     }
+  } else if (xlocs.replicas(0).osd_uuids_size() > 1 && operations.size() > 1) {
+    // Synchronous writes to a striped file: Write to all OSDs at once.
+    WriteToOSDsInParallel(osd_endpoints.get(), *file_credentials, operations);
   } else {
     // Synchronous writes.
     string osd_uuid = "";
@@ -381,88 +551,630 @@ int FileHandleImplementation::DoWrite(
                                          0,  // Use first and only replica.
                                          operations[j].osd_offsets[0]);
         temp_uuid_iterator_for_striping.AddUUID(osd_uuid);
+        temp_uuid_iterator_for_striping.set_health_registry(
+            client_->GetOSDHealthRegistry());
         uuid_iterator = &temp_uuid_iterator_for_striping;
       } else {
         // TODO(mberlin): Enhance UUIDIterator to read from different replicas.
         uuid_iterator = osd_uuid_iterator_;
       }
 
-      WriteToOSD(uuid_iterator, file_credentials,
+      WriteToOSD(uuid_iterator, osd_endpoints.get(), *file_credentials,
                   operations[j].obj_number, operations[j].req_offset,
-                  operations[j].data, operations[j].req_size);
-
-
-      boost::mutex::scoped_try_lock last_osd_lock(last_osd_mutex_);
-      if (last_osd_lock.owns_lock()) {
-       std::string last_osd_uuid = "";
-       uuid_iterator->GetUUID(&last_osd_uuid);
-       uuid_resolver_->UUIDToAddressWithOptions(
-           last_osd_uuid, &last_osd_address_, RPCOptions(
-               volume_options_.max_read_tries, volume_options_.retry_delay_s,
-               false, volume_options_.was_interrupted_function));
-       }
+                  operations[j].data, operations[j].req_size,
+                  volume_options_.max_write_tries);
+    }
+    if (!operations.empty()) {
+      SetLastOSD(xlocs.replicas(0).osd_uuids_size() > 1,
+                 operations.back().osd_offsets);
     }
+    // A read which started during the write may have cached the old data.
+    InvalidateDiskCache(global_file_id);
   }
 
   return count;
 }
 
+void FileHandleImplementation::InvalidateDiskCache(
+    const std::string& global_file_id) {
+  DiskObjectCache* disk_cache = client_->GetDiskObjectCache();
+  if (disk_cache) {
+    disk_cache->Invalidate(global_file_id);
+  }
+}
+
+void FileHandleImplementation::PrepareWriteRequest(
+    const FileCredentialsSnapshot& file_credentials,
+    int object_no,
+    int offset_in_object,
+    const char* buffer,
+    int bytes_to_write,
+    writeRequest* write_request) {
+  write_request->set_file_id(file_credentials.xcap().file_id());
+  write_request->set_object_number(object_no);
+  write_request->set_object_version(0);
+  write_request->set_offset(offset_in_object);
+  write_request->set_lease_timeout(0);
+
+  ObjectData *data = write_request->mutable_object_data();
+  data->set_checksum(volume_options_.object_checksums
+                     ? CRC32C(buffer, bytes_to_write)
+                     : 0);
+  data->set_invalid_checksum_on_osd(false);
+  data->set_zero_padding(0);
+}
+
+bool FileHandleImplementation::VerifyObjectData(
+    const ObjectData& object_data,
+    const char* data,
+    int data_length,
+    int object_no,
+    const std::string& osd_uuid) {
+  if (!volume_options_.object_checksums) {
+    return true;
+  }
+
+  string error;
+  if (object_data.invalid_checksum_on_osd()) {
+    error = "The OSD reported a wrong checksum";
+  } else if (object_data.checksum() != 0 &&
+             object_data.checksum() != CRC32C(data, data_length)) {
+    error = "Received data with a wrong checksum";
+  } else {
+    return true;
+  }
+
+  string path;
+  file_info_->GetPath(&path);
+  error += " for object " + boost::lexical_cast<string>(object_no)
+      + " of file " + path;
+  if (!osd_uuid.empty()) {
+    error += " from OSD " + osd_uuid;
+  }
+  error += ".";
+  Logging::log->getLog(LEVEL_ERROR) << error << endl;
+  ErrorLog::error_log->AppendError(error);
+  return false;
+}
+
+void FileHandleImplementation::WriteToOSDsInParallel(
+    OSDEndpointTable* osd_endpoints,
+    const FileCredentialsSnapshot& file_credentials,
+    const std::vector<WriteOperation>& operations) {
+  OSDHealthRegistry* health_registry = client_->GetOSDHealthRegistry();
+  RPCOptions options(volume_options_.max_write_tries,
+                     volume_options_.retry_delay_s,
+                     false,
+                     volume_options_.was_interrupted_function);
+
+  // Send the first attempt of every object without waiting for a response.
+  // The requests reference "operations[j].data" and "write_requests", i.e.
+  // all of them have to be completed before this method may return or throw.
+  vector<writeRequest> write_requests(operations.size());
+  vector<rpc::SyncCallbackBase*> responses(operations.size(), NULL);
+  vector<size_t> failed_operations;
+  // Attempts of every failed operation which are left for WriteToOSD().
+  vector<int> failed_operations_tries;
+  try {
+    for (size_t j = 0; j < operations.size(); j++) {
+      PrepareWriteRequest(file_credentials,
+                          operations[j].obj_number,
+                          operations[j].req_offset,
+                          operations[j].data,
+                          operations[j].req_size,
+                          &write_requests[j]);
+
+      string osd_address;
+      try {
+        osd_endpoints->GetAddress(0,  // Use first and only replica.
+                                  operations[j].osd_offsets[0],
+                                  &osd_address,
+                                  options);
+      } catch (const XtreemFSException&) {
+        // Left to the sequential write below which reports the error.
+        continue;
+      }
+      responses[j] = osd_service_client_->write_with_credentials_sync(
+          osd_address,
+          auth_bogus_,
+          user_credentials_bogus_,
+          file_credentials.serialized_field(),
+          &write_requests[j],
+          operations[j].data,
+          operations[j].req_size);
+    }
+
+    // Wait for all responses.
+    for (size_t j = 0; j < operations.size(); j++) {
+      if (responses[j] == NULL) {
+        failed_operations.push_back(j);
+        failed_operations_tries.push_back(options.max_retries());
+        continue;
+      }
+      // HasFailed() is an interruption point. Take the ownership only after
+      // the request was processed.
+      bool has_failed = responses[j]->HasFailed();
+      boost::scoped_ptr<rpc::SyncCallbackBase> response(responses[j]);
+      responses[j] = NULL;
+      const string& osd_uuid =
+          osd_endpoints->GetUUID(0, operations[j].osd_offsets[0]);
+      if (has_failed) {
+        const ErrorType error_type = response->error()->error_type();
+        const bool is_temporary = error_type == IO_ERROR ||
+                                  error_type == INTERNAL_SERVER_ERROR;
+        // The retry below does not know about this attempt.
+        if (health_registry != NULL && is_temporary) {
+          health_registry->ReportFailure(osd_uuid);
+        }
+        // Like ExecuteSyncRequest(), an insufficient voucher does not count
+        // as attempt. Other errors, e.g. EACCES, ENOSPC or a redirect, are
+        // not retried for a striped file.
+        int tries_left = options.max_retries();
+        if (is_temporary && options.max_retries() > 0) {
+          tries_left--;
+        }
+        if ((!is_temporary && error_type != INSUFFICIENT_VOUCHER) ||
+            (is_temporary && options.max_retries() == 1)) {
+          RPCHeader::ErrorResponse error(*response->error());
+          response->DeleteBuffers();
+          ThrowWriteError(error, osd_uuid);
+        }
+        response->DeleteBuffers();
+        failed_operations.push_back(j);
+        failed_operations_tries.push_back(tries_left);
+      } else {
+        if (health_registry != NULL) {
+          health_registry->ReportSuccess(osd_uuid);
+        }
+        ProcessWriteResponse(response.get());
+      }
+    }
+  } catch (...) {
+    // Wait until all outstanding requests were processed - otherwise leaks
+    // and accesses to deleted memory may occur.
+    for (size_t j = 0; j < responses.size(); j++) {
+      if (responses[j] != NULL) {
+        responses[j]->HasFailed();
+        responses[j]->DeleteBuffers();
+        delete responses[j];
+      }
+    }
+    throw;
+  }
+
+  // Retry the failed objects one after another. Since these are regular
+  // synchronous writes, the error handling does not differ from a sequential
+  // write of all objects, except that the first attempt was already used.
+  for (size_t i = 0; i < failed_operations.size(); i++) {
+    const WriteOperation& operation = operations[failed_operations[i]];
+    SimpleUUIDIterator uuid_iterator;
+    uuid_iterator.AddUUID(osd_endpoints->GetUUID(0, operation.osd_offsets[0]));
+    uuid_iterator.set_health_registry(health_registry);
+    WriteToOSD(&uuid_iterator, osd_endpoints, file_credentials,
+               operation.obj_number, operation.req_offset,
+               operation.data, operation.req_size,
+               failed_operations_tries[i]);
+  }
+
+  SetLastOSD(true, operations.back().osd_offsets);
+}
+
 void FileHandleImplementation::WriteToOSD(
     UUIDIterator* uuid_iterator,
-    const FileCredentials& file_credentials,
+    OSDEndpointTable* osd_endpoints,
+    const FileCredentialsSnapshot& file_credentials,
     int object_no, int offset_in_object, const char* buffer,
-    int bytes_to_write) {
+    int bytes_to_write, int max_tries) {
   writeRequest write_request;
-  write_request.mutable_file_credentials()->CopyFrom(file_credentials);
-  write_request.set_file_id(file_credentials.xcap().file_id());
-  write_request.set_object_number(object_no);
-  write_request.set_object_version(0);
-  write_request.set_offset(offset_in_object);
-  write_request.set_lease_timeout(0);
-
-  ObjectData *data = write_request.mutable_object_data();
-  data->set_checksum(0);
-  data->set_invalid_checksum_on_osd(false);
-  data->set_zero_padding(0);
-
+  PrepareWriteRequest(file_credentials,
+                      object_no,
+                      offset_in_object,
+                      buffer,
+                      bytes_to_write,
+                      &write_request);
+
+  // The inner bind is evaluated for every attempt, i.e. after
+  // ExecuteSyncRequest() possibly renewed the XCap.
+  RequestFileCredentials request_credentials(file_credentials);
   boost::scoped_ptr<rpc::SyncCallbackBase> response(
       ExecuteSyncRequest(
           boost::bind(
-              &xtreemfs::pbrpc::OSDServiceClient::write_sync,
+              &SplicingOSDServiceClient::write_with_credentials_sync,
               osd_service_client_,
               _1,
               boost::cref(auth_bogus_),
               boost::cref(user_credentials_bogus_),
+              boost::bind(&RequestFileCredentials::serialized_field,
+                          &request_credentials),
               &write_request,
               buffer,
               bytes_to_write),
           uuid_iterator,
-          uuid_resolver_,
-          RPCOptions(volume_options_.max_write_tries,
+          osd_endpoints,
+          RPCOptions(max_tries,
                       volume_options_.retry_delay_s,
                       false,
                       volume_options_.was_interrupted_function),
           false,
           &xcap_manager_,
-          write_request.mutable_file_credentials()->mutable_xcap()));
+          request_credentials.mutable_xcap()));
 
+  ProcessWriteResponse(response.get());
+}
+
+void FileHandleImplementation::ProcessWriteResponse(
+    rpc::SyncCallbackBase* response) {
   xtreemfs::pbrpc::OSDWriteResponse* write_response =
       static_cast<xtreemfs::pbrpc::OSDWriteResponse*>(response->response());
+  if (UpdateOSDWriteResponse(write_response)) {
+    // Do not delete "write_response" because ownership was transferred.
+    delete [] response->data();
+    delete response->error();
+  } else {
+    response->DeleteBuffers();
+  }
+}
+
+bool FileHandleImplementation::UpdateOSDWriteResponse(
+    xtreemfs::pbrpc::OSDWriteResponse* write_response) {
   // If the filesize has changed, remember OSDWriteResponse for later file
-  // size update towards the MRC (executed by
-  // VolumeImplementation::PeriodicFileSizeUpdate).
+  // size update towards the MRC (scheduled by
+  // FileInfo::TryToUpdateOSDWriteResponse()).
   if (write_response->has_size_in_bytes()) {
     XCap xcap;
     xcap_manager_.GetXCap(&xcap);
-    if (file_info_->TryToUpdateOSDWriteResponse(write_response, xcap)) {
-      // Do not delete "write_response" because ownership was transferred.
-      delete [] response->data();
-      delete response->error();
+    return file_info_->TryToUpdateOSDWriteResponse(write_response, xcap);
+  }
+  return false;
+}
+
+std::string FileHandleImplementation::GetFirstOSDUUID(
+    const XLocSet& xlocs,
+    const std::vector<size_t>& osd_offsets) {
+  if (xlocs.replicas(0).osd_uuids_size() > 1) {
+    // Replica is striped. Pick UUID from xlocset.
+    return GetOSDUUIDFromXlocSet(xlocs,
+                                 0,  // Use first and only replica.
+                                 osd_offsets[0]);
+  } else {
+    string osd_uuid;
+    osd_uuid_iterator_->GetUUID(&osd_uuid);
+    return osd_uuid;
+  }
+}
+
+bool FileHandleImplementation::TryToResolveOSDUUID(
+    OSDEndpointTable* osd_endpoints,
+    const std::string& osd_uuid,
+    std::string* osd_address) {
+  try {
+    osd_endpoints->UUIDToAddressWithOptions(
+        osd_uuid,
+        osd_address,
+        RPCOptions(volume_options_.max_tries,
+                   volume_options_.retry_delay_s,
+                   false,
+                   volume_options_.was_interrupted_function));
+  } catch (const XtreemFSException&) {
+    // Left to the blocking retry which reports the error.
+    return false;
+  }
+  return true;
+}
+
+void FileHandleImplementation::ReadAsync(
+    char *buf,
+    size_t count,
+    int64_t offset,
+    FileHandleCallbackInterface* callback,
+    void* context) {
+  ThrottleIO(count);
+  if (async_writes_enabled_) {
+    file_info_->WaitForPendingAsyncWrites();
+    ThrowIfAsyncWritesFailed();
+  }
+
+  boost::shared_ptr<OSDEndpointTable> osd_endpoints;
+  boost::shared_ptr<const FileCredentialsSnapshot> file_credentials =
+      GetFileCredentialsSnapshot(NULL, &osd_endpoints);
+  const XLocSet& xlocs = file_credentials->xlocs();
+  if (xlocs.replicas_size() == 0) {
+    string path;
+    file_info_->GetPath(&path);
+    string error = "No replica found for file: " + path;
+    Logging::log->getLog(LEVEL_ERROR) << error << endl;
+    throw PosixErrorException(POSIX_ERROR_EIO, error);
+  }
+
+  StripeTranslator::PolicyContainer striping_policies;
+  for (int32_t i = 0; i < xlocs.replicas_size(); ++i) {
+    striping_policies.push_back(&(xlocs.replicas(i).striping_policy()));
+  }
+  const StripeTranslator* translator =
+      GetStripeTranslator((*striping_policies.begin())->type());
+  const int64_t stripe_size =
+      static_cast<int64_t>(xlocs.replicas(0).striping_policy().stripe_size())
+      * 1024;
+
+  std::vector<ReadOperation> operations;
+  translator->TranslateReadRequest(buf, count, offset, striping_policies,
+                                   &operations);
+
+  // Ends the pending I/O again if adding the object requests fails.
+  std::auto_ptr<AsyncIOOperation> new_async_io(new AsyncIOOperation(
+      this, false, callback, context, &client_->GetAsyncIOCompletionQueue()));
+  vector<void*> contexts(operations.size());
+  for (size_t j = 0; j < operations.size(); j++) {
+    contexts[j] = new_async_io->AddObjectRequest(
+        operations[j].obj_number,
+        operations[j].obj_number * stripe_size + operations[j].req_offset,
+        operations[j].req_size,
+        operations[j].data);
+  }
+
+  // From here on, "async_io" is owned by the completion thread.
+  AsyncIOOperation* async_io = new_async_io.release();
+  for (size_t j = 0; j < operations.size(); j++) {
+    string osd_address;
+    try {
+      if (!TryToResolveOSDUUID(
+              osd_endpoints.get(),
+              GetFirstOSDUUID(xlocs, operations[j].osd_offsets),
+              &osd_address)) {
+        continue;
+      }
+    } catch (const XtreemFSException&) {
+      continue;
+    }
+
+    readRequest rq;
+    rq.set_file_id(file_credentials->xcap().file_id());
+    rq.set_object_number(operations[j].obj_number);
+    rq.set_object_version(0);
+    rq.set_offset(operations[j].req_offset);
+    rq.set_length(operations[j].req_size);
+
+    async_io->IncreasePendingResponses();
+    osd_service_client_->read_with_credentials(
+        osd_address,
+        auth_bogus_,
+        user_credentials_bogus_,
+        file_credentials->serialized_field(),
+        &rq,
+        static_cast<rpc::CallbackInterface<ObjectData>*>(async_io),
+        contexts[j]);
+  }
+  async_io->AllRequestsSent();
+}
+
+void FileHandleImplementation::WriteAsync(
+    const char *buf,
+    size_t count,
+    int64_t offset,
+    FileHandleCallbackInterface* callback,
+    void* context) {
+  ThrottleIO(count);
+  if (async_writes_enabled_) {
+    // Do not overtake previous Write()s.
+    file_info_->WaitForPendingAsyncWrites();
+    ThrowIfAsyncWritesFailed();
+  }
+
+  boost::shared_ptr<OSDEndpointTable> osd_endpoints;
+  boost::shared_ptr<const FileCredentialsSnapshot> file_credentials =
+      GetFileCredentialsSnapshot(NULL, &osd_endpoints);
+  const XLocSet& xlocs = file_credentials->xlocs();
+  if (xlocs.replicas_size() == 0) {
+    string path;
+    file_info_->GetPath(&path);
+    string error = "No replica found for file: " + path;
+    Logging::log->getLog(LEVEL_ERROR) << error << endl;
+    throw PosixErrorException(POSIX_ERROR_EIO, error);
+  }
+
+  StripeTranslator::PolicyContainer striping_policies;
+  for (int32_t i = 0; i < xlocs.replicas_size(); ++i) {
+    striping_policies.push_back(&(xlocs.replicas(i).striping_policy()));
+  }
+  const StripeTranslator* translator =
+      GetStripeTranslator((*striping_policies.begin())->type());
+  const int64_t stripe_size =
+      static_cast<int64_t>(xlocs.replicas(0).striping_policy().stripe_size())
+      * 1024;
+
+  InvalidateDiskCache(file_credentials->xcap().file_id());
+
+  std::vector<WriteOperation> operations;
+  translator->TranslateWriteRequest(buf, count, offset, striping_policies,
+                                    &operations);
+
+  // Ends the pending I/O again if adding the object requests fails.
+  std::auto_ptr<AsyncIOOperation> new_async_io(new AsyncIOOperation(
+      this, true, callback, context, &client_->GetAsyncIOCompletionQueue()));
+  vector<void*> contexts(operations.size());
+  for (size_t j = 0; j < operations.size(); j++) {
+    contexts[j] = new_async_io->AddObjectRequest(
+        operations[j].obj_number,
+        operations[j].obj_number * stripe_size + operations[j].req_offset,
+        operations[j].req_size,
+        const_cast<char*>(operations[j].data));
+  }
+
+  // From here on, "async_io" is owned by the completion thread.
+  AsyncIOOperation* async_io = new_async_io.release();
+  for (size_t j = 0; j < operations.size(); j++) {
+    string osd_address;
+    try {
+      if (!TryToResolveOSDUUID(
+              osd_endpoints.get(),
+              GetFirstOSDUUID(xlocs, operations[j].osd_offsets),
+              &osd_address)) {
+        continue;
+      }
+    } catch (const XtreemFSException&) {
+      continue;
+    }
+
+    writeRequest write_request;
+    PrepareWriteRequest(*file_credentials,
+                        operations[j].obj_number,
+                        operations[j].req_offset,
+                        operations[j].data,
+                        operations[j].req_size,
+                        &write_request);
+    async_io->IncreasePendingResponses();
+    osd_service_client_->write_with_credentials(
+        osd_address,
+        auth_bogus_,
+        user_credentials_bogus_,
+        file_credentials->serialized_field(),
+        &write_request,
+        operations[j].data,
+        operations[j].req_size,
+        static_cast<rpc::CallbackInterface<OSDWriteResponse>*>(async_io),
+        contexts[j]);
+  }
+  async_io->AllRequestsSent();
+}
+
+bool FileHandleImplementation::CompleteAsyncIO(AsyncIOOperation* operation) {
+  vector<AsyncIOOperation::ObjectRequest>& object_requests
+      = operation->object_requests();
+  bool retry = false;
+  for (size_t j = 0; j < object_requests.size(); j++) {
+    AsyncIOOperation::ObjectRequest& object = object_requests[j];
+
+    bool succeeded = object.response_message != NULL && object.error == NULL;
+    if (succeeded && !operation->is_write()) {
+      // The OSD is unknown here, it's reported by the synchronous retry.
+      succeeded = VerifyObjectData(
+          *static_cast<ObjectData*>(object.response_message),
+          object.data,
+          object.data_length,
+          object.object_no,
+          "");
+    }
+    if (!succeeded) {
+      if (Logging::log->loggingActive(LEVEL_DEBUG)) {
+        Logging::log->getLog(LEVEL_DEBUG)
+            << "Async " << (operation->is_write() ? "write" : "read")
+            << " of " << object.size << " bytes at offset "
+            << object.file_offset << " failed ("
+            << (object.error != NULL
+                ? object.error->error_message()
+                : object.response_message != NULL
+                    ? string("wrong checksum")
+                    : string("request not sent"))
+            << "), retrying it synchronously." << endl;
+      }
+      object.retry = true;
+      retry = true;
+      continue;
+    }
+
+    if (operation->is_write()) {
+      if (UpdateOSDWriteResponse(static_cast<OSDWriteResponse*>(
+              object.response_message))) {
+        // Ownership was transferred.
+        object.response_message = NULL;
+      }
+      operation->AddCompletedBytes(object.size);
     } else {
-      response->DeleteBuffers();
+      ObjectData* data = static_cast<ObjectData*>(object.response_message);
+      memcpy(object.buffer, object.data, object.data_length);
+      // If zero_padding() > 0, the gap has to be filled with zeroes.
+      memset(object.buffer + object.data_length, 0, data->zero_padding());
+      operation->AddCompletedBytes(object.data_length + data->zero_padding());
     }
-  } else {
-    response->DeleteBuffers();
+  }
+  if (retry) {
+    return false;
+  }
+
+  FinishAsyncIO(operation, NULL);
+  return true;
+}
+
+void FileHandleImplementation::RetryAsyncIO(AsyncIOOperation* operation) {
+  vector<AsyncIOOperation::ObjectRequest>& object_requests
+      = operation->object_requests();
+  try {
+    for (size_t j = 0; j < object_requests.size(); j++) {
+      AsyncIOOperation::ObjectRequest& object = object_requests[j];
+      if (!object.retry) {
+        continue;
+      }
+      // Retry the object with the usual error handling.
+      if (operation->is_write()) {
+        operation->AddCompletedBytes(
+            Write(object.buffer, object.size, object.file_offset));
+      } else {
+        operation->AddCompletedBytes(
+            Read(object.buffer, object.size, object.file_offset));
+      }
+    }
+    if (operation->is_write() && async_writes_enabled_) {
+      // Write() did return before the retried objects were acknowledged.
+      file_info_->WaitForPendingAsyncWrites();
+      ThrowIfAsyncWritesFailed();
+    }
+  } catch (const XtreemFSException& e) {
+    FinishAsyncIO(operation, &e);
+    return;
+  } catch (const boost::thread_interrupted&) {
+    PosixErrorException error(POSIX_ERROR_EINTR,
+                              "The client was shut down during the retry.");
+    FinishAsyncIO(operation, &error);
+    throw;
+  }
+  FinishAsyncIO(operation, NULL);
+}
+
+void FileHandleImplementation::FinishAsyncIO(AsyncIOOperation* operation,
+                                             const XtreemFSException* error) {
+  if (operation->is_write() && error == NULL) {
+    // A read which started during the write may have cached the old data.
+    XCap xcap;
+    xcap_manager_.GetXCap(&xcap);
+    InvalidateDiskCache(xcap.file_id());
+  }
+
+  try {
+    operation->callback()->AsyncIOFinished(
+        error == NULL ? operation->completed_bytes() : -1,
+        error,
+        operation->context());
+  } catch (const exception& e) {
+    Logging::log->getLog(LEVEL_ERROR)
+        << "The callback of an async "
+        << (operation->is_write() ? "write" : "read")
+        << " threw an exception: " << e.what() << endl;
+  } catch (...) {
+    Logging::log->getLog(LEVEL_ERROR)
+        << "The callback of an async "
+        << (operation->is_write() ? "write" : "read")
+        << " threw an unknown exception." << endl;
+  }
+}
+
+void FileHandleImplementation::IncreasePendingAsyncIO() {
+  boost::mutex::scoped_lock lock(pending_async_io_mutex_);
+  ++pending_async_io_;
+}
+
+void FileHandleImplementation::DecreasePendingAsyncIO() {
+  boost::mutex::scoped_lock lock(pending_async_io_mutex_);
+  assert(pending_async_io_ > 0);
+  --pending_async_io_;
+  if (pending_async_io_ == 0) {
+    all_async_io_completed_.notify_all();
+  }
+}
+
+void FileHandleImplementation::WaitForAsyncIO() {
+  boost::mutex::scoped_lock lock(pending_async_io_mutex_);
+  while (pending_async_io_ > 0) {
+    all_async_io_completed_.wait(lock);
   }
 }
 
@@ -471,12 +1183,18 @@ void FileHandleImplementation::Flush() {
 }
 
 void FileHandleImplementation::Flush(bool close_file) {
+  ScopedLatencyRecorder latency(
+      LatencyStatistics::GetHistogram(LatencyStatistics::kFlush));
   boost::function<void()> operation(
       boost::bind(&FileHandleImplementation::DoFlush, this, close_file));
   ExecuteViewCheckedOperation(operation);
 }
 
 void FileHandleImplementation::DoFlush(bool close_file) {
+  if (!close_file) {
+    file_info_->ThrowIfDeferredCloseFailed();
+  }
+
   file_info_->Flush(this, close_file);
 
   if (DidAsyncWritesFail()) {
@@ -494,6 +1212,8 @@ void FileHandleImplementation::DoFlush(bool close_file) {
 void FileHandleImplementation::Truncate(
     const xtreemfs::pbrpc::UserCredentials& user_credentials,
     int64_t new_file_size) {
+  ScopedLatencyRecorder latency(
+      LatencyStatistics::GetHistogram(LatencyStatistics::kTruncate));
   file_info_->WaitForPendingAsyncWrites();
   ThrowIfAsyncWritesFailed();
 
@@ -569,6 +1289,8 @@ void FileHandleImplementation::DoTruncatePhaseTwoAndThree(
 
   assert(write_response->has_size_in_bytes());
 
+  InvalidateDiskCache(truncate_rq.file_id());
+
   // Register the osd write response at this file's FileInfo.
   XCap xcap;
   xcap_manager_.GetXCap(&xcap);
@@ -596,6 +1318,8 @@ xtreemfs::pbrpc::Lock* FileHandleImplementation::AcquireLock(
     uint64_t length,
     bool exclusive,
     bool wait_for_lock) {
+  ScopedLatencyRecorder latency(
+      LatencyStatistics::GetHistogram(LatencyStatistics::kAcquireLock));
   boost::function<xtreemfs::pbrpc::Lock*()> operation(
       boost::bind(&FileHandleImplementation::DoAcquireLock, this,
                   process_id, offset, length, exclusive, wait_for_lock));
@@ -609,98 +1333,103 @@ xtreemfs::pbrpc::Lock* FileHandleImplementation::DoAcquireLock(
     uint64_t length,
     bool exclusive,
     bool wait_for_lock) {
-  // Create lockRequest object for the acquire lock request.
+  Lock lock;
+  lock.set_client_uuid(client_uuid_);
+  lock.set_client_pid(process_id);
+  lock.set_offset(offset);
+  lock.set_length(length);
+  lock.set_exclusive(exclusive);
   lockRequest lock_request;
-  lock_request.mutable_lock_request()->set_client_uuid(client_uuid_);
-  lock_request.mutable_lock_request()->set_client_pid(process_id);
-  lock_request.mutable_lock_request()->set_offset(offset);
-  lock_request.mutable_lock_request()->set_length(length);
-  lock_request.mutable_lock_request()->set_exclusive(exclusive);
+  lock_request.mutable_lock_request()->CopyFrom(lock);
+
+  LocalLockManager* local_locks = file_info_->local_lock_manager();
+  // In case of EAGAIN responses of the OSD, the lock is requested again after
+  // an exponentially growing delay of at most retry_delay_s.
+  int retries_left = volume_options_.max_tries;
+  int retry_delay_ms = kMinLockRetryDelayMs;
+  while (true) {
+    // Conflicts with other local processes are resolved without the OSD.
+    Lock conflicting_lock;
+    LocalLockManager::AcquireResult result = local_locks->AcquireLock(
+        lock,
+        wait_for_lock,
+        volume_options_.was_interrupted_function,
+        &conflicting_lock);
+    if (result == LocalLockManager::kConflict) {
+      throw PosixErrorException(POSIX_ERROR_EAGAIN, "conflicting lock");
+    }
+    if (result == LocalLockManager::kAcquiredLocally) {
+      return new Lock(lock);
+    }
 
-  // Check active locks first.
-  std::auto_ptr<Lock> conflicting_lock(new Lock());
-  bool lock_for_pid_cached, cached_lock_for_pid_equal, conflict_found;
-  file_info_->CheckLock(lock_request.lock_request(),
-                        conflicting_lock.get(),
-                        &lock_for_pid_cached,
-                        &cached_lock_for_pid_equal,
-                        &conflict_found);
-  if (conflict_found) {
-    throw PosixErrorException(POSIX_ERROR_EAGAIN, "conflicting lock");
-  }
-  // We allow only one lock per PID, i.e. an existing lock can be always
-  // overwritten. In consequence, AcquireLock always has to be executed except
-  // the new lock is equal to the current lock.
-  if (cached_lock_for_pid_equal) {
-    conflicting_lock->CopyFrom(lock_request.lock_request());
-    return conflicting_lock.release();
+    try {
+      std::auto_ptr<Lock> acquired_lock(AcquireLockAtOSD(
+          &lock_request,
+          wait_for_lock
+              ? RPCOptions(1,
+                           volume_options_.retry_delay_s,
+                           false,  // Delays are handled by this loop.
+                           volume_options_.was_interrupted_function)
+              : RPCOptionsFromOptions(volume_options_)));
+      local_locks->FinishAcquire(lock, true);
+      return acquired_lock.release();
+    } catch(const PosixErrorException& e) {
+      local_locks->FinishAcquire(lock, false);
+      // Only retry if there exists a conflicting lock and the server did
+      // return an EAGAIN - otherwise rethrow the exception.
+      if (!wait_for_lock ||
+          e.posix_errno() != POSIX_ERROR_EAGAIN ||
+          (retries_left != 0 && --retries_left == 0)) {
+        throw;
+      }
+    } catch(...) {
+      local_locks->FinishAcquire(lock, false);
+      throw;
+    }
+
+    Interruptibilizer::SleepInterruptible(
+        retry_delay_ms,
+        volume_options_.was_interrupted_function);
+    if (Interruptibilizer::WasInterrupted(
+            volume_options_.was_interrupted_function)) {
+      throw PosixErrorException(
+          POSIX_ERROR_EINTR,
+          "Waiting for a conflicting lock was aborted by the user.");
+    }
+    retry_delay_ms = min(2 * retry_delay_ms,
+                         max(volume_options_.retry_delay_s * 1000,
+                             kMinLockRetryDelayMs));
   }
+}
 
-  // Cache could not be used. Complete lockRequest and send to OSD.
+xtreemfs::pbrpc::Lock* FileHandleImplementation::AcquireLockAtOSD(
+    xtreemfs::pbrpc::lockRequest* lock_request,
+    const RPCOptions& options) {
   file_info_->GetXLocSet(
-      lock_request.mutable_file_credentials()->mutable_xlocs());
+      lock_request->mutable_file_credentials()->mutable_xlocs());
   xcap_manager_.GetXCap(
-      lock_request.mutable_file_credentials()->mutable_xcap());
+      lock_request->mutable_file_credentials()->mutable_xcap());
 
-  boost::scoped_ptr<rpc::SyncCallbackBase> response;
-  if (!wait_for_lock) {
-    response.reset(ExecuteSyncRequest(
+  boost::scoped_ptr<rpc::SyncCallbackBase> response(
+    ExecuteSyncRequest(
         boost::bind(
             &xtreemfs::pbrpc::OSDServiceClient::xtreemfs_lock_acquire_sync,
             osd_service_client_,
             _1,
             boost::cref(auth_bogus_),
             boost::cref(user_credentials_bogus_),
-            &lock_request),
+            lock_request),
         osd_uuid_iterator_,
         uuid_resolver_,
-        RPCOptionsFromOptions(volume_options_),
-        false,
+        options,
+        false,  // UUIDIterator contains UUIDs and not addresses.
         &xcap_manager_,
-        lock_request.mutable_file_credentials()->mutable_xcap()));
-  } else {
-    // Retry to obtain the lock in case of EAGAIN responses.
-    int retries_left = volume_options_.max_tries;
-    while (retries_left == 0 || retries_left--) {
-      try {
-        response.reset(ExecuteSyncRequest(
-            boost::bind(
-                &xtreemfs::pbrpc::OSDServiceClient::xtreemfs_lock_acquire_sync,
-                osd_service_client_,
-                _1,
-                boost::cref(auth_bogus_),
-                boost::cref(user_credentials_bogus_),
-                &lock_request),
-            osd_uuid_iterator_,
-            uuid_resolver_,
-            RPCOptions(1,
-                       volume_options_.retry_delay_s,
-                       true,  //  delay this attempt in case of errors.
-                       volume_options_.was_interrupted_function),
-            false,  // UUIDIterator contains UUIDs and not addresses.
-            &xcap_manager_,
-            lock_request.mutable_file_credentials()->mutable_xcap()));
-        break;  // If successful, do not retry again.
-      } catch(const PosixErrorException& e) {
-        if (e.posix_errno() != POSIX_ERROR_EAGAIN) {
-          // Only retry if there exists a conflicting lock and the server did
-          // return an EAGAIN - otherwise rethrow the exception.
-          response->DeleteBuffers();
-          throw;
-        }
-      }
-    }
-  }
+        lock_request->mutable_file_credentials()->mutable_xcap()));
   // Delete everything except the response.
   delete[] response->data();
   delete response->error();
 
-  // "Cache" new lock.
-  xtreemfs::pbrpc::Lock* lock =
-      static_cast<xtreemfs::pbrpc::Lock*>(response->response());
-  file_info_->PutLock(*lock);
-
-  return lock;
+  return static_cast<xtreemfs::pbrpc::Lock*>(response->response());
 }
 
 xtreemfs::pbrpc::Lock* FileHandleImplementation::CheckLock(
@@ -729,13 +1458,14 @@ xtreemfs::pbrpc::Lock* FileHandleImplementation::DoCheckLock(
   lock_request.mutable_lock_request()->set_exclusive(exclusive);
 
   // Check active locks first.
+  LocalLockManager* local_locks = file_info_->local_lock_manager();
   std::auto_ptr<Lock> conflicting_lock(new Lock());
   bool lock_for_pid_cached, cached_lock_for_pid_equal, conflict_found;
-  file_info_->CheckLock(lock_request.lock_request(),
-                        conflicting_lock.get(),
-                        &lock_for_pid_cached,
-                        &cached_lock_for_pid_equal,
-                        &conflict_found);
+  local_locks->CheckLock(lock_request.lock_request(),
+                         conflicting_lock.get(),
+                         &lock_for_pid_cached,
+                         &cached_lock_for_pid_equal,
+                         &conflict_found);
   if (conflict_found) {
     return conflicting_lock.release();
   }
@@ -798,7 +1528,12 @@ void FileHandleImplementation::ReleaseLock(
 void FileHandleImplementation::DoReleaseLock(
     const xtreemfs::pbrpc::Lock& lock) {
   // Only release locks which are known to this client.
-  if (!file_info_->CheckIfProcessHasLocks(lock.client_pid())) {
+  LocalLockManager* local_locks = file_info_->local_lock_manager();
+  lockRequest unlock_request;
+  LocalLockManager::ReleaseResult result = local_locks->ReleaseLock(
+      lock.client_pid(),
+      unlock_request.mutable_lock_request());
+  if (result == LocalLockManager::kNoLockFound) {
     if (Logging::log->loggingActive(LEVEL_DEBUG)) {
       Logging::log->getLog(LEVEL_DEBUG)
           << "FileHandleImplementation::ReleaseLock: Skipping unlock request "
@@ -809,31 +1544,34 @@ void FileHandleImplementation::DoReleaseLock(
     return;
   }
 
-  lockRequest unlock_request;
-  file_info_->GetXLocSet(
-      unlock_request.mutable_file_credentials()->mutable_xlocs());
-  xcap_manager_.GetXCap(
-      unlock_request.mutable_file_credentials()->mutable_xcap());
-  unlock_request.mutable_lock_request()->CopyFrom(lock);
+  try {
+    file_info_->GetXLocSet(
+        unlock_request.mutable_file_credentials()->mutable_xlocs());
+    xcap_manager_.GetXCap(
+        unlock_request.mutable_file_credentials()->mutable_xcap());
 
-  boost::scoped_ptr<rpc::SyncCallbackBase> response(
-    ExecuteSyncRequest(
-        boost::bind(
-            &xtreemfs::pbrpc::OSDServiceClient::xtreemfs_lock_release_sync,
-            osd_service_client_,
-            _1,
-            boost::cref(auth_bogus_),
-            boost::cref(user_credentials_bogus_),
-            &unlock_request),
-        osd_uuid_iterator_,
-        uuid_resolver_,
-        RPCOptionsFromOptions(volume_options_),
-        false,
-        &xcap_manager_,
-        unlock_request.mutable_file_credentials()->mutable_xcap()));
-  response->DeleteBuffers();
+    boost::scoped_ptr<rpc::SyncCallbackBase> response(
+      ExecuteSyncRequest(
+          boost::bind(
+              &xtreemfs::pbrpc::OSDServiceClient::xtreemfs_lock_release_sync,
+              osd_service_client_,
+              _1,
+              boost::cref(auth_bogus_),
+              boost::cref(user_credentials_bogus_),
+              &unlock_request),
+          osd_uuid_iterator_,
+          uuid_resolver_,
+          RPCOptionsFromOptions(volume_options_),
+          false,
+          &xcap_manager_,
+          unlock_request.mutable_file_credentials()->mutable_xcap()));
+    response->DeleteBuffers();
+  } catch(...) {
+    local_locks->FinishRelease(lock.client_pid(), false);
+    throw;
+  }
 
-  file_info_->DelLock(lock);
+  local_locks->FinishRelease(lock.client_pid(), true);
 }
 
 void FileHandleImplementation::ReleaseLockOfProcess(int process_id) {
@@ -911,6 +1649,39 @@ void FileHandleImplementation::DoPingReplica(
 }
 
 void FileHandleImplementation::Close() {
+  ScopedLatencyRecorder latency(
+      LatencyStatistics::GetHistogram(LatencyStatistics::kClose));
+  WaitForAsyncIO();
+
+  // A failed write-behind close of another file handle of this file is
+  // reported once this one was closed.
+  string deferred_close_error;
+  const bool deferred_close_failed =
+      file_info_->PopDeferredCloseError(&deferred_close_error);
+
+  if (volume_options_.enable_write_behind_close && async_writes_enabled_) {
+    // The pending writes and the file size update will be completed in the
+    // background. Errors are reported by the next Flush(), open or Close() of
+    // the file.
+    file_info_->DeferCloseFileHandle(this);
+  } else {
+    FinishClose();
+  }
+
+  // "this" may be deleted already.
+  if (deferred_close_failed) {
+    throw PosixErrorException(POSIX_ERROR_EIO, deferred_close_error);
+  }
+}
+
+void FileHandleImplementation::StartDeferredClose(const RPCOptions& options) {
+  file_info_->WaitForPendingAsyncWrites();
+  if (!DidAsyncWritesFail()) {
+    file_info_->WriteBackFileSizeAsync(options);
+  }
+}
+
+void FileHandleImplementation::FinishClose() {
   try {
     Flush(true);  // true = Tell Flush() the file will be closed.
 
@@ -934,8 +1705,52 @@ void FileHandleImplementation::Close() {
   file_info_->CloseFileHandle(this);
 }
 
+void FileHandleImplementation::SetLastOSD(
+    bool striped,
+    const std::vector<size_t>& osd_offsets) {
+  last_osd_position_.store(
+      striped ? static_cast<int>(osd_offsets[0]) : kLastOSDOfUUIDIterator,
+      boost::memory_order_relaxed);
+}
+
 string FileHandleImplementation::GetLastOSDAddress() {
-  return last_osd_address_;
+  int position = last_osd_position_.load(boost::memory_order_relaxed);
+  if (position == kLastOSDNone) {
+    return "";
+  }
+
+  boost::shared_ptr<OSDEndpointTable> osd_endpoints;
+  file_info_->GetXLocSetSnapshot(NULL, &osd_endpoints);
+  string osd_uuid;
+  string osd_address;
+  try {
+    if (position == kLastOSDOfUUIDIterator) {
+      osd_uuid_iterator_->GetUUID(&osd_uuid);
+    } else if (osd_endpoints->replica_count() > 0 &&
+               position < osd_endpoints->osd_count(0)) {
+      osd_uuid = osd_endpoints->GetUUID(0, position);
+    } else {
+      // The XLocSet was replaced in the meantime.
+      return "";
+    }
+    osd_endpoints->UUIDToAddressWithOptions(
+        osd_uuid, &osd_address, RPCOptions(
+            volume_options_.max_read_tries, volume_options_.retry_delay_s,
+            false, volume_options_.was_interrupted_function));
+  } catch (const XtreemFSException&) {
+    return "";
+  }
+  return osd_address;
+}
+
+void FileHandleImplementation::SetQoSKey(const std::string& key) {
+  qos_key_ = key;
+}
+
+void FileHandleImplementation::ThrottleIO(size_t count) {
+  if (io_throttle_) {
+    io_throttle_->Acquire(qos_key_, count);
+  }
 }
 
 const StripeTranslator* FileHandleImplementation::GetStripeTranslator(
@@ -1164,7 +1979,147 @@ XCapManager::XCapManager(
         uuid_resolver_(uuid_resolver),
         mrc_uuid_iterator_(mrc_uuid_iterator),
         auth_bogus_(auth_bogus),
-        user_credentials_bogus_(user_credentials_bogus){}
+        user_credentials_bogus_(user_credentials_bogus) {
+  xcap_snapshot_.reset(new XCap(xcap));
+}
+
+AsyncIOOperation::AsyncIOOperation(
+    FileHandleImplementation* file_handle,
+    bool is_write,
+    FileHandleCallbackInterface* callback,
+    void* context,
+    util::SynchronizedQueue<AsyncIOOperation*>* completion_queue)
+    : file_handle_(file_handle),
+      is_write_(is_write),
+      callback_(callback),
+      context_(context),
+      completion_queue_(completion_queue),
+      pending_responses_(1),
+      completed_bytes_(0) {
+  file_handle_->IncreasePendingAsyncIO();
+}
+
+AsyncIOOperation::~AsyncIOOperation() {
+  for (size_t j = 0; j < object_requests_.size(); j++) {
+    delete object_requests_[j].response_message;
+    delete [] object_requests_[j].data;
+    delete object_requests_[j].error;
+  }
+  file_handle_->DecreasePendingAsyncIO();
+}
+
+void* AsyncIOOperation::AddObjectRequest(int object_no,
+                                         int64_t file_offset,
+                                         size_t size,
+                                         char* buffer) {
+  object_requests_.push_back(
+      ObjectRequest(object_no, file_offset, size, buffer));
+  return reinterpret_cast<void*>(object_requests_.size() - 1);
+}
+
+void AsyncIOOperation::IncreasePendingResponses() {
+  boost::mutex::scoped_lock lock(mutex_);
+  ++pending_responses_;
+}
+
+void AsyncIOOperation::AllRequestsSent() {
+  DecreasePendingResponses();
+}
+
+void AsyncIOOperation::DecreasePendingResponses() {
+  {
+    boost::mutex::scoped_lock lock(mutex_);
+    assert(pending_responses_ > 0);
+    if (--pending_responses_ > 0) {
+      return;
+    }
+  }
+  completion_queue_->Enqueue(this);
+}
+
+void AsyncIOOperation::ProcessCompletions(
+    util::SynchronizedQueue<AsyncIOOperation*>& completion_queue,
+    util::SynchronizedQueue<AsyncIOOperation*>& retry_queue) {
+  while (!(boost::this_thread::interruption_requested() &&
+           boost::this_thread::interruption_enabled())) {
+    AsyncIOOperation* operation = completion_queue.Dequeue();
+    bool completed = true;
+    try {
+      completed = operation->file_handle()->CompleteAsyncIO(operation);
+    } catch (const exception& e) {
+      Logging::log->getLog(LEVEL_ERROR)
+          << "AsyncIOOperation::ProcessCompletions(): caught unhandled "
+          "exception: " << e.what() << endl;
+    } catch (...) {
+      Logging::log->getLog(LEVEL_ERROR)
+          << "AsyncIOOperation::ProcessCompletions(): caught unknown "
+          "exception." << endl;
+    }
+    if (completed) {
+      // Ends the pending I/O of the file handle.
+      delete operation;
+    } else {
+      retry_queue.Enqueue(operation);
+    }
+  }
+}
+
+void AsyncIOOperation::ProcessRetries(
+    util::SynchronizedQueue<AsyncIOOperation*>& retry_queue) {
+  while (!(boost::this_thread::interruption_requested() &&
+           boost::this_thread::interruption_enabled())) {
+    // Deleting the operation ends the pending I/O of its file handle.
+    boost::scoped_ptr<AsyncIOOperation> operation(retry_queue.Dequeue());
+    try {
+      operation->file_handle()->RetryAsyncIO(operation.get());
+    } catch (const boost::thread_interrupted&) {
+      throw;
+    } catch (const exception& e) {
+      Logging::log->getLog(LEVEL_ERROR)
+          << "AsyncIOOperation::ProcessRetries(): caught unhandled "
+          "exception: " << e.what() << endl;
+    } catch (...) {
+      Logging::log->getLog(LEVEL_ERROR)
+          << "AsyncIOOperation::ProcessRetries(): caught unknown "
+          "exception." << endl;
+    }
+  }
+}
+
+void AsyncIOOperation::CallFinished(
+    xtreemfs::pbrpc::ObjectData* response_message,
+    char* data,
+    uint32_t data_length,
+    xtreemfs::pbrpc::RPCHeader::ErrorResponse* error,
+    void* context) {
+  ResponseReceived(response_message, data, data_length, error, context);
+}
+
+void AsyncIOOperation::CallFinished(
+    xtreemfs::pbrpc::OSDWriteResponse* response_message,
+    char* data,
+    uint32_t data_length,
+    xtreemfs::pbrpc::RPCHeader::ErrorResponse* error,
+    void* context) {
+  ResponseReceived(response_message, data, data_length, error, context);
+}
+
+void AsyncIOOperation::ResponseReceived(
+    google::protobuf::Message* response_message,
+    char* data,
+    uint32_t data_length,
+    xtreemfs::pbrpc::RPCHeader::ErrorResponse* error,
+    void* context) {
+  // Every request has its own ObjectRequest, no lock required.
+  ObjectRequest& object
+      = object_requests_[reinterpret_cast<size_t>(context)];
+  object.response_message = response_message;
+  object.data = data;
+  object.data_length = data_length;
+  object.error = error;
+
+  DecreasePendingResponses();
+}
 
 void XCapManager::WaitForPendingXCapRenewal() {
   boost::mutex::scoped_lock lock(mutex_);
@@ -1180,9 +2135,16 @@ void XCapManager::GetXCap(xtreemfs::pbrpc::XCap* xcap) {
   xcap->CopyFrom(xcap_);
 }
 
+boost::shared_ptr<const xtreemfs::pbrpc::XCap> XCapManager::GetXCapSnapshot() {
+  return boost::atomic_load(&xcap_snapshot_);
+}
+
 void XCapManager::SetXCap(const xtreemfs::pbrpc::XCap& xcap) {
+  boost::shared_ptr<const XCap> xcap_snapshot(new XCap(xcap));
+
   boost::mutex::scoped_lock lock(mutex_);
   xcap_.CopyFrom(xcap);
+  boost::atomic_store(&xcap_snapshot_, xcap_snapshot);
 }
 
 uint64_t XCapManager::GetFileId() {
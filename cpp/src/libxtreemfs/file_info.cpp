@@ -12,6 +12,7 @@
 #include "libxtreemfs/file_handle_implementation.h"
 #include "libxtreemfs/helper.h"
 #include "libxtreemfs/options.h"
+#include "libxtreemfs/osd_endpoint_table.h"
 #include "libxtreemfs/volume_implementation.h"
 #include "libxtreemfs/xtreemfs_exception.h"
 #include "util/logging.h"
@@ -43,6 +44,7 @@ FileInfo::FileInfo(
       client_uuid_(client_uuid),
       osd_write_response_(NULL),
       osd_write_response_status_(kClean),
+      file_size_update_scheduled_(false),
 #ifdef _MSC_VER
 // Disable "warning C4355: 'this' : used in base member initializer list".
 // We can ignore that warning because we know that AsyncWriteHandler's
@@ -57,13 +59,18 @@ FileInfo::FileInfo(
                            volume->auth_bogus(),
                            volume->user_credentials_bogus(),
                            volume->volume_options(),
-                           client->GetAsyncWriteCallbackQueue()) {
+                           client->GetAsyncWriteCallbackQueue(),
+                           client->GetWriteWindowController(),
+                           volume->async_write_budget(),
+                           client->GetDiskObjectCache()) {
 #ifdef _MSC_VER
 #pragma warning(pop)
 #endif  // _MSC_VER
 
-  // Make an UUID container managed by a smart pointer.
-  osd_uuid_container_ = boost::make_shared<UUIDContainer>(xlocset);
+  // Skip OSDs which are known to be dead.
+  osd_uuid_iterator_.set_health_registry(client->GetOSDHealthRegistry());
+
+  PublishXLocSetSnapshotUnmutexed(xlocset);
 }
 
 FileInfo::~FileInfo() {
@@ -92,6 +99,7 @@ FileHandleImplementation* FileInfo::CreateFileHandle(
       volume_->osd_service_client(),
       volume_->stripe_translators(),
       async_writes_enabled,
+      volume_->io_throttle(),
       volume_->volume_options(),
       volume_->auth_bogus(),
       volume_->user_credentials_bogus());
@@ -125,10 +133,24 @@ void FileInfo::CloseFileHandle(FileHandleImplementation* file_handle) {
 
   // At this point the file_handle is already removed from the list of open file
   // handles, but the reference_count is not decreased yet. This has to happen
-  // after locking the open_file_table_ in Volume.
+  // after locking the file's shard of the open file table in Volume.
   volume_->CloseFile(file_id_, this, file_handle);
 }
 
+void FileInfo::DeferCloseFileHandle(FileHandleImplementation* file_handle) {
+  string path;
+  GetPath(&path);
+  volume_->DeferCloseFileHandle(file_id_, path, file_handle);
+}
+
+void FileInfo::ThrowIfDeferredCloseFailed() {
+  volume_->ThrowIfDeferredCloseFailed(file_id_);
+}
+
+bool FileInfo::PopDeferredCloseError(std::string* error) {
+  return volume_->PopDeferredCloseError(file_id_, error);
+}
+
 int FileInfo::DecreaseReferenceCount() {
   boost::mutex::scoped_lock lock(mutex_);
   --reference_count_;
@@ -170,6 +192,7 @@ bool FileInfo::TryToUpdateOSDWriteResponse(
     osd_write_response_.reset(response);
     osd_write_response_xcap_.CopyFrom(xcap);
     osd_write_response_status_ = kDirty;
+    ScheduleFileSizeUpdateUnmutexed();
 
     return true;
   } else {
@@ -179,6 +202,7 @@ bool FileInfo::TryToUpdateOSDWriteResponse(
 
 void FileInfo::WriteBackFileSizeAsync(const RPCOptions& options) {
   boost::mutex::scoped_lock lock(osd_write_response_mutex_);
+  file_size_update_scheduled_ = false;
 
   // Only update pending file size updates.
   if (osd_write_response_.get() && osd_write_response_status_ == kDirty) {
@@ -192,6 +216,13 @@ void FileInfo::WriteBackFileSizeAsync(const RPCOptions& options) {
   }
 }
 
+void FileInfo::ScheduleFileSizeUpdateUnmutexed() {
+  if (!file_size_update_scheduled_) {
+    file_size_update_scheduled_ = true;
+    volume_->ScheduleFileSizeUpdate(file_id_, this);
+  }
+}
+
 void FileInfo::RenewXCapsAsync(const RPCOptions& options) {
   boost::mutex::scoped_lock lock(open_file_handles_mutex_);
 
@@ -255,6 +286,7 @@ void FileInfo::AsyncFileSizeUpdateResponseHandler(
       osd_write_response_status_ = kClean;
     } else {
       osd_write_response_status_ = kDirty;  // Still dirty.
+      ScheduleFileSizeUpdateUnmutexed();
     }
   }
 
@@ -307,7 +339,9 @@ void FileInfo::FlushPendingFileSizeUpdate(FileHandleImplementation* file_handle,
       try {
         file_handle->WriteBackFileSize(response_copy, close_file);
       } catch (const XtreemFSException&) {
+        lock.lock();
         osd_write_response_status_ = kDirty;
+        ScheduleFileSizeUpdateUnmutexed();
         throw;  // Rethrow error.
       }
 
@@ -331,88 +365,11 @@ void FileInfo::FlushPendingFileSizeUpdate(FileHandleImplementation* file_handle,
 }
 
 
-void FileInfo::CheckLock(const xtreemfs::pbrpc::Lock& lock,
-                         xtreemfs::pbrpc::Lock* conflicting_lock,
-                         bool* lock_for_pid_cached,
-                         bool* cached_lock_for_pid_equal,
-                         bool* conflict_found) {
-  assert(conflicting_lock);
-  assert(lock_for_pid_cached);
-  assert(cached_lock_for_pid_equal);
-  assert(lock.client_uuid() == client_uuid_);
-
-  boost::mutex::scoped_lock mutex_lock(active_locks_mutex_);
-
-  *cached_lock_for_pid_equal = false;
-  *conflict_found = false;
-  *lock_for_pid_cached = false;
-
-  for (map<unsigned int, Lock*>::iterator it = active_locks_.begin();
-       it != active_locks_.end();
-       ++it) {
-    if (it->first == lock.client_pid()) {
-      *lock_for_pid_cached = true;
-      if (CheckIfLocksAreEqual(lock, *(it->second))) {
-        *cached_lock_for_pid_equal = true;
-      }
-      continue;
-    }
-
-    if (CheckIfLocksDoConflict(lock, *(it->second))) {
-      *conflict_found = true;
-      conflicting_lock->CopyFrom(*(it->second));
-      // A conflicting lock has a higher priority than a cached lock with the
-      // same PID.
-      break;
-    }
-  }
-}
-
-bool FileInfo::CheckIfProcessHasLocks(int process_id) {
-  boost::mutex::scoped_lock mutex_lock(active_locks_mutex_);
-
-  // There may be only up to one lock per process_id. No loop required.
-  map<unsigned int, Lock*>::const_iterator it = active_locks_.find(process_id);
-  return it != active_locks_.end();
-}
-
-void FileInfo::PutLock(const xtreemfs::pbrpc::Lock& lock) {
-  assert(lock.client_uuid() == client_uuid_);
-
-  boost::mutex::scoped_lock mutex_lock(active_locks_mutex_);
-
-  map<unsigned int, Lock*>::iterator it = active_locks_.find(lock.client_pid());
-  if (it != active_locks_.end()) {
-    delete it->second;
-    active_locks_.erase(it);
-  }
-  Lock* new_lock = new Lock(lock);
-  active_locks_[lock.client_pid()] = new_lock;
-}
-
-void FileInfo::DelLock(const xtreemfs::pbrpc::Lock& lock) {
-  assert(lock.client_uuid() == client_uuid_);
-  boost::mutex::scoped_lock mutex_lock(active_locks_mutex_);
-
-  map<unsigned int, Lock*>::iterator it = active_locks_.find(lock.client_pid());
-  if (it != active_locks_.end()) {
-    // Only up to one lock per PID. If its unlocked, just delete it.
-    delete it->second;
-    active_locks_.erase(it);
-  }
-}
-
 void FileInfo::ReleaseLockOfProcess(FileHandleImplementation* file_handle,
                                     int process_id) {
-  boost::mutex::scoped_lock mutex_lock(active_locks_mutex_);
-
-  // There may be only up to one lock per process_id. No loop required.
-  map<unsigned int, Lock*>::iterator it = active_locks_.find(process_id);
-  if (it != active_locks_.end()) {
-    Lock lock(*(it->second));
-    // Leave critical section.
-    mutex_lock.unlock();
-
+  // There may be only up to one lock per process_id.
+  Lock lock;
+  if (active_locks_.GetLockOfProcess(process_id, &lock)) {
     file_handle->ReleaseLock(lock);
   }
 }
@@ -421,17 +378,9 @@ void FileInfo::ReleaseAllLocks(FileHandleImplementation* file_handle) {
   // Do not use pointers here to ensure the deletion of this list - otherwise
   // a ReleaseLock() may fail and the memory wont be freed.
   list<Lock> active_locks_copy;
-  {
-    // Create a copy to avoid longer locking periods and ensure that ReleaseLock
-    // can delete the lock from active_locks_ without invalidating the iterator.
-    boost::mutex::scoped_lock mutex_lock(active_locks_mutex_);
-
-    for (map<unsigned int, Lock*>::iterator it = active_locks_.begin();
-         it != active_locks_.end();
-         ++it) {
-      active_locks_copy.push_back((*(it->second)));
-    }
-  }
+  // Create a copy to avoid longer locking periods and ensure that ReleaseLock
+  // can delete the lock from active_locks_ without invalidating the iterator.
+  active_locks_.GetLocks(&active_locks_copy);
 
   for (list<Lock>::const_iterator it = active_locks_copy.begin();
        it != active_locks_copy.end();
@@ -465,7 +414,7 @@ void FileInfo::UpdateXLocSetAndRest(const xtreemfs::pbrpc::XLocSet& new_xlocset,
 
   xlocset_.CopyFrom(new_xlocset);
   osd_uuid_iterator_.ClearAndGetOSDUUIDsFromXlocSet(new_xlocset);
-  osd_uuid_container_ = boost::make_shared<UUIDContainer>(new_xlocset);
+  PublishXLocSetSnapshotUnmutexed(new_xlocset);
 
   replicate_on_close_ = replicate_on_close;
 }
@@ -476,7 +425,7 @@ void FileInfo::UpdateXLocSetAndRest(
 
   xlocset_.CopyFrom(new_xlocset);
   osd_uuid_iterator_.ClearAndGetOSDUUIDsFromXlocSet(new_xlocset);
-  osd_uuid_container_ = boost::make_shared<UUIDContainer>(new_xlocset);
+  PublishXLocSetSnapshotUnmutexed(new_xlocset);
 }
 
 void FileInfo::GetXLocSet(xtreemfs::pbrpc::XLocSet* new_xlocset) {
@@ -490,7 +439,38 @@ boost::shared_ptr<UUIDContainer> FileInfo::GetXLocSetAndUUIDContainer(xtreemfs::
   boost::mutex::scoped_lock lock(xlocset_mutex_);
   new_xlocset->CopyFrom(xlocset_);
 
-  return osd_uuid_container_;
+  return xlocset_snapshot_->uuid_container;
+}
+
+boost::shared_ptr<const xtreemfs::pbrpc::XLocSet> FileInfo::GetXLocSetSnapshot(
+    boost::shared_ptr<UUIDContainer>* uuid_container) {
+  return GetXLocSetSnapshot(uuid_container, NULL);
+}
+
+boost::shared_ptr<const xtreemfs::pbrpc::XLocSet> FileInfo::GetXLocSetSnapshot(
+    boost::shared_ptr<UUIDContainer>* uuid_container,
+    boost::shared_ptr<OSDEndpointTable>* osd_endpoints) {
+  boost::shared_ptr<const XLocSetSnapshot> snapshot =
+      boost::atomic_load(&xlocset_snapshot_);
+  if (uuid_container) {
+    *uuid_container = snapshot->uuid_container;
+  }
+  if (osd_endpoints) {
+    *osd_endpoints = snapshot->osd_endpoints;
+  }
+  return snapshot->xlocset;
+}
+
+void FileInfo::PublishXLocSetSnapshotUnmutexed(
+    const xtreemfs::pbrpc::XLocSet& xlocset) {
+  boost::shared_ptr<XLocSetSnapshot> snapshot =
+      boost::make_shared<XLocSetSnapshot>();
+  snapshot->xlocset = boost::make_shared<const XLocSet>(xlocset);
+  snapshot->uuid_container = boost::make_shared<UUIDContainer>(xlocset);
+  snapshot->osd_endpoints = boost::make_shared<OSDEndpointTable>(
+      xlocset, volume_->uuid_resolver());
+  boost::atomic_store(&xlocset_snapshot_,
+                      boost::shared_ptr<const XLocSetSnapshot>(snapshot));
 }
 
 }  // namespace xtreemfs
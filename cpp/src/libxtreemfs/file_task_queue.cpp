@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2026 by the XtreemFS Authors, see AUTHORS file
+ *
+ * Licensed under the BSD License, see LICENSE file for details.
+ *
+ */
+
+#include "libxtreemfs/file_task_queue.h"
+
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+using namespace std;
+
+namespace xtreemfs {
+
+void FileTaskQueue::Push(const Task& task) {
+  boost::mutex::scoped_lock lock(mutex_);
+  bool new_first_deadline = tasks_.empty()
+      || task.deadline < tasks_.top().deadline;
+  tasks_.push(task);
+  if (new_first_deadline) {
+    task_added_.notify_all();
+  }
+}
+
+void FileTaskQueue::WaitForDueTasks(std::vector<Task>* due_tasks) {
+  due_tasks->clear();
+
+  boost::mutex::scoped_lock lock(mutex_);
+  while (true) {
+    if (tasks_.empty()) {
+      task_added_.wait(lock);
+      continue;
+    }
+
+    boost::posix_time::ptime now = Now();
+    if (tasks_.top().deadline > now) {
+      task_added_.timed_wait(lock, tasks_.top().deadline);
+      continue;
+    }
+
+    while (!tasks_.empty() && tasks_.top().deadline <= now) {
+      due_tasks->push_back(tasks_.top());
+      tasks_.pop();
+    }
+    return;
+  }
+}
+
+size_t FileTaskQueue::size() {
+  boost::mutex::scoped_lock lock(mutex_);
+  return tasks_.size();
+}
+
+boost::posix_time::ptime FileTaskQueue::Now() {
+  return boost::posix_time::microsec_clock::universal_time();
+}
+
+}  // namespace xtreemfs
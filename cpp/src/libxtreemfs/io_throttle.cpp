@@ -0,0 +1,183 @@
+/*
+ * Copyright (c) 2026 by the XtreemFS Authors, see AUTHORS file
+ *
+ * Licensed under the BSD License, see LICENSE file for details.
+ *
+ */
+
+#include "libxtreemfs/io_throttle.h"
+
+#include <boost/lexical_cast.hpp>
+#include <boost/thread/thread.hpp>
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+using namespace boost::posix_time;
+
+namespace xtreemfs {
+
+namespace {
+
+/** Maximum number of seconds of tokens a bucket can save up. */
+const double kBurstS = 0.1;
+
+/** Keys are active if they executed an operation during this time. */
+const int kActiveWindowMs = 1000;
+
+/** Waiting operations recheck their bucket at least this often, since the
+ *  share of their key grows when other keys become idle. */
+const int kMaxWaitMs = 100;
+
+/** Keys which were not active for this time are removed. */
+const int kIdleTimeoutS = 600;
+
+ptime Now() {
+  return microsec_clock::universal_time();
+}
+
+}  // namespace
+
+IOThrottle::IOThrottle(int64_t max_bytes_per_s,
+                       int64_t max_operations_per_s,
+                       const std::vector<std::string>& weights)
+    : max_bytes_per_s_(max_bytes_per_s),
+      max_operations_per_s_(max_operations_per_s) {
+  for (size_t i = 0; i < weights.size(); i++) {
+    string key;
+    int weight;
+    if (ParseWeight(weights[i], &key, &weight)) {
+      weights_[key] = weight;
+    }
+  }
+}
+
+void IOThrottle::Acquire(const std::string& key, size_t bytes) {
+  const ptime start = Now();
+  ptime now = start;
+  bool delayed = false;
+
+  boost::mutex::scoped_lock lock(mutex_);
+  map<string, Bucket>::iterator it = buckets_.find(key);
+  if (it == buckets_.end()) {
+    it = buckets_.insert(make_pair(key, Bucket())).first;
+    it->second.last_refill = start;
+    it->second.counters.weight = GetWeight(key);
+  }
+  // Buckets of waiting operations are active and therefore never removed.
+  Bucket* bucket = &it->second;
+
+  while (true) {
+    bucket->last_active = now;
+    double share = static_cast<double>(bucket->counters.weight)
+                   / GetActiveWeightUnmutexed(now);
+    RefillUnmutexed(now, share, bucket);
+    if (bucket->bytes >= 0 && bucket->operations >= 0) {
+      break;
+    }
+
+    double wait_s = 0;
+    if (bucket->bytes < 0) {
+      wait_s = max(wait_s, -bucket->bytes / (max_bytes_per_s_ * share));
+    }
+    if (bucket->operations < 0) {
+      wait_s = max(wait_s,
+                   -bucket->operations / (max_operations_per_s_ * share));
+    }
+    int wait_ms = min(kMaxWaitMs,
+                      max(1, static_cast<int>(ceil(wait_s * 1000))));
+    delayed = true;
+
+    lock.unlock();
+    boost::this_thread::sleep(millisec(wait_ms));
+    lock.lock();
+    now = Now();
+  }
+
+  if (max_bytes_per_s_ > 0) {
+    bucket->bytes -= bytes;
+  }
+  if (max_operations_per_s_ > 0) {
+    bucket->operations -= 1;
+  }
+  bucket->counters.operations++;
+  bucket->counters.bytes += bytes;
+  if (delayed) {
+    bucket->counters.delayed_operations++;
+    bucket->counters.delay_ms += (now - start).total_milliseconds();
+  }
+}
+
+void IOThrottle::GetCounters(std::map<std::string, QoSCounters>* counters) {
+  boost::mutex::scoped_lock lock(mutex_);
+  for (map<string, Bucket>::const_iterator it = buckets_.begin();
+       it != buckets_.end();
+       ++it) {
+    (*counters)[it->first] = it->second.counters;
+  }
+}
+
+bool IOThrottle::ParseWeight(const std::string& spec,
+                             std::string* key,
+                             int* weight) {
+  size_t separator = spec.rfind('=');
+  if (separator == string::npos || separator == 0) {
+    return false;
+  }
+  try {
+    *weight = boost::lexical_cast<int>(spec.substr(separator + 1));
+  } catch (const boost::bad_lexical_cast&) {
+    return false;
+  }
+  *key = spec.substr(0, separator);
+  return *weight > 0;
+}
+
+int IOThrottle::GetWeight(const std::string& key) const {
+  map<string, int>::const_iterator it = weights_.find(key);
+  if (it == weights_.end()) {
+    size_t separator = key.find(':');
+    if (separator != string::npos) {
+      it = weights_.find(key.substr(0, separator));
+    }
+  }
+  return it != weights_.end() ? it->second : 1;
+}
+
+void IOThrottle::RefillUnmutexed(const boost::posix_time::ptime& now,
+                                 double share,
+                                 Bucket* bucket) {
+  double elapsed_s = (now - bucket->last_refill).total_microseconds() / 1e6;
+  bucket->last_refill = now;
+
+  if (max_bytes_per_s_ > 0) {
+    double rate = max_bytes_per_s_ * share;
+    bucket->bytes = min(bucket->bytes + elapsed_s * rate, rate * kBurstS);
+  }
+  if (max_operations_per_s_ > 0) {
+    double rate = max_operations_per_s_ * share;
+    bucket->operations = min(bucket->operations + elapsed_s * rate,
+                             rate * kBurstS);
+  }
+}
+
+int IOThrottle::GetActiveWeightUnmutexed(const boost::posix_time::ptime& now) {
+  const ptime active_since = now - millisec(kActiveWindowMs);
+  const ptime idle_since = now - seconds(kIdleTimeoutS);
+
+  int active_weight = 0;
+  map<string, Bucket>::iterator it = buckets_.begin();
+  while (it != buckets_.end()) {
+    if (it->second.last_active < idle_since) {
+      buckets_.erase(it++);
+      continue;
+    }
+    if (it->second.last_active >= active_since) {
+      active_weight += it->second.counters.weight;
+    }
+    ++it;
+  }
+  return active_weight;
+}
+
+}  // namespace xtreemfs
@@ -0,0 +1,207 @@
+/*
+ * Copyright (c) 2026 by the XtreemFS Authors, see AUTHORS file
+ *
+ * Licensed under the BSD License, see LICENSE file for details.
+ *
+ */
+
+#include "libxtreemfs/local_lock_manager.h"
+
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <cassert>
+
+#include "libxtreemfs/helper.h"
+#include "libxtreemfs/xtreemfs_exception.h"
+
+using namespace xtreemfs::pbrpc;
+using namespace std;
+
+namespace xtreemfs {
+
+/** Interval in which a waiting AcquireLock() checks for interruptions. */
+static const int kInterruptCheckIntervalMs = 100;
+
+namespace {
+
+/** Returns the lock in "locks" which conflicts with "lock" and belongs to
+ *  another process or NULL. */
+const Lock* FindConflictingLockIn(
+    const std::map<unsigned int, xtreemfs::pbrpc::Lock>& locks,
+    const xtreemfs::pbrpc::Lock& lock) {
+  for (std::map<unsigned int, Lock>::const_iterator it = locks.begin();
+       it != locks.end();
+       ++it) {
+    if (it->first != lock.client_pid() &&
+        (lock.exclusive() || it->second.exclusive()) &&
+        CheckIfLocksDoConflict(lock, it->second)) {
+      return &it->second;
+    }
+  }
+  return NULL;
+}
+
+}  // namespace
+
+LocalLockManager::LocalLockManager() {}
+
+void LocalLockManager::CheckLock(const xtreemfs::pbrpc::Lock& lock,
+                                 xtreemfs::pbrpc::Lock* conflicting_lock,
+                                 bool* lock_for_pid_cached,
+                                 bool* cached_lock_for_pid_equal,
+                                 bool* conflict_found) {
+  assert(conflicting_lock);
+  assert(lock_for_pid_cached);
+  assert(cached_lock_for_pid_equal);
+
+  boost::mutex::scoped_lock mutex_lock(mutex_);
+
+  *cached_lock_for_pid_equal = false;
+  *conflict_found = false;
+  *lock_for_pid_cached = false;
+
+  // A conflicting lock has a higher priority than a cached lock with the
+  // same PID.
+  const Lock* conflict = FindConflictingLockUnmutexed(lock);
+  if (conflict != NULL) {
+    *conflict_found = true;
+    conflicting_lock->CopyFrom(*conflict);
+    return;
+  }
+
+  LockMap::const_iterator it = active_locks_.find(lock.client_pid());
+  if (it != active_locks_.end()) {
+    *lock_for_pid_cached = true;
+    *cached_lock_for_pid_equal = CheckIfLocksAreEqual(lock, it->second);
+  }
+}
+
+bool LocalLockManager::CheckIfProcessHasLocks(int process_id) {
+  boost::mutex::scoped_lock mutex_lock(mutex_);
+
+  // There may be only up to one lock per process_id. No loop required.
+  return active_locks_.find(process_id) != active_locks_.end();
+}
+
+bool LocalLockManager::GetLockOfProcess(int process_id,
+                                        xtreemfs::pbrpc::Lock* lock) {
+  boost::mutex::scoped_lock mutex_lock(mutex_);
+
+  LockMap::const_iterator it = active_locks_.find(process_id);
+  if (it == active_locks_.end()) {
+    return false;
+  }
+  lock->CopyFrom(it->second);
+  return true;
+}
+
+void LocalLockManager::GetLocks(std::list<xtreemfs::pbrpc::Lock>* locks) {
+  boost::mutex::scoped_lock mutex_lock(mutex_);
+
+  for (LockMap::const_iterator it = active_locks_.begin();
+       it != active_locks_.end();
+       ++it) {
+    locks->push_back(it->second);
+  }
+}
+
+LocalLockManager::AcquireResult LocalLockManager::AcquireLock(
+    const xtreemfs::pbrpc::Lock& lock,
+    bool wait_for_lock,
+    InterruptedCallback was_interrupted_cb,
+    xtreemfs::pbrpc::Lock* conflicting_lock) {
+  assert(conflicting_lock);
+
+  boost::mutex::scoped_lock mutex_lock(mutex_);
+
+  // Wait until no other request of the same process is pending at the OSD
+  // and "lock" does not conflict with the lock of another local process.
+  while (true) {
+    if (pending_locks_.find(lock.client_pid()) == pending_locks_.end()) {
+      const Lock* conflict = FindConflictingLockUnmutexed(lock);
+      if (conflict == NULL) {
+        break;
+      }
+      if (!wait_for_lock) {
+        conflicting_lock->CopyFrom(*conflict);
+        return kConflict;
+      }
+    }
+
+    if (Interruptibilizer::WasInterrupted(was_interrupted_cb)) {
+      throw PosixErrorException(
+          POSIX_ERROR_EINTR,
+          "Waiting for a conflicting lock was aborted by the user.");
+    }
+    locks_changed_.timed_wait(
+        mutex_lock,
+        boost::posix_time::milliseconds(kInterruptCheckIntervalMs));
+  }
+
+  LockMap::const_iterator it = active_locks_.find(lock.client_pid());
+  if (it != active_locks_.end() && CheckIfLocksAreEqual(lock, it->second)) {
+    return kAcquiredLocally;
+  }
+
+  pending_locks_[lock.client_pid()] = lock;
+  return kAcquireAtOSD;
+}
+
+void LocalLockManager::FinishAcquire(const xtreemfs::pbrpc::Lock& lock,
+                                     bool success) {
+  boost::mutex::scoped_lock mutex_lock(mutex_);
+  assert(pending_locks_.find(lock.client_pid()) != pending_locks_.end());
+
+  if (success) {
+    active_locks_[lock.client_pid()] = lock;
+  }
+  pending_locks_.erase(lock.client_pid());
+  // The process may have replaced a larger lock.
+  locks_changed_.notify_all();
+}
+
+LocalLockManager::ReleaseResult LocalLockManager::ReleaseLock(
+    int process_id,
+    xtreemfs::pbrpc::Lock* lock) {
+  assert(lock);
+
+  boost::mutex::scoped_lock mutex_lock(mutex_);
+
+  // Wait for the outcome of a pending acquisition of the same process.
+  while (pending_locks_.find(process_id) != pending_locks_.end()) {
+    locks_changed_.wait(mutex_lock);
+  }
+
+  LockMap::const_iterator it = active_locks_.find(process_id);
+  if (it == active_locks_.end()) {
+    return kNoLockFound;
+  }
+  lock->CopyFrom(it->second);
+  pending_locks_[process_id] = it->second;
+  return kReleaseAtOSD;
+}
+
+void LocalLockManager::FinishRelease(int process_id, bool success) {
+  boost::mutex::scoped_lock mutex_lock(mutex_);
+  assert(pending_locks_.find(process_id) != pending_locks_.end());
+
+  if (success) {
+    active_locks_.erase(process_id);
+  }
+  pending_locks_.erase(process_id);
+  locks_changed_.notify_all();
+}
+
+size_t LocalLockManager::size() {
+  boost::mutex::scoped_lock mutex_lock(mutex_);
+
+  return active_locks_.size();
+}
+
+const xtreemfs::pbrpc::Lock* LocalLockManager::FindConflictingLockUnmutexed(
+    const xtreemfs::pbrpc::Lock& lock) {
+  const Lock* conflict = FindConflictingLockIn(active_locks_, lock);
+  return conflict != NULL ? conflict
+                          : FindConflictingLockIn(pending_locks_, lock);
+}
+
+}  // namespace xtreemfs
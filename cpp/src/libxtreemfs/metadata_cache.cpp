@@ -7,6 +7,8 @@
 
 #include "libxtreemfs/metadata_cache.h"
 
+#include <algorithm>
+
 #include "libxtreemfs/helper.h"
 #include "util/logging.h"
 #include "xtreemfs/OSD.pb.h"
@@ -984,6 +986,97 @@ void MetadataCache::InvalidateXAttrs(const std::string& path) {
   }
 }
 
+void MetadataCache::GetUnexpiredEntries(
+    std::vector<MetadataCacheEntry*>* entries) {
+  if (!enabled) {
+    return;
+  }
+
+  boost::mutex::scoped_lock lock(mutex_);
+
+  uint64_t current_time_s = time(NULL);
+  by_list& index = cache_.get<IndexList>();
+  for (by_list::iterator it_list = index.begin();
+       it_list != index.end(); ++it_list) {
+    const MetadataCacheEntry& cache_entry = **it_list;
+    if (cache_entry.timeout_s < current_time_s) {
+      continue;
+    }
+
+    MetadataCacheEntry* copy = new MetadataCacheEntry();
+    copy->path = cache_entry.path;
+    copy->stat_timeout_s = 0;
+    copy->dir_entries_timeout_s = 0;
+    copy->xattrs_timeout_s = 0;
+    if (cache_entry.stat != NULL
+        && cache_entry.stat_timeout_s >= current_time_s) {
+      copy->stat = new Stat(*cache_entry.stat);
+      copy->stat_timeout_s = cache_entry.stat_timeout_s;
+    }
+    if (cache_entry.dir_entries != NULL
+        && cache_entry.dir_entries_timeout_s >= current_time_s) {
+      copy->dir_entries = new DirectoryEntries(*cache_entry.dir_entries);
+      copy->dir_entries_timeout_s = cache_entry.dir_entries_timeout_s;
+    }
+    if (cache_entry.xattrs != NULL
+        && cache_entry.xattrs_timeout_s >= current_time_s) {
+      copy->xattrs = new listxattrResponse(*cache_entry.xattrs);
+      copy->xattrs_timeout_s = cache_entry.xattrs_timeout_s;
+    }
+    copy->timeout_s = cache_entry.timeout_s;
+    entries->push_back(copy);
+  }
+}
+
+void MetadataCache::Restore(MetadataCacheEntry* entry) {
+  if (entry->path.empty() || !enabled) {
+    delete entry;
+    return;
+  }
+
+  uint64_t current_time_s = time(NULL);
+  if (entry->stat != NULL && entry->stat_timeout_s < current_time_s) {
+    delete entry->stat;
+    entry->stat = NULL;
+  }
+  if (entry->dir_entries != NULL
+      && entry->dir_entries_timeout_s < current_time_s) {
+    delete entry->dir_entries;
+    entry->dir_entries = NULL;
+  }
+  if (entry->xattrs != NULL && entry->xattrs_timeout_s < current_time_s) {
+    delete entry->xattrs;
+    entry->xattrs = NULL;
+  }
+  if (entry->stat == NULL && entry->dir_entries == NULL
+      && entry->xattrs == NULL) {
+    delete entry;
+    return;
+  }
+  entry->timeout_s = 0;
+  if (entry->stat != NULL) {
+    entry->timeout_s = max(entry->timeout_s, entry->stat_timeout_s);
+  }
+  if (entry->dir_entries != NULL) {
+    entry->timeout_s = max(entry->timeout_s, entry->dir_entries_timeout_s);
+  }
+  if (entry->xattrs != NULL) {
+    entry->timeout_s = max(entry->timeout_s, entry->xattrs_timeout_s);
+  }
+
+  boost::mutex::scoped_lock lock(mutex_);
+
+  by_map& index = cache_.get<IndexMap>();
+  if (index.find(entry->path) != index.end()) {
+    // The cached entry was retrieved from the MRC and is therefore newer.
+    delete entry;
+    return;
+  }
+
+  EvictUnmutexed(1);
+  index.insert(entry);
+}
+
 uint64_t MetadataCache::Size() {
   boost::mutex::scoped_lock lock(mutex_);
   return cache_.size();
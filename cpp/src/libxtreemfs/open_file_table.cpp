@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2026 by the XtreemFS Authors, see AUTHORS file
+ *
+ * Licensed under the BSD License, see LICENSE file for details.
+ *
+ */
+
+#include "libxtreemfs/open_file_table.h"
+
+#include <cassert>
+
+namespace xtreemfs {
+
+OpenFileTable::OpenFileTable(size_t number_of_shards)
+    : number_of_shards_(number_of_shards),
+      shards_(new Shard[number_of_shards]) {
+  assert(number_of_shards > 0);
+}
+
+boost::mutex& OpenFileTable::GetMutex(uint64_t file_id) {
+  return GetShard(file_id).mutex;
+}
+
+FileInfo* OpenFileTable::FindUnmutexed(uint64_t file_id) {
+  Shard& shard = GetShard(file_id);
+  boost::unordered_map<uint64_t, FileInfo*>::const_iterator it
+      = shard.files.find(file_id);
+  return it == shard.files.end() ? NULL : it->second;
+}
+
+void OpenFileTable::InsertUnmutexed(uint64_t file_id, FileInfo* file_info) {
+  bool inserted = GetShard(file_id).files.insert(
+      std::make_pair(file_id, file_info)).second;
+  assert(inserted);
+  (void) inserted;
+}
+
+bool OpenFileTable::EraseUnmutexed(uint64_t file_id) {
+  return GetShard(file_id).files.erase(file_id) > 0;
+}
+
+void OpenFileTable::ForEach(
+    const boost::function<void(FileInfo*)>& function) {
+  for (size_t i = 0; i < number_of_shards_; i++) {
+    boost::mutex::scoped_lock lock(shards_[i].mutex);
+    for (boost::unordered_map<uint64_t, FileInfo*>::iterator it
+             = shards_[i].files.begin();
+         it != shards_[i].files.end();
+         ++it) {
+      function(it->second);
+    }
+  }
+}
+
+size_t OpenFileTable::size() {
+  size_t size = 0;
+  for (size_t i = 0; i < number_of_shards_; i++) {
+    boost::mutex::scoped_lock lock(shards_[i].mutex);
+    size += shards_[i].files.size();
+  }
+  return size;
+}
+
+}  // namespace xtreemfs
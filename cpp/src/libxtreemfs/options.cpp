@@ -28,6 +28,7 @@
 #endif
 
 #include "rpc/ssl_options.h"
+#include "libxtreemfs/io_throttle.h"
 #include "libxtreemfs/pbrpc_url.h"
 #include "libxtreemfs/version_management.h"
 #include "libxtreemfs/xtreemfs_exception.h"
@@ -76,6 +77,19 @@ Options::Options()
   enable_async_writes = false;
   async_writes_max_request_size_kb = 128;  // default object size in kB.
   async_writes_max_requests = 10;  // Only 10 pending requests allowed by default.
+  async_writes_max_total_size_mb = 128;
+  async_writes_callback_threads = 4;
+  async_io_retry_threads = 4;
+  async_writes_adaptive_max_requests = 0;  // Disabled by default.
+  enable_write_behind_close = false;
+  write_behind_close_max_pending = 128;
+  prewarm_osd_connections = false;
+  disk_cache_path = "";
+  disk_cache_size_mb = 10240;
+  warm_start_snapshot_dir = "";
+  qos_max_bandwidth_kb = 0;  // Disabled by default.
+  qos_max_iops = 0;  // Disabled by default.
+  qos_key = "uid";
   readdir_chunk_size = 1024;
   enable_atime = false;
 
@@ -103,6 +117,9 @@ Options::Options()
   connect_timeout_s = 15;
   request_timeout_s = 15;
   linger_timeout_s = 600;  // 10 Minutes.
+  osd_health_probe_interval_s = 5;
+  address_mappings_refresh_margin_s = 60;
+  object_checksums = false;
 
 #ifdef HAS_OPENSSL
   // SSL options.
@@ -115,6 +132,7 @@ Options::Options()
   grid_ssl = false;
   ssl_verify_certificates = false;
   ssl_method_string = "ssltls";
+  ssl_kernel_tls = false;
 #endif  // HAS_OPENSSL
 
   // Grid Support options.
@@ -164,6 +182,8 @@ Options::Options()
   periodic_xcap_renewal_interval_s = 60;  // Default: 1 Minute.
   vivaldi_zipf_generator_skew = 0.5;
   xLoc_install_poll_interval_s = 5; // Default: 5 Seconds.
+  osd_health_failure_threshold = 2;
+  osd_health_readmit_probes = 2;
 
   // Internal options, not available from the command line interface.
   was_interrupted_function = NULL;
@@ -213,6 +233,80 @@ void Options::GenerateProgramOptionsDescriptions() {
             ->implicit_value(async_writes_max_requests),
         "Maximum number of pending write requests per file. Asynchronous writes"
         " will block if this limit is reached first.")
+    ("async-writes-adaptive-max-reqs",
+        po::value(&async_writes_adaptive_max_requests)
+            ->default_value(async_writes_adaptive_max_requests),
+        "Adapt the number of pending write requests per OSD to the observed"
+        " latency and errors, starting at async-writes-max-reqs and growing up"
+        " to this value.\n(Set to 0 to disable.)")
+    ("async-writes-max-total-size-mb",
+        po::value(&async_writes_max_total_size_mb)
+            ->default_value(async_writes_max_total_size_mb),
+        "Maximum size of the data of all pending asynchronous writes of a"
+        " volume. Writers block only if this limit is reached and are served"
+        " round-robin per file.\n(Set to 0 to disable.)")
+    ("async-writes-callback-threads",
+        po::value(&async_writes_callback_threads)
+            ->default_value(async_writes_callback_threads),
+        "Number of threads which process the responses of asynchronous writes."
+        " The callbacks of one file are always processed by the same thread.")
+    ("async-io-retry-threads",
+        po::value(&async_io_retry_threads)
+            ->default_value(async_io_retry_threads),
+        "Number of threads which retry the failed objects of asynchronous"
+        " reads and writes of the client library (ReadAsync(), WriteAsync()).")
+    ("enable-write-behind-close",
+        po::value(&enable_write_behind_close)
+          ->default_value(enable_write_behind_close)->zero_tokens(),
+        "close() returns after pending writes were handed to the asynchronous"
+        " write path. The file size update is completed in the background and"
+        " errors are reported by the next fsync(), close() or open() of the"
+        " file."
+        " Requires enable-async-writes.")
+    ("write-behind-close-max-pending",
+        po::value(&write_behind_close_max_pending)
+            ->default_value(write_behind_close_max_pending),
+        "Maximum number of pending write-behind closes. close() blocks if this"
+        " limit is reached.")
+    ("prewarm-osd-connections",
+        po::value(&prewarm_osd_connections)
+          ->default_value(prewarm_osd_connections)->zero_tokens(),
+        "open() connects to all OSDs of the file in the background, so the"
+        " first read or write does not wait for the connection setup.")
+    ("disk-cache-path",
+        po::value(&disk_cache_path)->default_value(disk_cache_path),
+        "Directory on a local disk which caches the read objects across"
+        " remounts. Local writes and truncates invalidate the cached objects"
+        " of a file, writes of other clients are not detected."
+        "\n(Leave empty to disable the cache.)")
+    ("disk-cache-size-mb",
+        po::value(&disk_cache_size_mb)->default_value(disk_cache_size_mb),
+        "Maximum size of the objects in the disk cache. The least recently"
+        " used objects are removed first.")
+    ("warm-start-snapshot-dir",
+        po::value(&warm_start_snapshot_dir)
+            ->default_value(warm_start_snapshot_dir),
+        "Directory in which the UUID mappings, the Vivaldi coordinates and the"
+        " metadata cache entries are saved on unmount. They are restored on"
+        " the next mount as long as their TTL has not expired."
+        "\n(Leave empty to disable the snapshot.)")
+    ("qos-max-bandwidth-kb",
+        po::value(&qos_max_bandwidth_kb)->default_value(qos_max_bandwidth_kb),
+        "Maximum bandwidth of all reads and writes in KiB/s. It is shared by"
+        " the users (see qos-key) which are currently reading or writing in"
+        " proportion to their weights.\n(Set to 0 to disable.)")
+    ("qos-max-iops",
+        po::value(&qos_max_iops)->default_value(qos_max_iops),
+        "Maximum number of reads and writes per second, shared like"
+        " qos-max-bandwidth-kb.\n(Set to 0 to disable.)")
+    ("qos-key",
+        po::value(&qos_key)->default_value(qos_key),
+        "uid|pgid: Share the QoS limits per user or per process group of a"
+        " user (the group of the process which opened the file).")
+    ("qos-weight",
+        po::value(&qos_weights),
+        "<user>=<weight>: Weight of a user for sharing the QoS limits (default"
+        " 1). Can be specified multiple times.")
     ("readdir-chunk-size",
         po::value(&readdir_chunk_size)->default_value(readdir_chunk_size),
         "Number of entries requested per readdir.");
@@ -255,7 +349,25 @@ void Options::GenerateProgramOptionsDescriptions() {
         "Timeout after which a request will be retried (in seconds).")
     ("linger-timeout",
         po::value(&linger_timeout_s)->default_value(linger_timeout_s),
-        "Time after which idle connections will be closed (in seconds).");
+        "Time after which idle connections will be closed (in seconds).")
+    ("osd-health-probe-interval",
+        po::value(&osd_health_probe_interval_s)
+            ->default_value(osd_health_probe_interval_s),
+        "Interval between health probes of unresponsive OSDs (in seconds). "
+        "Unresponsive OSDs are skipped by all open files until they respond "
+        "again.\n(Set to 0 to disable.)")
+    ("address-mappings-refresh-margin",
+        po::value(&address_mappings_refresh_margin_s)
+            ->default_value(address_mappings_refresh_margin_s),
+        "The addresses of all services are retrieved from the DIR at start and"
+        " refreshed this many seconds before they expire (in seconds)."
+        "\n(Set to 0 to resolve every service when it's used first.)")
+    ("object-checksums",
+        po::value(&object_checksums)->default_value(object_checksums)
+            ->zero_tokens(),
+        "Send a CRC32C checksum of written data to the OSDs and verify the "
+        "checksums of read data. Data with a wrong checksum is read again, "
+        "from another replica if available, at most once per replica.");
 
 #ifdef HAS_OPENSSL
   ssl_options_.add_options()
@@ -309,7 +421,15 @@ void Options::GenerateProgramOptionsDescriptions() {
         "\n  - tlsv11 accepts TLSv1.1 only\n"
         "  - tlsv12 accepts TLSv1.2 only"
 #endif  // BOOST_VERSION > 105300
-        );
+        )
+    ("kernel-tls",
+        po::value(&ssl_kernel_tls)->default_value(ssl_kernel_tls)
+            ->zero_tokens(),
+        "Lets the Linux kernel encrypt the sent data (kTLS) to save copies and"
+        " CPU time in the client. Only used for TLS 1.3 connections with"
+        " AES-GCM and if the kernel supports it (module \"tls\"). A connection"
+        " is re-established if the server requests a key update. Ignored in"
+        " Grid-SSL mode.");
 #endif  // HAS_OPENSSL
 
   grid_options_.add_options()
@@ -386,7 +506,16 @@ void Options::GenerateProgramOptionsDescriptions() {
         "Skewness of the Zipf distribution used for vivaldi OSD selection.")
     ("enable-atime",
         po::value(&enable_atime)->default_value(enable_atime)->zero_tokens(),
-        "Enable updates of atime attribute in Fuse and metadata cache.");
+        "Enable updates of atime attribute in Fuse and metadata cache.")
+    ("osd-health-failure-threshold",
+        po::value(&osd_health_failure_threshold)
+            ->default_value(osd_health_failure_threshold),
+        "Number of failed requests in a row after which an OSD is skipped.")
+    ("osd-health-readmit-probes",
+        po::value(&osd_health_readmit_probes)
+            ->default_value(osd_health_readmit_probes),
+        "Number of successful health probes in a row after which a skipped "
+        "OSD is used again.");
 
   deprecated_options_.add_options()
     ("interrupt-signal",
@@ -546,8 +675,81 @@ std::vector<std::string> Options::ParseCommandLine(int argc, char** argv) {
         " asynchronous writes (async-writes-max-reqs) must be greater 0.");
   }
 
+  if (async_writes_adaptive_max_requests < 0) {
+    throw InvalidCommandLineParametersException("The maximum adaptive number"
+        " of pending asynchronous writes (async-writes-adaptive-max-reqs) must"
+        " not be negative.");
+  }
+
+  if (async_writes_max_total_size_mb < 0) {
+    throw InvalidCommandLineParametersException("The maximum size of all"
+        " pending asynchronous writes (async-writes-max-total-size-mb) must"
+        " not be negative.");
+  }
+
+  if (async_writes_callback_threads < 1) {
+    throw InvalidCommandLineParametersException("The number of threads for"
+        " asynchronous write callbacks (async-writes-callback-threads) must be"
+        " greater 0.");
+  }
+
+  if (async_io_retry_threads < 1) {
+    throw InvalidCommandLineParametersException("The number of threads for"
+        " retries of asynchronous I/O (async-io-retry-threads) must be"
+        " greater 0.");
+  }
+
+  if (write_behind_close_max_pending < 1) {
+    throw InvalidCommandLineParametersException("The maximum number of pending"
+        " write-behind closes (write-behind-close-max-pending) must be greater"
+        " 0.");
+  }
+
+  if (disk_cache_size_mb < 1) {
+    throw InvalidCommandLineParametersException("The size of the disk cache"
+        " (disk-cache-size-mb) must be greater 0.");
+  }
+
+  if (enable_write_behind_close && !enable_async_writes) {
+    throw InvalidCommandLineParametersException("You specified"
+        " enable-write-behind-close but did not set enable-async-writes.");
+  }
+
+  if (qos_max_bandwidth_kb < 0 || qos_max_iops < 0) {
+    throw InvalidCommandLineParametersException("The QoS limits"
+        " (qos-max-bandwidth-kb, qos-max-iops) must not be negative.");
+  }
+
+  if (qos_key != "uid" && qos_key != "pgid") {
+    throw InvalidCommandLineParametersException("The QoS key (qos-key) must"
+        " be either uid or pgid.");
+  }
+
+  for (size_t i = 0; i < qos_weights.size(); i++) {
+    string user;
+    int weight;
+    if (!IOThrottle::ParseWeight(qos_weights[i], &user, &weight)) {
+      throw InvalidCommandLineParametersException("Invalid QoS weight: "
+          + qos_weights[i] + " (expected <user>=<weight> with a weight"
+          " greater 0).");
+    }
+  }
+
+  if (address_mappings_refresh_margin_s < 0) {
+    throw InvalidCommandLineParametersException("The address mappings refresh"
+        " margin (address-mappings-refresh-margin) must not be negative.");
+  }
+
+  if (osd_health_probe_interval_s < 0 || osd_health_failure_threshold < 1 ||
+      osd_health_readmit_probes < 1) {
+    throw InvalidCommandLineParametersException("The OSD health options must"
+        " not be negative and the failure threshold and the number of readmit"
+        " probes must be greater 0.");
+  }
+
   if (!enable_async_writes && (vm.count("async-writes-max-reqsize-kb") ||
-      vm.count("async-writes-max-reqs"))) {
+      vm.count("async-writes-max-reqs") ||
+      !vm["async-writes-adaptive-max-reqs"].defaulted())) {
     throw InvalidCommandLineParametersException("You specified async-writes-*"
         " options but did not set enable-async-writes.");
   }
@@ -707,7 +909,8 @@ xtreemfs::rpc::SSLOptions* Options::GenerateSSLOptions() const {
         grid_ssl || protocol == PBRPCURL::GetSchemePBRPCG(),
         ssl_verify_certificates,
         ssl_ignore_verify_errors,
-        ssl_method_string);
+        ssl_method_string,
+        ssl_kernel_tls);
   }
 #else
   opts = new xtreemfs::rpc::SSLOptions();
@@ -0,0 +1,163 @@
+/*
+ * Copyright (c) 2026 by the XtreemFS Authors, see AUTHORS file
+ *
+ * Licensed under the BSD License, see LICENSE file for details.
+ *
+ */
+
+#include "libxtreemfs/osd_endpoint_table.h"
+
+#include <cassert>
+#include <string>
+#include <vector>
+
+#include "libxtreemfs/execute_sync_request.h"
+#include "libxtreemfs/xtreemfs_exception.h"
+#include "util/logging.h"
+#include "xtreemfs/GlobalTypes.pb.h"
+
+using namespace std;
+using namespace xtreemfs::pbrpc;
+using namespace xtreemfs::util;
+
+namespace xtreemfs {
+
+OSDEndpointTable::OSDEndpointTable(const pbrpc::XLocSet& xlocs,
+                                   UUIDResolver* uuid_resolver,
+                                   time_t address_refresh_interval_s)
+    : uuid_resolver_(uuid_resolver),
+      address_refresh_interval_s_(address_refresh_interval_s),
+      replicas_(xlocs.replicas_size()) {
+  for (int i = 0; i < xlocs.replicas_size(); i++) {
+    const Replica& replica = xlocs.replicas(i);
+    for (int j = 0; j < replica.osd_uuids_size(); j++) {
+      Endpoint*& endpoint = endpoints_[replica.osd_uuids(j)];
+      if (endpoint == NULL) {
+        endpoint = new Endpoint(replica.osd_uuids(j));
+      }
+      replicas_[i].push_back(endpoint);
+    }
+  }
+}
+
+OSDEndpointTable::~OSDEndpointTable() {
+  for (EndpointMap::iterator it = endpoints_.begin();
+       it != endpoints_.end();
+       ++it) {
+    delete it->second->address.load();
+    delete it->second;
+  }
+  for (size_t i = 0; i < retired_addresses_.size(); i++) {
+    delete retired_addresses_[i];
+  }
+}
+
+const std::string& OSDEndpointTable::GetUUID(int replica,
+                                             int position) const {
+  return replicas_[replica][position]->uuid;
+}
+
+void OSDEndpointTable::GetAddress(int replica,
+                                  int position,
+                                  std::string* address,
+                                  const RPCOptions& options) {
+  GetAddress(replicas_[replica][position], address, &options);
+}
+
+void OSDEndpointTable::UUIDToAddress(const std::string& uuid,
+                                     std::string* address) {
+  EndpointMap::const_iterator it = endpoints_.find(uuid);
+  if (it == endpoints_.end()) {
+    uuid_resolver_->UUIDToAddress(uuid, address);
+  } else {
+    GetAddress(it->second, address, NULL);
+  }
+}
+
+void OSDEndpointTable::UUIDToAddressWithOptions(const std::string& uuid,
+                                                std::string* address,
+                                                const RPCOptions& options) {
+  EndpointMap::const_iterator it = endpoints_.find(uuid);
+  if (it == endpoints_.end()) {
+    uuid_resolver_->UUIDToAddressWithOptions(uuid, address, options);
+  } else {
+    GetAddress(it->second, address, &options);
+  }
+}
+
+void OSDEndpointTable::VolumeNameToMRCUUID(const std::string& volume_name,
+                                           std::string* mrc_uuid) {
+  uuid_resolver_->VolumeNameToMRCUUID(volume_name, mrc_uuid);
+}
+
+void OSDEndpointTable::VolumeNameToMRCUUID(const std::string& volume_name,
+                                           SimpleUUIDIterator* uuid_iterator) {
+  uuid_resolver_->VolumeNameToMRCUUID(volume_name, uuid_iterator);
+}
+
+std::vector<std::string> OSDEndpointTable::VolumeNameToMRCUUIDs(
+    const std::string& volume_name) {
+  return uuid_resolver_->VolumeNameToMRCUUIDs(volume_name);
+}
+
+void OSDEndpointTable::GetAddress(Endpoint* endpoint,
+                                  std::string* address,
+                                  const RPCOptions* options) {
+  const string* resolved_address =
+      endpoint->address.load(boost::memory_order_acquire);
+  if (resolved_address == NULL) {
+    Resolve(endpoint, options);
+    resolved_address = endpoint->address.load(boost::memory_order_acquire);
+  } else {
+    time_t attempted_at_s =
+        endpoint->resolve_attempted_at_s.load(boost::memory_order_relaxed);
+    time_t now_s = time(NULL);
+    // Claim the refresh, so that only one lookup per interval contacts the
+    // DIR even if the refresh fails.
+    if (now_s - attempted_at_s >= address_refresh_interval_s_ &&
+        endpoint->resolve_attempted_at_s.compare_exchange_strong(
+            attempted_at_s, now_s, boost::memory_order_relaxed)) {
+      Resolve(endpoint, options);
+      resolved_address = endpoint->address.load(boost::memory_order_acquire);
+    }
+  }
+  *address = *resolved_address;
+}
+
+void OSDEndpointTable::Resolve(Endpoint* endpoint,
+                               const RPCOptions* options) {
+  string address;
+  try {
+    if (options == NULL) {
+      uuid_resolver_->UUIDToAddress(endpoint->uuid, &address);
+    } else {
+      uuid_resolver_->UUIDToAddressWithOptions(endpoint->uuid,
+                                               &address,
+                                               *options);
+    }
+  } catch (const XtreemFSException& e) {
+    if (endpoint->address.load(boost::memory_order_acquire) == NULL) {
+      throw;
+    }
+    // Keep using the previous address until the UUID can be resolved again.
+    if (Logging::log->loggingActive(LEVEL_DEBUG)) {
+      Logging::log->getLog(LEVEL_DEBUG) << "Failed to resolve the address of"
+          " the OSD " << endpoint->uuid << " again, keeping the previous"
+          " address. Error: " << e.what() << endl;
+    }
+    return;
+  }
+
+  boost::mutex::scoped_lock lock(resolve_mutex_);
+  const string* old_address = endpoint->address.load();
+  if (old_address == NULL || *old_address != address) {
+    endpoint->address.store(new string(address), boost::memory_order_release);
+    if (old_address != NULL) {
+      retired_addresses_.push_back(old_address);
+    }
+  }
+  endpoint->resolve_attempted_at_s.store(time(NULL),
+                                         boost::memory_order_relaxed);
+}
+
+}  // namespace xtreemfs
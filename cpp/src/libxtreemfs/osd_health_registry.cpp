@@ -0,0 +1,220 @@
+/*
+ * Copyright (c) 2026 by the XtreemFS Authors, see AUTHORS file
+ *
+ * Licensed under the BSD License, see LICENSE file for details.
+ *
+ */
+
+#include "libxtreemfs/osd_health_registry.h"
+
+#include <boost/bind.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/interprocess/detail/atomic.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/version.hpp>
+#include <string>
+#include <vector>
+
+#include "libxtreemfs/execute_sync_request.h"
+#include "libxtreemfs/helper.h"
+#include "libxtreemfs/simple_uuid_iterator.h"
+#include "libxtreemfs/xtreemfs_exception.h"
+#include "rpc/sync_callback.h"
+#include "util/error_log.h"
+#include "util/logging.h"
+#include "xtreemfs/OSDServiceClient.h"
+
+using namespace std;
+using namespace xtreemfs::pbrpc;
+using namespace xtreemfs::util;
+
+#if (BOOST_VERSION < 104800)
+using boost::interprocess::detail::atomic_dec32;
+using boost::interprocess::detail::atomic_inc32;
+using boost::interprocess::detail::atomic_read32;
+using boost::interprocess::detail::atomic_write32;
+#else
+using boost::interprocess::ipcdetail::atomic_dec32;
+using boost::interprocess::ipcdetail::atomic_inc32;
+using boost::interprocess::ipcdetail::atomic_read32;
+using boost::interprocess::ipcdetail::atomic_write32;
+#endif  // BOOST_VERSION < 104800
+
+namespace xtreemfs {
+
+OSDHealthRegistry::OSDHealthRegistry(UUIDResolver* uuid_resolver,
+                                     const Options& options)
+    : uuid_resolver_(uuid_resolver),
+      probe_options_(options),
+      failure_threshold_(options.osd_health_failure_threshold),
+      readmit_probes_(options.osd_health_readmit_probes),
+      probe_interval_s_(options.osd_health_probe_interval_s),
+      reported_osds_count_(0),
+      dead_osds_count_(0) {
+  // Set AuthType to AUTH_NONE as it's currently not used.
+  auth_bogus_.set_auth_type(AUTH_NONE);
+  // Set username "xtreemfs" as it does not get checked at server side.
+  user_credentials_bogus_.set_username("xtreemfs");
+
+  // Probes must not be retried nor interrupted.
+  probe_options_.max_tries = 1;
+  probe_options_.was_interrupted_function = NULL;
+}
+
+OSDHealthRegistry::~OSDHealthRegistry() {}
+
+void OSDHealthRegistry::Initialize(rpc::Client* network_client) {
+  osd_service_client_.reset(new OSDServiceClient(network_client));
+}
+
+void OSDHealthRegistry::ReportFailure(const std::string& uuid) {
+  boost::mutex::scoped_lock lock(mutex_);
+
+  OSDHealth& health = health_[uuid];
+  health.consecutive_failures++;
+  health.successful_probes = 0;
+  atomic_write32(&reported_osds_count_, static_cast<uint32_t>(health_.size()));
+  if (!health.dead && health.consecutive_failures >= failure_threshold_) {
+    health.dead = true;
+    atomic_inc32(&dead_osds_count_);
+
+    string msg = "The OSD " + uuid + " did not respond to "
+        + boost::lexical_cast<string>(health.consecutive_failures)
+        + " requests in a row and will be skipped until it responds to"
+          " health probes again.";
+    Logging::log->getLog(LEVEL_WARN) << msg << endl;
+    ErrorLog::error_log->AppendError(msg);
+  }
+}
+
+void OSDHealthRegistry::ReportSuccess(const std::string& uuid) {
+  // Fast path: Nothing to do if no OSD was reported as failed.
+  if (atomic_read32(&reported_osds_count_) == 0) {
+    return;
+  }
+
+  boost::mutex::scoped_lock lock(mutex_);
+
+  map<string, OSDHealth>::iterator it = health_.find(uuid);
+  if (it == health_.end()) {
+    return;
+  }
+  if (it->second.dead) {
+    MarkAsAliveUnmutexed(uuid, &it->second);
+  }
+  health_.erase(it);
+  atomic_write32(&reported_osds_count_, static_cast<uint32_t>(health_.size()));
+}
+
+bool OSDHealthRegistry::IsDead(const std::string& uuid) {
+  if (atomic_read32(&dead_osds_count_) == 0) {
+    return false;
+  }
+
+  boost::mutex::scoped_lock lock(mutex_);
+
+  map<string, OSDHealth>::const_iterator it = health_.find(uuid);
+  return it != health_.end() && it->second.dead;
+}
+
+void OSDHealthRegistry::GetDeadOSDs(std::vector<std::string>* dead_osds) {
+  assert(dead_osds);
+  boost::mutex::scoped_lock lock(mutex_);
+
+  for (map<string, OSDHealth>::const_iterator it = health_.begin();
+       it != health_.end();
+       ++it) {
+    if (it->second.dead) {
+      dead_osds->push_back(it->first);
+    }
+  }
+}
+
+void OSDHealthRegistry::MarkAsAliveUnmutexed(const std::string& uuid,
+                                             OSDHealth* health) {
+  health->dead = false;
+  health->consecutive_failures = 0;
+  health->successful_probes = 0;
+  atomic_dec32(&dead_osds_count_);
+
+  if (Logging::log->loggingActive(LEVEL_INFO)) {
+    Logging::log->getLog(LEVEL_INFO) << "The OSD " << uuid
+        << " is reachable again and was re-admitted." << endl;
+  }
+}
+
+bool OSDHealthRegistry::Probe(const std::string& uuid) {
+  // The ping itself carries no information, the OSD only has to answer.
+  xtreemfs_pingMesssage ping_message;
+  ping_message.set_request_response(true);
+  ping_message.mutable_coordinates()->set_x_coordinate(0.0);
+  ping_message.mutable_coordinates()->set_y_coordinate(0.0);
+  ping_message.mutable_coordinates()->set_local_error(0.0);
+
+  // Use an iterator without registry, otherwise the dead OSD would be skipped.
+  SimpleUUIDIterator probed_osd;
+  probed_osd.AddUUID(uuid);
+
+  boost::scoped_ptr<rpc::SyncCallbackBase> response;
+  try {
+    response.reset(ExecuteSyncRequest(
+        boost::bind(
+            &xtreemfs::pbrpc::OSDServiceClient::xtreemfs_ping_sync,
+            osd_service_client_.get(),
+            _1,
+            boost::cref(auth_bogus_),
+            boost::cref(user_credentials_bogus_),
+            &ping_message),
+        &probed_osd,
+        uuid_resolver_,
+        RPCOptionsFromOptions(probe_options_)));
+    response->DeleteBuffers();
+    return true;
+  } catch (const XtreemFSException& e) {
+    if (response.get()) {
+      response->DeleteBuffers();
+    }
+    if (Logging::log->loggingActive(LEVEL_DEBUG)) {
+      Logging::log->getLog(LEVEL_DEBUG) << "Health probe of the OSD " << uuid
+          << " failed: " << e.what() << endl;
+    }
+    return false;
+  }
+}
+
+void OSDHealthRegistry::Run() {
+  assert(osd_service_client_.get() != NULL);
+
+  while (true) {
+    boost::this_thread::sleep(boost::posix_time::seconds(probe_interval_s_));
+
+    vector<string> dead_osds;
+    GetDeadOSDs(&dead_osds);
+
+    for (vector<string>::const_iterator it = dead_osds.begin();
+         it != dead_osds.end();
+         ++it) {
+      bool probe_succeeded = Probe(*it);
+
+      boost::mutex::scoped_lock lock(mutex_);
+      map<string, OSDHealth>::iterator health_it = health_.find(*it);
+      if (health_it == health_.end() || !health_it->second.dead) {
+        // Meanwhile re-admitted by a successful request.
+        continue;
+      }
+      if (probe_succeeded) {
+        if (++health_it->second.successful_probes >= readmit_probes_) {
+          MarkAsAliveUnmutexed(*it, &health_it->second);
+          health_.erase(health_it);
+          atomic_write32(&reported_osds_count_,
+                         static_cast<uint32_t>(health_.size()));
+        }
+      } else {
+        health_it->second.successful_probes = 0;
+      }
+    }
+  }
+}
+
+}  // namespace xtreemfs
@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2026 by the XtreemFS Authors, see AUTHORS file
+ *
+ * Licensed under the BSD License, see LICENSE file for details.
+ *
+ */
+
+#include "libxtreemfs/splicing_osd_service_client.h"
+
+#include <string>
+
+#include "rpc/client.h"
+#include "xtreemfs/OSD.pb.h"
+#include "xtreemfs/OSDServiceConstants.h"
+
+using namespace std;
+using namespace xtreemfs::pbrpc;
+
+namespace xtreemfs {
+
+SplicingOSDServiceClient::SplicingOSDServiceClient(rpc::Client* client)
+    : OSDServiceClient(client),
+      client_(client) {}
+
+SplicingOSDServiceClient::~SplicingOSDServiceClient() {}
+
+void SplicingOSDServiceClient::read_with_credentials(
+    const std::string& address,
+    const pbrpc::Auth& auth,
+    const pbrpc::UserCredentials& creds,
+    const std::string& serialized_file_credentials,
+    const pbrpc::readRequest* request,
+    rpc::CallbackInterface<pbrpc::ObjectData>* callback,
+    void* context) {
+  client_->sendRequest(address, INTERFACE_ID_OSD, PROC_ID_READ,
+                       creds, auth, serialized_file_credentials, request,
+                       NULL, 0, new ObjectData(),
+                       context, callback);
+}
+
+rpc::SyncCallback<pbrpc::ObjectData>*
+SplicingOSDServiceClient::read_with_credentials_sync(
+    const std::string& address,
+    const pbrpc::Auth& auth,
+    const pbrpc::UserCredentials& creds,
+    const std::string& serialized_file_credentials,
+    const pbrpc::readRequest* request) {
+  rpc::SyncCallback<ObjectData>* sync_cb = new rpc::SyncCallback<ObjectData>();
+  client_->sendRequest(address, INTERFACE_ID_OSD, PROC_ID_READ,
+                       creds, auth, serialized_file_credentials, request,
+                       NULL, 0, new ObjectData(),
+                       NULL, sync_cb);
+  return sync_cb;
+}
+
+void SplicingOSDServiceClient::write_with_credentials(
+    const std::string& address,
+    const pbrpc::Auth& auth,
+    const pbrpc::UserCredentials& creds,
+    const std::string& serialized_file_credentials,
+    const pbrpc::writeRequest* request,
+    const char* data,
+    uint32_t data_length,
+    rpc::CallbackInterface<pbrpc::OSDWriteResponse>* callback,
+    void* context) {
+  client_->sendRequest(address, INTERFACE_ID_OSD, PROC_ID_WRITE,
+                       creds, auth, serialized_file_credentials, request,
+                       data, data_length, new OSDWriteResponse(),
+                       context, callback);
+}
+
+rpc::SyncCallback<pbrpc::OSDWriteResponse>*
+SplicingOSDServiceClient::write_with_credentials_sync(
+    const std::string& address,
+    const pbrpc::Auth& auth,
+    const pbrpc::UserCredentials& creds,
+    const std::string& serialized_file_credentials,
+    const pbrpc::writeRequest* request,
+    const char* data,
+    uint32_t data_length) {
+  rpc::SyncCallback<OSDWriteResponse>* sync_cb =
+      new rpc::SyncCallback<OSDWriteResponse>();
+  client_->sendRequest(address, INTERFACE_ID_OSD, PROC_ID_WRITE,
+                       creds, auth, serialized_file_credentials, request,
+                       data, data_length, new OSDWriteResponse(),
+                       NULL, sync_cb);
+  return sync_cb;
+}
+
+}  // namespace xtreemfs
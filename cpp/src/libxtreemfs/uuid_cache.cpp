@@ -8,7 +8,7 @@
 
 #include <time.h>
 
-#include <map>
+#include <sstream>
 #include <string>
 #include <vector>
 
@@ -19,13 +19,13 @@ using namespace xtreemfs::util;
 
 namespace xtreemfs {
 
+UUIDCache::UUIDCache() : mappings_(new MappingMap()) {}
+
 void UUIDCache::update(
     const std::string& uuid,
     const std::string& address,
     const uint32_t port,
     const time_t ttls) {
-  boost::mutex::scoped_lock lock(mutex_);
-
   if (Logging::log->loggingActive(LEVEL_DEBUG)) {
     Logging::log->getLog(LEVEL_DEBUG)  << "UUID: registering new UUID "
         << uuid << " "
@@ -39,33 +39,43 @@ void UUIDCache::update(
   uuidMapping.port = port;
   uuidMapping.timeout = time(NULL) + ttls;  // calc timeout in seconds
 
-  // address contains update-time to evict old entries
-  cache_[uuid] = uuidMapping;
+  boost::mutex::scoped_lock lock(update_mutex_);
+  boost::shared_ptr<MappingMap> mappings
+      = CopyMappingsUnmutexed(time(NULL));
+  AddMapping(uuidMapping, mappings.get());
+  boost::atomic_store(&mappings_,
+                      boost::shared_ptr<const MappingMap>(mappings));
+}
+
+void UUIDCache::Update(const std::vector<UUIDMapping>& new_mappings) {
+  boost::mutex::scoped_lock lock(update_mutex_);
+  boost::shared_ptr<MappingMap> mappings
+      = CopyMappingsUnmutexed(time(NULL));
+  for (size_t i = 0; i < new_mappings.size(); i++) {
+    AddMapping(new_mappings[i], mappings.get());
+  }
+  boost::atomic_store(&mappings_,
+                      boost::shared_ptr<const MappingMap>(mappings));
 }
 
 /**
  * Old UUIDs are invalidated but there is no active pulling of new UUIDs.
  */
 std::string UUIDCache::get(const std::string& uuid) {
-  boost::mutex::scoped_lock lock(mutex_);
+  boost::shared_ptr<const MappingMap> mappings = boost::atomic_load(&mappings_);
 
-  std::map<string, UUIDMapping >::iterator it = cache_.find(uuid);
+  MappingMap::const_iterator it = mappings->find(uuid);
 
   // entry found?
-  if (it != cache_.end()) {
+  if (it != mappings->end()) {
     // entry timed out?
-    const UUIDMapping mapping = it->second;
-    if (time(NULL) < mapping.timeout) {
-      // Build ip-address:port from AddressMapping.
-      ostringstream s;
-      s << mapping.address << ":" << mapping.port;
-      return s.str();
+    if (time(NULL) < it->second.mapping.timeout) {
+      return it->second.address_and_port;
     } else {
-      // Expired => Remove from cache_.
+      // Expired entries are removed by the next update.
       if (Logging::log->loggingActive(LEVEL_DEBUG)) {
         Logging::log->getLog(LEVEL_DEBUG)  << "UUID expired:" << uuid << endl;
       }
-      cache_.erase(it);
     }
   }
 
@@ -75,4 +85,54 @@ std::string UUIDCache::get(const std::string& uuid) {
   return "";
 }
 
+void UUIDCache::GetMappings(std::vector<UUIDMapping>* mappings) {
+  boost::shared_ptr<const MappingMap> current = boost::atomic_load(&mappings_);
+
+  time_t now = time(NULL);
+  for (MappingMap::const_iterator it = current->begin();
+       it != current->end(); ++it) {
+    if (now < it->second.mapping.timeout) {
+      mappings->push_back(it->second.mapping);
+    }
+  }
+}
+
+void UUIDCache::Restore(const UUIDMapping& mapping) {
+  boost::mutex::scoped_lock lock(update_mutex_);
+
+  time_t now = time(NULL);
+  if (now >= mapping.timeout) {
+    return;
+  }
+  boost::shared_ptr<MappingMap> mappings = CopyMappingsUnmutexed(now);
+  // A mapping retrieved from the DIR is always more recent.
+  if (mappings->find(mapping.uuid) != mappings->end()) {
+    return;
+  }
+  AddMapping(mapping, mappings.get());
+  boost::atomic_store(&mappings_,
+                      boost::shared_ptr<const MappingMap>(mappings));
+}
+
+boost::shared_ptr<UUIDCache::MappingMap> UUIDCache::CopyMappingsUnmutexed(
+    time_t now) {
+  boost::shared_ptr<MappingMap> copy(new MappingMap());
+  for (MappingMap::const_iterator it = mappings_->begin();
+       it != mappings_->end(); ++it) {
+    if (now < it->second.mapping.timeout) {
+      copy->insert(*it);
+    }
+  }
+  return copy;
+}
+
+void UUIDCache::AddMapping(const UUIDMapping& mapping,
+                           MappingMap* mappings) {
+  CachedMapping& cached_mapping = (*mappings)[mapping.uuid];
+  cached_mapping.mapping = mapping;
+  ostringstream s;
+  s << mapping.address << ":" << mapping.port;
+  cached_mapping.address_and_port = s.str();
+}
+
 }  // namespace xtreemfs
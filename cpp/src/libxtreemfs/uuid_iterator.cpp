@@ -10,6 +10,7 @@
 
 #include <sstream>
 
+#include "libxtreemfs/osd_health_registry.h"
 #include "libxtreemfs/uuid_container.h"
 #include "libxtreemfs/xtreemfs_exception.h"
 #include "util/logging.h"
@@ -19,7 +20,7 @@ using namespace xtreemfs::util;
 
 namespace xtreemfs {
 
-UUIDIterator::UUIDIterator() {
+UUIDIterator::UUIDIterator() : health_registry_(NULL) {
   // Point to the past-the-end element in case of an empty list.
   current_uuid_ = uuids_.end();
 }
@@ -33,10 +34,30 @@ void UUIDIterator::GetUUID(std::string* result) {
   if (current_uuid_ == uuids_.end()) {
     throw UUIDIteratorListIsEmpyException("GetUUID() failed because the list of"
         " UUIDs is empty.");
-  } else {
-    assert(!(*current_uuid_)->IsFailed());
-    *result = (*current_uuid_)->uuid;
   }
+
+  if (health_registry_ != NULL &&
+      health_registry_->IsDead((*current_uuid_)->uuid)) {
+    // Advance to the next UUID which is not known to be dead. If there is
+    // none, keep the current one.
+    list<UUIDItem*>::iterator it = current_uuid_;
+    for (++it; it != current_uuid_; ++it) {
+      if (it == uuids_.end()) {
+        it = uuids_.begin();
+        if (it == current_uuid_) {
+          break;
+        }
+      }
+      if (!health_registry_->IsDead((*it)->uuid)) {
+        current_uuid_ = it;
+        (*current_uuid_)->Reset();
+        break;
+      }
+    }
+  }
+
+  assert(!(*current_uuid_)->IsFailed());
+  *result = (*current_uuid_)->uuid;
 }
 
 std::string UUIDIterator::DebugString() {
@@ -41,7 +41,9 @@ Vivaldi::Vivaldi(
     const Options& options)
     : dir_uuid_iterator_(dir_uuid_iterator),
       uuid_resolver_(uuid_resolver),
-      vivaldi_options_(options) {
+      vivaldi_options_(options),
+      coordinates_valid_(false),
+      restored_coordinates_pending_(false) {
   srand(static_cast<unsigned int>(time(NULL)));
   // Set AuthType to AUTH_NONE as it's currently not used.
   auth_bogus_.set_auth_type(AUTH_NONE);
@@ -63,20 +65,31 @@ void Vivaldi::Run() {
   assert(osd_client_.get() != NULL);
 
   bool loaded_from_file = false;
+  VivaldiCoordinates file_coordinates;
   ifstream vivaldi_coordinates_file(vivaldi_options_.vivaldi_filename.c_str());
   if (vivaldi_coordinates_file.is_open()) {
-    my_vivaldi_coordinates_.ParseFromIstream(&vivaldi_coordinates_file);
-    loaded_from_file = my_vivaldi_coordinates_.IsInitialized();
+    file_coordinates.ParseFromIstream(&vivaldi_coordinates_file);
+    loaded_from_file = file_coordinates.IsInitialized();
     if (!loaded_from_file) {
         Logging::log->getLog(LEVEL_ERROR)
             << "Vivaldi: Could not load coordinates from file: "
-            << my_vivaldi_coordinates_.InitializationErrorString() << endl;
-      my_vivaldi_coordinates_.Clear();
+            << file_coordinates.InitializationErrorString() << endl;
     }
     vivaldi_coordinates_file.close();
   }
 
-  if (!loaded_from_file) {
+  boost::mutex::scoped_lock coordinate_lock(coordinate_mutex_);
+  if (loaded_from_file) {
+    my_vivaldi_coordinates_.CopyFrom(file_coordinates);
+    coordinates_valid_ = true;
+    restored_coordinates_pending_ = false;
+  } else if (restored_coordinates_pending_) {
+    if (Logging::log->loggingActive(LEVEL_INFO)) {
+      Logging::log->getLog(LEVEL_INFO)
+          << "Vivaldi: Coordinates file does not exist or could not be parsed,"
+          << " starting with the restored coordinates." << endl;
+    }
+  } else {
     if (Logging::log->loggingActive(LEVEL_INFO)) {
       Logging::log->getLog(LEVEL_INFO)
           << "Vivaldi: Coordinates file does not exist or could not be parsed,"
@@ -91,6 +104,8 @@ void Vivaldi::Run() {
   }
 
   VivaldiNode own_node(my_vivaldi_coordinates_);
+  restored_coordinates_pending_ = false;
+  coordinate_lock.unlock();
 
   uint64_t vivaldi_iterations = 0;
 
@@ -104,6 +119,14 @@ void Vivaldi::Run() {
 
   for (;;) {
     boost::scoped_ptr<rpc::SyncCallbackBase> ping_response;
+    {
+      // Coordinates may have been restored while no OSD was reachable yet.
+      boost::mutex::scoped_lock lock(coordinate_mutex_);
+      if (restored_coordinates_pending_) {
+        own_node = VivaldiNode(my_vivaldi_coordinates_);
+        restored_coordinates_pending_ = false;
+      }
+    }
     try {
       // Get a list of OSDs from the DIR(s)
       if ((vivaldi_iterations %
@@ -247,6 +270,7 @@ void Vivaldi::Run() {
         {
           boost::mutex::scoped_lock lock(coordinate_mutex_);
           my_vivaldi_coordinates_.CopyFrom(*own_node.GetCoordinates());
+          coordinates_valid_ = true;
         }
 
         // Store the new coordinates in a local file
@@ -484,4 +508,13 @@ const VivaldiCoordinates& Vivaldi::GetVivaldiCoordinates() const {
   return my_vivaldi_coordinates_;
 }
 
+void Vivaldi::RestoreCoordinates(const VivaldiCoordinates& coordinates) {
+  boost::mutex::scoped_lock lock(coordinate_mutex_);
+  if (coordinates_valid_ || !coordinates.IsInitialized()) {
+    return;
+  }
+  my_vivaldi_coordinates_.CopyFrom(coordinates);
+  restored_coordinates_pending_ = true;
+}
+
 }  // namespace xtreemfs
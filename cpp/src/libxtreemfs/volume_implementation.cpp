@@ -12,18 +12,28 @@
 #include <boost/thread/thread.hpp>
 #include <limits>
 #include <map>
+#include <set>
 #include <string>
+#include <vector>
 
+#include "libxtreemfs/async_write_budget.h"
 #include "libxtreemfs/client_implementation.h"
+#include "libxtreemfs/disk_object_cache.h"
 #include "libxtreemfs/execute_sync_request.h"
 #include "libxtreemfs/file_handle_implementation.h"
 #include "libxtreemfs/file_info.h"
 #include "libxtreemfs/helper.h"
+#include "libxtreemfs/io_throttle.h"
+#include "libxtreemfs/osd_endpoint_table.h"
+#include "libxtreemfs/splicing_osd_service_client.h"
 #include "libxtreemfs/stripe_translator.h"
 #include "libxtreemfs/uuid_iterator.h"
+#include "libxtreemfs/vivaldi.h"
+#include "libxtreemfs/warm_start_snapshot.h"
 #include "libxtreemfs/xtreemfs_exception.h"
 #include "rpc/client.h"
 #include "util/error_log.h"
+#include "util/latency_histogram.h"
 #include "util/logging.h"
 #include "xtreemfs/MRC.pb.h"
 #include "xtreemfs/MRCServiceClient.h"
@@ -54,14 +64,30 @@ VolumeImplementation::VolumeImplementation(
       volume_options_(options),
       // Disable retries and interrupted querying for periodic threads.
       periodic_threads_options_(1, 40, false, NULL),
+      open_file_table_(OpenFileTable::kDefaultNumberOfShards),
       metadata_cache_(options.metadata_cache_size,
-                      options.metadata_cache_ttl_s) {
+                      options.metadata_cache_ttl_s),
+      pending_deferred_closes_(0),
+      stop_deferred_closes_(false) {
   // Set AuthType to AUTH_NONE as it's currently not used.
   auth_bogus_.set_auth_type(AUTH_NONE);
   // Set username "xtreemfs" as it does not get checked at server side.
   user_credentials_bogus_.set_username("xtreemfs");
 
   mrc_uuid_iterator_.reset(mrc_uuid_iterator);
+
+  if (options.enable_async_writes && options.async_writes_max_total_size_mb) {
+    async_write_budget_.reset(new AsyncWriteBudget(
+        static_cast<size_t>(options.async_writes_max_total_size_mb) * 1024
+            * 1024));
+  }
+
+  if (options.qos_max_bandwidth_kb || options.qos_max_iops) {
+    io_throttle_.reset(new IOThrottle(
+        static_cast<int64_t>(options.qos_max_bandwidth_kb) * 1024,
+        options.qos_max_iops,
+        options.qos_weights));
+  }
 }
 
 VolumeImplementation::~VolumeImplementation() {
@@ -94,31 +120,44 @@ void VolumeImplementation::Start() {
                                     network_client_.get())));
   // Create MRC and OSDServiceClient wrapper.
   mrc_service_client_.reset(new MRCServiceClient(network_client_.get()));
-  osd_service_client_.reset(new OSDServiceClient(network_client_.get()));
+  osd_service_client_.reset(
+      new SplicingOSDServiceClient(network_client_.get()));
 
   // Register StripingPolicies.
   stripe_translators_[STRIPING_POLICY_RAID0] = new StripeTranslatorRaid0();
 
-  // Start periodic threads.
-  xcap_renewal_thread_.reset(new boost::thread(boost::bind(
-      &xtreemfs::VolumeImplementation::PeriodicXCapRenewal,
-      this)));
-  filesize_writeback_thread_.reset(new boost::thread(boost::bind(
-      &xtreemfs::VolumeImplementation::PeriodicFileSizeUpdate,
+  // Start the thread which renews XCaps and writes back file sizes.
+  file_task_thread_.reset(new boost::thread(boost::bind(
+      &xtreemfs::VolumeImplementation::ProcessFileTasks,
       this)));
+  if (volume_options_.enable_write_behind_close) {
+    deferred_close_thread_.reset(new boost::thread(boost::bind(
+        &xtreemfs::VolumeImplementation::ProcessDeferredCloses,
+        this)));
+  }
+
+  if (!volume_options_.warm_start_snapshot_dir.empty()) {
+    RestoreWarmStartSnapshot();
+  }
 }
 
 /**
  * @throws OpenFileHandlesLeftException
  */
 void VolumeImplementation::CloseInternal() {
-  // Stop periodic threads.
-  filesize_writeback_thread_->interrupt();
-  xcap_renewal_thread_->interrupt();
-  filesize_writeback_thread_->join();
-  xcap_renewal_thread_->join();
+  // Complete all write-behind closes first, they still need the network client.
+  if (deferred_close_thread_) {
+    {
+      boost::mutex::scoped_lock lock(deferred_closes_mutex_);
+      stop_deferred_closes_ = true;
+      deferred_closes_changed_.notify_all();
+    }
+    deferred_close_thread_->join();
+  }
 
-  boost::mutex::scoped_lock lock_oft(open_file_table_mutex_);
+  // Stop periodic threads.
+  file_task_thread_->interrupt();
+  file_task_thread_->join();
 
   // There must not be any FileInfo object left.
   if (open_file_table_.size() != 0) {
@@ -132,6 +171,64 @@ void VolumeImplementation::CloseInternal() {
   // Shutdown network client.
   network_client_->shutdown();
   network_client_thread_->join();
+
+  if (!volume_options_.warm_start_snapshot_dir.empty()) {
+    WriteWarmStartSnapshot();
+  }
+}
+
+void VolumeImplementation::RestoreWarmStartSnapshot() {
+  string path = GetWarmStartSnapshotPath(
+      volume_options_.warm_start_snapshot_dir, volume_name_);
+  VivaldiCoordinates vivaldi_coordinates;
+  try {
+    if (!LoadWarmStartSnapshot(path,
+                               client_->GetUUIDCache(),
+                               &vivaldi_coordinates,
+                               &metadata_cache_)) {
+      return;
+    }
+  } catch (const XtreemFSException& e) {
+    // Continue with empty caches.
+    string error = "Failed to restore the warm start snapshot: "
+        + string(e.what());
+    Logging::log->getLog(LEVEL_WARN) << error << endl;
+    ErrorLog::error_log->AppendError(error);
+    return;
+  }
+
+  Vivaldi* vivaldi = client_->GetVivaldi();
+  if (vivaldi && vivaldi_coordinates.IsInitialized()) {
+    vivaldi->RestoreCoordinates(vivaldi_coordinates);
+  }
+
+  if (Logging::log->loggingActive(LEVEL_INFO)) {
+    Logging::log->getLog(LEVEL_INFO) << "Restored the warm start snapshot "
+        << path << ", metadata cache entries: " << metadata_cache_.Size()
+        << endl;
+  }
+}
+
+void VolumeImplementation::WriteWarmStartSnapshot() {
+  string path = GetWarmStartSnapshotPath(
+      volume_options_.warm_start_snapshot_dir, volume_name_);
+  Vivaldi* vivaldi = client_->GetVivaldi();
+  VivaldiCoordinates vivaldi_coordinates;
+  if (vivaldi) {
+    vivaldi_coordinates.CopyFrom(vivaldi->GetVivaldiCoordinates());
+  }
+
+  try {
+    SaveWarmStartSnapshot(path,
+                          client_->GetUUIDCache(),
+                          vivaldi ? &vivaldi_coordinates : NULL,
+                          &metadata_cache_);
+  } catch (const XtreemFSException& e) {
+    string error = "Failed to write the warm start snapshot: "
+        + string(e.what());
+    Logging::log->getLog(LEVEL_ERROR) << error << endl;
+    ErrorLog::error_log->AppendError(error);
+  }
 }
 
 void VolumeImplementation::Close() {
@@ -143,6 +240,8 @@ void VolumeImplementation::Close() {
 
 StatVFS* VolumeImplementation::StatFS(
     const xtreemfs::pbrpc::UserCredentials& user_credentials) {
+  ScopedLatencyRecorder latency(
+      LatencyStatistics::GetHistogram(LatencyStatistics::kStatFS));
   statvfsRequest rq;
   rq.set_volume_name(volume_name_);
   rq.set_known_etag(0);
@@ -297,6 +396,8 @@ FileHandle* VolumeImplementation::OpenFile(
     const xtreemfs::pbrpc::UserCredentials& user_credentials,
     const std::string& path,
     const xtreemfs::pbrpc::SYSTEM_V_FCNTL flags) {
+  ScopedLatencyRecorder latency(
+      LatencyStatistics::GetHistogram(LatencyStatistics::kOpen));
   return OpenFileWithTruncateSize(user_credentials, path, flags, 0, 0, 0);
 }
 
@@ -305,6 +406,8 @@ FileHandle* VolumeImplementation::OpenFile(
     const std::string& path,
     const xtreemfs::pbrpc::SYSTEM_V_FCNTL flags,
     uint32_t mode) {
+  ScopedLatencyRecorder latency(
+      LatencyStatistics::GetHistogram(LatencyStatistics::kOpen));
   return OpenFileWithTruncateSize(user_credentials, path, flags, mode, 0, 0);
 }
 
@@ -314,6 +417,8 @@ FileHandle* VolumeImplementation::OpenFile(
     const xtreemfs::pbrpc::SYSTEM_V_FCNTL flags,
     uint32_t mode,
     uint32_t attributes) {
+  ScopedLatencyRecorder latency(
+      LatencyStatistics::GetHistogram(LatencyStatistics::kOpen));
   return OpenFileWithTruncateSize(user_credentials, path, flags, mode, attributes, 0);
 }
 
@@ -327,27 +432,8 @@ FileHandle* VolumeImplementation::OpenFileWithTruncateSize(
     uint32_t mode,
     uint32_t attributes,
     int truncate_new_file_size) {
-  bool async_writes_enabled = volume_options_.enable_async_writes;
-
-  if (flags & SYSTEM_V_FCNTL_H_O_SYNC) {
-    if (Logging::log->loggingActive(LEVEL_DEBUG)) {
-      Logging::log->getLog(LEVEL_DEBUG)
-          << "open called with O_SYNC, async writes were disabled." << endl;
-    }
-    async_writes_enabled = false;
-  }
-
   openRequest rq;
-  rq.set_volume_name(volume_name_);
-  rq.set_path(path);
-  rq.set_flags(flags);
-  rq.set_mode(mode);
-  rq.set_attributes(attributes);
-
-  // set vivaldi coordinates if vivaldi is enabled
-  if (volume_options_.vivaldi_enable) {
-    rq.mutable_coordinates()->CopyFrom(this->client_->GetVivaldiCoordinates());
-  }
+  PrepareOpenRequest(path, flags, mode, attributes, &rq);
 
   boost::scoped_ptr<rpc::SyncCallbackBase> response(
       ExecuteSyncRequest(
@@ -362,36 +448,131 @@ FileHandle* VolumeImplementation::OpenFileWithTruncateSize(
           uuid_resolver_,
           RPCOptionsFromOptions(volume_options_)));
 
-  openResponse* open_response = static_cast<openResponse*>(
-      response->response());
+  FileHandle* file_handle = NULL;
+  try {
+    file_handle = ProcessOpenResponse(
+        user_credentials,
+        path,
+        flags,
+        truncate_new_file_size,
+        *static_cast<openResponse*>(response->response()));
+  } catch (const XtreemFSException&) {
+    response->DeleteBuffers();
+    throw;
+  }
+  response->DeleteBuffers();
+
+  return file_handle;
+}
+
+void VolumeImplementation::PrewarmOSDConnections(FileInfo* file_info) {
+  boost::shared_ptr<OSDEndpointTable> osd_endpoints;
+  file_info->GetXLocSetSnapshot(NULL, &osd_endpoints);
+
+  // Do not retry, the regular requests will do that if necessary.
+  RPCOptions options(1,
+                     volume_options_.retry_delay_s,
+                     false,
+                     volume_options_.was_interrupted_function);
+  set<string> addresses;
+  for (int replica = 0; replica < osd_endpoints->replica_count(); replica++) {
+    for (int pos = 0; pos < osd_endpoints->osd_count(replica); pos++) {
+      string address;
+      try {
+        osd_endpoints->GetAddress(replica, pos, &address, options);
+      } catch (const XtreemFSException& e) {
+        if (Logging::log->loggingActive(LEVEL_DEBUG)) {
+          Logging::log->getLog(LEVEL_DEBUG) << "Failed to resolve the OSD "
+              << osd_endpoints->GetUUID(replica, pos) << " for pre-warming its"
+              " connection: " << e.what() << endl;
+        }
+        continue;
+      }
+      // Replicas may share OSDs.
+      if (addresses.insert(address).second) {
+        network_client_->Connect(address);
+      }
+    }
+  }
+}
+
+void VolumeImplementation::PrepareOpenRequest(
+    const std::string& path,
+    const xtreemfs::pbrpc::SYSTEM_V_FCNTL flags,
+    uint32_t mode,
+    uint32_t attributes,
+    xtreemfs::pbrpc::openRequest* rq) {
+  rq->set_volume_name(volume_name_);
+  rq->set_path(path);
+  rq->set_flags(flags);
+  rq->set_mode(mode);
+  rq->set_attributes(attributes);
+
+  // set vivaldi coordinates if vivaldi is enabled
+  if (volume_options_.vivaldi_enable) {
+    rq->mutable_coordinates()->CopyFrom(this->client_->GetVivaldiCoordinates());
+  }
+}
+
+FileHandle* VolumeImplementation::ProcessOpenResponse(
+    const xtreemfs::pbrpc::UserCredentials& user_credentials,
+    const std::string& path,
+    const xtreemfs::pbrpc::SYSTEM_V_FCNTL flags,
+    int truncate_new_file_size,
+    const xtreemfs::pbrpc::openResponse& response) {
+  bool async_writes_enabled = volume_options_.enable_async_writes;
+
+  if (flags & SYSTEM_V_FCNTL_H_O_SYNC) {
+    if (Logging::log->loggingActive(LEVEL_DEBUG)) {
+      Logging::log->getLog(LEVEL_DEBUG)
+          << "open called with O_SYNC, async writes were disabled." << endl;
+    }
+    async_writes_enabled = false;
+  }
+
   // We must have obtained file credentials.
-  assert(open_response->has_creds());
+  assert(response.has_creds());
 
-  if (open_response->creds().xlocs().replicas_size() == 0) {
+  if (response.creds().xlocs().replicas_size() == 0) {
     string error = "MRC assigned no OSDs to file on open: " + path +
-        ", xloc: " + open_response->creds().xlocs().DebugString();
+        ", xloc: " + response.creds().xlocs().DebugString();
     Logging::log->getLog(LEVEL_ERROR) << error << endl;
     ErrorLog::error_log->AppendError(error);
     throw PosixErrorException(POSIX_ERROR_EIO, error);
   }
 
+  // Drop cached objects which were read before the file was truncated or
+  // its replicas changed.
+  DiskObjectCache* disk_cache = client_->GetDiskObjectCache();
+  if (disk_cache) {
+    disk_cache->Validate(response.creds().xcap().file_id(),
+                         response.creds().xcap().truncate_epoch(),
+                         response.creds().xlocs().version());
+  }
+
   FileHandleImplementation* file_handle = NULL;
+  FileInfo* file_info = NULL;
+  const uint64_t file_id = ExtractFileIdFromXCap(response.creds().xcap());
   // Create a FileInfo object if it does not exist yet.
   {
-    boost::mutex::scoped_lock lock(open_file_table_mutex_);
+    boost::mutex::scoped_lock lock(open_file_table_.GetMutex(file_id));
 
-    FileInfo* file_info = GetFileInfoOrCreateUnmutexed(
-        ExtractFileIdFromXCap(open_response->creds().xcap()),
+    file_info = GetFileInfoOrCreateUnmutexed(
+        file_id,
         path,
-        open_response->creds().xcap().replicate_on_close(),
-        open_response->creds().xlocs());
-    file_handle = file_info->CreateFileHandle(open_response->creds().xcap(),
+        response.creds().xcap().replicate_on_close(),
+        response.creds().xlocs());
+    file_handle = file_info->CreateFileHandle(response.creds().xcap(),
                                               async_writes_enabled);
   }
+  file_handle->SetQoSKey(user_credentials.username());
 
-  // Copy timestamp and free response memory.
-  uint64_t timestamp_s = open_response->timestamp_s();
-  response->DeleteBuffers();
+  // The FileInfo stays valid as long as file_handle is open.
+  if (volume_options_.prewarm_osd_connections) {
+    PrewarmOSDConnections(file_info);
+  }
+
+  uint64_t timestamp_s = response.timestamp_s();
 
   // If O_CREAT is set and the file did not previously exist, upon successful
   // completion, open() shall mark for update the st_atime, st_ctime, and
@@ -430,6 +611,13 @@ FileHandle* VolumeImplementation::OpenFileWithTruncateSize(
     }
   }
 
+  // Report a failed write-behind close of the file by this open.
+  string deferred_close_error;
+  if (PopDeferredCloseError(file_id, &deferred_close_error)) {
+    file_handle->Close();
+    throw PosixErrorException(POSIX_ERROR_EIO, deferred_close_error);
+  }
+
   return file_handle;
 }
 
@@ -463,10 +651,10 @@ void VolumeImplementation::CloseFile(
   boost::scoped_ptr<FileHandleImplementation> file_handle_ptr(file_handle);
 
   // Remove file_info if it has no more open file handles.
-  boost::mutex::scoped_lock lock(open_file_table_mutex_);
+  boost::mutex::scoped_lock lock(open_file_table_.GetMutex(file_id));
   if (file_info->DecreaseReferenceCount() == 0) {
     RemoveFileInfoUnmutexed(file_id, file_info);
-    // file_info is no longer visible: it's safe to unlock the open_file_table_.
+    // file_info is no longer visible: it's safe to unlock its shard.
     lock.unlock();
 
     // The last file handle of this file was closed: Release all locks.
@@ -490,6 +678,41 @@ void VolumeImplementation::CloseFile(
   }
 }
 
+void VolumeImplementation::DeferCloseFileHandle(
+    uint64_t file_id,
+    const std::string& path,
+    FileHandleImplementation* file_handle) {
+  boost::mutex::scoped_lock lock(deferred_closes_mutex_);
+  while (pending_deferred_closes_
+             >= volume_options_.write_behind_close_max_pending) {
+    deferred_closes_changed_.wait(lock);
+  }
+
+  pending_deferred_closes_++;
+  deferred_closes_.push_back(DeferredClose(file_id, path, file_handle));
+  deferred_closes_changed_.notify_all();
+}
+
+void VolumeImplementation::ThrowIfDeferredCloseFailed(uint64_t file_id) {
+  string error;
+  if (PopDeferredCloseError(file_id, &error)) {
+    throw PosixErrorException(POSIX_ERROR_EIO, error);
+  }
+}
+
+bool VolumeImplementation::PopDeferredCloseError(uint64_t file_id,
+                                                 std::string* error) {
+  boost::mutex::scoped_lock lock(deferred_closes_mutex_);
+  map<uint64_t, string>::iterator it = deferred_close_errors_.find(file_id);
+  if (it == deferred_close_errors_.end()) {
+    return false;
+  }
+
+  error->swap(it->second);
+  deferred_close_errors_.erase(it);
+  return true;
+}
+
 void VolumeImplementation::GetAttr(
     const xtreemfs::pbrpc::UserCredentials& user_credentials,
     const std::string& path,
@@ -548,17 +771,23 @@ void VolumeImplementation::GetAttrHelper(
           mrc_uuid_iterator_.get(),
           uuid_resolver_,
           RPCOptionsFromOptions(volume_options_)));
-  getattrResponse* getattr = static_cast<getattrResponse*>(
-      response->response());
+  ProcessGetAttrResponse(path,
+                         *static_cast<getattrResponse*>(response->response()),
+                         stat_buffer);
+
+  response->DeleteBuffers();
+}
 
-  stat_buffer->CopyFrom(getattr->stbuf());
+void VolumeImplementation::ProcessGetAttrResponse(
+    const std::string& path,
+    const xtreemfs::pbrpc::getattrResponse& response,
+    xtreemfs::pbrpc::Stat* stat_buffer) {
+  stat_buffer->CopyFrom(response.stbuf());
   if (stat_buffer->nlink() > 1) {  // Do not cache hard links.
     metadata_cache_.Invalidate(path);
   } else {
     metadata_cache_.UpdateStat(path, *stat_buffer);
   }
-
-  response->DeleteBuffers();
 }
 
 void VolumeImplementation::GetAttr(
@@ -567,69 +796,81 @@ void VolumeImplementation::GetAttr(
     bool ignore_metadata_cache,
     xtreemfs::pbrpc::Stat* stat_buffer,
     FileInfo* file_info) {
+  ScopedLatencyRecorder latency(
+      LatencyStatistics::GetHistogram(LatencyStatistics::kGetAttr));
   // Retrieve stat object from cache or MRC.
   GetAttrHelper(user_credentials, path, ignore_metadata_cache, stat_buffer);
 
   // Wait until async writes have finished and merge StatCache object with
   // possibly newer information from FileInfo.
   if (file_info == NULL) {
-    // Unknown if this file at "path" is open - look it up by its file_id.
-    boost::mutex::scoped_lock oft_lock(open_file_table_mutex_);
-
-    map<uint64_t, FileInfo*>::const_iterator it
-        = open_file_table_.find(stat_buffer->ino());  // ino = file_id.
-    if (it != open_file_table_.end()) {
-      // File at "path" is opened.
-
-      // Wait for pending asynchronous writes which haven't finished yet and
-      // whose new file size is not considered yet by the stat object.
-
-      // To avoid longer locking periods of the open file table, we will
-      // register an observer at the file and get notified later.
-      bool wait_completed = false;
-      boost::mutex wait_completed_mutex;
-      boost::mutex::scoped_lock wait_completed_lock(wait_completed_mutex);
-      boost::condition wait_completed_condition;
-      if (it->second->WaitForPendingAsyncWritesNonBlocking(
-              &wait_completed_condition,
-              &wait_completed,
-              &wait_completed_mutex)) {
-        // Wait would have blocked and did register our observer.
+    MergeStatWithOpenFile(user_credentials,
+                          path,
+                          ignore_metadata_cache,
+                          stat_buffer);
+  } else {
+    file_info->WaitForPendingAsyncWrites();
+    file_info->MergeStatAndOSDWriteResponse(stat_buffer);
+  }
+}
 
-        oft_lock.unlock();
+void VolumeImplementation::MergeStatWithOpenFile(
+    const xtreemfs::pbrpc::UserCredentials& user_credentials,
+    const std::string& path,
+    bool ignore_metadata_cache,
+    xtreemfs::pbrpc::Stat* stat_buffer) {
+  // Unknown if this file at "path" is open - look it up by its file_id.
+  uint64_t file_id = stat_buffer->ino();  // ino = file_id.
+  boost::mutex::scoped_lock oft_lock(open_file_table_.GetMutex(file_id));
+
+  FileInfo* file_info = open_file_table_.FindUnmutexed(file_id);
+  if (file_info) {
+    // File at "path" is opened.
+
+    // Wait for pending asynchronous writes which haven't finished yet and
+    // whose new file size is not considered yet by the stat object.
+
+    // To avoid longer locking periods of the open file table, we will
+    // register an observer at the file and get notified later.
+    bool wait_completed = false;
+    boost::mutex wait_completed_mutex;
+    boost::mutex::scoped_lock wait_completed_lock(wait_completed_mutex);
+    boost::condition wait_completed_condition;
+    if (file_info->WaitForPendingAsyncWritesNonBlocking(
+            &wait_completed_condition,
+            &wait_completed,
+            &wait_completed_mutex)) {
+      // Wait would have blocked and did register our observer.
+
+      oft_lock.unlock();
+
+      while (!wait_completed) {
+        wait_completed_condition.wait(wait_completed_lock);
+      }
 
-        while (!wait_completed) {
-          wait_completed_condition.wait(wait_completed_lock);
-        }
+      oft_lock.lock();
 
-        oft_lock.lock();
-
-        // As wait did unlock the open file table, the previously
-        // found FileInfo object may be removed and deleted meanwhile, i.e.
-        // search again for it.
-        map<uint64_t, FileInfo*>::const_iterator it2
-            = open_file_table_.find(stat_buffer->ino());  // ino = file_id.
-        if (it2 != open_file_table_.end()) {
-          it2->second->MergeStatAndOSDWriteResponse(stat_buffer);
-        } else {
-          // We dont find the previous FileInfo object anymore. This means we
-          // have to retrieve the file size once again from the MRC or stat cache.
-          // Return lock on open_file_table_.
-          oft_lock.unlock();
-          GetAttrHelper(user_credentials,
-                        path,
-                        ignore_metadata_cache,
-                        stat_buffer);
-        }
+      // As wait did unlock the open file table, the previously
+      // found FileInfo object may be removed and deleted meanwhile, i.e.
+      // search again for it.
+      file_info = open_file_table_.FindUnmutexed(file_id);
+      if (file_info) {
+        file_info->MergeStatAndOSDWriteResponse(stat_buffer);
       } else {
-        // Open file table was never unlocked and it's still safe to access the
-        // file info object.
-        it->second->MergeStatAndOSDWriteResponse(stat_buffer);
+        // We dont find the previous FileInfo object anymore. This means we
+        // have to retrieve the file size once again from the MRC or stat cache.
+        // Return lock on open_file_table_.
+        oft_lock.unlock();
+        GetAttrHelper(user_credentials,
+                      path,
+                      ignore_metadata_cache,
+                      stat_buffer);
       }
+    } else {
+      // Open file table was never unlocked and it's still safe to access the
+      // file info object.
+      file_info->MergeStatAndOSDWriteResponse(stat_buffer);
     }
-  } else {
-    file_info->WaitForPendingAsyncWrites();
-    file_info->MergeStatAndOSDWriteResponse(stat_buffer);
   }
 }
 
@@ -638,6 +879,8 @@ void VolumeImplementation::SetAttr(
     const std::string& path,
     const xtreemfs::pbrpc::Stat& stat,
     xtreemfs::pbrpc::Setattrs to_set) {
+  ScopedLatencyRecorder latency(
+      LatencyStatistics::GetHistogram(LatencyStatistics::kSetAttr));
   // Based on possibly cached stat, find out which attributes actually have
   // to be updated.
   Setattrs actual_to_set = metadata_cache_.SimulateSetStatAttributes(path,
@@ -703,6 +946,8 @@ void VolumeImplementation::SetAttr(
 void VolumeImplementation::Unlink(
     const xtreemfs::pbrpc::UserCredentials& user_credentials,
     const std::string& path) {
+  ScopedLatencyRecorder latency(
+      LatencyStatistics::GetHistogram(LatencyStatistics::kUnlink));
   // 1. Delete file at MRC.
   unlinkRequest rq;
   rq.set_volume_name(volume_name_);
@@ -720,24 +965,33 @@ void VolumeImplementation::Unlink(
           mrc_uuid_iterator_.get(),
           uuid_resolver_,
           RPCOptionsFromOptions(volume_options_)));
-  unlinkResponse* unlink_response = static_cast<unlinkResponse*>(
-      response->response());
+  try {
+    ProcessUnlinkResponse(
+        path, *static_cast<unlinkResponse*>(response->response()));
+  } catch (const XtreemFSException&) {
+    response->DeleteBuffers();
+    throw;
+  }
+
+  response->DeleteBuffers();
+}
 
+void VolumeImplementation::ProcessUnlinkResponse(
+    const std::string& path,
+    const xtreemfs::pbrpc::unlinkResponse& response) {
   // 2. Invalidate metadata caches.
   metadata_cache_.Invalidate(path);
   const string parent_dir = ResolveParentDirectory(path);
   metadata_cache_.UpdateStatTime(
       parent_dir,
-      unlink_response->timestamp_s(),
+      response.timestamp_s(),
       static_cast<Setattrs>(SETATTR_CTIME | SETATTR_MTIME));
   metadata_cache_.InvalidateDirEntry(parent_dir, GetBasename(path));
 
   // 3. Delete objects of all replicas on the OSDs.
-  if (unlink_response->has_creds()) {
-    UnlinkAtOSD(unlink_response->creds(), path);
+  if (response.has_creds()) {
+    UnlinkAtOSD(response.creds(), path);
   }
-
-  response->DeleteBuffers();
 }
 
 void VolumeImplementation::UnlinkAtOSD(const FileCredentials& fc,
@@ -773,6 +1027,8 @@ void VolumeImplementation::Rename(
     const xtreemfs::pbrpc::UserCredentials& user_credentials,
     const std::string& path,
     const std::string& new_path) {
+  ScopedLatencyRecorder latency(
+      LatencyStatistics::GetHistogram(LatencyStatistics::kRename));
   if (path == new_path) {
     return;  // Do nothing.
   }
@@ -835,14 +1091,10 @@ void VolumeImplementation::Rename(
                                  static_cast<Setattrs>(SETATTR_CTIME));
 
   // Rename path in all open FileInfo objects.
-  {
-    boost::mutex::scoped_lock lock(open_file_table_mutex_);
-    map<uint64_t, FileInfo*>::iterator it;
-    for (it = open_file_table_.begin();
-         it != open_file_table_.end(); ++it) {
-      it->second->RenamePath(path, new_path);
-    }
-  }
+  open_file_table_.ForEach(boost::bind(&FileInfo::RenamePath,
+                                       _1,
+                                       boost::cref(path),
+                                       boost::cref(new_path)));
 
   response->DeleteBuffers();
 }
@@ -851,6 +1103,8 @@ void VolumeImplementation::MakeDirectory(
     const xtreemfs::pbrpc::UserCredentials& user_credentials,
     const std::string& path,
     unsigned int mode) {
+  ScopedLatencyRecorder latency(
+      LatencyStatistics::GetHistogram(LatencyStatistics::kMakeDirectory));
   mkdirRequest rq;
   rq.set_volume_name(volume_name_);
   rq.set_path(path);
@@ -868,24 +1122,30 @@ void VolumeImplementation::MakeDirectory(
           mrc_uuid_iterator_.get(),
           uuid_resolver_,
           RPCOptionsFromOptions(volume_options_)));
-  timestampResponse* ts_response = static_cast<timestampResponse*>(
-      response->response());
+  ProcessMakeDirectoryResponse(
+      path, *static_cast<timestampResponse*>(response->response()));
 
+  response->DeleteBuffers();
+}
+
+void VolumeImplementation::ProcessMakeDirectoryResponse(
+    const std::string& path,
+    const xtreemfs::pbrpc::timestampResponse& response) {
   const string parent_dir = ResolveParentDirectory(path);
   metadata_cache_.UpdateStatTime(
       parent_dir,
-      ts_response->timestamp_s(),
+      response.timestamp_s(),
       static_cast<Setattrs>(SETATTR_CTIME | SETATTR_MTIME));
   // TODO(mberlin): Retrieve stat as optional member of openResponse instead
   //                and update cached DirectoryEntries accordingly.
   metadata_cache_.InvalidateDirEntries(parent_dir);
-
-  response->DeleteBuffers();
 }
 
 void VolumeImplementation::DeleteDirectory(
     const xtreemfs::pbrpc::UserCredentials& user_credentials,
     const std::string& path) {
+  ScopedLatencyRecorder latency(
+      LatencyStatistics::GetHistogram(LatencyStatistics::kDeleteDirectory));
   rmdirRequest rq;
   rq.set_volume_name(volume_name_);
   rq.set_path(path);
@@ -916,6 +1176,371 @@ void VolumeImplementation::DeleteDirectory(
   response->DeleteBuffers();
 }
 
+namespace {
+
+/** Returns the errno which corresponds to "e" (EIO if it has none). */
+POSIXErrno ExceptionToPOSIXErrno(const XtreemFSException& e) {
+  const PosixErrorException* posix_error
+      = dynamic_cast<const PosixErrorException*>(&e);
+  return posix_error != NULL ? posix_error->posix_errno() : POSIX_ERROR_EIO;
+}
+
+}  // namespace
+
+template<typename RequestType>
+void VolumeImplementation::ExecuteBatch(
+    const std::vector<RequestType>& requests,
+    const std::vector<size_t>& items,
+    boost::function<rpc::SyncCallbackBase*(
+        const std::string&, const RequestType*)> send_request,
+    boost::function<void(size_t, rpc::SyncCallbackBase*, bool)> complete_item,
+    std::vector<xtreemfs::pbrpc::POSIXErrno>* errors) {
+  assert(requests.size() == items.size());
+
+  string mrc_address;
+  try {
+    string mrc_uuid;
+    mrc_uuid_iterator_->GetUUID(&mrc_uuid);
+    uuid_resolver_->UUIDToAddressWithOptions(
+        mrc_uuid, &mrc_address, RPCOptionsFromOptions(volume_options_));
+  } catch (const XtreemFSException&) {
+    // Left to the blocking operation of every item which reports the error.
+    mrc_address.clear();
+  }
+
+  vector<rpc::SyncCallbackBase*> responses;
+  for (size_t first = 0;
+       first < requests.size();
+       first += kMaxPendingBatchRequests) {
+    const size_t last = min(requests.size(), first + kMaxPendingBatchRequests);
+
+    // The requests reference "requests", i.e. all of them have to be
+    // completed before this method may return or throw.
+    responses.assign(last - first, NULL);
+    try {
+      if (!mrc_address.empty()) {
+        for (size_t j = first; j < last; j++) {
+          responses[j - first] = send_request(mrc_address, &requests[j]);
+        }
+      }
+
+      for (size_t j = first; j < last; j++) {
+        const size_t item = items[j];
+        if (responses[j - first] == NULL) {
+          try {
+            complete_item(item, NULL, false);
+          } catch (const XtreemFSException& e) {
+            (*errors)[item] = ExceptionToPOSIXErrno(e);
+          }
+          continue;
+        }
+
+        // HasFailed() is an interruption point. Take the ownership only after
+        // the request was processed.
+        bool has_failed = responses[j - first]->HasFailed();
+        boost::scoped_ptr<rpc::SyncCallbackBase> response(
+            responses[j - first]);
+        responses[j - first] = NULL;
+        try {
+          if (!has_failed) {
+            complete_item(item, response.get(), true);
+          } else if (response->error()->error_type() == ERRNO) {
+            (*errors)[item] = response->error()->posix_errno();
+          } else {
+            // Redirects, timeouts etc. are handled by the blocking operation.
+            complete_item(item, NULL, true);
+          }
+        } catch (const XtreemFSException& e) {
+          (*errors)[item] = ExceptionToPOSIXErrno(e);
+        }
+        response->DeleteBuffers();
+      }
+    } catch (...) {
+      // Wait until all outstanding requests were processed - otherwise leaks
+      // and accesses to deleted memory may occur.
+      for (size_t j = 0; j < responses.size(); j++) {
+        if (responses[j] != NULL) {
+          responses[j]->HasFailed();
+          responses[j]->DeleteBuffers();
+          delete responses[j];
+        }
+      }
+      throw;
+    }
+  }
+}
+
+void VolumeImplementation::GetAttrs(
+    const xtreemfs::pbrpc::UserCredentials& user_credentials,
+    const std::vector<std::string>& paths,
+    std::vector<xtreemfs::pbrpc::Stat>* stats,
+    std::vector<xtreemfs::pbrpc::POSIXErrno>* errors) {
+  stats->clear();
+  stats->resize(paths.size());
+  errors->assign(paths.size(), POSIX_ERROR_NONE);
+
+  // Serve cached entries, request all others at once.
+  vector<size_t> items;
+  vector<getattrRequest> requests;
+  for (size_t i = 0; i < paths.size(); i++) {
+    MetadataCache::GetStatResult stat_cached =
+        metadata_cache_.GetStat(paths[i], &(*stats)[i]);
+    if (stat_cached == MetadataCache::kStatCached) {
+      try {
+        MergeStatWithOpenFile(user_credentials, paths[i], false, &(*stats)[i]);
+      } catch (const XtreemFSException& e) {
+        (*errors)[i] = ExceptionToPOSIXErrno(e);
+      }
+      continue;
+    } else if (stat_cached == MetadataCache::kPathDoesntExist) {
+      (*errors)[i] = POSIX_ERROR_ENOENT;
+      continue;
+    }
+
+    items.push_back(i);
+    requests.push_back(getattrRequest());
+    requests.back().set_volume_name(volume_name_);
+    requests.back().set_path(paths[i]);
+    requests.back().set_known_etag(0);
+  }
+
+  ExecuteBatch<getattrRequest>(
+      requests,
+      items,
+      boost::bind(&xtreemfs::pbrpc::MRCServiceClient::getattr_sync,
+                  mrc_service_client_.get(),
+                  _1,
+                  boost::cref(auth_bogus_),
+                  boost::cref(user_credentials),
+                  _2),
+      boost::bind(&VolumeImplementation::CompleteBatchGetAttr,
+                  this,
+                  &user_credentials,
+                  &paths,
+                  stats,
+                  _1,
+                  _2,
+                  _3),
+      errors);
+}
+
+void VolumeImplementation::CompleteBatchGetAttr(
+    const xtreemfs::pbrpc::UserCredentials* user_credentials,
+    const std::vector<std::string>* paths,
+    std::vector<xtreemfs::pbrpc::Stat>* stats,
+    size_t i,
+    rpc::SyncCallbackBase* response,
+    bool was_sent) {
+  if (response == NULL) {
+    GetAttr(*user_credentials, (*paths)[i], false, &(*stats)[i], NULL);
+    return;
+  }
+
+  ProcessGetAttrResponse((*paths)[i],
+                         *static_cast<getattrResponse*>(response->response()),
+                         &(*stats)[i]);
+  MergeStatWithOpenFile(*user_credentials, (*paths)[i], false, &(*stats)[i]);
+}
+
+void VolumeImplementation::OpenFiles(
+    const xtreemfs::pbrpc::UserCredentials& user_credentials,
+    const std::vector<std::string>& paths,
+    const xtreemfs::pbrpc::SYSTEM_V_FCNTL flags,
+    uint32_t mode,
+    std::vector<FileHandle*>* file_handles,
+    std::vector<xtreemfs::pbrpc::POSIXErrno>* errors) {
+  file_handles->assign(paths.size(), NULL);
+  errors->assign(paths.size(), POSIX_ERROR_NONE);
+
+  vector<size_t> items(paths.size());
+  vector<openRequest> requests(paths.size());
+  for (size_t i = 0; i < paths.size(); i++) {
+    items[i] = i;
+    PrepareOpenRequest(paths[i], flags, mode, 0, &requests[i]);
+  }
+
+  ExecuteBatch<openRequest>(
+      requests,
+      items,
+      boost::bind(&xtreemfs::pbrpc::MRCServiceClient::open_sync,
+                  mrc_service_client_.get(),
+                  _1,
+                  boost::cref(auth_bogus_),
+                  boost::cref(user_credentials),
+                  _2),
+      boost::bind(&VolumeImplementation::CompleteBatchOpen,
+                  this,
+                  &user_credentials,
+                  &paths,
+                  flags,
+                  mode,
+                  file_handles,
+                  _1,
+                  _2,
+                  _3),
+      errors);
+}
+
+void VolumeImplementation::CompleteBatchOpen(
+    const xtreemfs::pbrpc::UserCredentials* user_credentials,
+    const std::vector<std::string>* paths,
+    const xtreemfs::pbrpc::SYSTEM_V_FCNTL flags,
+    uint32_t mode,
+    std::vector<FileHandle*>* file_handles,
+    size_t i,
+    rpc::SyncCallbackBase* response,
+    bool was_sent) {
+  if (response == NULL) {
+    try {
+      (*file_handles)[i] =
+          OpenFile(*user_credentials, (*paths)[i], flags, mode);
+    } catch (const PosixErrorException& e) {
+      if (!was_sent || e.posix_errno() != POSIX_ERROR_EEXIST) {
+        throw;
+      }
+      // The sent request may have created the file before it failed, e.g.
+      // with a timeout.
+      (*file_handles)[i] = OpenFile(
+          *user_credentials,
+          (*paths)[i],
+          static_cast<SYSTEM_V_FCNTL>(flags & ~SYSTEM_V_FCNTL_H_O_EXCL),
+          mode);
+    }
+    return;
+  }
+
+  (*file_handles)[i] = ProcessOpenResponse(
+      *user_credentials,
+      (*paths)[i],
+      flags,
+      0,
+      *static_cast<openResponse*>(response->response()));
+}
+
+void VolumeImplementation::UnlinkFiles(
+    const xtreemfs::pbrpc::UserCredentials& user_credentials,
+    const std::vector<std::string>& paths,
+    std::vector<xtreemfs::pbrpc::POSIXErrno>* errors) {
+  errors->assign(paths.size(), POSIX_ERROR_NONE);
+
+  vector<size_t> items(paths.size());
+  vector<unlinkRequest> requests(paths.size());
+  for (size_t i = 0; i < paths.size(); i++) {
+    items[i] = i;
+    requests[i].set_volume_name(volume_name_);
+    requests[i].set_path(paths[i]);
+  }
+
+  ExecuteBatch<unlinkRequest>(
+      requests,
+      items,
+      boost::bind(&xtreemfs::pbrpc::MRCServiceClient::unlink_sync,
+                  mrc_service_client_.get(),
+                  _1,
+                  boost::cref(auth_bogus_),
+                  boost::cref(user_credentials),
+                  _2),
+      boost::bind(&VolumeImplementation::CompleteBatchUnlink,
+                  this,
+                  &user_credentials,
+                  &paths,
+                  _1,
+                  _2,
+                  _3),
+      errors);
+}
+
+void VolumeImplementation::CompleteBatchUnlink(
+    const xtreemfs::pbrpc::UserCredentials* user_credentials,
+    const std::vector<std::string>* paths,
+    size_t i,
+    rpc::SyncCallbackBase* response,
+    bool was_sent) {
+  if (response == NULL) {
+    try {
+      Unlink(*user_credentials, (*paths)[i]);
+    } catch (const PosixErrorException& e) {
+      if (!was_sent || e.posix_errno() != POSIX_ERROR_ENOENT) {
+        throw;
+      }
+      // The sent request may have removed the file before it failed, e.g.
+      // with a timeout. Its response did not update the caches.
+      const string& path = (*paths)[i];
+      const string parent_dir = ResolveParentDirectory(path);
+      metadata_cache_.Invalidate(path);
+      metadata_cache_.InvalidateStat(parent_dir);
+      metadata_cache_.InvalidateDirEntry(parent_dir, GetBasename(path));
+    }
+    return;
+  }
+
+  ProcessUnlinkResponse((*paths)[i],
+                        *static_cast<unlinkResponse*>(response->response()));
+}
+
+void VolumeImplementation::MakeDirectories(
+    const xtreemfs::pbrpc::UserCredentials& user_credentials,
+    const std::vector<std::string>& paths,
+    unsigned int mode,
+    std::vector<xtreemfs::pbrpc::POSIXErrno>* errors) {
+  errors->assign(paths.size(), POSIX_ERROR_NONE);
+
+  vector<size_t> items(paths.size());
+  vector<mkdirRequest> requests(paths.size());
+  for (size_t i = 0; i < paths.size(); i++) {
+    items[i] = i;
+    requests[i].set_volume_name(volume_name_);
+    requests[i].set_path(paths[i]);
+    requests[i].set_mode(mode);
+  }
+
+  ExecuteBatch<mkdirRequest>(
+      requests,
+      items,
+      boost::bind(&xtreemfs::pbrpc::MRCServiceClient::mkdir_sync,
+                  mrc_service_client_.get(),
+                  _1,
+                  boost::cref(auth_bogus_),
+                  boost::cref(user_credentials),
+                  _2),
+      boost::bind(&VolumeImplementation::CompleteBatchMakeDirectory,
+                  this,
+                  &user_credentials,
+                  &paths,
+                  mode,
+                  _1,
+                  _2,
+                  _3),
+      errors);
+}
+
+void VolumeImplementation::CompleteBatchMakeDirectory(
+    const xtreemfs::pbrpc::UserCredentials* user_credentials,
+    const std::vector<std::string>* paths,
+    unsigned int mode,
+    size_t i,
+    rpc::SyncCallbackBase* response,
+    bool was_sent) {
+  if (response == NULL) {
+    try {
+      MakeDirectory(*user_credentials, (*paths)[i], mode);
+    } catch (const PosixErrorException& e) {
+      if (!was_sent || e.posix_errno() != POSIX_ERROR_EEXIST) {
+        throw;
+      }
+      // The sent request may have created the directory before it failed,
+      // e.g. with a timeout. Its response did not update the caches.
+      const string parent_dir = ResolveParentDirectory((*paths)[i]);
+      metadata_cache_.InvalidateStat(parent_dir);
+      metadata_cache_.InvalidateDirEntries(parent_dir);
+    }
+    return;
+  }
+
+  ProcessMakeDirectoryResponse(
+      (*paths)[i], *static_cast<timestampResponse*>(response->response()));
+}
+
 /**
  * Larger readdir requests are split up into chunks of size "volume_options_.
  * readdir_chunk_size". Avoid to exceed this limit when specifying "count" -
@@ -946,6 +1571,8 @@ xtreemfs::pbrpc::DirectoryEntries* VolumeImplementation::ReadDir(
     uint64_t offset,
     uint32_t count,
     bool names_only) {
+  ScopedLatencyRecorder latency(
+      LatencyStatistics::GetHistogram(LatencyStatistics::kReadDir));
   DirectoryEntries* result = NULL;
 
   if (count == 0) {
@@ -1068,6 +1695,8 @@ xtreemfs::pbrpc::listxattrResponse* VolumeImplementation::ListXAttrs(
     const xtreemfs::pbrpc::UserCredentials& user_credentials,
     const std::string& path,
     bool use_cache) {
+  ScopedLatencyRecorder latency(
+      LatencyStatistics::GetHistogram(LatencyStatistics::kListXAttr));
   xtreemfs::pbrpc::listxattrResponse* result;
 
   // Check if the information was cached.
@@ -1113,6 +1742,8 @@ void VolumeImplementation::SetXAttr(
     const std::string& name,
     const std::string& value,
     xtreemfs::pbrpc::XATTR_FLAGS flags) {
+  ScopedLatencyRecorder latency(
+      LatencyStatistics::GetHistogram(LatencyStatistics::kSetXAttr));
   setxattrRequest rq;
   rq.set_volume_name(volume_name_);
   rq.set_path(path);
@@ -1145,6 +1776,8 @@ bool VolumeImplementation::GetXAttr(
     const std::string& path,
     const std::string& name,
     std::string* value) {
+  ScopedLatencyRecorder latency(
+      LatencyStatistics::GetHistogram(LatencyStatistics::kGetXAttr));
   // Try to get it from cache first.
   bool xattrs_cached;
   bool xtreemfs_attribute_requested = (name.substr(0, 9) == "xtreemfs.");
@@ -1333,10 +1966,13 @@ void VolumeImplementation::AddReplica(
 
   // Update the local XLocSet cached at FileInfo if it exists.
   uint64_t file_id = ExtractFileIdFromGlobalFileId(global_file_id);
-  map<uint64_t, FileInfo*>::const_iterator it = open_file_table_.find(file_id);
-  if (it != open_file_table_.end()) {
-    // File has already been opened: refresh the xlocset.
-    it->second->UpdateXLocSetAndRest(new_xlocset);
+  {
+    boost::mutex::scoped_lock lock(open_file_table_.GetMutex(file_id));
+    FileInfo* file_info = open_file_table_.FindUnmutexed(file_id);
+    if (file_info) {
+      // File has already been opened: refresh the xlocset.
+      file_info->UpdateXLocSetAndRest(new_xlocset);
+    }
   }
 
   // Trigger the ronly replication at this point by reading at least one byte.
@@ -1482,10 +2118,13 @@ void VolumeImplementation::RemoveReplica(
 
   // Update the local XLocSet cached at FileInfo if it exists.
   uint64_t file_id = ExtractFileIdFromGlobalFileId(global_file_id);
-  map<uint64_t, FileInfo*>::const_iterator it = open_file_table_.find(file_id);
-  if (it != open_file_table_.end()) {
-    // File has already been opened: refresh the xlocset.
-    it->second->UpdateXLocSetAndRest(new_xlocset);
+  {
+    boost::mutex::scoped_lock lock(open_file_table_.GetMutex(file_id));
+    FileInfo* file_info = open_file_table_.FindUnmutexed(file_id);
+    if (file_info) {
+      // File has already been opened: refresh the xlocset.
+      file_info->UpdateXLocSetAndRest(new_xlocset);
+    }
   }
 
   // Cleanup.
@@ -1585,11 +2224,17 @@ void VolumeImplementation::SetReplicaUpdatePolicy(
   metadata_cache_.UpdateXAttr(path, "xtreemfs.set_repl_update_policy", policy);
 }
 
+void VolumeImplementation::GetQoSCounters(
+    std::map<std::string, QoSCounters>* counters) {
+  if (io_throttle_.get()) {
+    io_throttle_->GetCounters(counters);
+  }
+}
 
 /**
  * @remark Ownership is NOT transferred to the caller.
  *
- * @remark Assumes that open_file_table_mutex_ is already locked.
+ * @remark Assumes that the shard of file_id in open_file_table_ is locked.
  */
 FileInfo* VolumeImplementation::GetFileInfoOrCreateUnmutexed(
     uint64_t file_id,
@@ -1597,26 +2242,27 @@ FileInfo* VolumeImplementation::GetFileInfoOrCreateUnmutexed(
     bool replicate_on_close,
     const xtreemfs::pbrpc::XLocSet& xlocset) {
   // Check if the file is already open and a FileInfo object exists for it.
-  map<uint64_t, FileInfo*>::const_iterator it = open_file_table_.find(file_id);
-  if (it != open_file_table_.end()) {
+  FileInfo* file_info = open_file_table_.FindUnmutexed(file_id);
+  if (file_info) {
     // File has already been opened.
-    it->second->UpdateXLocSetAndRest(xlocset, replicate_on_close);
+    file_info->UpdateXLocSetAndRest(xlocset, replicate_on_close);
     if (Logging::log->loggingActive(LEVEL_DEBUG)) {
       Logging::log->getLog(LEVEL_DEBUG) << "GetFileInfoOrCreateUnmutexed: "
           << "Updated the FileInfo object with the file_id: "
           << file_id << endl;
     }
-    return it->second;
+    return file_info;
   } else {
     // File has not been opened yet, add it.
-    FileInfo* file_info(new FileInfo(client_,
-                                     this,
-                                     file_id,
-                                     path,
-                                     replicate_on_close,
-                                     xlocset,
-                                     client_uuid_));
-    open_file_table_[file_id] = file_info;
+    file_info = new FileInfo(client_,
+                             this,
+                             file_id,
+                             path,
+                             replicate_on_close,
+                             xlocset,
+                             client_uuid_);
+    open_file_table_.InsertUnmutexed(file_id, file_info);
+    ScheduleXCapRenewalUnmutexed(file_id, file_info);
     if (Logging::log->loggingActive(LEVEL_DEBUG)) {
       Logging::log->getLog(LEVEL_DEBUG) << "GetFileInfoOrCreateUnmutexed: "
           << "Created a new FileInfo object for the file_id: "
@@ -1629,86 +2275,124 @@ FileInfo* VolumeImplementation::GetFileInfoOrCreateUnmutexed(
 /**
  * @throws FileInfoNotFoundException
  *
- * @remark Assumes that open_file_table_mutex_ is already locked.
+ * @remark Assumes that the shard of file_id in open_file_table_ is locked.
  */
 void VolumeImplementation::RemoveFileInfoUnmutexed(
     uint64_t file_id, FileInfo* file_info) {
-  // Find the correct entry and delete it
-  std::map<uint64_t, FileInfo*>::iterator it;
-  it = open_file_table_.find(file_id);
+  FileInfo* found_file_info = open_file_table_.FindUnmutexed(file_id);
   // The entry has to be found or throw an exception.
-  if (it == open_file_table_.end()) {
+  if (found_file_info == NULL) {
     throw FileInfoNotFoundException(file_id);
   }
   // Lets be sure we speak about the same FileInfo object.
-  assert(it->second == file_info);
-  open_file_table_.erase(it);
+  assert(found_file_info == file_info);
+  open_file_table_.EraseUnmutexed(file_id);
+}
+
+void VolumeImplementation::ScheduleFileSizeUpdate(uint64_t file_id,
+                                                  FileInfo* file_info) {
+  file_task_queue_.Push(FileTaskQueue::Task(
+      FileTaskQueue::Now() + boost::posix_time::seconds(
+          volume_options_.periodic_file_size_updates_interval_s),
+      FileTaskQueue::kFileSizeUpdate,
+      file_id,
+      file_info));
+}
+
+void VolumeImplementation::ScheduleXCapRenewalUnmutexed(uint64_t file_id,
+                                                        FileInfo* file_info) {
+  boost::posix_time::ptime deadline = FileTaskQueue::Now()
+      + boost::posix_time::seconds(
+          volume_options_.periodic_xcap_renewal_interval_s);
+  file_info->set_xcap_renewal_deadline(deadline);
+  file_task_queue_.Push(FileTaskQueue::Task(deadline,
+                                            FileTaskQueue::kXCapRenewal,
+                                            file_id,
+                                            file_info));
 }
 
-void VolumeImplementation::PeriodicXCapRenewal() {
+void VolumeImplementation::ProcessFileTasks() {
+  vector<FileTaskQueue::Task> due_tasks;
   while (true) {
-    // Send thread to sleep (by default for 1 minute).
-    boost::posix_time::seconds interval(
-        volume_options_.periodic_xcap_renewal_interval_s);
-    boost::this_thread::sleep(interval);
+    file_task_queue_.WaitForDueTasks(&due_tasks);
 
-    {
-      boost::mutex::scoped_lock lock(open_file_table_mutex_);
+    if (Logging::log->loggingActive(LEVEL_DEBUG)) {
+      Logging::log->getLog(LEVEL_DEBUG)
+          << "Processing " << due_tasks.size() << " due XCap renewals and"
+             " file size updates." << endl;
+    }
 
-      if (Logging::log->loggingActive(LEVEL_DEBUG)) {
-        Logging::log->getLog(LEVEL_DEBUG)
-            << "START open_file_table: Periodic XCap renewal for "
-            << open_file_table_.size()
-            << " open files." << endl;
-      }
+    for (size_t i = 0; i < due_tasks.size(); i++) {
+      const FileTaskQueue::Task& task = due_tasks[i];
 
-      // Iterate over the open_file_table_.
-      map<uint64_t, FileInfo*>::iterator it;
-      for (it = open_file_table_.begin();
-           it != open_file_table_.end(); ++it) {
-        it->second->RenewXCapsAsync(periodic_threads_options_);
+      // Lock the shard of the file per task only to not delay concurrent
+      // opens and closes. All executed operations are asynchronous.
+      boost::mutex::scoped_lock lock(open_file_table_.GetMutex(task.file_id));
+      FileInfo* file_info = open_file_table_.FindUnmutexed(task.file_id);
+      if (file_info != task.file_info) {
+        // The file was closed meanwhile.
+        continue;
       }
 
-      if (Logging::log->loggingActive(LEVEL_DEBUG)) {
-        Logging::log->getLog(LEVEL_DEBUG)
-            << "END open_file_table: Periodic XCap renewal for "
-            << open_file_table_.size()
-            << " open files." << std::endl;
+      if (task.type == FileTaskQueue::kXCapRenewal) {
+        if (file_info->xcap_renewal_deadline() != task.deadline) {
+          // Outdated task of a previous FileInfo object at the same address.
+          continue;
+        }
+        file_info->RenewXCapsAsync(periodic_threads_options_);
+        ScheduleXCapRenewalUnmutexed(task.file_id, file_info);
+      } else {
+        file_info->WriteBackFileSizeAsync(periodic_threads_options_);
       }
     }
   }
 }
 
-void VolumeImplementation::PeriodicFileSizeUpdate() {
+void VolumeImplementation::ProcessDeferredCloses() {
   while (true) {
-    // Send thread to sleep.
-    boost::posix_time::seconds interval(
-        volume_options_.periodic_file_size_updates_interval_s);
-    boost::this_thread::sleep(interval);
-
+    list<DeferredClose> file_handles;
     {
-      boost::mutex::scoped_lock lock(open_file_table_mutex_);
+      boost::mutex::scoped_lock lock(deferred_closes_mutex_);
+      while (deferred_closes_.empty() && !stop_deferred_closes_) {
+        deferred_closes_changed_.wait(lock);
+      }
+      if (deferred_closes_.empty()) {
+        return;
+      }
+      file_handles.swap(deferred_closes_);
+    }
 
-      if (Logging::log->loggingActive(LEVEL_DEBUG)) {
-        Logging::log->getLog(LEVEL_DEBUG)
-            << "START open_file_table: Periodic filesize update for "
-            << open_file_table_.size()
-            << " open files." << std::endl;
+    // Send the file size updates of all files first to let their round trips
+    // to the MRC overlap.
+    for (list<DeferredClose>::iterator it = file_handles.begin();
+         it != file_handles.end();
+         ++it) {
+      try {
+        it->file_handle->StartDeferredClose(periodic_threads_options_);
+      } catch (const XtreemFSException&) {
+        // Ignore errors, FinishClose() retries the update.
       }
+    }
 
-      // Iterate over the open_file_table_.
-      map<uint64_t, FileInfo*>::iterator it;
-      for (it = open_file_table_.begin();
-           it != open_file_table_.end(); ++it) {
-        it->second->WriteBackFileSizeAsync(periodic_threads_options_);
+    for (list<DeferredClose>::iterator it = file_handles.begin();
+         it != file_handles.end();
+         ++it) {
+      string error;
+      try {
+        it->file_handle->FinishClose();
+      } catch (const XtreemFSException& e) {
+        error = "Write-behind close of file: " + it->path + " failed: "
+            + e.what();
+        Logging::log->getLog(LEVEL_ERROR) << error << endl;
+        ErrorLog::error_log->AppendError(error);
       }
 
-      if (Logging::log->loggingActive(LEVEL_DEBUG)) {
-        Logging::log->getLog(LEVEL_DEBUG)
-            << "END open_file_table: Periodic filesize update for "
-            << open_file_table_.size()
-            << " open files." << std::endl;
+      boost::mutex::scoped_lock lock(deferred_closes_mutex_);
+      if (!error.empty()) {
+        deferred_close_errors_[it->file_id] = error;
       }
+      pending_deferred_closes_--;
+      deferred_closes_changed_.notify_all();
     }
   }
 }
@@ -0,0 +1,380 @@
+/*
+ * Copyright (c) 2026 by the XtreemFS Authors, see AUTHORS file
+ *
+ * Licensed under the BSD License, see LICENSE file for details.
+ *
+ */
+
+#include "libxtreemfs/warm_start_snapshot.h"
+
+#include <stdint.h>
+#ifndef WIN32
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+#endif  // !WIN32
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "libxtreemfs/metadata_cache.h"
+#include "libxtreemfs/metadata_cache_entry.h"
+#include "libxtreemfs/uuid_cache.h"
+#include "libxtreemfs/xtreemfs_exception.h"
+#include "util/logging.h"
+#include "xtreemfs/GlobalTypes.pb.h"
+#include "xtreemfs/MRC.pb.h"
+
+using namespace std;
+using namespace xtreemfs::pbrpc;
+using namespace xtreemfs::util;
+
+/** Format of a snapshot file.
+ * \file
+ *
+ * All integers are stored in little endian byte order. Strings and serialized
+ * Protocol Buffers messages are prefixed by their length (fixed32).
+ *
+ * - magic (8 bytes), format version (fixed32)
+ * - number of UUID mappings (fixed32), each:
+ *   uuid, address, port (fixed32), absolute timeout in s (fixed64)
+ * - Vivaldi coordinates present (1 byte), serialized VivaldiCoordinates
+ * - number of metadata cache entries (fixed64), each: path and
+ *   for stat, dir entries and xattrs: absolute timeout in s (fixed64, 0 if
+ *   absent) followed by the serialized message if present
+ * - magic (8 bytes) to detect truncated files
+ */
+
+namespace xtreemfs {
+
+namespace {
+
+const char kSnapshotMagic[8] = { 'X', 'T', 'F', 'S', 'W', 'A', 'R', 'M' };
+
+const uint32_t kSnapshotVersion = 1;
+
+/** Strings longer than this are treated as corruption. */
+const uint32_t kMaxStringLength = 256 * 1024 * 1024;
+
+class SnapshotWriter {
+ public:
+  explicit SnapshotWriter(ostream* stream) : stream_(stream) {}
+
+  void WriteFixed32(uint32_t value) {
+    char buffer[4];
+    for (int i = 0; i < 4; i++) {
+      buffer[i] = static_cast<char>((value >> (8 * i)) & 0xff);
+    }
+    stream_->write(buffer, sizeof(buffer));
+  }
+
+  void WriteFixed64(uint64_t value) {
+    WriteFixed32(static_cast<uint32_t>(value));
+    WriteFixed32(static_cast<uint32_t>(value >> 32));
+  }
+
+  void WriteString(const string& value) {
+    WriteFixed32(static_cast<uint32_t>(value.size()));
+    stream_->write(value.data(), value.size());
+  }
+
+  void WriteMessage(const google::protobuf::Message& message) {
+    string serialized;
+    message.SerializePartialToString(&serialized);
+    WriteString(serialized);
+  }
+
+ private:
+  ostream* stream_;
+};
+
+class SnapshotReader {
+ public:
+  SnapshotReader(istream* stream, const string& path)
+      : stream_(stream), path_(path) {}
+
+  void Read(char* buffer, size_t length) {
+    stream_->read(buffer, length);
+    if (static_cast<size_t>(stream_->gcount()) != length) {
+      throw XtreemFSException("The warm start snapshot " + path_
+          + " is truncated.");
+    }
+  }
+
+  uint32_t ReadFixed32() {
+    unsigned char buffer[4];
+    Read(reinterpret_cast<char*>(buffer), sizeof(buffer));
+    uint32_t value = 0;
+    for (int i = 3; i >= 0; i--) {
+      value = (value << 8) | buffer[i];
+    }
+    return value;
+  }
+
+  uint64_t ReadFixed64() {
+    uint64_t low = ReadFixed32();
+    uint64_t high = ReadFixed32();
+    return (high << 32) | low;
+  }
+
+  string ReadString() {
+    uint32_t length = ReadFixed32();
+    if (length > kMaxStringLength) {
+      throw XtreemFSException("The warm start snapshot " + path_
+          + " is corrupted.");
+    }
+    string value(length, '\0');
+    if (length > 0) {
+      Read(&value[0], length);
+    }
+    return value;
+  }
+
+  void ReadMessage(google::protobuf::Message* message) {
+    if (!message->ParsePartialFromString(ReadString())) {
+      throw XtreemFSException("The warm start snapshot " + path_
+          + " contains an invalid message of type "
+          + message->GetTypeName() + ".");
+    }
+  }
+
+  void ReadMagic() {
+    char magic[sizeof(kSnapshotMagic)];
+    Read(magic, sizeof(magic));
+    if (memcmp(magic, kSnapshotMagic, sizeof(kSnapshotMagic)) != 0) {
+      throw XtreemFSException("The file " + path_
+          + " is not a warm start snapshot.");
+    }
+  }
+
+ private:
+  istream* stream_;
+  const string& path_;
+};
+
+/** Frees the entries which were not passed to the metadata cache. */
+class MetadataCacheEntries {
+ public:
+  ~MetadataCacheEntries() {
+    for (size_t i = 0; i < entries.size(); i++) {
+      delete entries[i];
+    }
+  }
+
+  vector<MetadataCacheEntry*> entries;
+};
+
+template<class T>
+void WriteTimedMessage(SnapshotWriter* writer,
+                       const T* message,
+                       uint64_t timeout_s) {
+  if (message == NULL) {
+    writer->WriteFixed64(0);
+  } else {
+    writer->WriteFixed64(timeout_s);
+    writer->WriteMessage(*message);
+  }
+}
+
+template<class T>
+void ReadTimedMessage(SnapshotReader* reader,
+                      T** message,
+                      uint64_t* timeout_s) {
+  *timeout_s = reader->ReadFixed64();
+  if (*timeout_s != 0) {
+    *message = new T();
+    reader->ReadMessage(*message);
+  }
+}
+
+/** Writes "data" to the new file "path", which only the user may read, and
+ *  flushes it to the disk. Returns false on errors. */
+bool WriteFileToDisk(const string& path, const string& data) {
+#ifdef WIN32
+  ofstream stream(path.c_str(), ios_base::binary | ios_base::trunc);
+  stream.write(data.data(), data.size());
+  stream.close();
+  return !stream.fail();
+#else
+  // A leftover of an earlier attempt keeps its permissions with O_TRUNC.
+  unlink(path.c_str());
+  int fd = open(path.c_str(), O_CREAT | O_TRUNC | O_WRONLY, 0600);
+  if (fd == -1) {
+    return false;
+  }
+  size_t written = 0;
+  while (written < data.size()) {
+    ssize_t result = write(fd, data.data() + written, data.size() - written);
+    if (result == -1) {
+      if (errno == EINTR) {
+        continue;
+      }
+      close(fd);
+      return false;
+    }
+    written += result;
+  }
+  // Otherwise, the renamed snapshot may be empty after a crash.
+  if (fsync(fd) != 0) {
+    close(fd);
+    return false;
+  }
+  return close(fd) == 0;
+#endif  // WIN32
+}
+
+}  // namespace
+
+std::string GetWarmStartSnapshotPath(const std::string& directory,
+                                     const std::string& volume_name) {
+  string file_name = volume_name;
+  for (size_t i = 0; i < file_name.size(); i++) {
+    if (file_name[i] == '/' || file_name[i] == '\\') {
+      file_name[i] = '_';
+    }
+  }
+  string path = directory;
+  if (!path.empty() && path[path.size() - 1] != '/') {
+    path += "/";
+  }
+  return path + file_name + ".snapshot";
+}
+
+void SaveWarmStartSnapshot(
+    const std::string& path,
+    UUIDCache* uuid_cache,
+    const pbrpc::VivaldiCoordinates* vivaldi_coordinates,
+    MetadataCache* metadata_cache) {
+  vector<UUIDCache::UUIDMapping> mappings;
+  uuid_cache->GetMappings(&mappings);
+  MetadataCacheEntries metadata;
+  metadata_cache->GetUnexpiredEntries(&metadata.entries);
+
+  // The snapshot contains paths, attributes and extended attributes, so it
+  // is created with restrictive permissions instead of through a stream.
+  ostringstream stream;
+  SnapshotWriter writer(&stream);
+  stream.write(kSnapshotMagic, sizeof(kSnapshotMagic));
+  writer.WriteFixed32(kSnapshotVersion);
+
+  writer.WriteFixed32(static_cast<uint32_t>(mappings.size()));
+  for (size_t i = 0; i < mappings.size(); i++) {
+    writer.WriteString(mappings[i].uuid);
+    writer.WriteString(mappings[i].address);
+    writer.WriteFixed32(mappings[i].port);
+    writer.WriteFixed64(static_cast<uint64_t>(mappings[i].timeout));
+  }
+
+  if (vivaldi_coordinates != NULL && vivaldi_coordinates->IsInitialized()) {
+    stream.put(1);
+    writer.WriteMessage(*vivaldi_coordinates);
+  } else {
+    stream.put(0);
+  }
+
+  writer.WriteFixed64(metadata.entries.size());
+  for (size_t i = 0; i < metadata.entries.size(); i++) {
+    const MetadataCacheEntry& entry = *metadata.entries[i];
+    writer.WriteString(entry.path);
+    WriteTimedMessage(&writer, entry.stat, entry.stat_timeout_s);
+    WriteTimedMessage(&writer, entry.dir_entries, entry.dir_entries_timeout_s);
+    WriteTimedMessage(&writer, entry.xattrs, entry.xattrs_timeout_s);
+  }
+  stream.write(kSnapshotMagic, sizeof(kSnapshotMagic));
+
+  const string temporary_path = path + ".tmp";
+  if (!WriteFileToDisk(temporary_path, stream.str())) {
+    remove(temporary_path.c_str());
+    throw XtreemFSException("Failed to write the warm start snapshot "
+        + temporary_path + ".");
+  }
+#ifdef WIN32
+  // rename() does not replace existing files on Windows.
+  remove(path.c_str());
+#endif  // WIN32
+  if (rename(temporary_path.c_str(), path.c_str()) != 0) {
+    remove(temporary_path.c_str());
+    throw XtreemFSException("Failed to replace the warm start snapshot "
+        + path + ".");
+  }
+
+  if (Logging::log->loggingActive(LEVEL_DEBUG)) {
+    Logging::log->getLog(LEVEL_DEBUG) << "Wrote warm start snapshot " << path
+        << " with " << mappings.size() << " UUID mappings and "
+        << metadata.entries.size() << " metadata cache entries." << endl;
+  }
+}
+
+bool LoadWarmStartSnapshot(const std::string& path,
+                           UUIDCache* uuid_cache,
+                           pbrpc::VivaldiCoordinates* vivaldi_coordinates,
+                           MetadataCache* metadata_cache) {
+  ifstream stream(path.c_str(), ios_base::binary);
+  if (!stream.is_open()) {
+    return false;
+  }
+
+  SnapshotReader reader(&stream, path);
+  reader.ReadMagic();
+  uint32_t version = reader.ReadFixed32();
+  if (version != kSnapshotVersion) {
+    throw XtreemFSException("The warm start snapshot " + path
+        + " has an unsupported format version.");
+  }
+
+  vector<UUIDCache::UUIDMapping> mappings;
+  uint32_t mapping_count = reader.ReadFixed32();
+  for (uint32_t i = 0; i < mapping_count; i++) {
+    UUIDCache::UUIDMapping mapping;
+    mapping.uuid = reader.ReadString();
+    mapping.address = reader.ReadString();
+    mapping.port = reader.ReadFixed32();
+    mapping.timeout = static_cast<time_t>(reader.ReadFixed64());
+    mappings.push_back(mapping);
+  }
+
+  char has_vivaldi_coordinates = 0;
+  reader.Read(&has_vivaldi_coordinates, 1);
+  vivaldi_coordinates->Clear();
+  if (has_vivaldi_coordinates) {
+    reader.ReadMessage(vivaldi_coordinates);
+  }
+
+  MetadataCacheEntries metadata;
+  uint64_t entries = reader.ReadFixed64();
+  for (uint64_t i = 0; i < entries; i++) {
+    MetadataCacheEntry* entry = new MetadataCacheEntry();
+    metadata.entries.push_back(entry);
+    entry->path = reader.ReadString();
+    ReadTimedMessage(&reader, &entry->stat, &entry->stat_timeout_s);
+    ReadTimedMessage(&reader,
+                     &entry->dir_entries,
+                     &entry->dir_entries_timeout_s);
+    ReadTimedMessage(&reader, &entry->xattrs, &entry->xattrs_timeout_s);
+  }
+  reader.ReadMagic();
+
+  // The snapshot is complete, restore the entries.
+  for (size_t i = 0; i < mappings.size(); i++) {
+    uuid_cache->Restore(mappings[i]);
+  }
+  for (size_t i = 0; i < metadata.entries.size(); i++) {
+    metadata_cache->Restore(metadata.entries[i]);
+  }
+  metadata.entries.clear();
+
+  if (Logging::log->loggingActive(LEVEL_DEBUG)) {
+    Logging::log->getLog(LEVEL_DEBUG) << "Read warm start snapshot " << path
+        << " with " << mappings.size() << " UUID mappings and "
+        << entries << " metadata cache entries." << endl;
+  }
+  return true;
+}
+
+}  // namespace xtreemfs
@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2026 by the XtreemFS Authors, see AUTHORS file
+ *
+ * Licensed under the BSD License, see LICENSE file for details.
+ *
+ */
+
+#include "libxtreemfs/write_window_controller.h"
+
+#include <algorithm>
+#include <cassert>
+#include <string>
+
+#include "libxtreemfs/options.h"
+#include "util/logging.h"
+
+using namespace std;
+using namespace xtreemfs::util;
+
+namespace xtreemfs {
+
+WriteWindowController::WriteWindowController(const Options& options)
+    : initial_window_(options.async_writes_max_requests),
+      max_window_(max(options.async_writes_max_requests,
+                      options.async_writes_adaptive_max_requests)) {
+  assert(initial_window_ >= 1);
+}
+
+WriteWindowController::WriteWindowController(int initial_window,
+                                             int max_window)
+    : initial_window_(initial_window),
+      max_window_(max(initial_window, max_window)) {
+  assert(initial_window_ >= 1);
+}
+
+int WriteWindowController::GetWindow(const std::string& osd_uuid) {
+  boost::mutex::scoped_lock lock(mutex_);
+
+  map<string, OSDWindow>::const_iterator it = windows_.find(osd_uuid);
+  return it == windows_.end() ? initial_window_ : it->second.window;
+}
+
+void WriteWindowController::Acquire(const std::string& osd_uuid) {
+  boost::mutex::scoped_lock lock(mutex_);
+  OSDWindow& osd_window = GetOSDWindowUnmutexed(osd_uuid);
+
+  // wait() is an interruption point.
+  while (osd_window.in_flight >= osd_window.window) {
+    window_available_.wait(lock);
+  }
+  osd_window.in_flight++;
+}
+
+void WriteWindowController::Release(const std::string& osd_uuid) {
+  boost::mutex::scoped_lock lock(mutex_);
+  OSDWindow& osd_window = GetOSDWindowUnmutexed(osd_uuid);
+  assert(osd_window.in_flight > 0);
+
+  osd_window.in_flight--;
+  window_available_.notify_all();
+}
+
+void WriteWindowController::ReportSuccess(const std::string& osd_uuid,
+                                          uint64_t latency_us) {
+  boost::mutex::scoped_lock lock(mutex_);
+  OSDWindow& osd_window = GetOSDWindowUnmutexed(osd_uuid);
+
+  // The lowest latency is tracked per period of samples and the previous
+  // period is remembered, i.e. a minimum is forgotten after two periods. A
+  // higher base latency, e.g. after a route change, shrinks the window only
+  // until it is learned.
+  if (osd_window.latency_samples >= kLatencySamplesPerPeriod) {
+    osd_window.previous_min_latency_us = osd_window.min_latency_us;
+    osd_window.min_latency_us = 0;
+    osd_window.latency_samples = 0;
+  }
+  osd_window.latency_samples++;
+  if (osd_window.min_latency_us == 0 ||
+      latency_us < osd_window.min_latency_us) {
+    osd_window.min_latency_us = latency_us;
+  }
+  uint64_t base_latency_us = osd_window.min_latency_us;
+  if (osd_window.previous_min_latency_us != 0 &&
+      osd_window.previous_min_latency_us < base_latency_us) {
+    base_latency_us = osd_window.previous_min_latency_us;
+  }
+
+  if (latency_us > kLatencyThresholdFactor * base_latency_us) {
+    // Requests are queued up at the OSD. Back off, but only once per window
+    // to not react to the same congestion multiple times.
+    if (osd_window.acked_requests >= osd_window.window) {
+      DecreaseUnmutexed(osd_uuid, &osd_window);
+    } else {
+      osd_window.acked_requests++;
+    }
+    return;
+  }
+
+  if (++osd_window.acked_requests >= osd_window.window &&
+      osd_window.window < max_window_) {
+    osd_window.window++;
+    osd_window.acked_requests = 0;
+    window_available_.notify_all();
+
+    if (Logging::log->loggingActive(LEVEL_DEBUG)) {
+      Logging::log->getLog(LEVEL_DEBUG) << "Increased the async write window"
+          " of the OSD " << osd_uuid << " to: " << osd_window.window << endl;
+    }
+  }
+}
+
+void WriteWindowController::ReportFailure(const std::string& osd_uuid) {
+  boost::mutex::scoped_lock lock(mutex_);
+  DecreaseUnmutexed(osd_uuid, &GetOSDWindowUnmutexed(osd_uuid));
+}
+
+void WriteWindowController::GetWindows(
+    std::map<std::string, AsyncWriteWindow>* windows) {
+  assert(windows);
+  boost::mutex::scoped_lock lock(mutex_);
+
+  for (map<string, OSDWindow>::const_iterator it = windows_.begin();
+       it != windows_.end();
+       ++it) {
+    AsyncWriteWindow& window = (*windows)[it->first];
+    window.window = it->second.window;
+    window.in_flight = it->second.in_flight;
+  }
+}
+
+WriteWindowController::OSDWindow& WriteWindowController::GetOSDWindowUnmutexed(
+    const std::string& osd_uuid) {
+  map<string, OSDWindow>::iterator it = windows_.find(osd_uuid);
+  if (it == windows_.end()) {
+    it = windows_.insert(make_pair(osd_uuid, OSDWindow(initial_window_))).first;
+  }
+  return it->second;
+}
+
+void WriteWindowController::DecreaseUnmutexed(const std::string& osd_uuid,
+                                              OSDWindow* osd_window) {
+  osd_window->window = max(1, osd_window->window / 2);
+  osd_window->acked_requests = 0;
+
+  if (Logging::log->loggingActive(LEVEL_DEBUG)) {
+    Logging::log->getLog(LEVEL_DEBUG) << "Decreased the async write window"
+        " of the OSD " << osd_uuid << " to: " << osd_window->window << endl;
+  }
+}
+
+}  // namespace xtreemfs
@@ -21,7 +21,10 @@
 #include <set>
 #include <string>
 
+#include "rpc/kernel_tls.h"
+#include "rpc/ssl_session_cache.h"
 #include "util/logging.h"
+#include "xtreemfs/OSDServiceConstants.h"
 
 #ifdef HAS_OPENSSL
 #include <boost/asio/ssl.hpp>
@@ -66,6 +69,7 @@ Client::Client(int32_t connect_timeout_s,
       stopped_(false),
       stopped_ioservice_only_(false),
       callid_counter_(1),
+      request_header_cache_(RequestHeaderCache::kDefaultMaxEntries),
       rq_timeout_timer_(service_),
       rq_timeout_s_(request_timeout_s),
       connect_timeout_s_(connect_timeout_s),
@@ -81,7 +85,9 @@ Client::Client(int32_t connect_timeout_s,
       pemFileName(NULL),
       certFileName(NULL),
       trustedCAsFileName(NULL),
-      ssl_context_(NULL) {
+      ssl_context_(NULL),
+      ssl_session_cache_(NULL),
+      use_kernel_tls_(false) {
   // Check if ssl options were passed.
   if (options != NULL) {
     if (Logging::log->loggingActive(LEVEL_INFO)) {
@@ -306,6 +312,25 @@ Client::Client(int32_t connect_timeout_s,
       }
     }
 
+#if (BOOST_VERSION < 104700)
+    SSL_CTX* native_context = ssl_context_->impl();
+#else  // BOOST_VERSION < 104700
+    SSL_CTX* native_context = ssl_context_->native_handle();
+#endif  // BOOST_VERSION < 104700
+    // Resume the sessions of reconnects to avoid full handshakes.
+    ssl_session_cache_ = new SSLSessionCache(native_context);
+
+    // Grid SSL does not encrypt the data after the handshake.
+    if (options->use_kernel_tls() && !use_gridssl_) {
+      if (KernelTLSSupported()) {
+        use_kernel_tls_ = true;
+        EnableTLSSecretRecording(native_context);
+      } else {
+        Logging::log->getLog(LEVEL_WARN) << "Kernel TLS is not supported by"
+            " this build, all data is encrypted by OpenSSL." << endl;
+      }
+    }
+
     // Cleanup thread-local OpenSSL state.
     ERR_free_strings();
 #if (OPENSSL_VERSION_NUMBER < 0x1000000fL)
@@ -403,6 +428,87 @@ void Client::sendRequest(const string& address,
                          Message* response_message,
                          void* context,
                          ClientRequestCallbackInterface *callback) {
+  sendRequest(address,
+              interface_id,
+              proc_id,
+              userCreds,
+              auth,
+              message,
+              data,
+              data_length,
+              response_message,
+              context,
+              callback,
+              DefaultPriority(interface_id, proc_id));
+}
+
+void Client::sendRequest(const string& address,
+                         int32_t interface_id,
+                         int32_t proc_id,
+                         const UserCredentials& userCreds,
+                         const Auth& auth,
+                         const Message* message,
+                         const char* data,
+                         int data_length,
+                         Message* response_message,
+                         void* context,
+                         ClientRequestCallbackInterface *callback,
+                         RequestPriority priority) {
+  EnqueueRequest(address,
+                 interface_id,
+                 proc_id,
+                 userCreds,
+                 auth,
+                 NULL,
+                 message,
+                 data,
+                 data_length,
+                 response_message,
+                 context,
+                 callback,
+                 priority);
+}
+
+void Client::sendRequest(const string& address,
+                         int32_t interface_id,
+                         int32_t proc_id,
+                         const UserCredentials& userCreds,
+                         const Auth& auth,
+                         const string& message_prefix,
+                         const Message* message,
+                         const char* data,
+                         int data_length,
+                         Message* response_message,
+                         void* context,
+                         ClientRequestCallbackInterface *callback) {
+  EnqueueRequest(address,
+                 interface_id,
+                 proc_id,
+                 userCreds,
+                 auth,
+                 &message_prefix,
+                 message,
+                 data,
+                 data_length,
+                 response_message,
+                 context,
+                 callback,
+                 DefaultPriority(interface_id, proc_id));
+}
+
+void Client::EnqueueRequest(const string& address,
+                            int32_t interface_id,
+                            int32_t proc_id,
+                            const UserCredentials& userCreds,
+                            const Auth& auth,
+                            const string* message_prefix,
+                            const Message* message,
+                            const char* data,
+                            int data_length,
+                            Message* response_message,
+                            void* context,
+                            ClientRequestCallbackInterface *callback,
+                            RequestPriority priority) {
   uint32_t call_id = atomic_inc32(&callid_counter_);
   ClientRequest* request = new ClientRequest(address,
                                         call_id,
@@ -415,7 +521,10 @@ void Client::sendRequest(const string& address,
                                         data_length,
                                         response_message,
                                         context,
-                                        callback);
+                                        callback,
+                                        &request_header_cache_,
+                                        message_prefix);
+  request->set_priority(priority);
 
   boost::mutex::scoped_lock lock(requests_mutex_);
   if (stopped_) {
@@ -432,6 +541,28 @@ void Client::sendRequest(const string& address,
   }
 }
 
+RequestPriority Client::DefaultPriority(int32_t interface_id,
+                                        int32_t proc_id) {
+  if (static_cast<uint32_t>(interface_id) != INTERFACE_ID_OSD) {
+    return kPriorityMetadata;
+  }
+  switch (proc_id) {
+    // Truncates and lock releases must not overtake the writes which were
+    // issued before them.
+    case PROC_ID_READ:
+    case PROC_ID_WRITE:
+    case PROC_ID_TRUNCATE:
+    case PROC_ID_XTREEMFS_LOCK_RELEASE:
+      return kPriorityBulk;
+    case PROC_ID_XTREEMFS_PING:
+    case PROC_ID_XTREEMFS_LOCK_ACQUIRE:
+    case PROC_ID_XTREEMFS_LOCK_CHECK:
+      return kPriorityControl;
+    default:
+      return kPriorityMetadata;
+  }
+}
+
 void Client::sendInternalRequest() {
   if (stopped_ioservice_only_) {
     return;
@@ -474,24 +605,7 @@ void Client::sendInternalRequest() {
           std::string server = addr.substr(0, colonpos);
           std::string port = addr.substr(colonpos + 1);
 
-          con = new ClientConnection(server,
-                                     port,
-                                     service_,
-                                     &request_table_,
-                                     connect_timeout_s_,
-                                     connect_timeout_s_
-#ifdef HAS_OPENSSL
-                                     ,use_gridssl_,
-                                     ssl_context_
-#endif  // HAS_OPENSSL
-                                     );
-
-          if (Logging::log->loggingActive(LEVEL_DEBUG)) {
-            Logging::log->getLog(LEVEL_DEBUG) << "new connection for "
-                << addr << endl;
-          }
-
-          connections_[addr] = con;
+          con = CreateConnection(server, port);
           con->AddRequest(rq);
           con->DoProcess();
         } catch(std::out_of_range &exception) {
@@ -508,6 +622,84 @@ void Client::sendInternalRequest() {
   } while (true);
 }
 
+ClientConnection* Client::CreateConnection(const std::string& server,
+                                           const std::string& port) {
+  ClientConnection* con = new ClientConnection(server,
+                                               port,
+                                               service_,
+                                               &request_table_,
+                                               connect_timeout_s_,
+                                               connect_timeout_s_
+#ifdef HAS_OPENSSL
+                                               ,use_gridssl_,
+                                               ssl_context_,
+                                               ssl_session_cache_,
+                                               use_kernel_tls_
+#endif  // HAS_OPENSSL
+                                               );
+
+  if (Logging::log->loggingActive(LEVEL_DEBUG)) {
+    Logging::log->getLog(LEVEL_DEBUG) << "new connection for "
+        << server << ":" << port << endl;
+  }
+
+  connections_[server + ":" + port] = con;
+  return con;
+}
+
+void Client::Connect(const std::string& address) {
+  boost::mutex::scoped_lock lock(requests_mutex_);
+  if (!stopped_) {
+    service_.post(boost::bind(&Client::ConnectInternal, this, address));
+  }
+}
+
+void Client::ConnectInternal(const std::string& address) {
+  if (stopped_ioservice_only_) {
+    return;
+  }
+
+  connection_map::iterator iter = connections_.find(address);
+  if (iter != connections_.end()) {
+    // Connects again, if required, and postpones the linger timeout.
+    iter->second->DoProcess();
+    return;
+  }
+
+  size_t colonpos = address.find_last_of(":");
+  if (colonpos == string::npos) {
+    return;
+  }
+  CreateConnection(address.substr(0, colonpos),
+                   address.substr(colonpos + 1))->DoProcess();
+}
+
+void Client::GetConnectionCounts(size_t* connections, size_t* established) {
+  ConnectionCounts counts;
+  service_.post(boost::bind(&Client::CountConnections, this, &counts));
+
+  boost::mutex::scoped_lock lock(counts.mutex);
+  while (!counts.done) {
+    counts.done_condition.wait(lock);
+  }
+  *connections = counts.connections;
+  *established = counts.established;
+}
+
+void Client::CountConnections(ConnectionCounts* counts) {
+  boost::mutex::scoped_lock lock(counts->mutex);
+  counts->connections = connections_.size();
+  for (connection_map::const_iterator iter = connections_.begin();
+       iter != connections_.end();
+       ++iter) {
+    if (iter->second->IsConnected()) {
+      counts->established++;
+    }
+  }
+  counts->done = true;
+  counts->done_condition.notify_one();
+}
+
 void Client::handleTimeout(const boost::system::error_code& error) {
   // Do nothing when the timer was canceled.
   if (error == boost::asio::error::operation_aborted
@@ -834,6 +1026,7 @@ Client::~Client() {
   }
   delete ssl_options;
   delete ssl_context_;
+  delete ssl_session_cache_;
 #endif  // HAS_OPENSSL
 }
 
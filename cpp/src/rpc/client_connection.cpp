@@ -34,6 +34,15 @@ using namespace boost;
 using namespace google::protobuf;
 using namespace boost::asio::ip;
 
+namespace {
+
+/** Maximum number of control and metadata requests which are sent while bulk
+ *  requests are waiting. Keeps reads and writes flowing under a high load of
+ *  small requests. */
+const int kMaxPrioritizedSends = 4;
+
+}  // namespace
+
 ClientConnection::ClientConnection(
     const string& server_name,
     const string& port,
@@ -43,7 +52,9 @@ ClientConnection::ClientConnection(
     int32_t max_reconnect_interval_s
 #ifdef HAS_OPENSSL
     ,bool use_gridssl,
-    boost::asio::ssl::context* ssl_context
+    boost::asio::ssl::context* ssl_context,
+    SSLSessionCache* ssl_session_cache,
+    bool use_kernel_tls
 #endif  // HAS_OPENSSL
     )
     : receive_marker_(NULL),
@@ -52,6 +63,8 @@ ClientConnection::ClientConnection(
       receive_data_(NULL),
       connection_state_(IDLE),
       requests_(),
+      sending_priority_(kPriorityMetadata),
+      prioritized_sends_(0),
       current_request_(NULL),
       server_name_(server_name),
       server_port_(port),
@@ -65,10 +78,14 @@ ClientConnection::ClientConnection(
       max_reconnect_interval_s_(max_reconnect_interval_s),
       next_reconnect_at_(boost::posix_time::not_a_date_time),
       last_connect_was_at_(boost::posix_time::not_a_date_time),
-      reconnect_interval_s_(1)
+      reconnect_interval_s_(1),
+      latency_histogram_(LatencyStatistics::GetServerHistogram(
+          server_name + ":" + port))
 #ifdef HAS_OPENSSL
       ,use_gridssl_(use_gridssl),
-      ssl_context_(ssl_context)
+      ssl_context_(ssl_context),
+      ssl_session_cache_(ssl_session_cache),
+      use_kernel_tls_(use_kernel_tls)
 #endif  // HAS_OPENSSL
 {
   receive_marker_buffer_ = new char[RecordMarker::get_size()];
@@ -77,34 +94,39 @@ ClientConnection::ClientConnection(
 
 void ClientConnection::AddRequest(ClientRequest* request) {
   request->set_client_connection(this);
-  requests_.push(PendingRequest(request->call_id(), request));
+  requests_[request->priority()].push(
+      PendingRequest(request->call_id(), request));
   (*request_table_)[request->call_id()] = request;
 }
 
 void ClientConnection::SendError(POSIXErrno posix_errno,
                                  const string &error_message) {
-  if (!requests_.empty()) {
+  if (HasPendingRequests()) {
     RPCHeader::ErrorResponse err;
     err.set_error_type(IO_ERROR);
     err.set_posix_errno(posix_errno);
     err.set_error_message(error_message);
 
-    while (!requests_.empty()) {
-      uint32_t call_id = requests_.front().call_id;
-      request_map::iterator iter = request_table_->find(call_id);
-      if (iter != request_table_->end()) {
-        // ClientRequest still exists in request_table_, it's safe to access it.
-        ClientRequest *request = requests_.front().rq;
-        request->set_error(new RPCHeader::ErrorResponse(err));
-        request->ExecuteCallback();
-        request_table_->erase(call_id);
-
-        Logging::log->getLog(LEVEL_ERROR)
-            << "operation failed: call_id=" << call_id
-            << " errno=" << posix_errno
-            << " message=" << error_message << endl;
+    for (int priority = 0; priority < kNumberOfPriorities; priority++) {
+      queue<PendingRequest>& requests = requests_[priority];
+      while (!requests.empty()) {
+        uint32_t call_id = requests.front().call_id;
+        request_map::iterator iter = request_table_->find(call_id);
+        if (iter != request_table_->end()) {
+          // ClientRequest still exists in request_table_, it's safe to access
+          // it.
+          ClientRequest *request = requests.front().rq;
+          request->set_error(new RPCHeader::ErrorResponse(err));
+          request->ExecuteCallback();
+          request_table_->erase(call_id);
+
+          Logging::log->getLog(LEVEL_ERROR)
+              << "operation failed: call_id=" << call_id
+              << " errno=" << posix_errno
+              << " message=" << error_message << endl;
+        }
+        requests.pop();
       }
-      requests_.pop();
     }
   }
 }
@@ -161,9 +183,16 @@ void ClientConnection::CreateChannel() {
   if (ssl_context_ == NULL) {
     socket_ = new TCPSocketChannel(service_);
   } else if (use_gridssl_) {
-    socket_ = new GridSSLSocketChannel(service_, *ssl_context_);
+    socket_ = new GridSSLSocketChannel(service_,
+                                       *ssl_context_,
+                                       ssl_session_cache_,
+                                       GetServerAddress());
   } else {
-    socket_ = new SSLSocketChannel(service_, *ssl_context_);
+    socket_ = new SSLSocketChannel(service_,
+                                   *ssl_context_,
+                                   ssl_session_cache_,
+                                   GetServerAddress(),
+                                   use_kernel_tls_);
   }
 #endif  // !HAS_OPENSSL
 }
@@ -291,27 +320,66 @@ void ClientConnection::PostConnect(const boost::system::error_code& err,
           << (*endpoint_iterator).host_name() << ":"
           << (*endpoint_iterator).service_name() << endl;
 #ifdef HAS_OPENSSL
-      if (ssl_context_ != NULL) {
+      if (ssl_context_ != NULL && use_gridssl_) {
+        GridSSLSocketChannel* channel
+            = static_cast<GridSSLSocketChannel*>(socket_);
+        Logging::log->getLog(LEVEL_DEBUG) << "Using SSL/TLS version '"
+            << channel->ssl_tls_version() << "'"
+            << (channel->ssl_session_reused() ? ", resumed session" : "")
+            << "." << endl;
+      } else if (ssl_context_ != NULL) {
+        SSLSocketChannel* channel = static_cast<SSLSocketChannel*>(socket_);
         Logging::log->getLog(LEVEL_DEBUG) << "Using SSL/TLS version '"
-            << ((SSLSocketChannel*) socket_)->ssl_tls_version() << "'." << endl;
+            << channel->ssl_tls_version() << "'"
+            << (channel->ssl_session_reused() ? ", resumed session" : "")
+            << (channel->kernel_tls_active() ? ", kernel TLS" : "")
+            << "." << endl;
       }
 #endif  // HAS_OPENSSL
     }
 
     connection_state_ = IDLE;
-    if (!requests_.empty()) {
+    if (HasPendingRequests()) {
       SendRequest();
-      ReceiveRequest();
+    }
+    // Also wait for responses if the connection was established in advance
+    // (see Client::Connect()).
+    ReceiveRequest();
+  }
+}
+
+bool ClientConnection::HasPendingRequests() const {
+  for (int priority = 0; priority < kNumberOfPriorities; priority++) {
+    if (!requests_[priority].empty()) {
+      return true;
     }
   }
+  return false;
+}
+
+int ClientConnection::NextPriority() {
+  int priority = kPriorityControl;
+  while (requests_[priority].empty()) {
+    priority++;
+  }
+
+  if (priority == kPriorityBulk || requests_[kPriorityBulk].empty()) {
+    prioritized_sends_ = 0;
+  } else if (++prioritized_sends_ > kMaxPrioritizedSends) {
+    prioritized_sends_ = 0;
+    priority = kPriorityBulk;
+  }
+  return priority;
 }
 
 void ClientConnection::SendRequest() {
-  if (!requests_.empty()) {
+  if (HasPendingRequests()) {
     connection_state_ = ACTIVE;
 
-    uint32_t call_id = requests_.front().call_id;
-    ClientRequest* rq = requests_.front().rq;
+    sending_priority_ = NextPriority();
+    queue<PendingRequest>& requests = requests_[sending_priority_];
+    uint32_t call_id = requests.front().call_id;
+    ClientRequest* rq = requests.front().rq;
     assert(rq != NULL);
 
     // If the request is no longer present in request_table_, it was already
@@ -320,7 +388,7 @@ void ClientConnection::SendRequest() {
     request_map::iterator iter = request_table_->find(call_id);
     if (iter == request_table_->end()) {
       // ClientRequest was already deleted, stop here.
-      requests_.pop();
+      requests.pop();
       SendRequest();
     } else {
       // Process ClientRequest.
@@ -426,11 +494,11 @@ void ClientConnection::PostWrite(const boost::system::error_code& err,
                   + "': " + err.message());
   } else {
     // Pop sent request.
-    if (!requests_.empty()) {
-      requests_.pop();
+    if (!requests_[sending_priority_].empty()) {
+      requests_[sending_priority_].pop();
       connection_state_ = IDLE;
 
-      if (!requests_.empty()) {
+      if (HasPendingRequests()) {
         SendRequest();
       }
     }
@@ -586,6 +654,10 @@ void ClientConnection::PostReadMessage(const boost::system::error_code& err) {
       rq->set_resp_header(respHdr);
     }
 
+    if (latency_histogram_) {
+      latency_histogram_->RecordSince(rq->time_picked_up());
+    }
+
     // Remove from table and clean up buffers.
     request_table_->erase(call_id);
     DeleteInternalBuffers();
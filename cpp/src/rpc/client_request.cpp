@@ -8,12 +8,17 @@
 
 #include "rpc/client_request.h"
 
+#include <cstring>
+
+#include <boost/shared_ptr.hpp>
 #include <google/protobuf/message.h>
 #include <string>
 
 #include "pbrpc/RPC.pb.h"
 #include "rpc/client_request_callback_interface.h"
 #include "rpc/record_marker.h"
+#include "rpc/request_header_cache.h"
+#include "util/latency_histogram.h"
 #include "util/logging.h"
 
 namespace xtreemfs {
@@ -35,45 +40,76 @@ ClientRequest::ClientRequest(const string& address,
                              const int data_length,
                              Message* response_message,
                              void *context,
-                             ClientRequestCallbackInterface *callback)
+                             ClientRequestCallbackInterface *callback,
+                             RequestHeaderCache* header_cache,
+                             const string* message_prefix)
     : client_connection_(NULL),
       call_id_(call_id),
       interface_id_(interface_id),
       proc_id_(proc_id),
+      priority_(kPriorityMetadata),
       context_(context),
       callback_(callback),
       address_(address),
+      time_created_(LatencyHistogram::Now()),
       callback_executed_(false),
       error_(NULL),
       resp_header_(NULL),
       resp_message_(response_message),
       resp_data_(NULL),
       resp_data_len_(0) {
-  RPCHeader header = RPCHeader();
-  header.set_message_type(xtreemfs::pbrpc::RPC_REQUEST);
-  header.set_call_id(call_id);
-  header.mutable_request_header()->set_interface_id(interface_id);
-  header.mutable_request_header()->set_proc_id(proc_id);
-  header.mutable_request_header()->mutable_user_creds()->
-      MergeFrom(userCreds);
-  header.mutable_request_header()->mutable_auth_data()->MergeFrom(auth);
-
   assert(callback_ != NULL);
 
-  uint32_t msg_len =
-      (request_message == NULL) ? 0 : request_message->ByteSize();
-  this->request_marker_ = new RecordMarker(header.ByteSize(),
-      msg_len, data_length);
-  this->rq_hdr_msg_ = new char[RecordMarker::get_size()
-      + this->request_marker_->header_len()
-      + request_marker_->message_len()];
-  char *hdrPtr = this->rq_hdr_msg_ + RecordMarker::get_size();
-  char *msgPtr = hdrPtr + request_marker_->header_len();
-  request_marker_->serialize(rq_hdr_msg_);
-  header.SerializeToArray(hdrPtr, request_marker_->header_len());
-  if (msg_len > 0) {
-    request_message->SerializeToArray(msgPtr, request_marker_->message_len());
-    if (!request_message->IsInitialized()) {
+  const uint32_t prefix_len =
+      (message_prefix == NULL) ? 0 : message_prefix->size();
+  uint32_t msg_len = prefix_len +
+      ((request_message == NULL) ? 0 : request_message->ByteSize());
+
+  if (header_cache != NULL) {
+    boost::shared_ptr<const string> header_template
+        = header_cache->GetTemplate(userCreds, auth);
+    this->request_marker_ = new RecordMarker(header_template->size(),
+        msg_len, data_length);
+    this->rq_hdr_msg_ = new char[RecordMarker::get_size()
+        + this->request_marker_->header_len()
+        + request_marker_->message_len()];
+    char *hdrPtr = this->rq_hdr_msg_ + RecordMarker::get_size();
+    request_marker_->serialize(rq_hdr_msg_);
+    memcpy(hdrPtr, header_template->data(), header_template->size());
+    RequestHeaderCache::SetIds(call_id,
+                               interface_id,
+                               proc_id,
+                               hdrPtr,
+                               header_template->size());
+  } else {
+    RPCHeader header = RPCHeader();
+    header.set_message_type(xtreemfs::pbrpc::RPC_REQUEST);
+    header.set_call_id(call_id);
+    header.mutable_request_header()->set_interface_id(interface_id);
+    header.mutable_request_header()->set_proc_id(proc_id);
+    header.mutable_request_header()->mutable_user_creds()->
+        MergeFrom(userCreds);
+    header.mutable_request_header()->mutable_auth_data()->MergeFrom(auth);
+
+    this->request_marker_ = new RecordMarker(header.ByteSize(),
+        msg_len, data_length);
+    this->rq_hdr_msg_ = new char[RecordMarker::get_size()
+        + this->request_marker_->header_len()
+        + request_marker_->message_len()];
+    char *hdrPtr = this->rq_hdr_msg_ + RecordMarker::get_size();
+    request_marker_->serialize(rq_hdr_msg_);
+    header.SerializeToArray(hdrPtr, request_marker_->header_len());
+  }
+  char *msgPtr = this->rq_hdr_msg_ + RecordMarker::get_size()
+      + request_marker_->header_len();
+  if (prefix_len > 0) {
+    memcpy(msgPtr, message_prefix->data(), prefix_len);
+    msgPtr += prefix_len;
+  }
+  if (msg_len > prefix_len) {
+    // Required fields may be part of the prefix.
+    request_message->SerializePartialToArray(msgPtr, msg_len - prefix_len);
+    if (message_prefix == NULL && !request_message->IsInitialized()) {
       string errmsg = string("message is not valid. Not all required "
                              "fields have been initialized: ") +
           request_message->InitializationErrorString();
@@ -101,12 +137,27 @@ ClientRequest::~ClientRequest() {
 void ClientRequest::ExecuteCallback() {
   if (!callback_executed_) {
     callback_executed_ = true;
+    LatencyHistogram* network_latency
+        = LatencyStatistics::GetHistogram(LatencyStatistics::kRPCNetwork);
+    if (network_latency && !time_picked_up_.is_not_a_date_time()) {
+      network_latency->RecordSince(time_picked_up_);
+    }
+
+    // The callback may delete this object.
+    ScopedLatencyRecorder callback_latency(
+        LatencyStatistics::GetHistogram(LatencyStatistics::kRPCCallback));
     callback_->RequestCompleted(this);
   }
 }
 
 void ClientRequest::RequestSent() {
   time_sent_ = posix_time::microsec_clock::local_time();
+  time_picked_up_ = LatencyHistogram::Now();
+  LatencyHistogram* queue_latency
+      = LatencyStatistics::GetHistogram(LatencyStatistics::kRPCQueue);
+  if (queue_latency) {
+    queue_latency->RecordSince(time_created_);
+  }
 }
 
 }  // namespace rpc
@@ -0,0 +1,220 @@
+/*
+ * Copyright (c) 2026 by the XtreemFS Authors, see AUTHORS file
+ *
+ * Licensed under the BSD License, see LICENSE file for details.
+ *
+ */
+
+#ifdef HAS_OPENSSL
+
+#include "rpc/kernel_tls.h"
+
+#include <boost/thread/once.hpp>
+#include <cstring>
+
+#if defined(HAS_KERNEL_TLS) && (OPENSSL_VERSION_NUMBER >= 0x10101000L)
+#define XTREEMFS_KERNEL_TLS
+#include <linux/tls.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <openssl/crypto.h>
+#include <openssl/evp.h>
+#include <openssl/hmac.h>
+#include <sys/socket.h>
+
+#ifndef TCP_ULP
+#define TCP_ULP 31
+#endif
+#ifndef SOL_TLS
+#define SOL_TLS 282
+#endif
+#endif  // HAS_KERNEL_TLS && OPENSSL_VERSION_NUMBER >= 0x10101000L
+
+using namespace std;
+
+namespace xtreemfs {
+namespace rpc {
+
+#ifdef XTREEMFS_KERNEL_TLS
+namespace {
+
+boost::once_flag secret_index_initialized = BOOST_ONCE_INIT;
+
+/** Index of the secret string in the SSL ex data. */
+int secret_index = -1;
+
+void InitializeSecretIndex() {
+  secret_index = SSL_get_ex_new_index(0, NULL, NULL, NULL, NULL);
+}
+
+const char kClientTrafficSecretLabel[] = "CLIENT_TRAFFIC_SECRET_0 ";
+
+int HexValue(char c) {
+  if (c >= '0' && c <= '9') {
+    return c - '0';
+  } else if (c >= 'a' && c <= 'f') {
+    return c - 'a' + 10;
+  } else if (c >= 'A' && c <= 'F') {
+    return c - 'A' + 10;
+  }
+  return -1;
+}
+
+/** Receives the secrets of a connection in the NSS key log format
+ *  "<label> <client random> <secret>" (all hex encoded). */
+void KeyLogCallback(const SSL* ssl, const char* line) {
+  if (strncmp(line,
+              kClientTrafficSecretLabel,
+              sizeof(kClientTrafficSecretLabel) - 1) != 0) {
+    return;
+  }
+  string* secret = static_cast<string*>(SSL_get_ex_data(ssl, secret_index));
+  const char* hex = strrchr(line, ' ');
+  if (secret == NULL || hex == NULL) {
+    return;
+  }
+  hex++;
+
+  secret->clear();
+  size_t length = strlen(hex);
+  for (size_t i = 0; i + 1 < length; i += 2) {
+    int high = HexValue(hex[i]);
+    int low = HexValue(hex[i + 1]);
+    if (high < 0 || low < 0) {
+      secret->clear();
+      return;
+    }
+    secret->push_back(static_cast<char>(high << 4 | low));
+  }
+}
+
+/** HKDF-Expand-Label() of TLS 1.3 (RFC 8446, 7.1) with an empty context for
+ *  at most one block of output, which suffices for keys and IVs. */
+bool HkdfExpandLabel(const EVP_MD* digest,
+                     const string& secret,
+                     const string& label,
+                     size_t length,
+                     unsigned char* output) {
+  string full_label = "tls13 " + label;
+  string info;
+  info.push_back(static_cast<char>(length >> 8));
+  info.push_back(static_cast<char>(length & 0xff));
+  info.push_back(static_cast<char>(full_label.size()));
+  info.append(full_label);
+  info.push_back(0);  // Empty context.
+  info.push_back(1);  // Counter of the first block.
+
+  unsigned char block[EVP_MAX_MD_SIZE];
+  unsigned int block_length = 0;
+  if (HMAC(digest,
+           secret.data(),
+           static_cast<int>(secret.size()),
+           reinterpret_cast<const unsigned char*>(info.data()),
+           info.size(),
+           block,
+           &block_length) == NULL
+      || block_length < length) {
+    return false;
+  }
+  memcpy(output, block, length);
+  OPENSSL_cleanse(block, sizeof(block));
+  return true;
+}
+
+/** Derives the key and IV from "secret" and hands them to the kernel. */
+template<typename CryptoInfo>
+bool SetTransmitKey(int socket,
+                    const EVP_MD* digest,
+                    const string& secret,
+                    uint16_t cipher_type) {
+  CryptoInfo info;
+  memset(&info, 0, sizeof(info));
+  info.info.version = TLS_1_3_VERSION;
+  info.info.cipher_type = cipher_type;
+
+  // The kernel expects the first bytes of the IV as salt. The record sequence
+  // number starts at zero after the handshake.
+  unsigned char iv[sizeof(info.salt) + sizeof(info.iv)];
+  bool success
+      = HkdfExpandLabel(digest, secret, "key", sizeof(info.key), info.key)
+        && HkdfExpandLabel(digest, secret, "iv", sizeof(iv), iv);
+  if (success) {
+    memcpy(info.salt, iv, sizeof(info.salt));
+    memcpy(info.iv, iv + sizeof(info.salt), sizeof(info.iv));
+    success = setsockopt(socket, IPPROTO_TCP, TCP_ULP, "tls", sizeof("tls"))
+                  == 0
+              && setsockopt(socket, SOL_TLS, TLS_TX, &info, sizeof(info)) == 0;
+  }
+  OPENSSL_cleanse(&info, sizeof(info));
+  OPENSSL_cleanse(iv, sizeof(iv));
+  return success;
+}
+
+}  // namespace
+#endif  // XTREEMFS_KERNEL_TLS
+
+bool KernelTLSSupported() {
+#ifdef XTREEMFS_KERNEL_TLS
+  return true;
+#else
+  return false;
+#endif  // XTREEMFS_KERNEL_TLS
+}
+
+void EnableTLSSecretRecording(SSL_CTX* context) {
+#ifdef XTREEMFS_KERNEL_TLS
+  boost::call_once(&InitializeSecretIndex, secret_index_initialized);
+  SSL_CTX_set_keylog_callback(context, &KeyLogCallback);
+#endif  // XTREEMFS_KERNEL_TLS
+}
+
+void RecordTLSSecret(SSL* ssl, std::string* secret) {
+#ifdef XTREEMFS_KERNEL_TLS
+  boost::call_once(&InitializeSecretIndex, secret_index_initialized);
+  SSL_set_ex_data(ssl, secret_index, secret);
+#endif  // XTREEMFS_KERNEL_TLS
+}
+
+bool OffloadTLSTransmit(SSL* ssl, int socket, const std::string& secret) {
+#ifdef XTREEMFS_KERNEL_TLS
+  const SSL_CIPHER* cipher = SSL_get_current_cipher(ssl);
+  if (secret.empty() || SSL_version(ssl) != TLS1_3_VERSION || cipher == NULL) {
+    return false;
+  }
+
+  bool offloaded = false;
+  switch (SSL_CIPHER_get_id(cipher)) {
+    case TLS1_3_CK_AES_128_GCM_SHA256:
+      offloaded = SetTransmitKey<tls12_crypto_info_aes_gcm_128>(
+          socket, EVP_sha256(), secret, TLS_CIPHER_AES_GCM_128);
+      break;
+    case TLS1_3_CK_AES_256_GCM_SHA384:
+      offloaded = SetTransmitKey<tls12_crypto_info_aes_gcm_256>(
+          socket, EVP_sha384(), secret, TLS_CIPHER_AES_GCM_256);
+      break;
+    default:
+      break;
+  }
+  if (offloaded) {
+    // The caller writes to the socket directly from now on. Records of OpenSSL
+    // go to a null BIO which only counts them.
+    SSL_set0_wbio(ssl, BIO_new(BIO_s_null()));
+  }
+  return offloaded;
+#else
+  return false;
+#endif  // XTREEMFS_KERNEL_TLS
+}
+
+bool OpenSSLWroteAfterOffload(SSL* ssl) {
+#ifdef XTREEMFS_KERNEL_TLS
+  return BIO_number_written(SSL_get_wbio(ssl)) != 0;
+#else
+  return false;
+#endif  // XTREEMFS_KERNEL_TLS
+}
+
+}  // namespace rpc
+}  // namespace xtreemfs
+
+#endif  // HAS_OPENSSL
@@ -0,0 +1,188 @@
+/*
+ * Copyright (c) 2026 by the XtreemFS Authors, see AUTHORS file
+ *
+ * Licensed under the BSD License, see LICENSE file for details.
+ *
+ */
+
+#include "rpc/request_header_cache.h"
+
+#include <cassert>
+
+#include <boost/functional/hash.hpp>
+#include <google/protobuf/io/coded_stream.h>
+#include <string>
+#include <utility>
+
+#include "pbrpc/RPC.pb.h"
+
+using namespace std;
+using namespace xtreemfs::pbrpc;
+using google::protobuf::io::CodedOutputStream;
+
+namespace xtreemfs {
+namespace rpc {
+
+namespace {
+
+/** Wire format tags of the fields which are patched by SetIds(). */
+const uint8_t kTagCallId = (1 << 3) | 5;             // fixed32 call_id = 1
+const uint8_t kTagMessageType = (2 << 3) | 0;        // enum message_type = 2
+const uint8_t kTagRequestHeader = (3 << 3) | 2;      // request_header = 3
+const uint8_t kTagInterfaceId = (1 << 3) | 5;        // fixed32 interface_id = 1
+const uint8_t kTagProcId = (2 << 3) | 5;             // fixed32 proc_id = 2
+
+/** Returns true if "a" and "b" would be serialized to the same bytes. */
+bool Equals(const UserCredentials& a, const UserCredentials& b) {
+  if (a.username() != b.username() || a.groups_size() != b.groups_size()) {
+    return false;
+  }
+  for (int i = 0; i < a.groups_size(); i++) {
+    if (a.groups(i) != b.groups(i)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/** Returns true if "a" and "b" would be serialized to the same bytes. */
+bool Equals(const Auth& a, const Auth& b) {
+  return a.auth_type() == b.auth_type()
+      && a.has_auth_data() == b.has_auth_data()
+      && a.auth_data() == b.auth_data()
+      && a.has_auth_passwd() == b.has_auth_passwd()
+      && a.auth_passwd().has_password() == b.auth_passwd().has_password()
+      && a.auth_passwd().password() == b.auth_passwd().password();
+}
+
+}  // namespace
+
+RequestHeaderCache::RequestHeaderCache(size_t max_entries)
+    : max_entries_(max_entries),
+      templates_(new TemplateMap()) {}
+
+boost::shared_ptr<const std::string> RequestHeaderCache::GetTemplate(
+    const xtreemfs::pbrpc::UserCredentials& user_credentials,
+    const xtreemfs::pbrpc::Auth& auth) {
+  const size_t hash = Hash(user_credentials, auth);
+  {
+    boost::shared_ptr<const TemplateMap> templates
+        = boost::atomic_load(&templates_);
+    const boost::shared_ptr<const string>* header_template
+        = Find(*templates, hash, user_credentials, auth);
+    if (header_template) {
+      return *header_template;
+    }
+  }
+
+  Entry entry;
+  entry.user_credentials.CopyFrom(user_credentials);
+  entry.auth.CopyFrom(auth);
+  entry.header_template.reset(
+      new string(CreateTemplate(user_credentials, auth)));
+
+  boost::mutex::scoped_lock lock(update_mutex_);
+  // Another thread may have added the template in the meantime.
+  const boost::shared_ptr<const string>* header_template
+      = Find(*templates_, hash, user_credentials, auth);
+  if (header_template) {
+    return *header_template;
+  }
+  boost::shared_ptr<TemplateMap> templates;
+  if (templates_->size() >= max_entries_) {
+    templates.reset(new TemplateMap());
+  } else {
+    templates.reset(new TemplateMap(*templates_));
+  }
+  templates->insert(make_pair(hash, entry));
+  boost::atomic_store(&templates_,
+                      boost::shared_ptr<const TemplateMap>(templates));
+  return entry.header_template;
+}
+
+size_t RequestHeaderCache::Hash(
+    const xtreemfs::pbrpc::UserCredentials& user_credentials,
+    const xtreemfs::pbrpc::Auth& auth) {
+  size_t hash = 0;
+  boost::hash_combine(hash, user_credentials.username());
+  for (int i = 0; i < user_credentials.groups_size(); i++) {
+    boost::hash_combine(hash, user_credentials.groups(i));
+  }
+  boost::hash_combine(hash, static_cast<int>(auth.auth_type()));
+  boost::hash_combine(hash, auth.auth_data());
+  boost::hash_combine(hash, auth.auth_passwd().password());
+  return hash;
+}
+
+const boost::shared_ptr<const std::string>* RequestHeaderCache::Find(
+    const TemplateMap& templates,
+    size_t hash,
+    const xtreemfs::pbrpc::UserCredentials& user_credentials,
+    const xtreemfs::pbrpc::Auth& auth) {
+  pair<TemplateMap::const_iterator, TemplateMap::const_iterator> range
+      = templates.equal_range(hash);
+  for (TemplateMap::const_iterator it = range.first;
+       it != range.second;
+       ++it) {
+    if (Equals(it->second.user_credentials, user_credentials)
+        && Equals(it->second.auth, auth)) {
+      return &it->second.header_template;
+    }
+  }
+  return NULL;
+}
+
+std::string RequestHeaderCache::CreateTemplate(
+    const xtreemfs::pbrpc::UserCredentials& user_credentials,
+    const xtreemfs::pbrpc::Auth& auth) {
+  RPCHeader header;
+  header.set_message_type(xtreemfs::pbrpc::RPC_REQUEST);
+  header.set_call_id(0);
+  header.mutable_request_header()->set_interface_id(0);
+  header.mutable_request_header()->set_proc_id(0);
+  header.mutable_request_header()->mutable_user_creds()->
+      MergeFrom(user_credentials);
+  header.mutable_request_header()->mutable_auth_data()->MergeFrom(auth);
+
+  return header.SerializeAsString();
+}
+
+void RequestHeaderCache::SetIds(uint32_t call_id,
+                                uint32_t interface_id,
+                                uint32_t proc_id,
+                                char* header,
+                                size_t header_length) {
+  // Fields are serialized in the order of their field number:
+  // call_id, message_type (always 0) and the length-delimited request_header
+  // which starts with interface_id and proc_id.
+  uint8_t* pos = reinterpret_cast<uint8_t*>(header);
+  uint8_t* end = pos + header_length;
+
+  assert(pos[0] == kTagCallId);
+  CodedOutputStream::WriteLittleEndian32ToArray(call_id, pos + 1);
+  pos += 5;
+
+  assert(pos[0] == kTagMessageType && pos[1] == RPC_REQUEST);
+  pos += 2;
+
+  assert(pos[0] == kTagRequestHeader);
+  // Skip the tag and the varint length of the request header.
+  do {
+    pos++;
+  } while (*pos & 0x80);
+  pos++;
+
+  assert(pos[0] == kTagInterfaceId);
+  CodedOutputStream::WriteLittleEndian32ToArray(interface_id, pos + 1);
+  pos += 5;
+
+  assert(pos[0] == kTagProcId);
+  CodedOutputStream::WriteLittleEndian32ToArray(proc_id, pos + 1);
+  pos += 5;
+
+  assert(pos <= end);
+  (void) end;
+}
+
+}  // namespace rpc
+}  // namespace xtreemfs
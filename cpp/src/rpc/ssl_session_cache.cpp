@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2026 by the XtreemFS Authors, see AUTHORS file
+ *
+ * Licensed under the BSD License, see LICENSE file for details.
+ *
+ */
+
+#ifdef HAS_OPENSSL
+
+#include "rpc/ssl_session_cache.h"
+
+#include <boost/thread/once.hpp>
+
+#include "util/logging.h"
+
+using namespace std;
+using namespace xtreemfs::util;
+
+namespace xtreemfs {
+namespace rpc {
+
+namespace {
+
+boost::once_flag ex_data_indexes_initialized = BOOST_ONCE_INIT;
+
+/** Index of the SSLSessionCache in the SSL_CTX ex data. */
+int cache_index = -1;
+
+/** Index of the server address in the SSL ex data. */
+int address_index = -1;
+
+void InitializeExDataIndexes() {
+  cache_index = SSL_CTX_get_ex_new_index(0, NULL, NULL, NULL, NULL);
+  address_index = SSL_get_ex_new_index(0, NULL, NULL, NULL, NULL);
+}
+
+}  // namespace
+
+SSLSessionCache::SSLSessionCache(SSL_CTX* context) {
+  boost::call_once(&InitializeExDataIndexes, ex_data_indexes_initialized);
+
+  SSL_CTX_set_ex_data(context, cache_index, this);
+  // The sessions are only stored here, keyed by server.
+  SSL_CTX_set_session_cache_mode(
+      context,
+      SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+  SSL_CTX_sess_set_new_cb(context, &SSLSessionCache::NewSessionCallback);
+}
+
+SSLSessionCache::~SSLSessionCache() {
+  for (map<string, SSL_SESSION*>::iterator it = sessions_.begin();
+       it != sessions_.end();
+       ++it) {
+    SSL_SESSION_free(it->second);
+  }
+}
+
+void SSLSessionCache::PrepareHandshake(SSL* ssl, const std::string* address) {
+  SSL_set_ex_data(ssl, address_index, const_cast<string*>(address));
+
+  boost::mutex::scoped_lock lock(mutex_);
+  map<string, SSL_SESSION*>::iterator it = sessions_.find(*address);
+  if (it != sessions_.end()) {
+    // Increases the reference count of the session.
+    SSL_set_session(ssl, it->second);
+  }
+}
+
+void SSLSessionCache::Remove(const std::string& address) {
+  boost::mutex::scoped_lock lock(mutex_);
+  map<string, SSL_SESSION*>::iterator it = sessions_.find(address);
+  if (it != sessions_.end()) {
+    SSL_SESSION_free(it->second);
+    sessions_.erase(it);
+  }
+}
+
+size_t SSLSessionCache::size() {
+  boost::mutex::scoped_lock lock(mutex_);
+  return sessions_.size();
+}
+
+int SSLSessionCache::NewSessionCallback(SSL* ssl, SSL_SESSION* session) {
+  SSLSessionCache* cache = static_cast<SSLSessionCache*>(
+      SSL_CTX_get_ex_data(SSL_get_SSL_CTX(ssl), cache_index));
+  const string* address
+      = static_cast<const string*>(SSL_get_ex_data(ssl, address_index));
+  if (cache == NULL || address == NULL) {
+    return 0;  // OpenSSL keeps the ownership.
+  }
+
+  if (Logging::log->loggingActive(LEVEL_DEBUG)) {
+    Logging::log->getLog(LEVEL_DEBUG) << "Storing TLS session for "
+        << *address << " for resumption." << endl;
+  }
+  cache->Store(*address, session);
+  return 1;
+}
+
+void SSLSessionCache::Store(const std::string& address,
+                            SSL_SESSION* session) {
+  boost::mutex::scoped_lock lock(mutex_);
+  map<string, SSL_SESSION*>::iterator it = sessions_.find(address);
+  if (it != sessions_.end()) {
+    SSL_SESSION_free(it->second);
+    it->second = session;
+  } else {
+    sessions_[address] = session;
+  }
+}
+
+}  // namespace rpc
+}  // namespace xtreemfs
+
+#endif  // HAS_OPENSSL
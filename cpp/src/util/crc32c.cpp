@@ -0,0 +1,258 @@
+/*
+ * Copyright (c) 2026 by the XtreemFS Authors, see AUTHORS file
+ *
+ * Licensed under the BSD License, see LICENSE file for details.
+ *
+ */
+
+#include "util/crc32c.h"
+
+#include <boost/thread/once.hpp>
+#include <cstring>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#include <cpuid.h>
+#define XTREEMFS_CRC32C_SSE42
+#endif
+
+namespace xtreemfs {
+namespace util {
+
+namespace {
+
+/** CRC32C polynomial in reversed bit order. */
+const uint32_t kPolynomial = 0x82f63b78;
+
+/** Length of each of the three streams which are computed in parallel for
+ *  large respectively small remainders of the data. */
+const size_t kLongStream = 8192;
+const size_t kShortStream = 256;
+
+boost::once_flag tables_initialized = BOOST_ONCE_INIT;
+
+/** Tables of the slicing-by-8 implementation. */
+uint32_t slicing_table[8][256];
+
+/** Tables which append kLongStream and kShortStream zero bytes to a CRC. */
+uint32_t long_shift_table[4][256];
+uint32_t short_shift_table[4][256];
+
+bool hardware_accelerated = false;
+
+/** Multiplies the 32x32 matrix "matrix" over GF(2) with "vector". */
+uint32_t Gf2MatrixTimes(const uint32_t* matrix, uint32_t vector) {
+  uint32_t sum = 0;
+  while (vector) {
+    if (vector & 1) {
+      sum ^= *matrix;
+    }
+    vector >>= 1;
+    matrix++;
+  }
+  return sum;
+}
+
+void Gf2MatrixSquare(uint32_t* square, const uint32_t* matrix) {
+  for (int n = 0; n < 32; n++) {
+    square[n] = Gf2MatrixTimes(matrix, matrix[n]);
+  }
+}
+
+/** Fills "table" with the operator which appends "length" zero bytes to the
+ *  CRC register (see zlib's crc32_combine()). "length" has to be a power of
+ *  two. */
+void InitializeShiftTable(uint32_t table[4][256], size_t length) {
+  uint32_t even[32];
+  uint32_t odd[32];
+
+  // Operator for one zero bit.
+  odd[0] = kPolynomial;
+  uint32_t row = 1;
+  for (int n = 1; n < 32; n++) {
+    odd[n] = row;
+    row <<= 1;
+  }
+  Gf2MatrixSquare(even, odd);  // Two zero bits.
+  Gf2MatrixSquare(odd, even);  // Four zero bits.
+
+  // The first square yields the operator for one zero byte.
+  const uint32_t* result = NULL;
+  do {
+    Gf2MatrixSquare(even, odd);
+    length >>= 1;
+    result = even;
+    if (length == 0) {
+      break;
+    }
+    Gf2MatrixSquare(odd, even);
+    length >>= 1;
+    result = odd;
+  } while (length);
+
+  for (uint32_t n = 0; n < 256; n++) {
+    table[0][n] = Gf2MatrixTimes(result, n);
+    table[1][n] = Gf2MatrixTimes(result, n << 8);
+    table[2][n] = Gf2MatrixTimes(result, n << 16);
+    table[3][n] = Gf2MatrixTimes(result, n << 24);
+  }
+}
+
+uint32_t Shift(uint32_t table[4][256], uint32_t crc) {
+  return table[0][crc & 0xff] ^ table[1][(crc >> 8) & 0xff]
+      ^ table[2][(crc >> 16) & 0xff] ^ table[3][crc >> 24];
+}
+
+void InitializeTables() {
+  for (uint32_t n = 0; n < 256; n++) {
+    uint32_t crc = n;
+    for (int k = 0; k < 8; k++) {
+      crc = crc & 1 ? (crc >> 1) ^ kPolynomial : crc >> 1;
+    }
+    slicing_table[0][n] = crc;
+  }
+  for (uint32_t n = 0; n < 256; n++) {
+    uint32_t crc = slicing_table[0][n];
+    for (int k = 1; k < 8; k++) {
+      crc = slicing_table[0][crc & 0xff] ^ (crc >> 8);
+      slicing_table[k][n] = crc;
+    }
+  }
+
+#ifdef XTREEMFS_CRC32C_SSE42
+  unsigned int eax, ebx, ecx, edx;
+  if (__get_cpuid(1, &eax, &ebx, &ecx, &edx) && (ecx & bit_SSE4_2)) {
+    InitializeShiftTable(long_shift_table, kLongStream);
+    InitializeShiftTable(short_shift_table, kShortStream);
+    hardware_accelerated = true;
+  }
+#endif  // XTREEMFS_CRC32C_SSE42
+}
+
+uint32_t ExtendPortable(uint32_t crc, const unsigned char* next,
+                        size_t length) {
+  crc = ~crc;
+  while (length >= 8) {
+    crc ^= static_cast<uint32_t>(next[0])
+        | static_cast<uint32_t>(next[1]) << 8
+        | static_cast<uint32_t>(next[2]) << 16
+        | static_cast<uint32_t>(next[3]) << 24;
+    crc = slicing_table[7][crc & 0xff]
+        ^ slicing_table[6][(crc >> 8) & 0xff]
+        ^ slicing_table[5][(crc >> 16) & 0xff]
+        ^ slicing_table[4][crc >> 24]
+        ^ slicing_table[3][next[4]]
+        ^ slicing_table[2][next[5]]
+        ^ slicing_table[1][next[6]]
+        ^ slicing_table[0][next[7]];
+    next += 8;
+    length -= 8;
+  }
+  while (length) {
+    crc = slicing_table[0][(crc ^ *next) & 0xff] ^ (crc >> 8);
+    next++;
+    length--;
+  }
+  return ~crc;
+}
+
+#ifdef XTREEMFS_CRC32C_SSE42
+inline uint64_t Crc32Instruction64(uint64_t crc, const unsigned char* next) {
+  uint64_t value;
+  memcpy(&value, next, sizeof(value));
+  __asm__("crc32q %1, %0" : "+r"(crc) : "rm"(value));
+  return crc;
+}
+
+inline uint32_t Crc32Instruction8(uint32_t crc, unsigned char value) {
+  __asm__("crc32b %1, %0" : "+r"(crc) : "rm"(value));
+  return crc;
+}
+
+/** Computes three streams of "stream_length" bytes at once, since the crc32
+ *  instruction has a latency of three cycles but a throughput of one. The
+ *  results are combined with "shift_table". */
+inline const unsigned char* ExtendThreeStreams(uint64_t* crc,
+                                               const unsigned char* next,
+                                               size_t* length,
+                                               size_t stream_length,
+                                               uint32_t shift_table[4][256]) {
+  while (*length >= 3 * stream_length) {
+    uint64_t crc0 = *crc;
+    uint64_t crc1 = 0;
+    uint64_t crc2 = 0;
+    const unsigned char* end = next + stream_length;
+    do {
+      crc0 = Crc32Instruction64(crc0, next);
+      crc1 = Crc32Instruction64(crc1, next + stream_length);
+      crc2 = Crc32Instruction64(crc2, next + 2 * stream_length);
+      next += 8;
+    } while (next < end);
+    crc0 = Shift(shift_table, static_cast<uint32_t>(crc0)) ^ crc1;
+    crc0 = Shift(shift_table, static_cast<uint32_t>(crc0)) ^ crc2;
+    *crc = crc0;
+    next += 2 * stream_length;
+    *length -= 3 * stream_length;
+  }
+  return next;
+}
+
+uint32_t ExtendHardware(uint32_t crc, const unsigned char* next,
+                        size_t length) {
+  uint64_t crc0 = ~crc;
+  while (length && (reinterpret_cast<uintptr_t>(next) & 7) != 0) {
+    crc0 = Crc32Instruction8(static_cast<uint32_t>(crc0), *next);
+    next++;
+    length--;
+  }
+  next = ExtendThreeStreams(&crc0, next, &length, kLongStream,
+                            long_shift_table);
+  next = ExtendThreeStreams(&crc0, next, &length, kShortStream,
+                            short_shift_table);
+  while (length >= 8) {
+    crc0 = Crc32Instruction64(crc0, next);
+    next += 8;
+    length -= 8;
+  }
+  while (length) {
+    crc0 = Crc32Instruction8(static_cast<uint32_t>(crc0), *next);
+    next++;
+    length--;
+  }
+  return ~static_cast<uint32_t>(crc0);
+}
+#endif  // XTREEMFS_CRC32C_SSE42
+
+}  // namespace
+
+uint32_t CRC32C(const char* data, size_t length) {
+  return CRC32CExtend(0, data, length);
+}
+
+uint32_t CRC32CExtend(uint32_t crc, const char* data, size_t length) {
+  boost::call_once(&InitializeTables, tables_initialized);
+#ifdef XTREEMFS_CRC32C_SSE42
+  if (hardware_accelerated) {
+    return ExtendHardware(crc,
+                          reinterpret_cast<const unsigned char*>(data),
+                          length);
+  }
+#endif  // XTREEMFS_CRC32C_SSE42
+  return ExtendPortable(crc,
+                        reinterpret_cast<const unsigned char*>(data),
+                        length);
+}
+
+uint32_t CRC32CExtendPortable(uint32_t crc, const char* data, size_t length) {
+  boost::call_once(&InitializeTables, tables_initialized);
+  return ExtendPortable(crc,
+                        reinterpret_cast<const unsigned char*>(data),
+                        length);
+}
+
+bool CRC32CIsHardwareAccelerated() {
+  boost::call_once(&InitializeTables, tables_initialized);
+  return hardware_accelerated;
+}
+
+}  // namespace util
+}  // namespace xtreemfs
@@ -0,0 +1,218 @@
+/*
+ * Copyright (c) 2026 by the XtreemFS Authors, see AUTHORS file
+ *
+ * Licensed under the BSD License, see LICENSE file for details.
+ *
+ */
+
+#include "util/latency_histogram.h"
+
+#include <algorithm>
+#include <boost/functional/hash.hpp>
+#include <boost/thread/thread.hpp>
+#include <vector>
+
+using namespace std;
+
+namespace xtreemfs {
+namespace util {
+
+LatencyHistogram::LatencyHistogram() : stripes_(new Stripe[kStripes]) {
+  Reset();
+}
+
+int LatencyHistogram::GetBucketIndex(uint64_t latency_us) {
+  if (latency_us < static_cast<uint64_t>(kSubBuckets)) {
+    return static_cast<int>(latency_us);
+  }
+  int highest_bit = 0;
+  for (uint64_t value = latency_us >> 1; value != 0; value >>= 1) {
+    highest_bit++;
+  }
+  if (highest_bit >= kMaxLatencyBits) {
+    return kNumberOfBuckets - 1;
+  }
+  // The kSubBucketBits bits below the highest bit select the sub bucket.
+  int shift = highest_bit - kSubBucketBits;
+  int sub_bucket = static_cast<int>((latency_us >> shift) & (kSubBuckets - 1));
+  return (shift + 1) * kSubBuckets + sub_bucket;
+}
+
+uint64_t LatencyHistogram::GetBucketUpperBound(int index) {
+  if (index < kSubBuckets) {
+    return index;
+  }
+  int shift = index / kSubBuckets - 1;
+  uint64_t sub_bucket = index % kSubBuckets;
+  return ((kSubBuckets + sub_bucket + 1) << shift) - 1;
+}
+
+LatencyHistogram::Stripe& LatencyHistogram::GetStripeOfCurrentThread() {
+  static boost::hash<boost::thread::id> hasher;
+  return stripes_[hasher(boost::this_thread::get_id()) % kStripes];
+}
+
+void LatencyHistogram::Record(uint64_t latency_us) {
+  Stripe& stripe = GetStripeOfCurrentThread();
+  stripe.buckets[GetBucketIndex(latency_us)].fetch_add(
+      1, boost::memory_order_relaxed);
+  stripe.sum.fetch_add(latency_us, boost::memory_order_relaxed);
+
+  uint64_t max = stripe.max.load(boost::memory_order_relaxed);
+  while (latency_us > max &&
+         !stripe.max.compare_exchange_weak(max,
+                                           latency_us,
+                                           boost::memory_order_relaxed)) {
+  }
+}
+
+void LatencyHistogram::RecordSince(const boost::posix_time::ptime& start) {
+  boost::posix_time::time_duration latency = Now() - start;
+  Record(latency.is_negative() ? 0 : latency.total_microseconds());
+}
+
+void LatencyHistogram::GetSummary(Summary* summary) {
+  vector<uint64_t> buckets(kNumberOfBuckets, 0);
+  uint64_t sum = 0;
+  *summary = Summary();
+  for (int i = 0; i < kStripes; i++) {
+    for (int j = 0; j < kNumberOfBuckets; j++) {
+      uint64_t count
+          = stripes_[i].buckets[j].load(boost::memory_order_relaxed);
+      buckets[j] += count;
+      summary->count += count;
+    }
+    sum += stripes_[i].sum.load(boost::memory_order_relaxed);
+    summary->max = std::max(
+        summary->max, stripes_[i].max.load(boost::memory_order_relaxed));
+  }
+  if (summary->count == 0) {
+    return;
+  }
+  summary->mean = sum / summary->count;
+
+  // Report the upper bound of the bucket which contains the percentile.
+  const double kPercentiles[] = { 0.5, 0.9, 0.99, 0.999 };
+  uint64_t* values[] = { &summary->p50, &summary->p90,
+                         &summary->p99, &summary->p999 };
+  int percentile = 0;
+  uint64_t seen = 0;
+  for (int j = 0; j < kNumberOfBuckets && percentile < 4; j++) {
+    seen += buckets[j];
+    while (percentile < 4 && seen >= kPercentiles[percentile] * summary->count
+           && seen > 0) {
+      *values[percentile] = std::min(GetBucketUpperBound(j), summary->max);
+      percentile++;
+    }
+  }
+}
+
+void LatencyHistogram::Reset() {
+  for (int i = 0; i < kStripes; i++) {
+    for (int j = 0; j < kNumberOfBuckets; j++) {
+      stripes_[i].buckets[j].store(0, boost::memory_order_relaxed);
+    }
+    stripes_[i].sum.store(0, boost::memory_order_relaxed);
+    stripes_[i].max.store(0, boost::memory_order_relaxed);
+  }
+}
+
+LatencyStatistics::~LatencyStatistics() {
+  for (map<string, LatencyHistogram*>::iterator it = servers_.begin();
+       it != servers_.end();
+       ++it) {
+    delete it->second;
+  }
+}
+
+const char* LatencyStatistics::GetOperationName(Operation operation) {
+  static const char* kNames[kNumberOfOperations] = {
+    "getattr",
+    "setattr",
+    "open",
+    "close",
+    "read",
+    "write",
+    "flush",
+    "truncate",
+    "readdir",
+    "mkdir",
+    "rmdir",
+    "unlink",
+    "rename",
+    "statfs",
+    "getxattr",
+    "setxattr",
+    "listxattr",
+    "lock",
+    "rpc_queue",
+    "rpc_network",
+    "rpc_callback"
+  };
+  return kNames[operation];
+}
+
+LatencyHistogram* LatencyStatistics::GetServerHistogram(
+    const std::string& address) {
+  if (!latency_statistics) {
+    return NULL;
+  }
+  boost::mutex::scoped_lock lock(latency_statistics->servers_mutex_);
+  LatencyHistogram*& histogram = latency_statistics->servers_[address];
+  if (histogram == NULL) {
+    histogram = new LatencyHistogram();
+  }
+  return histogram;
+}
+
+void LatencyStatistics::GetOperationSummary(
+    Operation operation,
+    LatencyHistogram::Summary* summary) {
+  operations_[operation].GetSummary(summary);
+}
+
+void LatencyStatistics::GetServerSummaries(
+    std::map<std::string, LatencyHistogram::Summary>* summaries) {
+  boost::mutex::scoped_lock lock(servers_mutex_);
+  for (map<string, LatencyHistogram*>::iterator it = servers_.begin();
+       it != servers_.end();
+       ++it) {
+    it->second->GetSummary(&(*summaries)[it->first]);
+  }
+}
+
+void LatencyStatistics::Reset() {
+  for (int i = 0; i < kNumberOfOperations; i++) {
+    operations_[i].Reset();
+  }
+  boost::mutex::scoped_lock lock(servers_mutex_);
+  for (map<string, LatencyHistogram*>::iterator it = servers_.begin();
+       it != servers_.end();
+       ++it) {
+    it->second->Reset();
+  }
+}
+
+void initialize_latency_statistics() {
+  // Do not initialize the statistics multiple times.
+  if (LatencyStatistics::latency_statistics) {
+    LatencyStatistics::latency_statistics->register_init();
+    return;
+  }
+
+  LatencyStatistics::latency_statistics = new LatencyStatistics();
+}
+
+void shutdown_latency_statistics() {
+  // Delete the statistics only if no instance is left.
+  if (LatencyStatistics::latency_statistics &&
+      LatencyStatistics::latency_statistics->register_shutdown()) {
+    delete LatencyStatistics::latency_statistics;
+    LatencyStatistics::latency_statistics = NULL;
+  }
+}
+
+LatencyStatistics* LatencyStatistics::latency_statistics = NULL;
+
+}  // namespace util
+}  // namespace xtreemfs
@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2026 by the XtreemFS Authors, see AUTHORS file
+ *
+ * Licensed under the BSD License, see LICENSE file for details.
+ *
+ */
+
+#include "util/log_ring_buffer.h"
+
+using namespace std;
+
+namespace xtreemfs {
+namespace util {
+
+LogRingBuffer::LogRingBuffer(size_t capacity)
+    : entries_(new Entry[capacity]),
+      capacity_(capacity),
+      thread_id_(boost::this_thread::get_id()),
+      head_(0),
+      tail_(0),
+      dropped_(0) {}
+
+bool LogRingBuffer::TryPush(LogLevel level,
+                            const boost::posix_time::ptime& time,
+                            std::string* message) {
+  size_t head = head_.load(boost::memory_order_relaxed);
+  if (head - tail_.load(boost::memory_order_acquire) >= capacity_) {
+    dropped_.fetch_add(1, boost::memory_order_relaxed);
+    message->clear();
+    return false;
+  }
+
+  Entry& entry = entries_[head % capacity_];
+  entry.level = level;
+  entry.time = time;
+  entry.message.swap(*message);
+  message->clear();
+  head_.store(head + 1, boost::memory_order_release);
+  return true;
+}
+
+LogRingBuffer::Entry* LogRingBuffer::Front() {
+  size_t tail = tail_.load(boost::memory_order_relaxed);
+  if (tail == head_.load(boost::memory_order_acquire)) {
+    return NULL;
+  }
+  return &entries_[tail % capacity_];
+}
+
+void LogRingBuffer::Pop() {
+  tail_.store(tail_.load(boost::memory_order_relaxed) + 1,
+              boost::memory_order_release);
+}
+
+bool LogRingBuffer::empty() const {
+  return tail_.load(boost::memory_order_acquire)
+      == head_.load(boost::memory_order_acquire);
+}
+
+uint64_t LogRingBuffer::TakeDroppedCount() {
+  return dropped_.exchange(0, boost::memory_order_relaxed);
+}
+
+}  // namespace util
+}  // namespace xtreemfs
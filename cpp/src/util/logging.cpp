@@ -7,75 +7,324 @@
  */
 #include "util/logging.h"
 
-#ifdef WIN32
-#define WIN32_LEAN_AND_MEAN
-#include <windows.h>
-#else
-#include <ctime>
-#endif
+#include <stdlib.h>
 
+#include <boost/bind.hpp>
+#include <boost/date_time/c_local_time_adjustor.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
 #include <boost/thread.hpp>
+#include <boost/thread/tss.hpp>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
 #include <ostream>
+#include <streambuf>
 #include <string>
+#include <vector>
+
+#include "util/log_ring_buffer.h"
 
 using namespace std;
 
 namespace xtreemfs {
 namespace util {
 
+/** Number of messages which can be buffered per thread. */
+static const size_t kRingBufferSize = 1024;
+
+/** State of a thread which logs: the stream returned by getLog() and the ring
+ *  buffer which receives the completed messages. */
+class ThreadLog : public std::streambuf {
+ public:
+  explicit ThreadLog(Logging* logging)
+      : stream_(this),
+        logging_(logging),
+        instance_id_(logging->instance_id_),
+        ring_buffer_(logging->RegisterThread()),
+        level_(LEVEL_ERROR) {}
+
+  virtual ~ThreadLog() {
+    // The Logging instance may be gone already, so the writer thread is not
+    // woken up. The message is written with the next one or by Flush().
+    if (!message_.empty()) {
+      ring_buffer_->TryPush(level_, time_, &message_);
+    }
+  }
+
+  /** Completes the current message and starts a new one. */
+  std::ostream& Begin(LogLevel level) {
+    Commit();
+    level_ = level;
+    time_ = boost::posix_time::microsec_clock::universal_time();
+    // Reset modifiers of the previous message.
+    stream_.clear();
+    stream_.flags(ios::dec | ios::skipws);
+    stream_.fill(' ');
+    stream_.width(0);
+    return stream_;
+  }
+
+  /** Moves the current message into the ring buffer. */
+  void Commit() {
+    if (!message_.empty()) {
+      ring_buffer_->TryPush(level_, time_, &message_);
+      logging_->WakeUpWriter();
+    }
+  }
+
+  uint64_t instance_id() const {
+    return instance_id_;
+  }
+
+ protected:
+  virtual int_type overflow(int_type c) {
+    if (!traits_type::eq_int_type(c, traits_type::eof())) {
+      message_.push_back(traits_type::to_char_type(c));
+    }
+    return traits_type::not_eof(c);
+  }
+
+  virtual std::streamsize xsputn(const char* s, std::streamsize n) {
+    message_.append(s, n);
+    return n;
+  }
+
+  /** Called by std::endl and std::flush. */
+  virtual int sync() {
+    Commit();
+    return 0;
+  }
+
+ private:
+  std::ostream stream_;
+
+  /** Only valid if instance_id_ is the id of Logging::log. */
+  Logging* logging_;
+
+  /** Id of the Logging instance this state belongs to. */
+  const uint64_t instance_id_;
+
+  boost::shared_ptr<LogRingBuffer> ring_buffer_;
+
+  LogLevel level_;
+
+  boost::posix_time::ptime time_;
+
+  /** Text of the current message. */
+  std::string message_;
+};
+
+/** Log state of the current thread. */
+static boost::thread_specific_ptr<ThreadLog> current_thread_log;
+
+static boost::atomic<uint64_t> next_instance_id(0);
+
 Logging::Logging(LogLevel level, std::ostream* stream)
-    : log_stream_(*stream), log_file_stream_(stream), level_(level), init_count_(1) {
+    : log_stream_(*stream),
+      log_file_stream_(stream),
+      level_(level),
+      init_count_(1),
+      instance_id_(next_instance_id.fetch_add(1)),
+      stop_writer_(false),
+      writer_sleeping_(false),
+      flush_requests_(0),
+      completed_flushes_(0),
+      dropped_messages_(0) {
+  Start();
 }
 
 Logging::Logging(LogLevel level)
-    : log_stream_(std::cout), log_file_stream_(NULL), level_(level), init_count_(1) {
+    : log_stream_(std::cout),
+      log_file_stream_(NULL),
+      level_(level),
+      init_count_(1),
+      instance_id_(next_instance_id.fetch_add(1)),
+      stop_writer_(false),
+      writer_sleeping_(false),
+      flush_requests_(0),
+      completed_flushes_(0),
+      dropped_messages_(0) {
+  Start();
 }
 
 Logging::~Logging() {
+  // Messages which are logged after this point are lost.
+  {
+    boost::mutex::scoped_lock lock(writer_mutex_);
+    stop_writer_ = true;
+    writer_wakeup_.notify_one();
+  }
+  writer_thread_->join();
+
   if (log_file_stream_) {
     delete log_file_stream_;
   }
 }
 
+void Logging::Start() {
+  writer_thread_.reset(new boost::thread(boost::bind(&Logging::Run, this)));
+}
+
 std::ostream& Logging::getLog(LogLevel level, const char* file, int line) {
-#ifdef WIN32
-  SYSTEMTIME st, lt;
-  GetSystemTime(&st);
-  GetLocalTime(&lt);
-#else
-  timeval current_time;
-  gettimeofday(&current_time, 0);
-  struct tm* tm = localtime(&current_time.tv_sec);
-#endif
+  // NOTE(mberlin): Disabled output of __FILE__ and __LINE__ since they are
+  // not used in the current (3/2012) code base.
+  ThreadLog* thread_log = current_thread_log.get();
+  if (thread_log == NULL || thread_log->instance_id() != instance_id_) {
+    // The state of a previous instance is dropped.
+    thread_log = new ThreadLog(this);
+    current_thread_log.reset(thread_log);
+  }
+  return thread_log->Begin(level);
+}
+
+void Logging::Flush() {
+  ThreadLog* thread_log = current_thread_log.get();
+  if (thread_log != NULL && thread_log->instance_id() == instance_id_) {
+    thread_log->Commit();
+  }
+
+  boost::mutex::scoped_lock lock(writer_mutex_);
+  uint64_t flush_request = ++flush_requests_;
+  writer_wakeup_.notify_one();
+  while (completed_flushes_ < flush_request) {
+    flush_completed_.wait(lock);
+  }
+}
+
+void Logging::WakeUpWriter() {
+  // Pairs with the fence in Run(): either the writer sees the new message
+  // before it goes to sleep or this thread sees writer_sleeping_.
+  boost::atomic_thread_fence(boost::memory_order_seq_cst);
+  if (writer_sleeping_.load(boost::memory_order_relaxed)) {
+    boost::mutex::scoped_lock lock(writer_mutex_);
+    writer_wakeup_.notify_one();
+  }
+}
+
+bool Logging::AllRingBuffersEmpty() {
+  boost::mutex::scoped_lock lock(ring_buffers_mutex_);
+  for (list<boost::shared_ptr<LogRingBuffer> >::const_iterator it
+           = ring_buffers_.begin();
+       it != ring_buffers_.end();
+       ++it) {
+    if (!(*it)->empty()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+boost::shared_ptr<LogRingBuffer> Logging::RegisterThread() {
+  boost::shared_ptr<LogRingBuffer> ring_buffer(
+      new LogRingBuffer(kRingBufferSize));
+  boost::mutex::scoped_lock lock(ring_buffers_mutex_);
+  ring_buffers_.push_back(ring_buffer);
+  return ring_buffer;
+}
+
+void Logging::Run() {
+  boost::mutex::scoped_lock lock(writer_mutex_);
+  while (!stop_writer_) {
+    // All messages committed before Flush() was called are written when
+    // the buffers are empty afterwards.
+    uint64_t flush_request = flush_requests_;
+    lock.unlock();
+    while (WriteBufferedMessages() > 0) {}
+    lock.lock();
+    if (completed_flushes_ != flush_request) {
+      completed_flushes_ = flush_request;
+      flush_completed_.notify_all();
+    }
+    if (stop_writer_ || flush_requests_ != flush_request) {
+      continue;
+    }
+
+    writer_sleeping_.store(true, boost::memory_order_relaxed);
+    boost::atomic_thread_fence(boost::memory_order_seq_cst);
+    if (AllRingBuffersEmpty()) {
+      writer_wakeup_.wait(lock);
+    }
+    writer_sleeping_.store(false, boost::memory_order_relaxed);
+  }
+  lock.unlock();
+  WriteBufferedMessages();
+}
+
+size_t Logging::WriteBufferedMessages() {
+  vector<boost::shared_ptr<LogRingBuffer> > ring_buffers;
+  {
+    boost::mutex::scoped_lock lock(ring_buffers_mutex_);
+    ring_buffers.assign(ring_buffers_.begin(), ring_buffers_.end());
+  }
+
+  size_t written = 0;
+  for (size_t i = 0; i < ring_buffers.size(); i++) {
+    LogRingBuffer* ring_buffer = ring_buffers[i].get();
+    LogRingBuffer::Entry* entry;
+    while ((entry = ring_buffer->Front()) != NULL) {
+      WriteHeader(entry->level, entry->time, ring_buffer->thread_id());
+      log_stream_ << entry->message;
+      if (entry->message[entry->message.size() - 1] != '\n') {
+        log_stream_ << '\n';
+      }
+      ring_buffer->Pop();
+      ++written;
+    }
+
+    uint64_t dropped = ring_buffer->TakeDroppedCount();
+    if (dropped > 0) {
+      dropped_messages_.fetch_add(dropped, boost::memory_order_relaxed);
+      WriteHeader(LEVEL_WARN,
+                  boost::posix_time::microsec_clock::universal_time(),
+                  ring_buffer->thread_id());
+      log_stream_ << "Dropped " << dropped << " log message(s) of this thread"
+          " since its log buffer was full." << '\n';
+      ++written;
+    }
+  }
+  if (written > 0) {
+    log_stream_.flush();
+  }
+
+  // Remove the buffers of exited threads.
+  ring_buffers.clear();
+  boost::mutex::scoped_lock lock(ring_buffers_mutex_);
+  for (list<boost::shared_ptr<LogRingBuffer> >::iterator it
+           = ring_buffers_.begin();
+       it != ring_buffers_.end();) {
+    if (it->unique() && (*it)->empty()) {
+      it = ring_buffers_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+
+  return written;
+}
+
+void Logging::WriteHeader(LogLevel level,
+                          const boost::posix_time::ptime& time,
+                          const boost::thread::id& thread_id) {
+  boost::posix_time::ptime local_time
+      = boost::date_time::c_local_adjustor<boost::posix_time::ptime>
+          ::utc_to_local(time);
+  boost::gregorian::date date = local_time.date();
+  boost::posix_time::time_duration time_of_day = local_time.time_of_day();
 
   log_stream_
       << "[ " << levelToChar(level) << " | "
-      // NOTE(mberlin): Disabled output of __FILE__ and __LINE__ since they are
-      // not used in the current (3/2012) code base.
-//      << file << ":" << line << " | "
-
       << setiosflags(ios::dec)
-#ifdef WIN32
-      << setw(2) << lt.wMonth << "/" << setw(2) << lt.wDay << " "
-      << setfill('0') << setw(2) << lt.wHour << ":"
-      << setfill('0') << setw(2) << lt.wMinute << ":"
-      << setfill('0') << setw(2) << lt.wSecond << "."
-      << setfill('0') << setw(3) << lt.wMilliseconds << " | "
-#else
-      << setw(2) << (tm->tm_mon + 1) << "/" << setw(2) << tm->tm_mday << " "
-      << setfill('0') << setw(2) << tm->tm_hour << ":"
-      << setfill('0') << setw(2) << tm->tm_min << ":"
-      << setfill('0') << setw(2) << tm->tm_sec << "."
-      << setfill('0') << setw(3) << (current_time.tv_usec / 1000) << " | "
-#endif
+      << setw(2) << date.month().as_number() << "/" << setw(2) << date.day()
+      << " "
+      << setfill('0') << setw(2) << time_of_day.hours() << ":"
+      << setfill('0') << setw(2) << time_of_day.minutes() << ":"
+      << setfill('0') << setw(2) << time_of_day.seconds() << "."
+      << setfill('0') << setw(3)
+      << (time_of_day.total_milliseconds() % 1000) << " | "
       << left << setfill(' ') << setw(14)
-      << boost::this_thread::get_id() << " ] "
+      << thread_id << " ] "
       // Reset modifiers.
       << setfill(' ') << resetiosflags(ios::hex | ios::left);
-  return log_stream_;
 }
 
 char Logging::levelToChar(LogLevel level) {
@@ -93,10 +342,6 @@ char Logging::levelToChar(LogLevel level) {
   return 'U';  // unkown
 }
 
-bool Logging::loggingActive(LogLevel level) {
-  return (level <= level_);
-}
-
 void Logging::register_init() {
   ++init_count_;
 }
@@ -137,6 +382,22 @@ void initialize_logger(std::string stringLevel,
   initialize_logger(stringToLevel(stringLevel, defaultLevel), logfilePath);
 }
 
+/** Writes the buffered messages if a program exits without calling
+ *  shutdown_logger(). */
+static void FlushLoggerAtExit() {
+  if (Logging::log) {
+    Logging::log->Flush();
+  }
+}
+
+static void RegisterFlushLoggerAtExit() {
+  static bool registered = false;
+  if (!registered) {
+    atexit(&FlushLoggerAtExit);
+    registered = true;
+  }
+}
+
 /**
  * Log to a file given by logfilePath. If logfilePath is empty,
  * stdout is used.
@@ -155,6 +416,7 @@ void initialize_logger(LogLevel level, std::string logfilePath) {
     if (logfile != NULL && logfile->is_open()) {
       cerr << "Logging to file " << logfilePath.c_str() << "." << endl;
       Logging::log = new Logging(level, logfile);
+      RegisterFlushLoggerAtExit();
       return;
     }
     cerr << "Could not log to file " << logfilePath.c_str()
@@ -162,6 +424,7 @@ void initialize_logger(LogLevel level, std::string logfilePath) {
   }
   // in case of an error, log to stdout
   Logging::log = new Logging(level);
+  RegisterFlushLoggerAtExit();
 }
 
 /**
@@ -174,6 +437,7 @@ void initialize_logger(LogLevel level) {
     return;
   }
   Logging::log = new Logging(level);
+  RegisterFlushLoggerAtExit();
 }
 
 void shutdown_logger() {
@@ -915,6 +915,105 @@ bool ShowErrors(const string& xctl_file,
   }
 }
 
+// Prints one row of the latency statistics.
+void PrintLatencyStatistics(const string& name, const Json::Value& summary) {
+  const int setwValue1st = 25;
+  const int setwValue = 10;
+  cout << setw(setwValue1st) << left << name << right
+       << setw(setwValue) << summary["count"].asUInt64()
+       << setw(setwValue) << summary["mean_us"].asUInt64()
+       << setw(setwValue) << summary["p50_us"].asUInt64()
+       << setw(setwValue) << summary["p90_us"].asUInt64()
+       << setw(setwValue) << summary["p99_us"].asUInt64()
+       << setw(setwValue) << summary["p999_us"].asUInt64()
+       << setw(setwValue) << summary["max_us"].asUInt64() << endl;
+}
+
+// Shows the latency percentiles of the client (in microseconds).
+bool ShowLatencyStatistics(const string& xctl_file,
+                           const string& path,
+                           const variables_map& vm) {
+  Json::Value request(Json::objectValue);
+  request["operation"] = "getLatencyStatistics";
+  request["reset"] = vm.count("reset-latency-stats") > 0;
+
+  Json::Value response;
+  if (executeOperation(xctl_file, request, &response)) {
+    const Json::Value& result = response["result"];
+    cout << setw(25) << left << "Operation (us)" << right
+         << setw(10) << "Count"
+         << setw(10) << "Mean"
+         << setw(10) << "p50"
+         << setw(10) << "p90"
+         << setw(10) << "p99"
+         << setw(10) << "p99.9"
+         << setw(10) << "Max" << endl;
+    Json::Value::Members names = result["operations"].getMemberNames();
+    for (size_t i = 0; i < names.size(); i++) {
+      if (result["operations"][names[i]]["count"].asUInt64() > 0) {
+        PrintLatencyStatistics(names[i], result["operations"][names[i]]);
+      }
+    }
+    names = result["servers"].getMemberNames();
+    if (!names.empty()) {
+      cout << endl << setw(25) << left << "Server (us)" << right << endl;
+    }
+    for (size_t i = 0; i < names.size(); i++) {
+      PrintLatencyStatistics(names[i], result["servers"][names[i]]);
+    }
+    names = result["write_windows"].getMemberNames();
+    if (!names.empty()) {
+      cout << endl << setw(40) << left << "OSD (async write window)" << right
+           << setw(10) << "Window"
+           << setw(10) << "In flight" << endl;
+    }
+    for (size_t i = 0; i < names.size(); i++) {
+      const Json::Value& window = result["write_windows"][names[i]];
+      cout << setw(40) << left << names[i] << right
+           << setw(10) << window["window"].asInt()
+           << setw(10) << window["in_flight"].asInt() << endl;
+    }
+    return true;
+  } else {
+    cerr << "Showing Latency Statistics FAILED" << endl;
+    return false;
+  }
+}
+
+// Shows the bandwidth and throttling delays of the reads and writes per user
+// or process group.
+bool ShowQoSStatistics(const string& xctl_file,
+                       const string& path,
+                       const variables_map& vm) {
+  Json::Value request(Json::objectValue);
+  request["operation"] = "getQoSStatistics";
+
+  Json::Value response;
+  if (executeOperation(xctl_file, request, &response)) {
+    const Json::Value& result = response["result"];
+    cout << setw(25) << left << "QoS key" << right
+         << setw(8) << "Weight"
+         << setw(12) << "Ops"
+         << setw(16) << "Bytes"
+         << setw(12) << "Delayed"
+         << setw(12) << "Delay (ms)" << endl;
+    Json::Value::Members keys = result.getMemberNames();
+    for (size_t i = 0; i < keys.size(); i++) {
+      const Json::Value& counters = result[keys[i]];
+      cout << setw(25) << left << keys[i] << right
+           << setw(8) << counters["weight"].asInt()
+           << setw(12) << counters["operations"].asUInt64()
+           << setw(16) << counters["bytes"].asUInt64()
+           << setw(12) << counters["delayed_operations"].asUInt64()
+           << setw(12) << counters["delay_ms"].asUInt64() << endl;
+    }
+    return true;
+  } else {
+    cerr << "Showing QoS Statistics FAILED" << endl;
+    return false;
+  }
+}
+
 // Returns a list of OSDs suitable for a new replica.
 bool GetSuitableOSDs(const string& xctl_file,
                      const string& path,
@@ -1351,6 +1450,11 @@ int main(int argc, char **argv) {
       ("help,h", "produce help message")
       ("version,V", "Show the version number.")
       ("errors", "show client errors for a volume")
+      ("latency-stats", "show latency percentiles of the client")
+      ("reset-latency-stats",
+       "reset the latency statistics after showing them")
+      ("qos-stats", "show the throttled reads and writes per user or process"
+       " group of the client")
       ("set-dsp", "set (change) the default striping policy (volume)")
       ("striping-policy,p",
        value<string>()->implicit_value("RAID0"),
@@ -1660,6 +1764,16 @@ int main(int argc, char **argv) {
     ++operationsCount;
     failedOperationsCount += ShowErrors(xctl_file, path_on_volume, vm) ? 0 : 1;
   }
+  if (vm.count("latency-stats") > 0 || vm.count("reset-latency-stats") > 0) {
+    ++operationsCount;
+    failedOperationsCount
+        += ShowLatencyStatistics(xctl_file, path_on_volume, vm) ? 0 : 1;
+  }
+  if (vm.count("qos-stats") > 0) {
+    ++operationsCount;
+    failedOperationsCount
+        += ShowQoSStatistics(xctl_file, path_on_volume, vm) ? 0 : 1;
+  }
   if (vm.count("set-quota") > 0) {
     ++operationsCount;
     failedOperationsCount += SetQuota(xctl_file, path_on_volume, vm) ? 0 : 1;
@@ -23,7 +23,10 @@
 #include "libxtreemfs/volume.h"
 #include "libxtreemfs/xtreemfs_exception.h"
 #include "libxtreemfs/helper.h"
+#include "libxtreemfs/io_throttle.h"
+#include "libxtreemfs/write_window_controller.h"
 #include "util/error_log.h"
+#include "util/latency_histogram.h"
 #include "util/logging.h"
 
 using namespace std;
@@ -82,6 +85,10 @@ void XtfsUtilServer::ParseAndExecute(const xtreemfs::pbrpc::UserCredentials& uc,
   try {
     if (op_name == "getErrors") {
       OpGetErrors(uc, input, &result);
+    } else if (op_name == "getLatencyStatistics") {
+      OpGetLatencyStatistics(uc, input, &result);
+    } else if (op_name == "getQoSStatistics") {
+      OpGetQoSStatistics(uc, input, &result);
     } else if (op_name == "getattr") {
       OpStat(uc, input, &result);
     } else if (op_name == "setDefaultSP") {
@@ -147,6 +154,100 @@ void XtfsUtilServer::OpGetErrors(const xtreemfs::pbrpc::UserCredentials& uc,
   (*output)["result"] = result;
 }
 
+/** Converts "summary" into a JSON object. */
+static Json::Value LatencySummaryToJson(
+    const LatencyHistogram::Summary& summary) {
+  Json::Value result(Json::objectValue);
+  result["count"] = Json::Value::UInt64(summary.count);
+  result["mean_us"] = Json::Value::UInt64(summary.mean);
+  result["max_us"] = Json::Value::UInt64(summary.max);
+  result["p50_us"] = Json::Value::UInt64(summary.p50);
+  result["p90_us"] = Json::Value::UInt64(summary.p90);
+  result["p99_us"] = Json::Value::UInt64(summary.p99);
+  result["p999_us"] = Json::Value::UInt64(summary.p999);
+  return result;
+}
+
+void XtfsUtilServer::OpGetLatencyStatistics(
+    const xtreemfs::pbrpc::UserCredentials& uc,
+    const Json::Value& input,
+    Json::Value* output) {
+  LatencyStatistics* statistics = LatencyStatistics::latency_statistics;
+  if (statistics == NULL) {
+    (*output)["error"] = Json::Value("Latency statistics are not available.");
+    return;
+  }
+
+  Json::Value operations(Json::objectValue);
+  for (int i = 0; i < LatencyStatistics::kNumberOfOperations; i++) {
+    LatencyStatistics::Operation operation
+        = static_cast<LatencyStatistics::Operation>(i);
+    LatencyHistogram::Summary summary;
+    statistics->GetOperationSummary(operation, &summary);
+    operations[LatencyStatistics::GetOperationName(operation)]
+        = LatencySummaryToJson(summary);
+  }
+
+  Json::Value servers(Json::objectValue);
+  map<string, LatencyHistogram::Summary> server_summaries;
+  statistics->GetServerSummaries(&server_summaries);
+  for (map<string, LatencyHistogram::Summary>::const_iterator it
+           = server_summaries.begin();
+       it != server_summaries.end();
+       ++it) {
+    servers[it->first] = LatencySummaryToJson(it->second);
+  }
+
+  // The adaptive async write window per OSD is not reset.
+  Json::Value write_windows(Json::objectValue);
+  map<string, AsyncWriteWindow> windows;
+  if (client_) {
+    client_->GetAsyncWriteWindows(&windows);
+  }
+  for (map<string, AsyncWriteWindow>::const_iterator it = windows.begin();
+       it != windows.end();
+       ++it) {
+    Json::Value window(Json::objectValue);
+    window["window"] = Json::Value(it->second.window);
+    window["in_flight"] = Json::Value(it->second.in_flight);
+    write_windows[it->first] = window;
+  }
+
+  if (input.isMember("reset") && input["reset"].isBool()
+      && input["reset"].asBool()) {
+    statistics->Reset();
+  }
+
+  Json::Value result(Json::objectValue);
+  result["operations"] = operations;
+  result["servers"] = servers;
+  result["write_windows"] = write_windows;
+  (*output)["result"] = result;
+}
+
+void XtfsUtilServer::OpGetQoSStatistics(
+    const xtreemfs::pbrpc::UserCredentials& uc,
+    const Json::Value& input,
+    Json::Value* output) {
+  map<string, QoSCounters> counters;
+  volume_->GetQoSCounters(&counters);
+
+  Json::Value result(Json::objectValue);
+  for (map<string, QoSCounters>::const_iterator it = counters.begin();
+       it != counters.end();
+       ++it) {
+    Json::Value key(Json::objectValue);
+    key["weight"] = Json::Value(it->second.weight);
+    key["operations"] = Json::Value::UInt64(it->second.operations);
+    key["bytes"] = Json::Value::UInt64(it->second.bytes);
+    key["delayed_operations"]
+        = Json::Value::UInt64(it->second.delayed_operations);
+    key["delay_ms"] = Json::Value::UInt64(it->second.delay_ms);
+    result[it->first] = key;
+  }
+  (*output)["result"] = result;
+}
+
 void XtfsUtilServer::OpStat(const xtreemfs::pbrpc::UserCredentials& uc,
                             const Json::Value& input,
                             Json::Value* output) {
@@ -8,6 +8,10 @@
 #ifndef CPP_TEST_COMMON_DROP_RULES_H_
 #define CPP_TEST_COMMON_DROP_RULES_H_
 
+#include <stdint.h>
+
+#include <boost/scoped_ptr.hpp>
+
 namespace xtreemfs {
 namespace rpc {
 
@@ -25,6 +25,7 @@
 #include <iostream>
 #include <map>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "include/Common.pb.h"
@@ -182,6 +183,22 @@ template <class Derived> class TestRPCServer {
     drop_connection_ = true;
   }
 
+  /** The next "count" requests with "proc_id" are answered with an ERRNO
+   *  error response with "posix_errno" instead of being processed. */
+  void FailNextRequests(uint32_t proc_id,
+                        int count,
+                        pbrpc::POSIXErrno posix_errno) {
+    boost::mutex::scoped_lock lock(failing_requests_mutex_);
+    failing_requests_[proc_id] = std::make_pair(count, posix_errno);
+  }
+
+  /** Returns the proc ids of all received requests in the order they were
+   *  processed. */
+  std::vector<uint32_t> GetReceivedProcIDs() {
+    boost::mutex::scoped_lock lock(received_proc_ids_mutex_);
+    return received_proc_ids_;
+  }
+
  protected:
   /** Function pointer an implemented server operation. */
   typedef google::protobuf::Message* (Derived::*Operation)(
@@ -242,6 +259,21 @@ template <class Derived> class TestRPCServer {
     return drop_request;
   }
 
+  /** Returns true and sets "posix_errno" if the request shall be answered
+   *  with an error. */
+  bool CheckIfRequestShallFail(uint32_t proc_id,
+                               pbrpc::POSIXErrno* posix_errno) {
+    boost::mutex::scoped_lock lock(failing_requests_mutex_);
+    std::map<uint32_t, std::pair<int, pbrpc::POSIXErrno> >::iterator
+        it = failing_requests_.find(proc_id);
+    if (it == failing_requests_.end() || it->second.first <= 0) {
+      return false;
+    }
+    it->second.first--;
+    *posix_errno = it->second.second;
+    return true;
+  }
+
   static void DummySignalHandler(int signal) {
     // See comment at TestRPCServer::Stop() why this is needed.
   }
@@ -461,43 +493,57 @@ template <class Derived> class TestRPCServer {
           }
         }
 
+        {
+          boost::mutex::scoped_lock lock(received_proc_ids_mutex_);
+          received_proc_ids_.push_back(proc_id);
+        }
+
         // Check if the request should be dropped.
         if (CheckIfRequestShallBeDropped(proc_id)) {
           continue;
         }
 
         // Process request.
+        xtreemfs::pbrpc::RPCHeader response_header(request_rpc_header);
         boost::scoped_array<char> response_data;
         uint32_t response_data_len = 0;
-        boost::scoped_ptr<google::protobuf::Message> response_message(
-            ExecuteOperation(proc_id,
-                request_rpc_header.request_header().auth_data(),
-                request_rpc_header.request_header().user_creds(),
-                *request_message,
-                data_buffer.get(),
-                request_rm->data_len(),
-                &response_data,
-                &response_data_len));
-        if (!response_message.get()) {
-          Logging::log->getLog(xtreemfs::util::LEVEL_ERROR)
-              << "No response was generated. Operation with proc id = "
-              << proc_id << " is probably not implemented? (interface_id = "
-              << interface_id_ << ")" << std::endl;
-          break;
-        }
-        if (!response_message->IsInitialized()) {
-          Logging::log->getLog(xtreemfs::util::LEVEL_ERROR)
-              << "Response message is not valid."
-                 " Not all required fields have been initialized: "
-              << response_message->InitializationErrorString() << std::endl;
-          break;
+        boost::scoped_ptr<google::protobuf::Message> response_message;
+        pbrpc::POSIXErrno posix_errno;
+        if (CheckIfRequestShallFail(proc_id, &posix_errno)) {
+          pbrpc::RPCHeader::ErrorResponse* error =
+              response_header.mutable_error_response();
+          error->set_error_type(pbrpc::ERRNO);
+          error->set_posix_errno(posix_errno);
+          error->set_error_message("Injected error of the test server.");
+        } else {
+          response_message.reset(ExecuteOperation(proc_id,
+              request_rpc_header.request_header().auth_data(),
+              request_rpc_header.request_header().user_creds(),
+              *request_message,
+              data_buffer.get(),
+              request_rm->data_len(),
+              &response_data,
+              &response_data_len));
+          if (!response_message.get()) {
+            Logging::log->getLog(xtreemfs::util::LEVEL_ERROR)
+                << "No response was generated. Operation with proc id = "
+                << proc_id << " is probably not implemented? (interface_id = "
+                << interface_id_ << ")" << std::endl;
+            break;
+          }
+          if (!response_message->IsInitialized()) {
+            Logging::log->getLog(xtreemfs::util::LEVEL_ERROR)
+                << "Response message is not valid."
+                   " Not all required fields have been initialized: "
+                << response_message->InitializationErrorString() << std::endl;
+            break;
+          }
         }
 
         // Send response.
-        xtreemfs::pbrpc::RPCHeader response_header(request_rpc_header);
         xtreemfs::rpc::RecordMarker response_rm(
             response_header.ByteSize(),
-            response_message->ByteSize(),
+            response_message.get() ? response_message->ByteSize() : 0,
             response_data_len);
 
         size_t response_bytes_size = xtreemfs::rpc::RecordMarker::get_size()
@@ -517,11 +563,13 @@ template <class Derived> class TestRPCServer {
         }
         response += response_rm.header_len();
 
-        response_message->CheckInitialized();
-        if (!response_message->SerializeToArray(response, response_rm.message_len())) {
-            Logging::log->getLog(xtreemfs::util::LEVEL_ERROR)
-                << "Failed to serialize message" << std::endl;
-            break;
+        if (response_message.get() != NULL) {
+          response_message->CheckInitialized();
+          if (!response_message->SerializeToArray(response, response_rm.message_len())) {
+              Logging::log->getLog(xtreemfs::util::LEVEL_ERROR)
+                  << "Failed to serialize message" << std::endl;
+              break;
+          }
         }
 
         response += response_rm.message_len();
@@ -582,6 +630,19 @@ template <class Derived> class TestRPCServer {
 
   /** Guards access drop_connection_. */
   boost::mutex drop_connection_mutex_;
+
+  /** Proc id -> number of requests which are still to fail and their
+   *  error. */
+  std::map<uint32_t, std::pair<int, pbrpc::POSIXErrno> > failing_requests_;
+
+  /** Guards access to failing_requests_. */
+  boost::mutex failing_requests_mutex_;
+
+  /** Proc ids of all received requests. */
+  std::vector<uint32_t> received_proc_ids_;
+
+  /** Guards access received_proc_ids_. */
+  boost::mutex received_proc_ids_mutex_;
 };
 
 }  // namespace rpc
@@ -10,6 +10,7 @@
 #include "xtreemfs/MRC.pb.h"
 #include "xtreemfs/MRCServiceConstants.h"
 
+#include <algorithm>
 #include <ctime>
 
 using namespace std;
@@ -78,7 +79,9 @@ google::protobuf::Message* TestRPCServerMRC::OpenOperation(
 
   replica->mutable_striping_policy()->set_type(STRIPING_POLICY_RAID0);
   replica->mutable_striping_policy()->set_stripe_size(128);
-  replica->mutable_striping_policy()->set_width(1);
+  // Stripe over all registered OSDs.
+  replica->mutable_striping_policy()->set_width(
+      std::max(1, static_cast<int>(osd_uuids_.size())));
 
   response->set_timestamp_s(static_cast<uint32_t>(time(0)));
 
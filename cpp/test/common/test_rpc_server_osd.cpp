@@ -7,6 +7,10 @@
 
 #include "common/test_rpc_server_osd.h"
 
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/thread/thread.hpp>
+
+#include "util/crc32c.h"
 #include "util/logging.h"
 #include "xtreemfs/OSD.pb.h"
 #include "xtreemfs/OSDServiceConstants.h"
@@ -20,7 +24,11 @@ namespace rpc {
 
 const int kMaxFileSize = 10 * 1024 * 1024;
 
-TestRPCServerOSD::TestRPCServerOSD() : file_size_(0) {
+TestRPCServerOSD::TestRPCServerOSD()
+    : file_size_(0),
+      return_checksums_(false),
+      reads_to_corrupt_(0),
+      next_write_delay_ms_(0) {
   interface_id_ = INTERFACE_ID_OSD;
   // Register available operations.
   operations_[PROC_ID_TRUNCATE]
@@ -31,6 +39,8 @@ TestRPCServerOSD::TestRPCServerOSD() : file_size_(0) {
       = Op(this, &TestRPCServerOSD::ReadOperation);
   operations_[PROC_ID_XTREEMFS_FINALIZE_VOUCHERS]
       = Op(this, &TestRPCServerOSD::FinalizeVoucherOperation);
+  operations_[PROC_ID_XTREEMFS_PING]
+      = Op(this, &TestRPCServerOSD::PingOperation);
   data_.reset(new char[kMaxFileSize]);
 }
 
@@ -39,6 +49,21 @@ const std::vector<WriteEntry> TestRPCServerOSD::GetReceivedWrites() const {
   return received_writes_;
 }
 
+void TestRPCServerOSD::SetReturnChecksums(bool return_checksums) {
+  boost::mutex::scoped_lock lock(mutex_);
+  return_checksums_ = return_checksums;
+}
+
+void TestRPCServerOSD::CorruptNextReads(int count) {
+  boost::mutex::scoped_lock lock(mutex_);
+  reads_to_corrupt_ = count;
+}
+
+void TestRPCServerOSD::DelayNextWrite(int delay_ms) {
+  boost::mutex::scoped_lock lock(mutex_);
+  next_write_delay_ms_ = delay_ms;
+}
+
 google::protobuf::Message* TestRPCServerOSD::TruncateOperation(
     const pbrpc::Auth& auth,
     const pbrpc::UserCredentials& user_credentials,
@@ -102,6 +127,14 @@ google::protobuf::Message* TestRPCServerOSD::ReadOperation(
   response->set_zero_padding(0);
   response->set_invalid_checksum_on_osd(false);
   response->set_checksum(0);
+  if (return_checksums_ && bytes_to_read > 0) {
+    response->set_checksum(
+        xtreemfs::util::CRC32C(response_data->get(), bytes_to_read));
+    if (reads_to_corrupt_ > 0) {
+      reads_to_corrupt_--;
+      response_data->get()[0] ^= 1;
+    }
+  }
   return response;
 }
 
@@ -114,11 +147,19 @@ google::protobuf::Message* TestRPCServerOSD::WriteOperation(
     boost::scoped_array<char>* response_data,
     uint32_t* response_data_len) {
   boost::mutex::scoped_lock lock(mutex_);
+  if (next_write_delay_ms_ > 0) {
+    int delay_ms = next_write_delay_ms_;
+    next_write_delay_ms_ = 0;
+    lock.unlock();
+    boost::this_thread::sleep(boost::posix_time::milliseconds(delay_ms));
+    lock.lock();
+  }
   const writeRequest* rq
       = static_cast<const writeRequest*>(&request);
 
   received_writes_.push_back(
       WriteEntry(rq->object_number(), rq->offset(), data_len));
+  received_writes_.back().checksum_ = rq->object_data().checksum();
 
   if (Logging::log->loggingActive(xtreemfs::util::LEVEL_DEBUG)) {
     Logging::log->getLog(xtreemfs::util::LEVEL_DEBUG)
@@ -163,5 +204,18 @@ google::protobuf::Message* TestRPCServerOSD::FinalizeVoucherOperation(
   return response;
 }
 
+google::protobuf::Message* TestRPCServerOSD::PingOperation(
+    const pbrpc::Auth& auth,
+    const pbrpc::UserCredentials& user_credentials,
+    const google::protobuf::Message& request,
+    const char* data,
+    uint32_t data_len,
+    boost::scoped_array<char>* response_data,
+    uint32_t* response_data_len) {
+  xtreemfs_pingMesssage* response = new xtreemfs_pingMesssage();
+  response->CopyFrom(request);
+  return response;
+}
+
 }  // namespace rpc
 }  // namespace xtreemfs
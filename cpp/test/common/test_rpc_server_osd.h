@@ -27,10 +27,11 @@ namespace rpc {
 class WriteEntry {
  public:
   WriteEntry()
-      : object_number_(0), offset_(0), data_len_(0) { }
+      : object_number_(0), offset_(0), data_len_(0), checksum_(0) { }
 
   WriteEntry(uint64_t objectNumber, uint32_t offset, uint32_t data_len)
-    : object_number_(objectNumber), offset_(offset), data_len_(data_len) { }
+    : object_number_(objectNumber), offset_(offset), data_len_(data_len),
+      checksum_(0) { }
 
   bool operator==(const WriteEntry& other) const {
     return (other.object_number_ == this->object_number_)
@@ -41,6 +42,8 @@ class WriteEntry {
   uint64_t object_number_;
   uint32_t offset_;
   uint32_t data_len_;
+  /** Checksum sent by the client. Not compared by operator==. */
+  uint32_t checksum_;
 };
 
 class TestRPCServerOSD : public TestRPCServer<TestRPCServerOSD> {
@@ -48,6 +51,17 @@ class TestRPCServerOSD : public TestRPCServer<TestRPCServerOSD> {
   TestRPCServerOSD();
   const std::vector<WriteEntry> GetReceivedWrites() const;
 
+  /** If enabled, read responses contain the CRC32C of the data. */
+  void SetReturnChecksums(bool return_checksums);
+
+  /** Modifies the data of the next "count" reads after the checksum was
+   *  computed. */
+  void CorruptNextReads(int count);
+
+  /** Lets the next write wait "delay_ms" milliseconds before it is processed.
+   *  Later requests of the same connection wait as well. */
+  void DelayNextWrite(int delay_ms);
+
  private:
   google::protobuf::Message* TruncateOperation(
       const pbrpc::Auth& auth,
@@ -86,6 +100,15 @@ class TestRPCServerOSD : public TestRPCServer<TestRPCServerOSD> {
       boost::scoped_array<char>* response_data,
       uint32_t* response_data_len);
 
+  google::protobuf::Message* PingOperation(
+      const pbrpc::Auth& auth,
+      const pbrpc::UserCredentials& user_credentials,
+      const google::protobuf::Message& request,
+      const char* data,
+      uint32_t data_len,
+      boost::scoped_array<char>* response_data,
+      uint32_t* response_data_len);
+
   /** Mutex used to protect all member variables from concurrent access. */
   mutable boost::mutex mutex_;
 
@@ -95,6 +118,12 @@ class TestRPCServerOSD : public TestRPCServer<TestRPCServerOSD> {
   /** The file data. */
   boost::scoped_array<char> data_;
 
+  bool return_checksums_;
+
+  int reads_to_corrupt_;
+
+  int next_write_delay_ms_;
+
   /** A list of received write requests that can be used to check against an
    *  expected result.
    */
@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2026 by the XtreemFS Authors, see AUTHORS file
+ *
+ * Licensed under the BSD License, see LICENSE file for details.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <stdint.h>
+
+#include <string>
+
+#include "fuse/fuse_inode_table.h"
+
+using namespace std;
+
+namespace xtreemfs {
+
+const uint64_t kRoot = FuseInodeTable::kRootInode;
+
+class FuseInodeTableTest : public ::testing::Test {
+ protected:
+  /** Returns the path of "ino" or "(unknown)". */
+  string Path(uint64_t ino) {
+    string path;
+    if (!table_.GetPath(ino, &path)) {
+      return "(unknown)";
+    }
+    return path;
+  }
+
+  FuseInodeTable table_;
+};
+
+TEST_F(FuseInodeTableTest, RootIsNeverForgotten) {
+  EXPECT_EQ("/", Path(kRoot));
+  table_.Forget(kRoot, 100);
+  EXPECT_EQ("/", Path(kRoot));
+}
+
+TEST_F(FuseInodeTableTest, InodeIsKnownUntilAllLookupsAreForgotten) {
+  EXPECT_EQ(10, table_.AddLookup(kRoot, "dir", 10, false));
+  EXPECT_EQ(11, table_.AddLookup(10, "file", 11, false));
+  EXPECT_EQ(11, table_.AddLookup(10, "file", 11, false));
+  EXPECT_EQ("/dir/file", Path(11));
+
+  table_.Forget(11, 1);
+  EXPECT_EQ("/dir/file", Path(11));
+  table_.Forget(11, 1);
+  EXPECT_EQ("(unknown)", Path(11));
+  EXPECT_EQ("/dir", Path(10));
+
+  // Forgetting an unknown inode is ignored.
+  table_.Forget(11, 1);
+  EXPECT_EQ("/dir", Path(10));
+}
+
+TEST_F(FuseInodeTableTest, RenamedDirectoryMovesItsChildren) {
+  table_.AddLookup(kRoot, "a", 10, false);
+  table_.AddLookup(10, "b", 11, false);
+  table_.AddLookup(11, "file", 12, false);
+  table_.AddLookup(kRoot, "ab", 13, false);
+
+  table_.Rename(kRoot, "a", kRoot, "c");
+  EXPECT_EQ("/c", Path(10));
+  EXPECT_EQ("/c/b", Path(11));
+  EXPECT_EQ("/c/b/file", Path(12));
+  // A path with the same prefix is not affected.
+  EXPECT_EQ("/ab", Path(13));
+
+  table_.Rename(11, "file", kRoot, "moved");
+  EXPECT_EQ("/moved", Path(12));
+}
+
+TEST_F(FuseInodeTableTest, RenameOverDropsNameOfReplacedFile) {
+  table_.AddLookup(kRoot, "source", 10, false);
+  table_.AddLookup(kRoot, "target", 11, false);
+
+  table_.Rename(kRoot, "source", kRoot, "target");
+  EXPECT_EQ("/target", Path(10));
+  EXPECT_EQ("(unknown)", Path(11));
+
+  // The replaced file is dropped even if the renamed one is unknown.
+  table_.AddLookup(kRoot, "other", 12, false);
+  table_.Rename(kRoot, "unknown", kRoot, "other");
+  EXPECT_EQ("(unknown)", Path(12));
+}
+
+TEST_F(FuseInodeTableTest, UnlinkDropsOnlyTheRemovedName) {
+  // Two hard links.
+  table_.AddLookup(kRoot, "link1", 10, false);
+  table_.AddLookup(kRoot, "link2", 10, false);
+
+  table_.RemoveName(kRoot, "link1");
+  EXPECT_EQ("/link2", Path(10));
+  table_.RemoveName(kRoot, "link2");
+  EXPECT_EQ("(unknown)", Path(10));
+
+  // A new lookup of the still known inode makes it accessible again.
+  table_.AddLookup(kRoot, "link3", 10, false);
+  EXPECT_EQ("/link3", Path(10));
+  table_.Forget(10, 3);
+  EXPECT_EQ("(unknown)", Path(10));
+}
+
+/** A lookup which finds another file under a known name moves the name. */
+TEST_F(FuseInodeTableTest, ReplacedEntryMovesName) {
+  table_.AddLookup(kRoot, "file", 10, false);
+  table_.AddLookup(kRoot, "file", 11, false);
+  EXPECT_EQ("(unknown)", Path(10));
+  EXPECT_EQ("/file", Path(11));
+}
+
+TEST_F(FuseInodeTableTest, XctlFilesGetSeparateInodes) {
+  uint64_t ino = table_.AddLookup(kRoot, ".xctl$$$", 0, true);
+  EXPECT_NE(0, ino);
+  EXPECT_EQ(ino, table_.AddLookup(kRoot, ".xctl$$$", 0, true));
+  EXPECT_NE(ino, table_.AddLookup(kRoot, ".xctl$$$2", 0, true));
+  EXPECT_EQ("/.xctl$$$", Path(ino));
+
+  table_.Forget(ino, 2);
+  EXPECT_EQ("(unknown)", Path(ino));
+  EXPECT_NE(ino, table_.AddLookup(kRoot, ".xctl$$$", 0, true));
+}
+
+}  // namespace xtreemfs
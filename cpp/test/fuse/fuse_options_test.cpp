@@ -81,4 +81,26 @@ TEST_F(FuseOptionsTest, TestCommandLineMultipleOptionsPerFuseOptionAndMinusoOpti
   delete[] argv;
 }
 
+TEST_F(FuseOptionsTest, TestCommandLineLowLevelApi) {
+  int argc = 4;
+  char** argv = new char*[argc];
+  argv[0] = strdup("mount.xtreemfs");
+  argv[1] = strdup("--lowlevel-fuse");
+  argv[2] = strdup("localhost/test");
+  argv[3] = strdup("/mnt/xtreemfs");
+
+  xtreemfs::FuseOptions options;
+  EXPECT_FALSE(options.use_lowlevel_api);
+
+  ASSERT_NO_THROW({
+    options.ParseCommandLine(argc, argv);
+  });
+  EXPECT_TRUE(options.use_lowlevel_api);
+
+  for (int i = 0; i < argc; i++) {
+    free(argv[i]);
+  }
+  delete[] argv;
+}
+
 }  // namespace xtreemfs
@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2026 by the XtreemFS Authors, see AUTHORS file
+ *
+ * Licensed under the BSD License, see LICENSE file for details.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <stdint.h>
+
+#include <boost/bind.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+#include <vector>
+
+#include "libxtreemfs/async_write_budget.h"
+
+using namespace std;
+using namespace xtreemfs;
+
+namespace {
+
+const void* FileId(intptr_t id) {
+  return reinterpret_cast<const void*>(id);
+}
+
+/** Acquires "bytes" for "owner" and appends "owner" to "order" afterwards. */
+void AcquireAndRecord(AsyncWriteBudget* budget,
+                      int owner,
+                      size_t bytes,
+                      boost::mutex* order_mutex,
+                      vector<int>* order) {
+  budget->Acquire(FileId(owner), bytes);
+  boost::mutex::scoped_lock lock(*order_mutex);
+  order->push_back(owner);
+}
+
+/** Gives started threads time to block, there is no way to observe it. */
+void WaitForBlockedThreads() {
+  boost::this_thread::sleep(boost::posix_time::milliseconds(100));
+}
+
+}  // namespace
+
+TEST(AsyncWriteBudgetTest, BlocksOnlyIfExhausted) {
+  AsyncWriteBudget budget(100);
+  const void* file1 = FileId(1);
+
+  budget.Acquire(file1, 60);
+  budget.Acquire(file1, 40);
+  EXPECT_EQ(100, budget.used_bytes());
+
+  boost::mutex order_mutex;
+  vector<int> order;
+  boost::thread writer(boost::bind(
+      &AcquireAndRecord, &budget, 2, 50, &order_mutex, &order));
+  WaitForBlockedThreads();
+  {
+    boost::mutex::scoped_lock lock(order_mutex);
+    EXPECT_TRUE(order.empty());
+  }
+
+  budget.Release(60);
+  writer.join();
+  ASSERT_EQ(1, order.size());
+  EXPECT_EQ(90, budget.used_bytes());
+
+  budget.Release(90);
+  EXPECT_EQ(0, budget.used_bytes());
+
+  // Requests larger than the budget pass if nothing else is reserved.
+  budget.Acquire(file1, 200);
+  budget.Release(200);
+}
+
+TEST(AsyncWriteBudgetTest, FilesAreServedRoundRobin) {
+  AsyncWriteBudget budget(10);
+  budget.Acquire(FileId(9), 10);
+
+  boost::mutex order_mutex;
+  vector<int> order;
+  boost::thread_group writers;
+  // File 1 queues up two writes before file 2 gets the chance to.
+  writers.create_thread(boost::bind(
+      &AcquireAndRecord, &budget, 1, 10, &order_mutex, &order));
+  WaitForBlockedThreads();
+  writers.create_thread(boost::bind(
+      &AcquireAndRecord, &budget, 1, 10, &order_mutex, &order));
+  WaitForBlockedThreads();
+  writers.create_thread(boost::bind(
+      &AcquireAndRecord, &budget, 2, 10, &order_mutex, &order));
+  WaitForBlockedThreads();
+
+  for (int i = 0; i < 3; i++) {
+    budget.Release(10);
+    WaitForBlockedThreads();
+  }
+  writers.join_all();
+
+  ASSERT_EQ(3, order.size());
+  EXPECT_EQ(1, order[0]);
+  EXPECT_EQ(2, order[1]);
+  EXPECT_EQ(1, order[2]);
+  budget.Release(10);
+}
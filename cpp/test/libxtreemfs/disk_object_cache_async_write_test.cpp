@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2026 by the XtreemFS Authors, see AUTHORS file
+ *
+ * Licensed under the BSD License, see LICENSE file for details.
+ *
+ */
+
+#ifndef WIN32
+#include <gtest/gtest.h>
+
+#include <stdlib.h>
+
+#include <boost/bind.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/scoped_array.hpp>
+#include <boost/thread/thread.hpp>
+#include <cstring>
+#include <string>
+
+#include "common/test_environment.h"
+#include "common/test_rpc_server_osd.h"
+#include "libxtreemfs/client.h"
+#include "libxtreemfs/file_handle.h"
+#include "libxtreemfs/options.h"
+#include "libxtreemfs/volume.h"
+#include "util/logging.h"
+
+using namespace std;
+using namespace xtreemfs::pbrpc;
+using namespace xtreemfs::util;
+
+namespace xtreemfs {
+namespace rpc {
+
+namespace {
+
+const int kBlockSize = 1024 * 128;
+
+void WriteObject(FileHandle* file, const char* buffer, size_t count) {
+  file->Write(buffer, count, 0);
+}
+
+}  // namespace
+
+class DiskObjectCacheAsyncWriteTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    initialize_logger(LEVEL_WARN);
+    char path[] = "/tmp/xtreemfs_disk_cache_async_write_test_XXXXXX";
+    ASSERT_TRUE(mkdtemp(path) != NULL);
+    cache_path_ = path;
+
+    test_env.options.connect_timeout_s = 3;
+    test_env.options.request_timeout_s = 3;
+    test_env.options.retry_delay_s = 1;
+    test_env.options.enable_async_writes = true;
+    test_env.options.async_writes_max_request_size_kb = 128;
+    // All files share a window of a single write to the OSD.
+    test_env.options.async_writes_max_requests = 1;
+    test_env.options.async_writes_adaptive_max_requests = 1;
+    test_env.options.disk_cache_path = cache_path_ + "/cache";
+    test_env.options.disk_cache_size_mb = 16;
+    ASSERT_TRUE(test_env.Start());
+
+    volume = test_env.client->OpenVolume(
+        test_env.volume_name_,
+        NULL,  // No SSL options.
+        test_env.options);
+    // The test MRC returns the same file id for every path. A second volume
+    // has its own FileInfo for it, i.e. its writes are not pending ones of
+    // the first volume.
+    other_volume = test_env.client->OpenVolume(
+        test_env.volume_name_,
+        NULL,  // No SSL options.
+        test_env.options);
+  }
+
+  virtual void TearDown() {
+    test_env.Stop();
+    int result = system(("rm -rf " + cache_path_).c_str());
+    (void) result;
+  }
+
+  FileHandle* OpenFile(Volume* volume, const string& path) {
+    return volume->OpenFile(
+        test_env.user_credentials,
+        path,
+        static_cast<xtreemfs::pbrpc::SYSTEM_V_FCNTL>(
+            xtreemfs::pbrpc::SYSTEM_V_FCNTL_H_O_CREAT |
+            xtreemfs::pbrpc::SYSTEM_V_FCNTL_H_O_TRUNC |
+            xtreemfs::pbrpc::SYSTEM_V_FCNTL_H_O_RDWR));
+  }
+
+  string cache_path_;
+  TestEnvironment test_env;
+  Volume* volume;
+  Volume* other_volume;
+};
+
+/** A read which reaches the OSD before an async write of the same object must
+ *  not leave the old data in the cache. */
+TEST_F(DiskObjectCacheAsyncWriteTest, ReadDuringAsyncWriteIsNotCached) {
+  FileHandle* file = OpenFile(volume, "/test_file");
+  FileHandle* other_file = OpenFile(other_volume, "/other_file");
+  boost::scoped_array<char> old_data(new char[2 * kBlockSize]);
+  memset(old_data.get(), 'a', 2 * kBlockSize);
+  boost::scoped_array<char> new_data(new char[kBlockSize]);
+  memset(new_data.get(), 'b', kBlockSize);
+  boost::scoped_array<char> read_buf(new char[kBlockSize]);
+
+  ASSERT_NO_THROW(file->Write(old_data.get(), 2 * kBlockSize, 0));
+  ASSERT_NO_THROW(file->Flush());
+
+  // The write of the other file occupies the window of the OSD, so the write
+  // of the file is blocked after it invalidated the cache and the read is
+  // sent before it.
+  test_env.osds[0]->DelayNextWrite(500);
+  ASSERT_NO_THROW(other_file->Write(old_data.get(), 1, 10 * kBlockSize));
+  boost::thread writer(boost::bind(&WriteObject, file, new_data.get(),
+                                   static_cast<size_t>(kBlockSize)));
+  boost::this_thread::sleep(boost::posix_time::milliseconds(100));
+
+  ASSERT_EQ(kBlockSize, file->Read(read_buf.get(), kBlockSize, 0));
+  EXPECT_EQ('a', read_buf[0]);
+
+  writer.join();
+  ASSERT_NO_THROW(file->Flush());
+  ASSERT_NO_THROW(other_file->Flush());
+
+  ASSERT_EQ(kBlockSize, file->Read(read_buf.get(), kBlockSize, 0));
+  EXPECT_EQ('b', read_buf[0]);
+  EXPECT_EQ('b', read_buf[kBlockSize - 1]);
+
+  ASSERT_NO_THROW(other_file->Close());
+  ASSERT_NO_THROW(file->Close());
+}
+
+}  // namespace rpc
+}  // namespace xtreemfs
+#endif  // !WIN32
@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2026 by the XtreemFS Authors, see AUTHORS file
+ *
+ * Licensed under the BSD License, see LICENSE file for details.
+ *
+ */
+
+#ifndef WIN32
+#include <gtest/gtest.h>
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <boost/scoped_ptr.hpp>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "libxtreemfs/disk_object_cache.h"
+#include "libxtreemfs/xtreemfs_exception.h"
+#include "util/logging.h"
+
+using namespace std;
+using namespace xtreemfs::util;
+
+namespace xtreemfs {
+
+namespace {
+
+const int kObjectSize = 1024;
+
+}  // namespace
+
+class DiskObjectCacheTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    initialize_logger(LEVEL_WARN);
+    char path[] = "/tmp/xtreemfs_disk_cache_test_XXXXXX";
+    ASSERT_TRUE(mkdtemp(path) != NULL);
+    path_ = path;
+    object_.assign(kObjectSize, 'a');
+    for (int i = 0; i < kObjectSize; i++) {
+      object_[i] = static_cast<char>(i % 251);
+    }
+  }
+
+  virtual void TearDown() {
+    cache_.reset();
+    // Remove the files of the cache and the directory.
+    int result = system(("rm -rf " + path_).c_str());
+    (void) result;
+    shutdown_logger();
+  }
+
+  void OpenCache(uint64_t max_size_bytes) {
+    cache_.reset();
+    cache_.reset(new DiskObjectCache(path_, max_size_bytes));
+  }
+
+  void Store(const DiskObjectCache::Key& key) {
+    cache_->Store(key, &object_[0], kObjectSize, cache_->GetGeneration());
+  }
+
+  std::string path_;
+  std::vector<char> object_;
+  boost::scoped_ptr<DiskObjectCache> cache_;
+};
+
+TEST_F(DiskObjectCacheTest, StoreAndRead) {
+  OpenCache(1024 * 1024);
+  DiskObjectCache::Key key("volume:1", 3, 0, 1);
+  char buffer[kObjectSize];
+
+  EXPECT_EQ(-1, cache_->Read(key, buffer, 0, kObjectSize));
+  Store(key);
+  EXPECT_EQ(1, cache_->size());
+  EXPECT_EQ(kObjectSize, cache_->size_bytes());
+
+  ASSERT_EQ(100, cache_->Read(key, buffer, 10, 100));
+  EXPECT_EQ(0, memcmp(buffer, &object_[10], 100));
+  // Reads beyond the end of the object are shortened.
+  EXPECT_EQ(24, cache_->Read(key, buffer, kObjectSize - 24, 100));
+  EXPECT_EQ(0, cache_->Read(key, buffer, kObjectSize, 100));
+
+  // Another truncate epoch or XLocSet version is a miss.
+  EXPECT_EQ(-1, cache_->Read(DiskObjectCache::Key("volume:1", 3, 1, 1),
+                             buffer, 0, 100));
+  EXPECT_EQ(0, cache_->size());
+}
+
+TEST_F(DiskObjectCacheTest, SurvivesReopen) {
+  OpenCache(1024 * 1024);
+  DiskObjectCache::Key key("volume:1", 0, 2, 3);
+  Store(key);
+
+  OpenCache(1024 * 1024);
+  char buffer[kObjectSize];
+  ASSERT_EQ(kObjectSize, cache_->Read(key, buffer, 0, kObjectSize));
+  EXPECT_EQ(0, memcmp(buffer, &object_[0], kObjectSize));
+}
+
+TEST_F(DiskObjectCacheTest, SecondInstanceIsRejected) {
+  OpenCache(1024 * 1024);
+  EXPECT_THROW(DiskObjectCache(path_, 1024 * 1024), XtreemFSException);
+}
+
+TEST_F(DiskObjectCacheTest, EvictsLeastRecentlyUsed) {
+  OpenCache(3 * kObjectSize);
+  char buffer[kObjectSize];
+  Store(DiskObjectCache::Key("volume:1", 0, 0, 0));
+  Store(DiskObjectCache::Key("volume:1", 1, 0, 0));
+  Store(DiskObjectCache::Key("volume:1", 2, 0, 0));
+  // Object 0 becomes the most recently used one.
+  EXPECT_EQ(1, cache_->Read(DiskObjectCache::Key("volume:1", 0, 0, 0),
+                            buffer, 0, 1));
+
+  Store(DiskObjectCache::Key("volume:1", 3, 0, 0));
+  EXPECT_EQ(3, cache_->size());
+  EXPECT_EQ(-1, cache_->Read(DiskObjectCache::Key("volume:1", 1, 0, 0),
+                             buffer, 0, 1));
+  EXPECT_EQ(1, cache_->Read(DiskObjectCache::Key("volume:1", 0, 0, 0),
+                            buffer, 0, 1));
+}
+
+TEST_F(DiskObjectCacheTest, ValidateAndInvalidate) {
+  OpenCache(1024 * 1024);
+  Store(DiskObjectCache::Key("volume:1", 0, 0, 0));
+  Store(DiskObjectCache::Key("volume:1", 1, 0, 0));
+  Store(DiskObjectCache::Key("volume:12", 0, 0, 0));
+
+  cache_->Validate("volume:1", 0, 0);
+  EXPECT_EQ(3, cache_->size());
+  // The file was truncated since.
+  cache_->Validate("volume:1", 1, 0);
+  EXPECT_EQ(1, cache_->size());
+
+  Store(DiskObjectCache::Key("volume:1", 0, 1, 0));
+  cache_->Invalidate("volume:1");
+  EXPECT_EQ(1, cache_->size());
+}
+
+/** Data which was read before an invalidation is not stored. */
+TEST_F(DiskObjectCacheTest, StoreAfterInvalidationIsIgnored) {
+  OpenCache(1024 * 1024);
+  uint64_t generation = cache_->GetGeneration();
+  cache_->Invalidate("volume:1");
+  cache_->Store(DiskObjectCache::Key("volume:1", 0, 0, 0),
+                &object_[0], kObjectSize, generation);
+  EXPECT_EQ(0, cache_->size());
+}
+
+}  // namespace xtreemfs
+#endif  // !WIN32
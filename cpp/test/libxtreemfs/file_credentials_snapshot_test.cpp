@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2026 by the XtreemFS Authors, see AUTHORS file
+ *
+ * Licensed under the BSD License, see LICENSE file for details.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <boost/scoped_ptr.hpp>
+#include <boost/shared_ptr.hpp>
+#include <string>
+
+#include "libxtreemfs/file_credentials_snapshot.h"
+#include "pbrpc/RPC.pb.h"
+#include "rpc/client_request.h"
+#include "rpc/client_request_callback_interface.h"
+#include "rpc/record_marker.h"
+#include "xtreemfs/GlobalTypes.pb.h"
+#include "xtreemfs/OSD.pb.h"
+#include "xtreemfs/OSDServiceConstants.h"
+
+using namespace std;
+using namespace xtreemfs::pbrpc;
+
+namespace xtreemfs {
+
+namespace {
+
+class NoOpCallback : public rpc::ClientRequestCallbackInterface {
+ public:
+  virtual void RequestCompleted(rpc::ClientRequest* request) {}
+};
+
+XCap* CreateXCap(uint32_t truncate_epoch) {
+  XCap* xcap = new XCap();
+  xcap->set_access_mode(SYSTEM_V_FCNTL_H_O_RDWR);
+  xcap->set_client_identity("client");
+  xcap->set_expire_time_s(600);
+  xcap->set_expire_timeout_s(3600);
+  xcap->set_file_id("volume:1");
+  xcap->set_replicate_on_close(false);
+  xcap->set_server_signature("signature");
+  xcap->set_truncate_epoch(truncate_epoch);
+  xcap->set_snap_config(SNAP_CONFIG_SNAPS_DISABLED);
+  xcap->set_snap_timestamp(0);
+  return xcap;
+}
+
+XLocSet* CreateXLocSet() {
+  XLocSet* xlocs = new XLocSet();
+  xlocs->set_read_only_file_size(0);
+  xlocs->set_replica_update_policy("");
+  xlocs->set_version(3);
+  Replica* replica = xlocs->add_replicas();
+  replica->add_osd_uuids("osd0");
+  replica->add_osd_uuids("osd1");
+  replica->set_replication_flags(0);
+  replica->mutable_striping_policy()->set_type(STRIPING_POLICY_RAID0);
+  replica->mutable_striping_policy()->set_stripe_size(128);
+  replica->mutable_striping_policy()->set_width(2);
+  return xlocs;
+}
+
+/** Returns a writeRequest without file_credentials. */
+writeRequest CreateWriteRequest() {
+  writeRequest rq;
+  rq.set_file_id("volume:1");
+  rq.set_object_number(7);
+  rq.set_object_version(0);
+  rq.set_offset(512);
+  rq.set_lease_timeout(0);
+  rq.mutable_object_data()->set_checksum(0);
+  rq.mutable_object_data()->set_invalid_checksum_on_osd(false);
+  rq.mutable_object_data()->set_zero_padding(0);
+  return rq;
+}
+
+/** Returns the RPC header and the message of "request" as sent. */
+string GetSentBytes(const rpc::ClientRequest& request) {
+  return string(request.rq_hdr_msg(),
+                rpc::RecordMarker::get_size()
+                    + request.request_marker()->header_len()
+                    + request.request_marker()->message_len());
+}
+
+}  // namespace
+
+class FileCredentialsSnapshotTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    xcap.reset(CreateXCap(1));
+    xlocs.reset(CreateXLocSet());
+    snapshot.reset(new FileCredentialsSnapshot(xcap, xlocs));
+  }
+
+  boost::shared_ptr<const XCap> xcap;
+  boost::shared_ptr<const XLocSet> xlocs;
+  boost::scoped_ptr<FileCredentialsSnapshot> snapshot;
+};
+
+/** The serialized field followed by the request without FileCredentials is
+ *  the complete request. */
+TEST_F(FileCredentialsSnapshotTest, SplicedRequestEqualsSerializedRequest) {
+  writeRequest rq = CreateWriteRequest();
+  string spliced = snapshot->serialized_field() + rq.SerializePartialAsString();
+
+  rq.mutable_file_credentials()->mutable_xcap()->CopyFrom(*xcap);
+  rq.mutable_file_credentials()->mutable_xlocs()->CopyFrom(*xlocs);
+  EXPECT_EQ(rq.SerializeAsString(), spliced);
+
+  writeRequest parsed;
+  ASSERT_TRUE(parsed.ParseFromString(spliced));
+  EXPECT_EQ(xcap->file_id(), parsed.file_credentials().xcap().file_id());
+  EXPECT_EQ(xlocs->version(), parsed.file_credentials().xlocs().version());
+}
+
+/** ClientRequest sends the same bytes whether the FileCredentials are part of
+ *  the message or its prefix. */
+TEST_F(FileCredentialsSnapshotTest, ClientRequestSendsSplicedBytes) {
+  NoOpCallback callback;
+  UserCredentials user_credentials;
+  user_credentials.set_username("xtreemfs");
+  Auth auth;
+  auth.set_auth_type(AUTH_NONE);
+  const char data[] = "data";
+
+  writeRequest rq = CreateWriteRequest();
+  rpc::ClientRequest spliced_request(
+      "localhost:32640", 42, INTERFACE_ID_OSD, PROC_ID_WRITE,
+      user_credentials, auth, &rq, data, sizeof(data), NULL, NULL,
+      &callback, NULL, &snapshot->serialized_field());
+
+  rq.mutable_file_credentials()->mutable_xcap()->CopyFrom(*xcap);
+  rq.mutable_file_credentials()->mutable_xlocs()->CopyFrom(*xlocs);
+  rpc::ClientRequest request(
+      "localhost:32640", 42, INTERFACE_ID_OSD, PROC_ID_WRITE,
+      user_credentials, auth, &rq, data, sizeof(data), NULL, NULL,
+      &callback);
+
+  EXPECT_EQ(static_cast<uint32_t>(rq.ByteSize()),
+            spliced_request.request_marker()->message_len());
+  EXPECT_EQ(GetSentBytes(request), GetSentBytes(spliced_request));
+}
+
+TEST_F(FileCredentialsSnapshotTest, RetriesUseRenewedXCap) {
+  RequestFileCredentials request_credentials(*snapshot);
+  EXPECT_EQ(&snapshot->serialized_field(),
+            &request_credentials.serialized_field());
+
+  // What ExecuteSyncRequest() does before a retry.
+  boost::scoped_ptr<XCap> renewed_xcap(CreateXCap(2));
+  request_credentials.mutable_xcap()->CopyFrom(*renewed_xcap);
+
+  readRequest rq;
+  rq.set_file_id("volume:1");
+  rq.set_object_number(0);
+  rq.set_object_version(0);
+  rq.set_offset(0);
+  rq.set_length(4096);
+  string spliced =
+      request_credentials.serialized_field() + rq.SerializePartialAsString();
+
+  rq.mutable_file_credentials()->mutable_xcap()->CopyFrom(*renewed_xcap);
+  rq.mutable_file_credentials()->mutable_xlocs()->CopyFrom(*xlocs);
+  EXPECT_EQ(rq.SerializeAsString(), spliced);
+}
+
+}  // namespace xtreemfs
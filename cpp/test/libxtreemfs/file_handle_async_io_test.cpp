@@ -0,0 +1,197 @@
+/*
+ * Copyright (c) 2026 by the XtreemFS Authors, see AUTHORS file
+ *
+ * Licensed under the BSD License, see LICENSE file for details.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <boost/scoped_array.hpp>
+#include <boost/thread/condition.hpp>
+#include <boost/thread/mutex.hpp>
+#include <cstring>
+#include <vector>
+
+#include "common/test_environment.h"
+#include "common/test_rpc_server_dir.h"
+#include "common/test_rpc_server_mrc.h"
+#include "common/test_rpc_server_osd.h"
+#include "libxtreemfs/client.h"
+#include "libxtreemfs/file_handle.h"
+#include "libxtreemfs/options.h"
+#include "libxtreemfs/volume.h"
+#include "libxtreemfs/xtreemfs_exception.h"
+#include "xtreemfs/OSDServiceConstants.h"
+
+using namespace std;
+using namespace xtreemfs::pbrpc;
+using namespace xtreemfs::util;
+
+namespace xtreemfs {
+namespace rpc {
+
+/** Remembers the result of an async operation and allows to wait for it. */
+class AsyncIOResult : public FileHandleCallbackInterface {
+ public:
+  AsyncIOResult() : finished_(false), result_(0), failed_(false) {}
+
+  virtual void AsyncIOFinished(int result,
+                               const XtreemFSException* error,
+                               void* context) {
+    boost::mutex::scoped_lock lock(mutex_);
+    finished_ = true;
+    result_ = result;
+    failed_ = error != NULL;
+    finished_cond_.notify_all();
+  }
+
+  /** Waits for the callback and returns the result (-1 on error). */
+  int Wait() {
+    boost::mutex::scoped_lock lock(mutex_);
+    while (!finished_) {
+      finished_cond_.wait(lock);
+    }
+    return failed_ ? -1 : result_;
+  }
+
+ private:
+  boost::mutex mutex_;
+  boost::condition finished_cond_;
+  bool finished_;
+  int result_;
+  bool failed_;
+};
+
+/** Throws something which is not a std::exception after storing the result. */
+class ThrowingAsyncIOResult : public AsyncIOResult {
+ public:
+  virtual void AsyncIOFinished(int result,
+                               const XtreemFSException* error,
+                               void* context) {
+    AsyncIOResult::AsyncIOFinished(result, error, context);
+    throw 42;
+  }
+};
+
+class FileHandleAsyncIOTest : public ::testing::Test {
+ protected:
+  static const int kBlockSize = 1024 * 128;
+
+  virtual void SetUp() {
+    initialize_logger(LEVEL_WARN);
+    test_env.options.connect_timeout_s = 3;
+    test_env.options.request_timeout_s = 3;
+    test_env.options.retry_delay_s = 1;
+    test_env.options.enable_async_writes = false;
+    ASSERT_TRUE(test_env.Start());
+
+    volume = test_env.client->OpenVolume(
+        test_env.volume_name_,
+        NULL,  // No SSL options.
+        test_env.options);
+
+    file = volume->OpenFile(
+        test_env.user_credentials,
+        "/test_file",
+        static_cast<xtreemfs::pbrpc::SYSTEM_V_FCNTL>(
+            xtreemfs::pbrpc::SYSTEM_V_FCNTL_H_O_CREAT |
+            xtreemfs::pbrpc::SYSTEM_V_FCNTL_H_O_TRUNC |
+            xtreemfs::pbrpc::SYSTEM_V_FCNTL_H_O_RDWR));
+  }
+
+  virtual void TearDown() {
+    test_env.Stop();
+  }
+
+  TestEnvironment test_env;
+  Volume* volume;
+  FileHandle* file;
+};
+
+TEST_F(FileHandleAsyncIOTest, WriteAsyncSendsAllObjects) {
+  size_t blocks = 5;
+  size_t buffer_size = kBlockSize * blocks;
+  boost::scoped_array<char> write_buf(new char[buffer_size]());
+
+  AsyncIOResult result;
+  ASSERT_NO_THROW(file->WriteAsync(write_buf.get(), buffer_size, 0,
+                                   &result, NULL));
+  EXPECT_EQ(buffer_size, result.Wait());
+
+  // The objects were sent at once, i.e. their order is undefined.
+  vector<WriteEntry> received = test_env.osds[0]->GetReceivedWrites();
+  ASSERT_EQ(blocks, received.size());
+  for (size_t i = 0; i < blocks; ++i) {
+    EXPECT_NE(received.end(),
+              find(received.begin(), received.end(),
+                   WriteEntry(i, 0, kBlockSize)));
+  }
+
+  ASSERT_NO_THROW(file->Close());
+}
+
+TEST_F(FileHandleAsyncIOTest, ReadAsyncReturnsWrittenData) {
+  size_t blocks = 5;
+  size_t buffer_size = kBlockSize * blocks;
+  boost::scoped_array<char> write_buf(new char[buffer_size]);
+  for (size_t i = 0; i < buffer_size; ++i) {
+    write_buf[i] = static_cast<char>(i % 251);
+  }
+  ASSERT_NO_THROW(file->Write(write_buf.get(), buffer_size, 0));
+
+  boost::scoped_array<char> read_buf(new char[buffer_size]());
+  AsyncIOResult result;
+  ASSERT_NO_THROW(file->ReadAsync(read_buf.get(), buffer_size, 0,
+                                  &result, NULL));
+  EXPECT_EQ(buffer_size, result.Wait());
+  EXPECT_EQ(0, memcmp(write_buf.get(), read_buf.get(), buffer_size));
+
+  ASSERT_NO_THROW(file->Close());
+}
+
+/** A failed object is read again before the callback is executed. */
+TEST_F(FileHandleAsyncIOTest, ReadAsyncRetriesFailedObject) {
+  size_t blocks = 3;
+  size_t buffer_size = kBlockSize * blocks;
+  boost::scoped_array<char> write_buf(new char[buffer_size]);
+  for (size_t i = 0; i < buffer_size; ++i) {
+    write_buf[i] = static_cast<char>(i % 251);
+  }
+  ASSERT_NO_THROW(file->Write(write_buf.get(), buffer_size, 0));
+
+  test_env.osds[0]->AddDropRule(
+      new ProcIDFilterRule(xtreemfs::pbrpc::PROC_ID_READ, new DropNRule(1)));
+
+  boost::scoped_array<char> read_buf(new char[buffer_size]());
+  AsyncIOResult result;
+  ASSERT_NO_THROW(file->ReadAsync(read_buf.get(), buffer_size, 0,
+                                  &result, NULL));
+  EXPECT_EQ(buffer_size, result.Wait());
+  EXPECT_EQ(0, memcmp(write_buf.get(), read_buf.get(), buffer_size));
+
+  ASSERT_NO_THROW(file->Close());
+}
+
+/** A throwing callback neither stops the completion of further operations
+ *  nor leaves the operation pending, i.e. Close() returns. */
+TEST_F(FileHandleAsyncIOTest, ThrowingCallbackCompletesOperation) {
+  size_t buffer_size = kBlockSize;
+  boost::scoped_array<char> write_buf(new char[buffer_size]());
+
+  ThrowingAsyncIOResult throwing_result;
+  ASSERT_NO_THROW(file->WriteAsync(write_buf.get(), buffer_size, 0,
+                                   &throwing_result, NULL));
+  EXPECT_EQ(buffer_size, throwing_result.Wait());
+
+  AsyncIOResult result;
+  ASSERT_NO_THROW(file->WriteAsync(write_buf.get(), buffer_size, 0,
+                                   &result, NULL));
+  EXPECT_EQ(buffer_size, result.Wait());
+
+  ASSERT_NO_THROW(file->Close());
+}
+
+}  // namespace rpc
+}  // namespace xtreemfs
@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2026 by the XtreemFS Authors, see AUTHORS file
+ *
+ * Licensed under the BSD License, see LICENSE file for details.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <boost/bind.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/thread/thread.hpp>
+#include <vector>
+
+#include "libxtreemfs/file_task_queue.h"
+
+using namespace std;
+
+namespace xtreemfs {
+
+TEST(FileTaskQueueTest, ReturnsOnlyDueTasksOrderedByDeadline) {
+  FileTaskQueue queue;
+  boost::posix_time::ptime now = FileTaskQueue::Now();
+
+  queue.Push(FileTaskQueue::Task(now - boost::posix_time::seconds(1),
+                                 FileTaskQueue::kFileSizeUpdate, 2, NULL));
+  queue.Push(FileTaskQueue::Task(now + boost::posix_time::hours(1),
+                                 FileTaskQueue::kXCapRenewal, 3, NULL));
+  queue.Push(FileTaskQueue::Task(now - boost::posix_time::seconds(2),
+                                 FileTaskQueue::kXCapRenewal, 1, NULL));
+
+  vector<FileTaskQueue::Task> due_tasks;
+  queue.WaitForDueTasks(&due_tasks);
+
+  ASSERT_EQ(2, due_tasks.size());
+  EXPECT_EQ(1, due_tasks[0].file_id);
+  EXPECT_EQ(FileTaskQueue::kXCapRenewal, due_tasks[0].type);
+  EXPECT_EQ(2, due_tasks[1].file_id);
+  EXPECT_EQ(FileTaskQueue::kFileSizeUpdate, due_tasks[1].type);
+  EXPECT_EQ(1, queue.size());
+}
+
+TEST(FileTaskQueueTest, WaitsForDeadline) {
+  FileTaskQueue queue;
+  boost::posix_time::ptime deadline
+      = FileTaskQueue::Now() + boost::posix_time::milliseconds(200);
+  queue.Push(FileTaskQueue::Task(deadline,
+                                 FileTaskQueue::kXCapRenewal, 1, NULL));
+
+  vector<FileTaskQueue::Task> due_tasks;
+  queue.WaitForDueTasks(&due_tasks);
+
+  EXPECT_LE(deadline, FileTaskQueue::Now());
+  ASSERT_EQ(1, due_tasks.size());
+  EXPECT_EQ(0, queue.size());
+}
+
+/** A task with an earlier deadline wakes up a waiting thread. */
+TEST(FileTaskQueueTest, EarlierTaskWakesUpWaiter) {
+  FileTaskQueue queue;
+  queue.Push(FileTaskQueue::Task(
+      FileTaskQueue::Now() + boost::posix_time::hours(1),
+      FileTaskQueue::kXCapRenewal, 1, NULL));
+
+  vector<FileTaskQueue::Task> due_tasks;
+  boost::thread waiter(boost::bind(&FileTaskQueue::WaitForDueTasks,
+                                   &queue,
+                                   &due_tasks));
+  boost::this_thread::sleep(boost::posix_time::milliseconds(50));
+  queue.Push(FileTaskQueue::Task(FileTaskQueue::Now(),
+                                 FileTaskQueue::kFileSizeUpdate, 2, NULL));
+
+  ASSERT_TRUE(waiter.timed_join(boost::posix_time::seconds(5)));
+  ASSERT_EQ(1, due_tasks.size());
+  EXPECT_EQ(2, due_tasks[0].file_id);
+}
+
+/** A waiting thread can be interrupted, e.g. when the volume is closed. */
+TEST(FileTaskQueueTest, WaitIsInterruptible) {
+  FileTaskQueue queue;
+  vector<FileTaskQueue::Task> due_tasks;
+  boost::thread waiter(boost::bind(&FileTaskQueue::WaitForDueTasks,
+                                   &queue,
+                                   &due_tasks));
+  waiter.interrupt();
+  EXPECT_TRUE(waiter.timed_join(boost::posix_time::seconds(5)));
+}
+
+}  // namespace xtreemfs
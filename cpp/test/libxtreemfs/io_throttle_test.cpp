@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2026 by the XtreemFS Authors, see AUTHORS file
+ *
+ * Licensed under the BSD License, see LICENSE file for details.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <boost/bind.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/thread/thread.hpp>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "libxtreemfs/io_throttle.h"
+
+using namespace std;
+using namespace xtreemfs;
+using namespace boost::posix_time;
+
+namespace {
+
+/** Executes operations of "bytes" for "key" until "end". */
+void AcquireUntil(IOThrottle* throttle,
+                  const string& key,
+                  size_t bytes,
+                  ptime end) {
+  while (microsec_clock::universal_time() < end) {
+    throttle->Acquire(key, bytes);
+  }
+}
+
+}  // namespace
+
+TEST(IOThrottleTest, ParseWeight) {
+  string key;
+  int weight = 0;
+  EXPECT_TRUE(IOThrottle::ParseWeight("alice=3", &key, &weight));
+  EXPECT_EQ("alice", key);
+  EXPECT_EQ(3, weight);
+
+  EXPECT_FALSE(IOThrottle::ParseWeight("alice", &key, &weight));
+  EXPECT_FALSE(IOThrottle::ParseWeight("=3", &key, &weight));
+  EXPECT_FALSE(IOThrottle::ParseWeight("alice=", &key, &weight));
+  EXPECT_FALSE(IOThrottle::ParseWeight("alice=0", &key, &weight));
+  EXPECT_FALSE(IOThrottle::ParseWeight("alice=x", &key, &weight));
+}
+
+TEST(IOThrottleTest, LimitsBandwidth) {
+  IOThrottle throttle(1000 * 1000, 0, vector<string>());
+
+  ptime start = microsec_clock::universal_time();
+  for (int i = 0; i < 10; i++) {
+    throttle.Acquire("alice", 100 * 1000);
+  }
+  time_duration elapsed = microsec_clock::universal_time() - start;
+  // The first operation is admitted immediately.
+  EXPECT_GE(elapsed.total_milliseconds(), 800);
+  EXPECT_LT(elapsed.total_milliseconds(), 2000);
+
+  map<string, QoSCounters> counters;
+  throttle.GetCounters(&counters);
+  ASSERT_EQ(1, counters.size());
+  EXPECT_EQ(1, counters["alice"].weight);
+  EXPECT_EQ(10, counters["alice"].operations);
+  EXPECT_EQ(1000 * 1000, counters["alice"].bytes);
+  EXPECT_GT(counters["alice"].delayed_operations, 0);
+  EXPECT_GE(counters["alice"].delay_ms, 800);
+}
+
+TEST(IOThrottleTest, SharesLimitByWeight) {
+  vector<string> weights;
+  weights.push_back("alice=3");
+  IOThrottle throttle(0, 400, weights);
+
+  ptime end = microsec_clock::universal_time() + seconds(2);
+  boost::thread alice(boost::bind(&AcquireUntil, &throttle, "alice", 1, end));
+  boost::thread bob(boost::bind(&AcquireUntil, &throttle, "bob", 1, end));
+  alice.join();
+  bob.join();
+
+  map<string, QoSCounters> counters;
+  throttle.GetCounters(&counters);
+  EXPECT_EQ(3, counters["alice"].weight);
+  EXPECT_EQ(1, counters["bob"].weight);
+  uint64_t total = counters["alice"].operations + counters["bob"].operations;
+  EXPECT_GT(total, 600);
+  EXPECT_LT(total, 1000);
+  double ratio = static_cast<double>(counters["alice"].operations)
+                 / counters["bob"].operations;
+  EXPECT_GT(ratio, 2.0);
+  EXPECT_LT(ratio, 4.5);
+}
+
+TEST(IOThrottleTest, ProcessGroupKeysInheritUserWeight) {
+  vector<string> weights;
+  weights.push_back("alice=5");
+  IOThrottle throttle(0, 1000, weights);
+
+  throttle.Acquire("alice:4711", 1);
+  throttle.Acquire("bob:4712", 1);
+
+  map<string, QoSCounters> counters;
+  throttle.GetCounters(&counters);
+  EXPECT_EQ(5, counters["alice:4711"].weight);
+  EXPECT_EQ(1, counters["bob:4712"].weight);
+}
@@ -0,0 +1,228 @@
+/*
+ * Copyright (c) 2026 by the XtreemFS Authors, see AUTHORS file
+ *
+ * Licensed under the BSD License, see LICENSE file for details.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <boost/bind.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/thread/thread.hpp>
+
+#include "libxtreemfs/local_lock_manager.h"
+#include "xtreemfs/OSD.pb.h"
+
+using namespace std;
+using namespace xtreemfs::pbrpc;
+
+namespace xtreemfs {
+
+namespace {
+
+Lock MakeLock(int process_id, uint64_t offset, uint64_t length,
+              bool exclusive) {
+  Lock lock;
+  lock.set_client_uuid("client");
+  lock.set_client_pid(process_id);
+  lock.set_offset(offset);
+  lock.set_length(length);
+  lock.set_exclusive(exclusive);
+  return lock;
+}
+
+/** Acquires "lock" and emulates a successful request to the OSD. */
+LocalLockManager::AcquireResult AcquireLock(LocalLockManager* manager,
+                                            const Lock& lock,
+                                            bool wait_for_lock) {
+  Lock conflicting_lock;
+  LocalLockManager::AcquireResult result = manager->AcquireLock(
+      lock, wait_for_lock, NULL, &conflicting_lock);
+  if (result == LocalLockManager::kAcquireAtOSD) {
+    manager->FinishAcquire(lock, true);
+  }
+  return result;
+}
+
+/** Releases the lock of "process_id" and emulates a successful request to
+ *  the OSD. */
+LocalLockManager::ReleaseResult ReleaseLock(LocalLockManager* manager,
+                                            int process_id) {
+  Lock lock;
+  LocalLockManager::ReleaseResult result
+      = manager->ReleaseLock(process_id, &lock);
+  if (result == LocalLockManager::kReleaseAtOSD) {
+    manager->FinishRelease(process_id, true);
+  }
+  return result;
+}
+
+void AcquireLockAndStoreResult(LocalLockManager* manager,
+                               const Lock& lock,
+                               LocalLockManager::AcquireResult* result) {
+  *result = AcquireLock(manager, lock, true);
+}
+
+void ReleaseLockAndStoreResult(LocalLockManager* manager,
+                               int process_id,
+                               LocalLockManager::ReleaseResult* result) {
+  *result = ReleaseLock(manager, process_id);
+}
+
+}  // namespace
+
+/** Every lock is acquired and released at the OSD unless the process already
+ *  holds it. */
+TEST(LocalLockManagerTest, EveryLockIsHeldAtOSD) {
+  LocalLockManager manager;
+
+  EXPECT_EQ(LocalLockManager::kAcquireAtOSD,
+            AcquireLock(&manager, MakeLock(1, 0, 0, false), false));
+  EXPECT_EQ(LocalLockManager::kAcquireAtOSD,
+            AcquireLock(&manager, MakeLock(2, 10, 5, false), false));
+  EXPECT_EQ(LocalLockManager::kAcquiredLocally,
+            AcquireLock(&manager, MakeLock(2, 10, 5, false), false));
+  EXPECT_EQ(2, manager.size());
+
+  Lock lock;
+  EXPECT_EQ(LocalLockManager::kReleaseAtOSD, manager.ReleaseLock(1, &lock));
+  EXPECT_EQ(1, lock.client_pid());
+  EXPECT_EQ(0, lock.length());
+  manager.FinishRelease(1, true);
+  EXPECT_EQ(LocalLockManager::kNoLockFound, ReleaseLock(&manager, 1));
+  EXPECT_EQ(LocalLockManager::kReleaseAtOSD, ReleaseLock(&manager, 2));
+  EXPECT_EQ(0, manager.size());
+}
+
+/** Disjoint locks and locks of different modes are not merged. */
+TEST(LocalLockManagerTest, LocksAreHeldPerRange) {
+  LocalLockManager manager;
+  Lock conflicting_lock;
+
+  EXPECT_EQ(LocalLockManager::kAcquireAtOSD,
+            AcquireLock(&manager, MakeLock(1, 10, 10, false), false));
+
+  Lock lock = MakeLock(2, 30, 10, true);
+  ASSERT_EQ(LocalLockManager::kAcquireAtOSD,
+            manager.AcquireLock(lock, false, NULL, &conflicting_lock));
+  // A failed request to the OSD does not change the local state.
+  manager.FinishAcquire(lock, false);
+  EXPECT_EQ(1, manager.size());
+  EXPECT_FALSE(manager.CheckIfProcessHasLocks(2));
+
+  EXPECT_EQ(LocalLockManager::kAcquireAtOSD,
+            AcquireLock(&manager, lock, false));
+  ASSERT_TRUE(manager.GetLockOfProcess(1, &lock));
+  EXPECT_EQ(10, lock.offset());
+  EXPECT_EQ(10, lock.length());
+  EXPECT_FALSE(lock.exclusive());
+  ASSERT_TRUE(manager.GetLockOfProcess(2, &lock));
+  EXPECT_EQ(30, lock.offset());
+  EXPECT_EQ(10, lock.length());
+  EXPECT_TRUE(lock.exclusive());
+
+  // Releasing one of them does not affect the other.
+  EXPECT_EQ(LocalLockManager::kReleaseAtOSD, ReleaseLock(&manager, 2));
+  EXPECT_TRUE(manager.CheckIfProcessHasLocks(1));
+}
+
+TEST(LocalLockManagerTest, LocalConflict) {
+  LocalLockManager manager;
+
+  EXPECT_EQ(LocalLockManager::kAcquireAtOSD,
+            AcquireLock(&manager, MakeLock(1, 0, 10, true), false));
+
+  Lock conflicting_lock;
+  EXPECT_EQ(LocalLockManager::kConflict,
+            manager.AcquireLock(MakeLock(2, 5, 10, false), false, NULL,
+                                &conflicting_lock));
+  EXPECT_EQ(1, conflicting_lock.client_pid());
+
+  // A process may replace its own lock.
+  EXPECT_EQ(LocalLockManager::kAcquireAtOSD,
+            AcquireLock(&manager, MakeLock(1, 0, 5, true), false));
+  EXPECT_EQ(1, manager.size());
+
+  // Shared locks do not conflict.
+  EXPECT_EQ(LocalLockManager::kAcquireAtOSD,
+            AcquireLock(&manager, MakeLock(2, 10, 0, false), false));
+  EXPECT_EQ(LocalLockManager::kAcquireAtOSD,
+            AcquireLock(&manager, MakeLock(3, 20, 0, false), false));
+}
+
+/** A waiting process is woken up as soon as the conflicting lock is
+ *  released. */
+TEST(LocalLockManagerTest, ReleaseWakesUpWaiter) {
+  LocalLockManager manager;
+
+  EXPECT_EQ(LocalLockManager::kAcquireAtOSD,
+            AcquireLock(&manager, MakeLock(3, 100, 10, false), false));
+  EXPECT_EQ(LocalLockManager::kAcquireAtOSD,
+            AcquireLock(&manager, MakeLock(1, 0, 10, true), false));
+
+  LocalLockManager::AcquireResult result = LocalLockManager::kConflict;
+  boost::thread waiter(boost::bind(&AcquireLockAndStoreResult,
+                                   &manager,
+                                   MakeLock(2, 0, 10, true),
+                                   &result));
+  EXPECT_FALSE(waiter.timed_join(boost::posix_time::milliseconds(200)));
+
+  boost::posix_time::ptime start
+      = boost::posix_time::microsec_clock::universal_time();
+  EXPECT_EQ(LocalLockManager::kReleaseAtOSD, ReleaseLock(&manager, 1));
+  ASSERT_TRUE(waiter.timed_join(boost::posix_time::seconds(5)));
+  EXPECT_GT(boost::posix_time::seconds(1),
+            boost::posix_time::microsec_clock::universal_time() - start);
+
+  EXPECT_EQ(LocalLockManager::kAcquireAtOSD, result);
+  EXPECT_TRUE(manager.CheckIfProcessHasLocks(2));
+}
+
+/** Locks which are being acquired or released at the OSD conflict with the
+ *  locks of other processes. */
+TEST(LocalLockManagerTest, PendingLocksConflict) {
+  LocalLockManager manager;
+  Lock lock = MakeLock(1, 0, 10, true);
+  Lock conflicting_lock;
+  ASSERT_EQ(LocalLockManager::kAcquireAtOSD,
+            manager.AcquireLock(lock, false, NULL, &conflicting_lock));
+
+  EXPECT_EQ(LocalLockManager::kConflict,
+            manager.AcquireLock(MakeLock(2, 5, 1, false), false, NULL,
+                                &conflicting_lock));
+  EXPECT_EQ(1, conflicting_lock.client_pid());
+  manager.FinishAcquire(lock, true);
+
+  ASSERT_EQ(LocalLockManager::kReleaseAtOSD, manager.ReleaseLock(1, &lock));
+  EXPECT_EQ(LocalLockManager::kConflict,
+            manager.AcquireLock(MakeLock(2, 5, 1, false), false, NULL,
+                                &conflicting_lock));
+  manager.FinishRelease(1, true);
+
+  EXPECT_EQ(LocalLockManager::kAcquireAtOSD,
+            AcquireLock(&manager, MakeLock(2, 5, 1, false), false));
+}
+
+/** A release waits for a pending acquisition of the same process. */
+TEST(LocalLockManagerTest, ReleaseWaitsForPendingAcquisition) {
+  LocalLockManager manager;
+  Lock lock = MakeLock(1, 20, 10, false);
+  Lock conflicting_lock;
+  ASSERT_EQ(LocalLockManager::kAcquireAtOSD,
+            manager.AcquireLock(lock, false, NULL, &conflicting_lock));
+
+  LocalLockManager::ReleaseResult result = LocalLockManager::kNoLockFound;
+  boost::thread releaser(boost::bind(&ReleaseLockAndStoreResult,
+                                     &manager,
+                                     1,
+                                     &result));
+  EXPECT_FALSE(releaser.timed_join(boost::posix_time::milliseconds(200)));
+
+  manager.FinishAcquire(lock, true);
+  ASSERT_TRUE(releaser.timed_join(boost::posix_time::seconds(5)));
+  EXPECT_EQ(LocalLockManager::kReleaseAtOSD, result);
+  EXPECT_EQ(0, manager.size());
+}
+
+}  // namespace xtreemfs
@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2026 by the XtreemFS Authors, see AUTHORS file
+ *
+ * Licensed under the BSD License, see LICENSE file for details.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <boost/scoped_array.hpp>
+#include <cstring>
+#include <vector>
+
+#include "common/test_environment.h"
+#include "common/test_rpc_server_osd.h"
+#include "libxtreemfs/client.h"
+#include "libxtreemfs/file_handle.h"
+#include "libxtreemfs/options.h"
+#include "libxtreemfs/volume.h"
+#include "libxtreemfs/xtreemfs_exception.h"
+#include "util/crc32c.h"
+#include "util/logging.h"
+
+using namespace std;
+using namespace xtreemfs::pbrpc;
+using namespace xtreemfs::util;
+
+namespace xtreemfs {
+namespace rpc {
+
+class ObjectChecksumTest : public ::testing::Test {
+ protected:
+  static const int kBlockSize = 1024 * 128;
+
+  virtual void SetUp() {
+    initialize_logger(LEVEL_WARN);
+    test_env.options.connect_timeout_s = 3;
+    test_env.options.request_timeout_s = 3;
+    test_env.options.retry_delay_s = 1;
+    test_env.options.max_read_tries = 3;
+    test_env.options.enable_async_writes = false;
+    test_env.options.object_checksums = true;
+    ASSERT_TRUE(test_env.Start());
+    test_env.osds[0]->SetReturnChecksums(true);
+
+    volume = test_env.client->OpenVolume(
+        test_env.volume_name_,
+        NULL,  // No SSL options.
+        test_env.options);
+
+    file = volume->OpenFile(
+        test_env.user_credentials,
+        "/test_file",
+        static_cast<xtreemfs::pbrpc::SYSTEM_V_FCNTL>(
+            xtreemfs::pbrpc::SYSTEM_V_FCNTL_H_O_CREAT |
+            xtreemfs::pbrpc::SYSTEM_V_FCNTL_H_O_TRUNC |
+            xtreemfs::pbrpc::SYSTEM_V_FCNTL_H_O_RDWR));
+
+    buffer_size = kBlockSize * 2;
+    write_buf.reset(new char[buffer_size]);
+    for (size_t i = 0; i < buffer_size; ++i) {
+      write_buf[i] = static_cast<char>(i % 251);
+    }
+  }
+
+  virtual void TearDown() {
+    test_env.Stop();
+  }
+
+  TestEnvironment test_env;
+  Volume* volume;
+  FileHandle* file;
+  size_t buffer_size;
+  boost::scoped_array<char> write_buf;
+};
+
+TEST_F(ObjectChecksumTest, WritesSendChecksums) {
+  ASSERT_NO_THROW(file->Write(write_buf.get(), buffer_size, 0));
+
+  vector<WriteEntry> received = test_env.osds[0]->GetReceivedWrites();
+  ASSERT_EQ(2, received.size());
+  for (size_t i = 0; i < received.size(); ++i) {
+    EXPECT_EQ(CRC32C(write_buf.get() + received[i].object_number_ * kBlockSize,
+                     kBlockSize),
+              received[i].checksum_);
+  }
+
+  ASSERT_NO_THROW(file->Close());
+}
+
+/** Data with a wrong checksum is read again. */
+TEST_F(ObjectChecksumTest, CorruptedReadIsRetried) {
+  ASSERT_NO_THROW(file->Write(write_buf.get(), buffer_size, 0));
+  test_env.osds[0]->CorruptNextReads(1);
+
+  boost::scoped_array<char> read_buf(new char[buffer_size]());
+  EXPECT_EQ(buffer_size, file->Read(read_buf.get(), buffer_size, 0));
+  EXPECT_EQ(0, memcmp(write_buf.get(), read_buf.get(), buffer_size));
+
+  ASSERT_NO_THROW(file->Close());
+}
+
+TEST_F(ObjectChecksumTest, ReadFailsIfDataStaysCorrupted) {
+  ASSERT_NO_THROW(file->Write(write_buf.get(), buffer_size, 0));
+  test_env.osds[0]->CorruptNextReads(3);
+
+  boost::scoped_array<char> read_buf(new char[buffer_size]());
+  EXPECT_THROW(file->Read(read_buf.get(), kBlockSize, 0),
+               PosixErrorException);
+
+  ASSERT_NO_THROW(file->Close());
+}
+
+/** Without a limit of read attempts, the single replica is read twice. */
+TEST_F(ObjectChecksumTest, UnlimitedReadTriesStopAtWrongChecksum) {
+  ASSERT_NO_THROW(file->Write(write_buf.get(), buffer_size, 0));
+  ASSERT_NO_THROW(file->Close());
+
+  Options options = test_env.options;
+  options.max_read_tries = 0;
+  Volume* unlimited_volume = test_env.client->OpenVolume(
+      test_env.volume_name_, NULL, options);
+  file = unlimited_volume->OpenFile(
+      test_env.user_credentials,
+      "/test_file",
+      xtreemfs::pbrpc::SYSTEM_V_FCNTL_H_O_RDONLY);
+  test_env.osds[0]->CorruptNextReads(3);
+
+  boost::scoped_array<char> read_buf(new char[buffer_size]());
+  try {
+    file->Read(read_buf.get(), kBlockSize, 0);
+    ADD_FAILURE() << "The corrupted object was returned.";
+  } catch (const PosixErrorException& e) {
+    EXPECT_EQ(POSIX_ERROR_EIO, e.posix_errno());
+  }
+
+  // Only one of the two reads of the next attempt is corrupted.
+  EXPECT_EQ(static_cast<int>(kBlockSize),
+            file->Read(read_buf.get(), kBlockSize, 0));
+  EXPECT_EQ(0, memcmp(write_buf.get(), read_buf.get(), kBlockSize));
+
+  ASSERT_NO_THROW(file->Close());
+}
+
+}  // namespace rpc
+}  // namespace xtreemfs
@@ -0,0 +1,207 @@
+/*
+ * Copyright (c) 2026 by the XtreemFS Authors, see AUTHORS file
+ *
+ * Licensed under the BSD License, see LICENSE file for details.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <boost/bind.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/thread/thread.hpp>
+#include <iostream>
+#include <vector>
+
+#include "libxtreemfs/open_file_table.h"
+
+using namespace std;
+
+namespace xtreemfs {
+
+namespace {
+
+/** The table never dereferences the stored pointers. */
+FileInfo* FakeFileInfo(uint64_t file_id) {
+  return reinterpret_cast<FileInfo*>(static_cast<uintptr_t>(file_id + 1) * 8);
+}
+
+void CountFileInfo(int* count, FileInfo* file_info) {
+  (*count)++;
+}
+
+/** Counts the FileInfos which are no FakeFileInfo() of the files 0 ..
+ *  max_file_id - 1. */
+void CheckFileInfo(uint64_t max_file_id, int* invalid, FileInfo* file_info) {
+  uintptr_t value = reinterpret_cast<uintptr_t>(file_info);
+  if (value % 8 != 0 || value == 0 || value / 8 > max_file_id) {
+    (*invalid)++;
+  }
+}
+
+/** Visits all files until "stop" is set. */
+void VisitFiles(OpenFileTable* table,
+                uint64_t max_file_id,
+                int* invalid,
+                boost::mutex* stop_mutex,
+                bool* stop) {
+  for (;;) {
+    table->ForEach(boost::bind(&CheckFileInfo, max_file_id, invalid, _1));
+    boost::mutex::scoped_lock lock(*stop_mutex);
+    if (*stop) {
+      return;
+    }
+  }
+}
+
+/** Emulates the accesses of VolumeImplementation's open and close of the
+ *  files first_file_id .. first_file_id + files - 1. */
+void OpenAndCloseFiles(OpenFileTable* table,
+                       uint64_t first_file_id,
+                       int files,
+                       int iterations) {
+  for (int i = 0; i < iterations; i++) {
+    uint64_t file_id = first_file_id + (i % files);
+    {
+      // Open: get or create the FileInfo.
+      boost::mutex::scoped_lock lock(table->GetMutex(file_id));
+      if (table->FindUnmutexed(file_id) == NULL) {
+        table->InsertUnmutexed(file_id, FakeFileInfo(file_id));
+      }
+    }
+    {
+      // Close: remove the FileInfo of the last file handle.
+      boost::mutex::scoped_lock lock(table->GetMutex(file_id));
+      table->EraseUnmutexed(file_id);
+    }
+  }
+}
+
+/** Returns the open and close operations per second of "threads" threads. */
+double MeasureOpenCloseThroughput(size_t number_of_shards, int threads) {
+  const int kFilesPerThread = 1000;
+  const int kIterationsPerThread = 200000;
+
+  OpenFileTable table(number_of_shards);
+  boost::posix_time::ptime start
+      = boost::posix_time::microsec_clock::universal_time();
+  vector<boost::thread*> workers;
+  for (int i = 0; i < threads; i++) {
+    workers.push_back(new boost::thread(boost::bind(
+        &OpenAndCloseFiles,
+        &table,
+        static_cast<uint64_t>(i) * kFilesPerThread,
+        kFilesPerThread,
+        kIterationsPerThread)));
+  }
+  for (int i = 0; i < threads; i++) {
+    workers[i]->join();
+    delete workers[i];
+  }
+  boost::posix_time::time_duration duration
+      = boost::posix_time::microsec_clock::universal_time() - start;
+
+  EXPECT_EQ(0, table.size());
+  return 2.0 * threads * kIterationsPerThread * 1000000
+      / (duration.total_microseconds() + 1);
+}
+
+}  // namespace
+
+TEST(OpenFileTableTest, InsertFindErase) {
+  OpenFileTable table(OpenFileTable::kDefaultNumberOfShards);
+
+  for (uint64_t file_id = 0; file_id < 1000; file_id++) {
+    boost::mutex::scoped_lock lock(table.GetMutex(file_id));
+    EXPECT_EQ(NULL, table.FindUnmutexed(file_id));
+    table.InsertUnmutexed(file_id, FakeFileInfo(file_id));
+  }
+  EXPECT_EQ(1000, table.size());
+
+  for (uint64_t file_id = 0; file_id < 1000; file_id++) {
+    boost::mutex::scoped_lock lock(table.GetMutex(file_id));
+    EXPECT_EQ(FakeFileInfo(file_id), table.FindUnmutexed(file_id));
+  }
+
+  {
+    boost::mutex::scoped_lock lock(table.GetMutex(10));
+    EXPECT_TRUE(table.EraseUnmutexed(10));
+    EXPECT_FALSE(table.EraseUnmutexed(10));
+    EXPECT_EQ(NULL, table.FindUnmutexed(10));
+  }
+  EXPECT_EQ(999, table.size());
+}
+
+TEST(OpenFileTableTest, ForEachVisitsAllFiles) {
+  OpenFileTable table(7);
+  for (uint64_t file_id = 100; file_id < 150; file_id++) {
+    boost::mutex::scoped_lock lock(table.GetMutex(file_id));
+    table.InsertUnmutexed(file_id, FakeFileInfo(file_id));
+  }
+
+  int count = 0;
+  table.ForEach(boost::bind(&CountFileInfo, &count, _1));
+  EXPECT_EQ(50, count);
+}
+
+/** Threads open and close files of all shards while another thread iterates
+ *  over the table. */
+TEST(OpenFileTableTest, ConcurrentInsertEraseForEach) {
+  const int kThreads = 4;
+  const int kFilesPerThread = 50;
+  const uint64_t kFiles = kThreads * kFilesPerThread;
+  OpenFileTable table(7);
+
+  int invalid = 0;
+  boost::mutex stop_mutex;
+  bool stop = false;
+  boost::thread visitor(boost::bind(
+      &VisitFiles, &table, kFiles, &invalid, &stop_mutex, &stop));
+  vector<boost::thread*> workers;
+  for (int i = 0; i < kThreads; i++) {
+    workers.push_back(new boost::thread(boost::bind(
+        &OpenAndCloseFiles,
+        &table,
+        static_cast<uint64_t>(i) * kFilesPerThread,
+        kFilesPerThread,
+        2000)));
+  }
+  for (int i = 0; i < kThreads; i++) {
+    workers[i]->join();
+    delete workers[i];
+  }
+  {
+    boost::mutex::scoped_lock lock(stop_mutex);
+    stop = true;
+  }
+  visitor.join();
+  EXPECT_EQ(0, invalid);
+  EXPECT_EQ(0, table.size());
+
+  for (uint64_t file_id = 0; file_id < kFiles; file_id++) {
+    boost::mutex::scoped_lock lock(table.GetMutex(file_id));
+    table.InsertUnmutexed(file_id, FakeFileInfo(file_id));
+  }
+  int count = 0;
+  table.ForEach(boost::bind(&CountFileInfo, &count, _1));
+  EXPECT_EQ(kFiles, count);
+}
+
+/** Compares the open/close throughput of a single locked table with the
+ *  sharded table. Only reports the results as they depend on the machine,
+ *  run it with --gtest_also_run_disabled_tests. */
+TEST(OpenFileTableTest, DISABLED_ConcurrentOpenCloseThroughput) {
+  int threads = std::max(4u, boost::thread::hardware_concurrency());
+
+  double single_lock = MeasureOpenCloseThroughput(1, threads);
+  double sharded = MeasureOpenCloseThroughput(
+      OpenFileTable::kDefaultNumberOfShards, threads);
+
+  cout << "Open/close operations per second with " << threads << " threads:"
+       << " single lock: " << static_cast<uint64_t>(single_lock)
+       << ", " << OpenFileTable::kDefaultNumberOfShards << " shards: "
+       << static_cast<uint64_t>(sharded) << endl;
+}
+
+}  // namespace xtreemfs
@@ -0,0 +1,176 @@
+/*
+ * Copyright (c) 2026 by the XtreemFS Authors, see AUTHORS file
+ *
+ * Licensed under the BSD License, see LICENSE file for details.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/thread/thread.hpp>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "libxtreemfs/execute_sync_request.h"
+#include "libxtreemfs/osd_endpoint_table.h"
+#include "libxtreemfs/uuid_resolver.h"
+#include "libxtreemfs/xtreemfs_exception.h"
+#include "util/logging.h"
+#include "xtreemfs/GlobalTypes.pb.h"
+
+using namespace std;
+using namespace xtreemfs::pbrpc;
+using namespace xtreemfs::util;
+
+namespace xtreemfs {
+
+namespace {
+
+/** Resolves "<uuid>" to "<uuid>.example.com:32640" and counts the calls. */
+class CountingUUIDResolver : public UUIDResolver {
+ public:
+  CountingUUIDResolver() : fail_(false) {}
+
+  virtual void UUIDToAddress(const std::string& uuid, std::string* address) {
+    Resolve(uuid, address);
+  }
+
+  virtual void UUIDToAddressWithOptions(const std::string& uuid,
+                                        std::string* address,
+                                        const RPCOptions& options) {
+    Resolve(uuid, address);
+  }
+
+  virtual void VolumeNameToMRCUUID(const std::string& volume_name,
+                                   std::string* mrc_uuid) {
+    *mrc_uuid = "mrc";
+  }
+
+  virtual void VolumeNameToMRCUUID(const std::string& volume_name,
+                                   SimpleUUIDIterator* uuid_iterator) {}
+
+  virtual std::vector<std::string> VolumeNameToMRCUUIDs(
+      const std::string& volume_name) {
+    return vector<string>(1, "mrc");
+  }
+
+  map<string, int> calls_;
+  bool fail_;
+
+ private:
+  void Resolve(const std::string& uuid, std::string* address) {
+    calls_[uuid]++;
+    if (fail_) {
+      throw AddressToUUIDNotFoundException(uuid);
+    }
+    *address = uuid + ".example.com:32640";
+  }
+};
+
+RPCOptions CreateRPCOptions() {
+  return RPCOptions(1, 0, false, NULL);
+}
+
+}  // namespace
+
+class OSDEndpointTableTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    initialize_logger(LEVEL_WARN);
+
+    // Two striped replicas which share the OSD "osd2".
+    Replica* replica = xlocs_.add_replicas();
+    replica->add_osd_uuids("osd0");
+    replica->add_osd_uuids("osd1");
+    replica->add_osd_uuids("osd2");
+    replica = xlocs_.add_replicas();
+    replica->add_osd_uuids("osd2");
+    replica->add_osd_uuids("osd3");
+  }
+
+  virtual void TearDown() {
+    shutdown_logger();
+  }
+
+  XLocSet xlocs_;
+  CountingUUIDResolver resolver_;
+};
+
+TEST_F(OSDEndpointTableTest, IndexedByReplicaAndPosition) {
+  OSDEndpointTable table(xlocs_, &resolver_);
+  ASSERT_EQ(2, table.replica_count());
+  EXPECT_EQ(3, table.osd_count(0));
+  EXPECT_EQ(2, table.osd_count(1));
+  EXPECT_EQ("osd1", table.GetUUID(0, 1));
+  EXPECT_EQ("osd3", table.GetUUID(1, 1));
+
+  string address;
+  table.GetAddress(1, 1, &address, CreateRPCOptions());
+  EXPECT_EQ("osd3.example.com:32640", address);
+}
+
+/** Every OSD is resolved once, no matter how it is looked up. */
+TEST_F(OSDEndpointTableTest, ResolvesOnFirstUseOnly) {
+  OSDEndpointTable table(xlocs_, &resolver_);
+  EXPECT_TRUE(resolver_.calls_.empty());
+
+  string address;
+  for (int i = 0; i < 10; i++) {
+    table.GetAddress(0, 2, &address, CreateRPCOptions());
+    table.GetAddress(1, 0, &address, CreateRPCOptions());
+    table.UUIDToAddressWithOptions("osd2", &address, CreateRPCOptions());
+    table.UUIDToAddress("osd2", &address);
+  }
+  EXPECT_EQ("osd2.example.com:32640", address);
+  EXPECT_EQ(1, resolver_.calls_["osd2"]);
+  EXPECT_EQ(0, resolver_.calls_.count("osd0"));
+}
+
+/** UUIDs which are not part of the XLocSet are passed to the resolver. */
+TEST_F(OSDEndpointTableTest, UnknownUUIDsArePassedOn) {
+  OSDEndpointTable table(xlocs_, &resolver_);
+  string address;
+  table.UUIDToAddressWithOptions("osd9", &address, CreateRPCOptions());
+  table.UUIDToAddressWithOptions("osd9", &address, CreateRPCOptions());
+  EXPECT_EQ("osd9.example.com:32640", address);
+  EXPECT_EQ(2, resolver_.calls_["osd9"]);
+
+  string mrc_uuid;
+  table.VolumeNameToMRCUUID("volume", &mrc_uuid);
+  EXPECT_EQ("mrc", mrc_uuid);
+}
+
+TEST_F(OSDEndpointTableTest, ResolveErrorsArePassedOn) {
+  OSDEndpointTable table(xlocs_, &resolver_);
+  resolver_.fail_ = true;
+  string address;
+  EXPECT_THROW(table.GetAddress(0, 0, &address, CreateRPCOptions()),
+               AddressToUUIDNotFoundException);
+
+  // The error is not cached.
+  resolver_.fail_ = false;
+  table.GetAddress(0, 0, &address, CreateRPCOptions());
+  EXPECT_EQ("osd0.example.com:32640", address);
+  EXPECT_EQ(2, resolver_.calls_["osd0"]);
+}
+
+/** A failed refresh keeps the previous address and is not repeated by every
+ *  lookup. */
+TEST_F(OSDEndpointTableTest, FailedRefreshIsAttemptedOncePerInterval) {
+  OSDEndpointTable table(xlocs_, &resolver_, 1);
+  string address;
+  table.GetAddress(0, 0, &address, CreateRPCOptions());
+  EXPECT_EQ(1, resolver_.calls_["osd0"]);
+
+  boost::this_thread::sleep(boost::posix_time::milliseconds(2100));
+  resolver_.fail_ = true;
+  for (int i = 0; i < 10; i++) {
+    table.GetAddress(0, 0, &address, CreateRPCOptions());
+    EXPECT_EQ("osd0.example.com:32640", address);
+  }
+  EXPECT_EQ(2, resolver_.calls_["osd0"]);
+}
+
+}  // namespace xtreemfs
@@ -0,0 +1,187 @@
+/*
+ * Copyright (c) 2026 by the XtreemFS Authors, see AUTHORS file
+ *
+ * Licensed under the BSD License, see LICENSE file for details.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <boost/bind.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/scoped_array.hpp>
+#include <boost/thread/thread.hpp>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "common/drop_rules.h"
+#include "common/test_environment.h"
+#include "common/test_rpc_server_osd.h"
+#include "libxtreemfs/client_implementation.h"
+#include "libxtreemfs/file_handle.h"
+#include "libxtreemfs/options.h"
+#include "libxtreemfs/osd_health_registry.h"
+#include "libxtreemfs/volume.h"
+#include "libxtreemfs/xtreemfs_exception.h"
+#include "util/logging.h"
+#include "xtreemfs/OSDServiceConstants.h"
+
+using namespace std;
+using namespace xtreemfs::pbrpc;
+using namespace xtreemfs::util;
+
+namespace xtreemfs {
+namespace rpc {
+
+namespace {
+
+void WriteAndCatchInterruption(FileHandle* file,
+                               const char* buffer,
+                               size_t count,
+                               bool* interrupted) {
+  try {
+    file->Write(buffer, count, 0);
+  } catch (const boost::thread_interrupted&) {
+    *interrupted = true;
+  }
+}
+
+}  // namespace
+
+/** Synchronous writes to a file striped over two OSDs. */
+class StripedWriteTest : public ::testing::Test {
+ protected:
+  static const int kObjectSize = 128 * 1024;
+
+  virtual void SetUp() {
+    initialize_logger(LEVEL_WARN);
+    test_env.AddOSDs(2);
+    test_env.options.connect_timeout_s = 2;
+    test_env.options.request_timeout_s = 2;
+    test_env.options.retry_delay_s = 0;
+    test_env.options.max_write_tries = 2;
+    test_env.options.enable_async_writes = false;
+    // Do not re-admit OSDs during the test.
+    test_env.options.osd_health_probe_interval_s = 3600;
+    test_env.options.osd_health_failure_threshold = 2;
+    ASSERT_TRUE(test_env.Start());
+
+    volume = test_env.client->OpenVolume(
+        test_env.volume_name_,
+        NULL,  // No SSL options.
+        test_env.options);
+
+    file = volume->OpenFile(
+        test_env.user_credentials,
+        "/test_file",
+        static_cast<xtreemfs::pbrpc::SYSTEM_V_FCNTL>(
+            xtreemfs::pbrpc::SYSTEM_V_FCNTL_H_O_CREAT |
+            xtreemfs::pbrpc::SYSTEM_V_FCNTL_H_O_TRUNC |
+            xtreemfs::pbrpc::SYSTEM_V_FCNTL_H_O_RDWR));
+
+    // One object per OSD.
+    buffer_size = kObjectSize * 2;
+    write_buf.reset(new char[buffer_size]());
+  }
+
+  virtual void TearDown() {
+    test_env.Stop();
+  }
+
+  /** Returns the number of writes "osd" received, including dropped ones. */
+  int CountWrites(TestRPCServerOSD* osd) {
+    vector<uint32_t> proc_ids = osd->GetReceivedProcIDs();
+    return static_cast<int>(count(proc_ids.begin(), proc_ids.end(),
+                                  static_cast<uint32_t>(PROC_ID_WRITE)));
+  }
+
+  OSDHealthRegistry* GetHealthRegistry() {
+    ClientImplementation* client =
+        dynamic_cast<ClientImplementation*>(test_env.client.get());
+    return client->GetOSDHealthRegistry();
+  }
+
+  TestEnvironment test_env;
+  Volume* volume;
+  FileHandle* file;
+  size_t buffer_size;
+  boost::scoped_array<char> write_buf;
+};
+
+TEST_F(StripedWriteTest, WritesToAllOSDs) {
+  EXPECT_EQ(buffer_size, file->Write(write_buf.get(), buffer_size, 0));
+
+  ASSERT_EQ(1, test_env.osds[0]->GetReceivedWrites().size());
+  EXPECT_EQ(0, test_env.osds[0]->GetReceivedWrites()[0].object_number_);
+  ASSERT_EQ(1, test_env.osds[1]->GetReceivedWrites().size());
+  EXPECT_EQ(1, test_env.osds[1]->GetReceivedWrites()[0].object_number_);
+
+  ASSERT_NO_THROW(file->Close());
+}
+
+/** A failed first attempt counts as failure of the OSD, like its retry, and
+ *  as one of the max_write_tries attempts. */
+TEST_F(StripedWriteTest, FailedFirstAttemptIsReportedToHealthRegistry) {
+  // Drop the parallel first attempt and the sequential retry.
+  test_env.osds[0]->AddDropRule(
+      new ProcIDFilterRule(PROC_ID_WRITE, new DropNRule(2)));
+
+  EXPECT_THROW(file->Write(write_buf.get(), buffer_size, 0), IOException);
+  EXPECT_EQ(2, CountWrites(test_env.osds[0]));
+
+  // Two failures reach the threshold.
+  EXPECT_TRUE(GetHealthRegistry()->IsDead(test_env.osds[0]->GetAddress()));
+  EXPECT_FALSE(GetHealthRegistry()->IsDead(test_env.osds[1]->GetAddress()));
+  EXPECT_EQ(1, test_env.osds[1]->GetReceivedWrites().size());
+
+  ASSERT_NO_THROW(file->Close());
+}
+
+/** Errors other than timeouts or internal server errors are not retried. */
+TEST_F(StripedWriteTest, PosixErrorIsNotRetried) {
+  test_env.osds[0]->FailNextRequests(PROC_ID_WRITE, 1, POSIX_ERROR_ENOSPC);
+
+  try {
+    file->Write(write_buf.get(), buffer_size, 0);
+    FAIL() << "The write did not fail.";
+  } catch (const PosixErrorException& e) {
+    EXPECT_EQ(POSIX_ERROR_ENOSPC, e.posix_errno());
+  }
+  EXPECT_EQ(1, CountWrites(test_env.osds[0]));
+  EXPECT_FALSE(GetHealthRegistry()->IsDead(test_env.osds[0]->GetAddress()));
+
+  ASSERT_NO_THROW(file->Close());
+}
+
+/** An interrupted write returns only after all requests, which reference the
+ *  caller's buffer, were completed. */
+TEST_F(StripedWriteTest, InterruptedWriteWaitsForOutstandingRequests) {
+  // The request to the first OSD does not complete before the timeout.
+  test_env.osds[0]->AddDropRule(
+      new ProcIDFilterRule(PROC_ID_WRITE, new DropNRule(1)));
+
+  bool interrupted = false;
+  boost::posix_time::ptime start =
+      boost::posix_time::microsec_clock::local_time();
+  boost::thread writer(boost::bind(&WriteAndCatchInterruption,
+                                   file,
+                                   write_buf.get(),
+                                   buffer_size,
+                                   &interrupted));
+  boost::this_thread::sleep(boost::posix_time::milliseconds(200));
+  writer.interrupt();
+  writer.join();
+  boost::posix_time::time_duration elapsed =
+      boost::posix_time::microsec_clock::local_time() - start;
+
+  EXPECT_TRUE(interrupted);
+  EXPECT_GE(elapsed.total_milliseconds(),
+            test_env.options.request_timeout_s * 1000 - 500);
+  EXPECT_EQ(1, test_env.osds[1]->GetReceivedWrites().size());
+
+  ASSERT_NO_THROW(file->Close());
+}
+
+}  // namespace rpc
+}  // namespace xtreemfs
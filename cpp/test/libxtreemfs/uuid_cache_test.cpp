@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2026 by the XtreemFS Authors, see AUTHORS file
+ *
+ * Licensed under the BSD License, see LICENSE file for details.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <time.h>
+
+#include <boost/atomic.hpp>
+#include <boost/bind.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/thread/thread.hpp>
+#include <string>
+#include <vector>
+
+#include "libxtreemfs/uuid_cache.h"
+#include "util/logging.h"
+
+using namespace std;
+using namespace xtreemfs::util;
+
+namespace xtreemfs {
+
+namespace {
+
+UUIDCache::UUIDMapping CreateMapping(const string& uuid,
+                                     const string& address,
+                                     uint32_t port,
+                                     time_t timeout) {
+  UUIDCache::UUIDMapping mapping;
+  mapping.uuid = uuid;
+  mapping.address = address;
+  mapping.port = port;
+  mapping.timeout = timeout;
+  return mapping;
+}
+
+void LookUpUntilStopped(UUIDCache* cache,
+                        boost::atomic<bool>* stop,
+                        boost::atomic<int>* errors) {
+  while (!stop->load()) {
+    if (cache->get("osd0") != "osd0.example.com:32640") {
+      errors->fetch_add(1);
+    }
+  }
+}
+
+}  // namespace
+
+class UUIDCacheTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    initialize_logger(LEVEL_WARN);
+  }
+
+  virtual void TearDown() {
+    shutdown_logger();
+  }
+
+  UUIDCache cache_;
+};
+
+TEST_F(UUIDCacheTest, UpdateAndGet) {
+  EXPECT_EQ("", cache_.get("osd0"));
+  cache_.update("osd0", "osd0.example.com", 32640, 3600);
+  EXPECT_EQ("osd0.example.com:32640", cache_.get("osd0"));
+
+  cache_.update("osd0", "osd0.new.example.com", 32641, 3600);
+  EXPECT_EQ("osd0.new.example.com:32641", cache_.get("osd0"));
+}
+
+TEST_F(UUIDCacheTest, ExpiredMappingsAreNotReturned) {
+  vector<UUIDCache::UUIDMapping> mappings;
+  mappings.push_back(
+      CreateMapping("osd0", "osd0.example.com", 32640, time(NULL) - 1));
+  mappings.push_back(
+      CreateMapping("osd1", "osd1.example.com", 32640, time(NULL) + 3600));
+  cache_.Update(mappings);
+
+  EXPECT_EQ("", cache_.get("osd0"));
+  EXPECT_EQ("osd1.example.com:32640", cache_.get("osd1"));
+
+  mappings.clear();
+  cache_.GetMappings(&mappings);
+  ASSERT_EQ(1, mappings.size());
+  EXPECT_EQ("osd1", mappings[0].uuid);
+}
+
+/** A bulk update keeps the mappings which were not part of it. */
+TEST_F(UUIDCacheTest, BulkUpdateKeepsOtherMappings) {
+  cache_.update("mrc", "mrc.example.com", 32636, 3600);
+
+  vector<UUIDCache::UUIDMapping> mappings;
+  for (int i = 0; i < 100; i++) {
+    string uuid = "osd" + boost::lexical_cast<string>(i);
+    mappings.push_back(CreateMapping(uuid, uuid + ".example.com", 32640,
+                                     time(NULL) + 3600));
+  }
+  cache_.Update(mappings);
+
+  EXPECT_EQ("mrc.example.com:32636", cache_.get("mrc"));
+  EXPECT_EQ("osd42.example.com:32640", cache_.get("osd42"));
+  mappings.clear();
+  cache_.GetMappings(&mappings);
+  EXPECT_EQ(101, mappings.size());
+}
+
+/** Lookups always see a complete snapshot while the cache is updated. */
+TEST_F(UUIDCacheTest, ConcurrentLookupsAndUpdates) {
+  cache_.update("osd0", "osd0.example.com", 32640, 3600);
+  boost::atomic<bool> stop(false);
+  boost::atomic<int> errors(0);
+
+  boost::thread_group readers;
+  for (int i = 0; i < 4; i++) {
+    readers.create_thread(
+        boost::bind(&LookUpUntilStopped, &cache_, &stop, &errors));
+  }
+  for (int i = 0; i < 1000; i++) {
+    string uuid = "osd" + boost::lexical_cast<string>(i % 50 + 1);
+    cache_.update(uuid, uuid + ".example.com", 32640, 3600);
+  }
+  stop.store(true);
+  readers.join_all();
+
+  EXPECT_EQ(0, errors.load());
+}
+
+}  // namespace xtreemfs
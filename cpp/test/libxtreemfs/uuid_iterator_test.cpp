@@ -15,12 +15,15 @@
 #include <string>
 #include <vector>
 
+#include "libxtreemfs/options.h"
+#include "libxtreemfs/osd_health_registry.h"
 #include "libxtreemfs/stripe_translator.h"
 #include "libxtreemfs/uuid_container.h"
 #include "libxtreemfs/uuid_item.h"
 #include "libxtreemfs/container_uuid_iterator.h"
 #include "libxtreemfs/simple_uuid_iterator.h"
 #include "libxtreemfs/xtreemfs_exception.h"
+#include "util/error_log.h"
 #include "util/logging.h"
 #include "xtreemfs/GlobalTypes.pb.h"
 
@@ -214,6 +217,48 @@ TYPED_TEST(UUIDIteratorTest, DebugString) {
   EXPECT_EQ("[ [ uuid1, 0], [ uuid2, 0], [ uuid3, 0] ]", this->uuid_iterator_->DebugString());
 }
 
+TYPED_TEST(UUIDIteratorTest, SkipDeadOSDs) {
+  string uuid1 = "uuid1";
+  string uuid2 = "uuid2";
+  string current_uuid;
+
+  initialize_error_log(20);
+  Options options;
+  options.osd_health_failure_threshold = 2;
+  OSDHealthRegistry health_registry(NULL, options);
+  this->uuid_iterator_->set_health_registry(&health_registry);
+
+  this->adder_(this->uuid_iterator_.get(), uuid1);
+  this->adder_(this->uuid_iterator_.get(), uuid2);
+
+  // A single failure does not exceed the threshold.
+  health_registry.ReportFailure(uuid1);
+  EXPECT_FALSE(health_registry.IsDead(uuid1));
+  this->uuid_iterator_->GetUUID(&current_uuid);
+  EXPECT_EQ(uuid1, current_uuid);
+
+  // Dead OSDs are skipped without being marked as failed in this iterator.
+  health_registry.ReportFailure(uuid1);
+  EXPECT_TRUE(health_registry.IsDead(uuid1));
+  this->uuid_iterator_->GetUUID(&current_uuid);
+  EXPECT_EQ(uuid2, current_uuid);
+
+  // If all OSDs are dead, the current one is kept.
+  health_registry.ReportFailure(uuid2);
+  health_registry.ReportFailure(uuid2);
+  this->uuid_iterator_->GetUUID(&current_uuid);
+  EXPECT_EQ(uuid2, current_uuid);
+
+  // A successful request re-admits the OSD.
+  health_registry.ReportSuccess(uuid1);
+  EXPECT_FALSE(health_registry.IsDead(uuid1));
+  this->uuid_iterator_->GetUUID(&current_uuid);
+  EXPECT_EQ(uuid1, current_uuid);
+
+  this->uuid_iterator_->set_health_registry(NULL);
+  shutdown_error_log();
+}
+
 #endif  // GTEST_HAS_TYPED_TEST
 
 // Tests for SimpleUUIDIterator
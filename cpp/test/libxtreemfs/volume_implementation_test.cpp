@@ -13,6 +13,7 @@
 #include <cstdio>
 #include <cctype>
 #include <string>
+#include <vector>
 
 #include "libxtreemfs/client.h"
 #include "libxtreemfs/file_info.h"
@@ -1041,4 +1042,62 @@ TEST_F(VolumeImplementationTestFastPeriodicFileSizeUpdate, Truncate) {
   });
 }
 
+/** The batch operations report the result of every item separately. */
+TEST_F(VolumeImplementationTest, BatchMetadataOperations) {
+  vector<string> directories;
+  directories.push_back("/batch_a");
+  directories.push_back("/batch_b");
+  vector<string> files;
+  files.push_back("/batch_a/file1");
+  files.push_back("/batch_a/file2");
+  files.push_back("/batch_b/file3");
+
+  ASSERT_NO_THROW({
+    vector<POSIXErrno> errors;
+    volume_->MakeDirectories(user_credentials_, directories, 448, &errors);
+    ASSERT_EQ(directories.size(), errors.size());
+    for (size_t i = 0; i < errors.size(); i++) {
+      EXPECT_EQ(POSIX_ERROR_NONE, errors[i]);
+    }
+
+    vector<FileHandle*> file_handles;
+    volume_->OpenFiles(
+        user_credentials_,
+        files,
+        static_cast<SYSTEM_V_FCNTL>(
+            SYSTEM_V_FCNTL_H_O_CREAT | SYSTEM_V_FCNTL_H_O_RDWR),
+        420,
+        &file_handles,
+        &errors);
+    ASSERT_EQ(files.size(), file_handles.size());
+    for (size_t i = 0; i < file_handles.size(); i++) {
+      EXPECT_EQ(POSIX_ERROR_NONE, errors[i]);
+      ASSERT_TRUE(file_handles[i] != NULL);
+      file_handles[i]->Close();
+    }
+
+    // A missing file fails without affecting the other items.
+    vector<string> paths(files);
+    paths.push_back("/batch_a/missing");
+    vector<Stat> stats;
+    volume_->GetAttrs(user_credentials_, paths, &stats, &errors);
+    ASSERT_EQ(paths.size(), stats.size());
+    for (size_t i = 0; i < files.size(); i++) {
+      EXPECT_EQ(POSIX_ERROR_NONE, errors[i]);
+      EXPECT_EQ(0, stats[i].size());
+    }
+    EXPECT_EQ(POSIX_ERROR_ENOENT, errors.back());
+
+    volume_->UnlinkFiles(user_credentials_, files, &errors);
+    for (size_t i = 0; i < errors.size(); i++) {
+      EXPECT_EQ(POSIX_ERROR_NONE, errors[i]);
+    }
+
+    volume_->GetAttrs(user_credentials_, files, &stats, &errors);
+    for (size_t i = 0; i < errors.size(); i++) {
+      EXPECT_EQ(POSIX_ERROR_ENOENT, errors[i]);
+    }
+  });
+}
+
 }  // namespace xtreemfs
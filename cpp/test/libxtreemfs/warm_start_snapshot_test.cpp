@@ -0,0 +1,231 @@
+/*
+ * Copyright (c) 2026 by the XtreemFS Authors, see AUTHORS file
+ *
+ * Licensed under the BSD License, see LICENSE file for details.
+ *
+ */
+
+#ifndef WIN32
+#include <gtest/gtest.h>
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <boost/scoped_ptr.hpp>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "libxtreemfs/metadata_cache.h"
+#include "libxtreemfs/metadata_cache_entry.h"
+#include "libxtreemfs/uuid_cache.h"
+#include "libxtreemfs/warm_start_snapshot.h"
+#include "libxtreemfs/xtreemfs_exception.h"
+#include "util/logging.h"
+#include "xtreemfs/GlobalTypes.pb.h"
+#include "xtreemfs/MRC.pb.h"
+
+using namespace std;
+using namespace xtreemfs::pbrpc;
+using namespace xtreemfs::util;
+
+namespace xtreemfs {
+
+class WarmStartSnapshotTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    initialize_logger(LEVEL_WARN);
+    char path[] = "/tmp/xtreemfs_warm_start_snapshot_test_XXXXXX";
+    int fd = mkstemp(path);
+    ASSERT_NE(-1, fd);
+    close(fd);
+    path_ = path;
+    remove(path_.c_str());
+  }
+
+  virtual void TearDown() {
+    remove(path_.c_str());
+    google::protobuf::ShutdownProtobufLibrary();
+    shutdown_logger();
+  }
+
+  void FillCaches(UUIDCache* uuid_cache, MetadataCache* metadata_cache) {
+    uuid_cache->update("osd1", "osd1.example.com", 32640, 3600);
+    uuid_cache->update("osd2", "osd2.example.com", 32641, 3600);
+
+    Stat stat;
+    stat.set_ino(42);
+    stat.set_nlink(1);
+    metadata_cache->UpdateStat("/file", stat);
+    DirectoryEntries dir_entries;
+    dir_entries.add_entries()->set_name("file");
+    metadata_cache->UpdateDirEntries("/", dir_entries);
+  }
+
+  std::string path_;
+};
+
+TEST_F(WarmStartSnapshotTest, SaveAndLoad) {
+  {
+    UUIDCache uuid_cache;
+    MetadataCache metadata_cache(1024, 3600);
+    FillCaches(&uuid_cache, &metadata_cache);
+    VivaldiCoordinates coordinates;
+    coordinates.set_x_coordinate(1.5);
+    coordinates.set_y_coordinate(-2.5);
+    coordinates.set_local_error(0.25);
+    SaveWarmStartSnapshot(path_, &uuid_cache, &coordinates, &metadata_cache);
+  }
+
+  UUIDCache uuid_cache;
+  MetadataCache metadata_cache(1024, 3600);
+  VivaldiCoordinates coordinates;
+  ASSERT_TRUE(LoadWarmStartSnapshot(path_,
+                                    &uuid_cache,
+                                    &coordinates,
+                                    &metadata_cache));
+
+  EXPECT_EQ("osd1.example.com:32640", uuid_cache.get("osd1"));
+  EXPECT_EQ("osd2.example.com:32641", uuid_cache.get("osd2"));
+  ASSERT_TRUE(coordinates.IsInitialized());
+  EXPECT_EQ(1.5, coordinates.x_coordinate());
+  EXPECT_EQ(-2.5, coordinates.y_coordinate());
+
+  EXPECT_EQ(2, metadata_cache.Size());
+  Stat stat;
+  ASSERT_EQ(MetadataCache::kStatCached,
+            metadata_cache.GetStat("/file", &stat));
+  EXPECT_EQ(42, stat.ino());
+  // The restored directory listing is used to answer negative lookups.
+  EXPECT_EQ(MetadataCache::kPathDoesntExist,
+            metadata_cache.GetStat("/missing", &stat));
+  boost::scoped_ptr<DirectoryEntries> dir_entries(
+      metadata_cache.GetDirEntries("/", 0, 10));
+  ASSERT_TRUE(dir_entries.get() != NULL);
+  EXPECT_EQ("file", dir_entries->entries(0).name());
+}
+
+/** The snapshot contains metadata of the volume, so only the user may read
+ *  it, even if a temporary file of an earlier attempt is left. */
+TEST_F(WarmStartSnapshotTest, SnapshotIsOnlyAccessibleByTheUser) {
+  const string temporary_path = path_ + ".tmp";
+  {
+    ofstream leftover(temporary_path.c_str());
+  }
+  ASSERT_EQ(0, chmod(temporary_path.c_str(), 0644));
+  mode_t previous_umask = umask(0);
+
+  UUIDCache uuid_cache;
+  MetadataCache metadata_cache(1024, 3600);
+  FillCaches(&uuid_cache, &metadata_cache);
+  EXPECT_NO_THROW(SaveWarmStartSnapshot(path_,
+                                        &uuid_cache,
+                                        NULL,
+                                        &metadata_cache));
+  umask(previous_umask);
+
+  struct stat snapshot_stat;
+  ASSERT_EQ(0, stat(path_.c_str(), &snapshot_stat));
+  EXPECT_EQ(0600, snapshot_stat.st_mode & 0777);
+  EXPECT_NE(0, access(temporary_path.c_str(), F_OK));
+}
+
+TEST_F(WarmStartSnapshotTest, MissingSnapshot) {
+  UUIDCache uuid_cache;
+  MetadataCache metadata_cache(1024, 3600);
+  VivaldiCoordinates coordinates;
+  EXPECT_FALSE(LoadWarmStartSnapshot(path_,
+                                     &uuid_cache,
+                                     &coordinates,
+                                     &metadata_cache));
+}
+
+/** Entries whose TTL expired since the snapshot was written are skipped. */
+TEST_F(WarmStartSnapshotTest, ExpiredEntriesAreNotRestored) {
+  UUIDCache uuid_cache;
+  UUIDCache::UUIDMapping expired_mapping;
+  expired_mapping.uuid = "osd1";
+  expired_mapping.address = "osd1.example.com";
+  expired_mapping.port = 32640;
+  expired_mapping.timeout = time(NULL) - 1;
+  uuid_cache.Restore(expired_mapping);
+  EXPECT_EQ("", uuid_cache.get("osd1"));
+
+  MetadataCache metadata_cache(1024, 3600);
+  MetadataCacheEntry* entry = new MetadataCacheEntry();
+  entry->path = "/file";
+  entry->stat = new Stat();
+  entry->stat_timeout_s = time(NULL) - 1;
+  entry->dir_entries_timeout_s = 0;
+  entry->xattrs_timeout_s = 0;
+  metadata_cache.Restore(entry);
+  EXPECT_EQ(0, metadata_cache.Size());
+}
+
+/** Entries retrieved from the servers are not replaced by the snapshot. */
+TEST_F(WarmStartSnapshotTest, CachedEntriesTakePrecedence) {
+  {
+    UUIDCache uuid_cache;
+    MetadataCache metadata_cache(1024, 3600);
+    FillCaches(&uuid_cache, &metadata_cache);
+    SaveWarmStartSnapshot(path_, &uuid_cache, NULL, &metadata_cache);
+  }
+
+  UUIDCache uuid_cache;
+  uuid_cache.update("osd1", "osd1.new.example.com", 32640, 3600);
+  MetadataCache metadata_cache(1024, 3600);
+  Stat stat;
+  stat.set_ino(43);
+  stat.set_nlink(1);
+  metadata_cache.UpdateStat("/file", stat);
+  VivaldiCoordinates coordinates;
+  ASSERT_TRUE(LoadWarmStartSnapshot(path_,
+                                    &uuid_cache,
+                                    &coordinates,
+                                    &metadata_cache));
+
+  EXPECT_FALSE(coordinates.IsInitialized());
+  EXPECT_EQ("osd1.new.example.com:32640", uuid_cache.get("osd1"));
+  ASSERT_EQ(MetadataCache::kStatCached,
+            metadata_cache.GetStat("/file", &stat));
+  EXPECT_EQ(43, stat.ino());
+}
+
+/** A truncated snapshot does not modify the caches. */
+TEST_F(WarmStartSnapshotTest, TruncatedSnapshotIsRejected) {
+  {
+    UUIDCache uuid_cache;
+    MetadataCache metadata_cache(1024, 3600);
+    FillCaches(&uuid_cache, &metadata_cache);
+    SaveWarmStartSnapshot(path_, &uuid_cache, NULL, &metadata_cache);
+  }
+  string content;
+  {
+    ifstream in(path_.c_str(), ios_base::binary);
+    content.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+  }
+  ASSERT_GT(content.size(), 1);
+  {
+    ofstream out(path_.c_str(), ios_base::binary | ios_base::trunc);
+    out.write(content.data(), content.size() - 1);
+  }
+
+  UUIDCache uuid_cache;
+  MetadataCache metadata_cache(1024, 3600);
+  VivaldiCoordinates coordinates;
+  EXPECT_THROW(LoadWarmStartSnapshot(path_,
+                                     &uuid_cache,
+                                     &coordinates,
+                                     &metadata_cache),
+               XtreemFSException);
+  EXPECT_EQ("", uuid_cache.get("osd1"));
+  EXPECT_EQ(0, metadata_cache.Size());
+}
+
+}  // namespace xtreemfs
+#endif  // !WIN32
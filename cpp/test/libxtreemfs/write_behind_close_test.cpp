@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) 2026 by the XtreemFS Authors, see AUTHORS file
+ *
+ * Licensed under the BSD License, see LICENSE file for details.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <boost/scoped_array.hpp>
+#include <boost/thread/thread.hpp>
+#include <vector>
+
+#include "common/test_environment.h"
+#include "common/test_rpc_server_dir.h"
+#include "common/test_rpc_server_mrc.h"
+#include "common/test_rpc_server_osd.h"
+#include "libxtreemfs/client.h"
+#include "libxtreemfs/file_handle.h"
+#include "libxtreemfs/options.h"
+#include "libxtreemfs/volume.h"
+#include "libxtreemfs/xtreemfs_exception.h"
+#include "xtreemfs/OSDServiceConstants.h"
+
+using namespace std;
+using namespace xtreemfs::pbrpc;
+using namespace xtreemfs::util;
+
+namespace xtreemfs {
+namespace rpc {
+
+class WriteBehindCloseTest : public ::testing::Test {
+ protected:
+  static const int kBlockSize = 1024 * 128;
+
+  virtual void SetUp() {
+    initialize_logger(LEVEL_WARN);
+    test_env.options.connect_timeout_s = 3;
+    test_env.options.request_timeout_s = 3;
+    test_env.options.retry_delay_s = 1;
+    test_env.options.max_write_tries = 2;
+    test_env.options.enable_async_writes = true;
+    test_env.options.async_writes_max_request_size_kb = 128;
+    test_env.options.enable_write_behind_close = true;
+    test_env.options.write_behind_close_max_pending = 2;
+    ASSERT_TRUE(test_env.Start());
+
+    volume = test_env.client->OpenVolume(
+        test_env.volume_name_,
+        NULL,  // No SSL options.
+        test_env.options);
+  }
+
+  virtual void TearDown() {
+    test_env.Stop();
+  }
+
+  FileHandle* OpenTestFile(const string& path = "/test_file") {
+    return volume->OpenFile(
+        test_env.user_credentials,
+        path,
+        static_cast<xtreemfs::pbrpc::SYSTEM_V_FCNTL>(
+            xtreemfs::pbrpc::SYSTEM_V_FCNTL_H_O_CREAT |
+            xtreemfs::pbrpc::SYSTEM_V_FCNTL_H_O_RDWR));
+  }
+
+  TestEnvironment test_env;
+  Volume* volume;
+};
+
+/** Closing the volume waits for all write-behind closes. */
+TEST_F(WriteBehindCloseTest, VolumeCloseCompletesPendingCloses) {
+  size_t blocks = 5;
+  size_t buffer_size = kBlockSize * blocks;
+  boost::scoped_array<char> write_buf(new char[buffer_size]());
+
+  // More closes than write_behind_close_max_pending.
+  for (size_t i = 0; i < blocks; ++i) {
+    FileHandle* file = OpenTestFile();
+    ASSERT_NO_THROW(file->Write(write_buf.get() + i * kBlockSize,
+                                kBlockSize,
+                                i * kBlockSize));
+    ASSERT_NO_THROW(file->Close());
+  }
+
+  ASSERT_NO_THROW(volume->Close());
+
+  vector<WriteEntry> received = test_env.osds[0]->GetReceivedWrites();
+  ASSERT_EQ(blocks, received.size());
+  for (size_t i = 0; i < blocks; ++i) {
+    EXPECT_NE(received.end(),
+              find(received.begin(), received.end(),
+                   WriteEntry(i, 0, kBlockSize)));
+  }
+}
+
+/** The file can be opened again while its previous close is pending. */
+TEST_F(WriteBehindCloseTest, ReopenWhileCloseIsPending) {
+  boost::scoped_array<char> write_buf(new char[kBlockSize]());
+
+  FileHandle* file = OpenTestFile();
+  ASSERT_NO_THROW(file->Write(write_buf.get(), kBlockSize, 0));
+  ASSERT_NO_THROW(file->Close());
+
+  file = OpenTestFile();
+  ASSERT_NO_THROW(file->Write(write_buf.get(), kBlockSize, kBlockSize));
+  ASSERT_NO_THROW(file->Flush());
+  ASSERT_NO_THROW(file->Close());
+
+  ASSERT_NO_THROW(volume->Close());
+  EXPECT_EQ(2, test_env.osds[0]->GetReceivedWrites().size());
+}
+
+/** The error of a failed write-behind close is reported once by the next
+ *  operation on the same file, even if it was renamed meanwhile. */
+TEST_F(WriteBehindCloseTest, FailedCloseIsReportedForTheFile) {
+  boost::scoped_array<char> write_buf(new char[kBlockSize]());
+  test_env.osds[0]->AddDropRule(
+      new DropByProcIDRule(xtreemfs::pbrpc::PROC_ID_WRITE));
+
+  FileHandle* file = OpenTestFile();
+  ASSERT_NO_THROW(file->Write(write_buf.get(), kBlockSize, 0));
+  ASSERT_NO_THROW(file->Close());
+
+  // The test MRC returns the same file id for every path.
+  int reported_errors = 0;
+  for (int i = 0; i < 60 && reported_errors == 0; ++i) {
+    try {
+      file = OpenTestFile("/renamed_file");
+      file->Close();
+      boost::this_thread::sleep(boost::posix_time::millisec(500));
+    } catch (const PosixErrorException& e) {
+      EXPECT_EQ(POSIX_ERROR_EIO, e.posix_errno());
+      ++reported_errors;
+    }
+  }
+  EXPECT_EQ(1, reported_errors);
+
+  ASSERT_NO_THROW({
+    file = OpenTestFile();
+    file->Close();
+  });
+  ASSERT_NO_THROW(volume->Close());
+}
+
+}  // namespace rpc
+}  // namespace xtreemfs
@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2026 by the XtreemFS Authors, see AUTHORS file
+ *
+ * Licensed under the BSD License, see LICENSE file for details.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <boost/bind.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <boost/thread/thread.hpp>
+#include <map>
+#include <string>
+
+#include "libxtreemfs/write_window_controller.h"
+#include "util/logging.h"
+
+using namespace std;
+using namespace xtreemfs;
+using namespace xtreemfs::util;
+
+class WriteWindowControllerTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    initialize_logger(LEVEL_WARN);
+    controller_.reset(new WriteWindowController(4, 8));
+  }
+
+  virtual void TearDown() {
+    controller_.reset();
+    shutdown_logger();
+  }
+
+  boost::scoped_ptr<WriteWindowController> controller_;
+};
+
+/** The window grows by one per window of successful writes up to the max. */
+TEST_F(WriteWindowControllerTest, AdditiveIncrease) {
+  EXPECT_EQ(4, controller_->GetWindow("osd1"));
+
+  for (int i = 0; i < 4; i++) {
+    controller_->ReportSuccess("osd1", 1000);
+  }
+  EXPECT_EQ(5, controller_->GetWindow("osd1"));
+
+  for (int i = 0; i < 100; i++) {
+    controller_->ReportSuccess("osd1", 1000);
+  }
+  EXPECT_EQ(8, controller_->GetWindow("osd1"));
+
+  // Other OSDs are not affected.
+  EXPECT_EQ(4, controller_->GetWindow("osd2"));
+}
+
+/** Errors halve the window, but never below 1. */
+TEST_F(WriteWindowControllerTest, MultiplicativeDecreaseOnFailure) {
+  controller_->ReportFailure("osd1");
+  EXPECT_EQ(2, controller_->GetWindow("osd1"));
+  controller_->ReportFailure("osd1");
+  controller_->ReportFailure("osd1");
+  EXPECT_EQ(1, controller_->GetWindow("osd1"));
+
+  map<string, AsyncWriteWindow> windows;
+  controller_->GetWindows(&windows);
+  ASSERT_EQ(1, windows.size());
+  EXPECT_EQ(1, windows["osd1"].window);
+  EXPECT_EQ(0, windows["osd1"].in_flight);
+}
+
+/** A rising latency shrinks the window at most once per window. */
+TEST_F(WriteWindowControllerTest, DecreaseOnQueueingDelay) {
+  controller_->ReportSuccess("osd1", 1000);
+  for (int i = 0; i < 3; i++) {
+    controller_->ReportSuccess("osd1", 5000);
+  }
+  EXPECT_EQ(4, controller_->GetWindow("osd1"));
+
+  controller_->ReportSuccess("osd1", 5000);
+  EXPECT_EQ(2, controller_->GetWindow("osd1"));
+  controller_->ReportSuccess("osd1", 5000);
+  EXPECT_EQ(2, controller_->GetWindow("osd1"));
+}
+
+/** After the base latency rose, e.g. due to a route change, the window grows
+ *  again once the old minimum was forgotten. */
+TEST_F(WriteWindowControllerTest, HigherBaseLatencyIsLearned) {
+  controller_->ReportSuccess("osd1", 1000);
+  for (int i = 0; i < 50; i++) {
+    controller_->ReportSuccess("osd1", 5000);
+  }
+  EXPECT_EQ(1, controller_->GetWindow("osd1"));
+
+  for (int i = 0; i < 300; i++) {
+    controller_->ReportSuccess("osd1", 5000);
+  }
+  EXPECT_EQ(8, controller_->GetWindow("osd1"));
+}
+
+namespace {
+
+void AcquireWindow(WriteWindowController* controller, bool* acquired) {
+  controller->Acquire("osd1");
+  *acquired = true;
+}
+
+}  // namespace
+
+/** The writes in flight to an OSD are limited across all callers. */
+TEST_F(WriteWindowControllerTest, WindowLimitsWritesInFlightPerOSD) {
+  // Two "files" writing to the same OSD share its window of 4.
+  for (int i = 0; i < 4; i++) {
+    controller_->Acquire("osd1");
+  }
+  // Other OSDs are not affected.
+  controller_->Acquire("osd2");
+
+  bool acquired = false;
+  boost::thread writer(boost::bind(&AcquireWindow, controller_.get(),
+                                   &acquired));
+  boost::this_thread::sleep(boost::posix_time::milliseconds(100));
+  EXPECT_FALSE(acquired);
+
+  map<string, AsyncWriteWindow> windows;
+  controller_->GetWindows(&windows);
+  EXPECT_EQ(4, windows["osd1"].in_flight);
+  EXPECT_EQ(1, windows["osd2"].in_flight);
+
+  controller_->Release("osd1");
+  writer.join();
+  EXPECT_TRUE(acquired);
+
+  windows.clear();
+  controller_->GetWindows(&windows);
+  EXPECT_EQ(4, windows["osd1"].in_flight);
+}
+
+/** A blocked Acquire() can be interrupted and does not count. */
+TEST_F(WriteWindowControllerTest, AcquireIsInterruptible) {
+  for (int i = 0; i < 4; i++) {
+    controller_->Acquire("osd1");
+  }
+
+  bool acquired = false;
+  boost::thread writer(boost::bind(&AcquireWindow, controller_.get(),
+                                   &acquired));
+  boost::this_thread::sleep(boost::posix_time::milliseconds(50));
+  writer.interrupt();
+  writer.join();
+  EXPECT_FALSE(acquired);
+
+  map<string, AsyncWriteWindow> windows;
+  controller_->GetWindows(&windows);
+  EXPECT_EQ(4, windows["osd1"].in_flight);
+}
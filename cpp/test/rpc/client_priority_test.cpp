@@ -0,0 +1,194 @@
+/*
+ * Copyright (c) 2026 by the XtreemFS Authors, see AUTHORS file
+ *
+ * Licensed under the BSD License, see LICENSE file for details.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <boost/bind.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <boost/thread/thread.hpp>
+#include <string>
+#include <vector>
+
+#include "common/test_rpc_server_osd.h"
+#include "rpc/client.h"
+#include "rpc/sync_callback.h"
+#include "util/logging.h"
+#include "xtreemfs/OSDServiceClient.h"
+#include "xtreemfs/OSDServiceConstants.h"
+
+using namespace std;
+using namespace xtreemfs::pbrpc;
+using namespace xtreemfs::util;
+
+namespace xtreemfs {
+namespace rpc {
+
+class ClientPriorityTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    initialize_logger(LEVEL_WARN);
+    ASSERT_TRUE(osd_.Start());
+    client_.reset(new Client(5, 5, 60, NULL));
+    osd_client_.reset(new OSDServiceClient(client_.get()));
+
+    auth_.set_auth_type(AUTH_NONE);
+    user_credentials_.set_username("test");
+    user_credentials_.add_groups("test");
+
+    FileCredentials* creds = truncate_rq_.mutable_file_credentials();
+    XCap* xcap = creds->mutable_xcap();
+    xcap->set_access_mode(SYSTEM_V_FCNTL_H_O_RDWR);
+    xcap->set_client_identity("client");
+    xcap->set_expire_time_s(0);
+    xcap->set_expire_timeout_s(0);
+    xcap->set_file_id("volume:1");
+    xcap->set_replicate_on_close(false);
+    xcap->set_server_signature("");
+    xcap->set_truncate_epoch(0);
+    xcap->set_snap_config(SNAP_CONFIG_SNAPS_DISABLED);
+    xcap->set_snap_timestamp(0);
+    XLocSet* xlocs = creds->mutable_xlocs();
+    xlocs->set_read_only_file_size(0);
+    xlocs->set_replica_update_policy("");
+    xlocs->set_version(0);
+    Replica* replica = xlocs->add_replicas();
+    replica->add_osd_uuids("osd");
+    replica->set_replication_flags(0);
+    replica->mutable_striping_policy()->set_type(STRIPING_POLICY_RAID0);
+    replica->mutable_striping_policy()->set_stripe_size(128);
+    replica->mutable_striping_policy()->set_width(1);
+    truncate_rq_.set_file_id("volume:1");
+    truncate_rq_.set_new_file_size(0);
+
+    write_rq_.mutable_file_credentials()->CopyFrom(*creds);
+    write_rq_.set_file_id("volume:1");
+    write_rq_.set_object_number(0);
+    write_rq_.set_object_version(0);
+    write_rq_.set_offset(0);
+    write_rq_.set_lease_timeout(0);
+    write_rq_.mutable_object_data()->set_checksum(0);
+    write_rq_.mutable_object_data()->set_invalid_checksum_on_osd(false);
+    write_rq_.mutable_object_data()->set_zero_padding(0);
+
+    VivaldiCoordinates* coordinates = ping_rq_.mutable_coordinates();
+    coordinates->set_x_coordinate(0);
+    coordinates->set_y_coordinate(0);
+    coordinates->set_local_error(0);
+    ping_rq_.set_request_response(true);
+  }
+
+  virtual void TearDown() {
+    client_->shutdown();
+    if (client_thread_.get()) {
+      client_thread_->join();
+    }
+    osd_.Stop();
+    shutdown_logger();
+  }
+
+  void SendWrite() {
+    callbacks_.push_back(osd_client_->write_sync(
+        osd_.GetAddress(), auth_, user_credentials_, &write_rq_, data_, 4));
+  }
+
+  void SendTruncate() {
+    callbacks_.push_back(osd_client_->truncate_sync(
+        osd_.GetAddress(), auth_, user_credentials_, &truncate_rq_));
+  }
+
+  void SendPing() {
+    callbacks_.push_back(osd_client_->xtreemfs_ping_sync(
+        osd_.GetAddress(), auth_, user_credentials_, &ping_rq_));
+  }
+
+  /** Starts the network thread and waits for all responses. Since the
+   *  requests were queued before, all of them are pending in the connection
+   *  once it is established. */
+  void RunClientAndWait() {
+    client_thread_.reset(new boost::thread(boost::bind(&Client::run,
+                                                       client_.get())));
+    for (size_t i = 0; i < callbacks_.size(); i++) {
+      EXPECT_FALSE(callbacks_[i]->HasFailed());
+      callbacks_[i]->DeleteBuffers();
+      delete callbacks_[i];
+    }
+    callbacks_.clear();
+  }
+
+  TestRPCServerOSD osd_;
+  boost::scoped_ptr<Client> client_;
+  boost::scoped_ptr<boost::thread> client_thread_;
+  boost::scoped_ptr<OSDServiceClient> osd_client_;
+
+  Auth auth_;
+  UserCredentials user_credentials_;
+  truncateRequest truncate_rq_;
+  writeRequest write_rq_;
+  xtreemfs_pingMesssage ping_rq_;
+  char data_[4];
+  vector<SyncCallbackBase*> callbacks_;
+};
+
+TEST_F(ClientPriorityTest, DefaultPriority) {
+  EXPECT_EQ(kPriorityBulk,
+            Client::DefaultPriority(INTERFACE_ID_OSD, PROC_ID_READ));
+  EXPECT_EQ(kPriorityBulk,
+            Client::DefaultPriority(INTERFACE_ID_OSD, PROC_ID_WRITE));
+  EXPECT_EQ(kPriorityControl,
+            Client::DefaultPriority(INTERFACE_ID_OSD, PROC_ID_XTREEMFS_PING));
+  EXPECT_EQ(kPriorityControl,
+            Client::DefaultPriority(INTERFACE_ID_OSD,
+                                    PROC_ID_XTREEMFS_LOCK_ACQUIRE));
+  EXPECT_EQ(kPriorityControl,
+            Client::DefaultPriority(INTERFACE_ID_OSD,
+                                    PROC_ID_XTREEMFS_LOCK_CHECK));
+  EXPECT_EQ(kPriorityBulk,
+            Client::DefaultPriority(INTERFACE_ID_OSD, PROC_ID_TRUNCATE));
+  EXPECT_EQ(kPriorityBulk,
+            Client::DefaultPriority(INTERFACE_ID_OSD,
+                                    PROC_ID_XTREEMFS_LOCK_RELEASE));
+  EXPECT_EQ(kPriorityMetadata,
+            Client::DefaultPriority(INTERFACE_ID_OSD,
+                                    PROC_ID_XTREEMFS_FINALIZE_VOUCHERS));
+  // MRC readdir (20001, 10) shares its proc id with OSD read. The MRC
+  // constants are not included as they collide with the OSD ones.
+  EXPECT_EQ(kPriorityMetadata, Client::DefaultPriority(20001, 10));
+}
+
+/** The ping overtakes the writes, the truncate stays behind them. */
+TEST_F(ClientPriorityTest, HigherPrioritiesAreSentFirst) {
+  SendWrite();
+  SendWrite();
+  SendTruncate();
+  SendPing();
+  RunClientAndWait();
+
+  vector<uint32_t> received = osd_.GetReceivedProcIDs();
+  ASSERT_EQ(4, received.size());
+  EXPECT_EQ(PROC_ID_XTREEMFS_PING, received[0]);
+  EXPECT_EQ(PROC_ID_WRITE, received[1]);
+  EXPECT_EQ(PROC_ID_WRITE, received[2]);
+  EXPECT_EQ(PROC_ID_TRUNCATE, received[3]);
+}
+
+/** Bulk requests wait for at most four requests of higher priorities. */
+TEST_F(ClientPriorityTest, BulkRequestsAreNotStarved) {
+  SendWrite();
+  for (int i = 0; i < 6; i++) {
+    SendPing();
+  }
+  RunClientAndWait();
+
+  vector<uint32_t> received = osd_.GetReceivedProcIDs();
+  ASSERT_EQ(7, received.size());
+  for (int i = 0; i < 7; i++) {
+    EXPECT_EQ(i == 4 ? PROC_ID_WRITE : PROC_ID_XTREEMFS_PING, received[i]);
+  }
+}
+
+}  // namespace rpc
+}  // namespace xtreemfs
@@ -127,6 +127,31 @@ TEST_F(ClientTestDropConnection, ConnectionTimeout) {
   });
 }
 
+/** A connection established by Connect() is used by later requests. */
+TEST_F(ClientTestFastTimeout, ConnectInAdvance) {
+  xtreemfs::ClientImplementation* impl =
+      dynamic_cast<xtreemfs::ClientImplementation*>(test_env.client.get());
+  ASSERT_TRUE(impl != NULL);
+  impl->network_client_->Connect(test_env.dir->GetAddress());
+  impl->network_client_->Connect(test_env.dir->GetAddress());
+
+  size_t connections = 0, established = 0;
+  for (int i = 0; i < 50 && established == 0; i++) {
+    boost::this_thread::sleep(boost::posix_time::milliseconds(20));
+    impl->network_client_->GetConnectionCounts(&connections, &established);
+  }
+  EXPECT_EQ(1, connections);
+  EXPECT_EQ(1, established);
+
+  // The response is received although the connection was idle before.
+  string mrc_uuid;
+  EXPECT_NO_THROW(
+      impl->GetUUIDResolver()->VolumeNameToMRCUUID(test_env.volume_name_,
+                                                   &mrc_uuid));
+  impl->network_client_->GetConnectionCounts(&connections, &established);
+  EXPECT_EQ(1, connections);
+}
+
 /** Inactive connections shall be successfully closed. */
 TEST_F(ClientTestFastLingerTimeout, LingerTests) {
   xtreemfs::ClientImplementation* impl =
@@ -137,7 +162,9 @@ TEST_F(ClientTestFastLingerTimeout, LingerTests) {
 
   boost::this_thread::sleep(boost::posix_time::seconds(2));
 
-  EXPECT_EQ(0, impl->network_client_->connections_.size());
+  size_t connections = 0, established = 0;
+  impl->network_client_->GetConnectionCounts(&connections, &established);
+  EXPECT_EQ(0, connections);
 }
 
 /** Connect timeout callbacks (which are executed after deleting
@@ -160,7 +187,9 @@ TEST_F(ClientTestFastLingerTimeoutConnectTimeout, LingerTests) {
 
   // At this point the connection must have been deleted
   // due to the very low linger timeout.
-  EXPECT_EQ(0, impl->network_client_->connections_.size());
+  size_t connections = 0, established = 0;
+  impl->network_client_->GetConnectionCounts(&connections, &established);
+  EXPECT_EQ(0, connections);
 }
 
 }  // namespace rpc
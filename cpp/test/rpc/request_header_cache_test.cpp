@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2026 by the XtreemFS Authors, see AUTHORS file
+ *
+ * Licensed under the BSD License, see LICENSE file for details.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <boost/shared_ptr.hpp>
+#include <string>
+
+#include "pbrpc/RPC.pb.h"
+#include "rpc/request_header_cache.h"
+
+using namespace std;
+using namespace xtreemfs::pbrpc;
+using namespace xtreemfs::rpc;
+
+namespace {
+
+string SerializeHeader(uint32_t call_id,
+                       uint32_t interface_id,
+                       uint32_t proc_id,
+                       const UserCredentials& user_credentials,
+                       const Auth& auth) {
+  RPCHeader header;
+  header.set_message_type(RPC_REQUEST);
+  header.set_call_id(call_id);
+  header.mutable_request_header()->set_interface_id(interface_id);
+  header.mutable_request_header()->set_proc_id(proc_id);
+  header.mutable_request_header()->mutable_user_creds()->
+      MergeFrom(user_credentials);
+  header.mutable_request_header()->mutable_auth_data()->MergeFrom(auth);
+  return header.SerializeAsString();
+}
+
+}  // namespace
+
+TEST(RequestHeaderCacheTest, PatchedTemplateEqualsSerializedHeader) {
+  RequestHeaderCache cache(RequestHeaderCache::kDefaultMaxEntries);
+  UserCredentials user_credentials;
+  user_credentials.set_username("test");
+  user_credentials.add_groups("test");
+  Auth auth;
+  auth.set_auth_type(AUTH_PASSWORD);
+  // Make the request header larger than 127 bytes (two byte length varint).
+  auth.mutable_auth_passwd()->set_password(string(200, 'p'));
+
+  boost::shared_ptr<const string> header_template
+      = cache.GetTemplate(user_credentials, auth);
+  string header = *header_template;
+  RequestHeaderCache::SetIds(0xdeadbeef,
+                             20001,
+                             13,
+                             &header[0],
+                             header.size());
+
+  EXPECT_EQ(SerializeHeader(0xdeadbeef, 20001, 13, user_credentials, auth),
+            header);
+  // The template itself is not modified.
+  EXPECT_EQ(SerializeHeader(0, 0, 0, user_credentials, auth),
+            *header_template);
+}
+
+TEST(RequestHeaderCacheTest, TemplatesAreCachedPerCredentials) {
+  RequestHeaderCache cache(2);
+  UserCredentials user1;
+  user1.set_username("user1");
+  user1.add_groups("group");
+  UserCredentials user2;
+  user2.set_username("user2");
+  user2.add_groups("group");
+  Auth auth;
+  auth.set_auth_type(AUTH_NONE);
+
+  boost::shared_ptr<const string> template1 = cache.GetTemplate(user1, auth);
+  EXPECT_EQ(template1.get(), cache.GetTemplate(user1, auth).get());
+  EXPECT_NE(template1.get(), cache.GetTemplate(user2, auth).get());
+
+  // A differing group list must not share the template.
+  user1.add_groups("other");
+  boost::shared_ptr<const string> template2 = cache.GetTemplate(user1, auth);
+  EXPECT_NE(template1.get(), template2.get());
+  EXPECT_EQ(SerializeHeader(0, 0, 0, user1, auth), *template2);
+}
+
+TEST(RequestHeaderCacheTest, TemplatesAreCachedPerAuth) {
+  RequestHeaderCache cache(RequestHeaderCache::kDefaultMaxEntries);
+  UserCredentials user_credentials;
+  user_credentials.set_username("test");
+  Auth auth;
+  auth.set_auth_type(AUTH_PASSWORD);
+  auth.mutable_auth_passwd()->set_password("secret");
+
+  boost::shared_ptr<const string> template1
+      = cache.GetTemplate(user_credentials, auth);
+
+  // An equal Auth object shares the template.
+  Auth equal_auth;
+  equal_auth.CopyFrom(auth);
+  EXPECT_EQ(template1.get(),
+            cache.GetTemplate(user_credentials, equal_auth).get());
+
+  Auth other_password(auth);
+  other_password.mutable_auth_passwd()->set_password("other");
+  boost::shared_ptr<const string> template2
+      = cache.GetTemplate(user_credentials, other_password);
+  EXPECT_NE(template1.get(), template2.get());
+  EXPECT_EQ(SerializeHeader(0, 0, 0, user_credentials, other_password),
+            *template2);
+
+  // Set but empty auth_data is serialized and therefore differs.
+  Auth empty_auth_data(auth);
+  empty_auth_data.set_auth_data("");
+  EXPECT_NE(template1.get(),
+            cache.GetTemplate(user_credentials, empty_auth_data).get());
+}
@@ -0,0 +1,172 @@
+/*
+ * Copyright (c) 2026 by the XtreemFS Authors, see AUTHORS file
+ *
+ * Licensed under the BSD License, see LICENSE file for details.
+ *
+ */
+
+#ifdef HAS_OPENSSL
+
+#include <gtest/gtest.h>
+
+#include <openssl/evp.h>
+#include <openssl/ssl.h>
+#include <openssl/x509.h>
+
+#include <string>
+
+#include "rpc/ssl_session_cache.h"
+#include "util/logging.h"
+
+using namespace std;
+using namespace xtreemfs::util;
+
+namespace xtreemfs {
+namespace rpc {
+
+namespace {
+
+/** Returns a new P-256 key. */
+EVP_PKEY* CreateKey() {
+  EVP_PKEY* key = NULL;
+  EVP_PKEY_CTX* context = EVP_PKEY_CTX_new_id(EVP_PKEY_EC, NULL);
+  if (context != NULL &&
+      EVP_PKEY_keygen_init(context) == 1 &&
+      EVP_PKEY_CTX_set_ec_paramgen_curve_nid(context,
+                                             NID_X9_62_prime256v1) == 1) {
+    EVP_PKEY_keygen(context, &key);
+  }
+  EVP_PKEY_CTX_free(context);
+  return key;
+}
+
+/** Returns a self-signed certificate for "key". */
+X509* CreateCertificate(EVP_PKEY* key) {
+  X509* certificate = X509_new();
+  X509_set_version(certificate, 2);
+  ASN1_INTEGER_set(X509_get_serialNumber(certificate), 1);
+  X509_gmtime_adj(X509_get_notBefore(certificate), 0);
+  X509_gmtime_adj(X509_get_notAfter(certificate), 3600);
+  X509_set_pubkey(certificate, key);
+  X509_NAME* name = X509_get_subject_name(certificate);
+  X509_NAME_add_entry_by_txt(
+      name, "CN", MBSTRING_ASC,
+      reinterpret_cast<const unsigned char*>("localhost"), -1, -1, 0);
+  X509_set_issuer_name(certificate, name);
+  X509_sign(certificate, key, EVP_sha256());
+  return certificate;
+}
+
+}  // namespace
+
+class SSLSessionCacheTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    initialize_logger(LEVEL_WARN);
+
+    EVP_PKEY* key = CreateKey();
+    ASSERT_TRUE(key != NULL);
+    X509* certificate = CreateCertificate(key);
+    server_context_ = SSL_CTX_new(SSLv23_server_method());
+    ASSERT_EQ(1, SSL_CTX_use_certificate(server_context_, certificate));
+    ASSERT_EQ(1, SSL_CTX_use_PrivateKey(server_context_, key));
+    X509_free(certificate);
+    EVP_PKEY_free(key);
+
+    client_context_ = SSL_CTX_new(SSLv23_client_method());
+    cache_ = new SSLSessionCache(client_context_);
+  }
+
+  virtual void TearDown() {
+    delete cache_;
+    SSL_CTX_free(client_context_);
+    SSL_CTX_free(server_context_);
+
+    shutdown_logger();
+  }
+
+  /** Connects a client to the server in memory and returns true if the
+   *  client resumed a session. "address" may be NULL to bypass the cache. */
+  bool Handshake(const string* address) {
+    SSL* client = SSL_new(client_context_);
+    SSL* server = SSL_new(server_context_);
+    BIO* client_bio = NULL;
+    BIO* server_bio = NULL;
+    BIO_new_bio_pair(&client_bio, 0, &server_bio, 0);
+    SSL_set_bio(client, client_bio, client_bio);
+    SSL_set_bio(server, server_bio, server_bio);
+    SSL_set_connect_state(client);
+    SSL_set_accept_state(server);
+    if (address != NULL) {
+      cache_->PrepareHandshake(client, address);
+    }
+
+    bool client_done = false;
+    bool server_done = false;
+    for (int i = 0; i < 20 && !(client_done && server_done); i++) {
+      client_done = client_done || SSL_do_handshake(client) == 1;
+      server_done = server_done || SSL_do_handshake(server) == 1;
+    }
+    EXPECT_TRUE(client_done && server_done);
+    // Lets the client process the session tickets of TLS 1.3.
+    char buffer;
+    EXPECT_GE(0, SSL_read(client, &buffer, 1));
+
+    bool reused = SSL_session_reused(client) == 1;
+    // Without a shutdown, OpenSSL marks the session as not resumable.
+    SSL_shutdown(client);
+    SSL_shutdown(server);
+    SSL_free(client);
+    SSL_free(server);
+    return reused;
+  }
+
+  SSL_CTX* server_context_;
+  SSL_CTX* client_context_;
+  SSLSessionCache* cache_;
+};
+
+TEST_F(SSLSessionCacheTest, ResumesSessionOfSameServer) {
+  const string address = "osd1.example.com:32640";
+  EXPECT_EQ(0, cache_->size());
+
+  EXPECT_FALSE(Handshake(&address));
+  EXPECT_EQ(1, cache_->size());
+  EXPECT_TRUE(Handshake(&address));
+  EXPECT_EQ(1, cache_->size());
+}
+
+/** Sessions are cached per server address. */
+TEST_F(SSLSessionCacheTest, SessionsPerServer) {
+  const string address1 = "osd1.example.com:32640";
+  const string address2 = "osd2.example.com:32640";
+
+  EXPECT_FALSE(Handshake(&address1));
+  EXPECT_FALSE(Handshake(&address2));
+  EXPECT_EQ(2, cache_->size());
+  EXPECT_TRUE(Handshake(&address2));
+  EXPECT_TRUE(Handshake(&address1));
+}
+
+TEST_F(SSLSessionCacheTest, RemovedSessionIsNotResumed) {
+  const string address = "osd1.example.com:32640";
+  EXPECT_FALSE(Handshake(&address));
+
+  cache_->Remove(address);
+  EXPECT_EQ(0, cache_->size());
+  cache_->Remove(address);
+
+  EXPECT_FALSE(Handshake(&address));
+  EXPECT_EQ(1, cache_->size());
+}
+
+/** Sessions of connections which were not prepared are not stored. */
+TEST_F(SSLSessionCacheTest, UnknownServerIsNotCached) {
+  EXPECT_FALSE(Handshake(NULL));
+  EXPECT_EQ(0, cache_->size());
+}
+
+}  // namespace rpc
+}  // namespace xtreemfs
+
+#endif  // HAS_OPENSSL
@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2026 by the XtreemFS Authors, see AUTHORS file
+ *
+ * Licensed under the BSD License, see LICENSE file for details.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <stdint.h>
+
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/scoped_array.hpp>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+#include "util/crc32c.h"
+
+using namespace std;
+using namespace xtreemfs::util;
+
+namespace xtreemfs {
+
+namespace {
+
+typedef uint32_t (*ChecksumFunction)(uint32_t, const char*, size_t);
+
+/** Returns the throughput of "function" over "buffer" in MB/s. */
+double MeasureThroughput(ChecksumFunction function,
+                         const char* buffer,
+                         size_t length,
+                         int iterations) {
+  uint32_t crc = 0;
+  boost::posix_time::ptime start
+      = boost::posix_time::microsec_clock::universal_time();
+  for (int i = 0; i < iterations; i++) {
+    crc = function(crc, buffer, length);
+  }
+  boost::posix_time::time_duration duration
+      = boost::posix_time::microsec_clock::universal_time() - start;
+  // Prevent that the loop is optimized away.
+  EXPECT_NE(crc, crc + 1);
+  return static_cast<double>(length) * iterations
+      / (duration.total_microseconds() + 1);
+}
+
+uint32_t Copy(uint32_t crc, const char* buffer, size_t length) {
+  static boost::scoped_array<char> target(new char[length]);
+  memcpy(target.get(), buffer, length);
+  return crc + target[length - 1];
+}
+
+}  // namespace
+
+/** Test vectors from RFC 3720, B.4. */
+TEST(CRC32CTest, KnownValues) {
+  char buffer[32];
+  memset(buffer, 0, sizeof(buffer));
+  EXPECT_EQ(0x8a9136aa, CRC32C(buffer, sizeof(buffer)));
+  memset(buffer, 0xff, sizeof(buffer));
+  EXPECT_EQ(0x62a8ab43, CRC32C(buffer, sizeof(buffer)));
+  for (int i = 0; i < 32; i++) {
+    buffer[i] = static_cast<char>(i);
+  }
+  EXPECT_EQ(0x46dd794e, CRC32C(buffer, sizeof(buffer)));
+
+  EXPECT_EQ(0xe3069283, CRC32C("123456789", 9));
+  EXPECT_EQ(0xe3069283, CRC32CExtendPortable(0, "123456789", 9));
+  EXPECT_EQ(0, CRC32C("", 0));
+}
+
+/** Both implementations agree for all lengths and alignments, including
+ *  lengths which use the interleaved streams. */
+TEST(CRC32CTest, HardwareAndPortableImplementationsAgree) {
+  const size_t kLength = 3 * 8192 + 3 * 256 + 100;
+  string data(kLength + 8, '\0');
+  uint32_t state = 42;
+  for (size_t i = 0; i < data.size(); i++) {
+    state = state * 1103515245 + 12345;
+    data[i] = static_cast<char>(state >> 16);
+  }
+
+  for (size_t offset = 0; offset < 8; offset++) {
+    for (size_t length = 0; length < 600; length += 7) {
+      ASSERT_EQ(CRC32CExtendPortable(0, data.data() + offset, length),
+                CRC32C(data.data() + offset, length));
+    }
+    EXPECT_EQ(CRC32CExtendPortable(0, data.data() + offset, kLength),
+              CRC32C(data.data() + offset, kLength));
+  }
+}
+
+TEST(CRC32CTest, Extend) {
+  string data = "The quick brown fox jumps over the lazy dog";
+  uint32_t crc = CRC32C(data.data(), 10);
+  crc = CRC32CExtend(crc, data.data() + 10, data.size() - 10);
+  EXPECT_EQ(CRC32C(data.data(), data.size()), crc);
+}
+
+/** Compares the checksum throughput with copying the data, which every read
+ *  and write does at least once. Only reports the results as they depend on
+ *  the machine, run it with --gtest_also_run_disabled_tests. */
+TEST(CRC32CTest, DISABLED_Throughput) {
+  const size_t kObjectSize = 128 * 1024;
+  const int kIterations = 4096;  // 512 MB.
+  boost::scoped_array<char> object(new char[kObjectSize]);
+  memset(object.get(), 0x5a, kObjectSize);
+
+  double hardware = MeasureThroughput(&CRC32CExtend, object.get(),
+                                      kObjectSize, kIterations);
+  double portable = MeasureThroughput(&CRC32CExtendPortable, object.get(),
+                                      kObjectSize, kIterations);
+  double copy = MeasureThroughput(&Copy, object.get(), kObjectSize,
+                                  kIterations);
+
+  cout << "Throughput for " << kObjectSize / 1024 << " kB objects in MB/s: "
+       << "CRC32C" << (CRC32CIsHardwareAccelerated() ? " (SSE4.2)" : "")
+       << ": " << static_cast<uint64_t>(hardware)
+       << ", CRC32C (portable): " << static_cast<uint64_t>(portable)
+       << ", memcpy: " << static_cast<uint64_t>(copy) << endl;
+}
+
+}  // namespace xtreemfs
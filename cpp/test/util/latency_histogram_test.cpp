@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2026 by the XtreemFS Authors, see AUTHORS file
+ *
+ * Licensed under the BSD License, see LICENSE file for details.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+#include <map>
+#include <string>
+
+#include "util/latency_histogram.h"
+
+using namespace std;
+using namespace xtreemfs::util;
+
+namespace xtreemfs {
+
+namespace {
+
+void RecordLatencies(LatencyHistogram* histogram, int count) {
+  for (int i = 0; i < count; i++) {
+    histogram->Record(i % 100);
+  }
+}
+
+}  // namespace
+
+TEST(LatencyHistogramTest, EmptyHistogram) {
+  LatencyHistogram histogram;
+  LatencyHistogram::Summary summary;
+  histogram.GetSummary(&summary);
+
+  EXPECT_EQ(0, summary.count);
+  EXPECT_EQ(0, summary.max);
+  EXPECT_EQ(0, summary.p999);
+}
+
+/** Percentiles are reported with a relative error below 1/16. */
+TEST(LatencyHistogramTest, Percentiles) {
+  LatencyHistogram histogram;
+  for (uint64_t i = 1; i <= 10000; i++) {
+    histogram.Record(i);
+  }
+
+  LatencyHistogram::Summary summary;
+  histogram.GetSummary(&summary);
+  EXPECT_EQ(10000, summary.count);
+  EXPECT_EQ(5000, summary.mean);
+  EXPECT_EQ(10000, summary.max);
+  EXPECT_LE(5000, summary.p50);
+  EXPECT_GE(5000 * 17 / 16, summary.p50);
+  EXPECT_LE(9900, summary.p99);
+  EXPECT_GE(9900 * 17 / 16, summary.p99);
+  EXPECT_LE(9990, summary.p999);
+  EXPECT_GE(10000, summary.p999);
+
+  // Small latencies are counted exactly.
+  LatencyHistogram small;
+  small.Record(3);
+  small.Record(7);
+  small.GetSummary(&summary);
+  EXPECT_EQ(3, summary.p50);
+  EXPECT_EQ(7, summary.p99);
+}
+
+TEST(LatencyHistogramTest, Reset) {
+  LatencyHistogram histogram;
+  histogram.Record(42);
+  histogram.Reset();
+
+  LatencyHistogram::Summary summary;
+  histogram.GetSummary(&summary);
+  EXPECT_EQ(0, summary.count);
+  EXPECT_EQ(0, summary.max);
+}
+
+TEST(LatencyHistogramTest, ConcurrentRecords) {
+  LatencyHistogram histogram;
+  const int kThreads = 8;
+  const int kRecordsPerThread = 10000;
+
+  boost::thread_group threads;
+  for (int i = 0; i < kThreads; i++) {
+    threads.create_thread(
+        boost::bind(&RecordLatencies, &histogram, kRecordsPerThread));
+  }
+  threads.join_all();
+
+  LatencyHistogram::Summary summary;
+  histogram.GetSummary(&summary);
+  EXPECT_EQ(kThreads * kRecordsPerThread, summary.count);
+  EXPECT_EQ(99, summary.max);
+}
+
+TEST(LatencyStatisticsTest, ServerHistograms) {
+  EXPECT_EQ(NULL, LatencyStatistics::GetHistogram(LatencyStatistics::kRead));
+  EXPECT_EQ(NULL, LatencyStatistics::GetServerHistogram("osd:32640"));
+
+  initialize_latency_statistics();
+  LatencyHistogram* histogram
+      = LatencyStatistics::GetServerHistogram("osd:32640");
+  ASSERT_TRUE(histogram != NULL);
+  EXPECT_EQ(histogram, LatencyStatistics::GetServerHistogram("osd:32640"));
+  histogram->Record(10);
+
+  map<string, LatencyHistogram::Summary> summaries;
+  LatencyStatistics::latency_statistics->GetServerSummaries(&summaries);
+  ASSERT_EQ(1, summaries.size());
+  EXPECT_EQ(1, summaries["osd:32640"].count);
+
+  LatencyStatistics::latency_statistics->Reset();
+  summaries.clear();
+  LatencyStatistics::latency_statistics->GetServerSummaries(&summaries);
+  EXPECT_EQ(0, summaries["osd:32640"].count);
+  shutdown_latency_statistics();
+  EXPECT_EQ(NULL, LatencyStatistics::latency_statistics);
+}
+
+}  // namespace xtreemfs
@@ -0,0 +1,172 @@
+/*
+ * Copyright (c) 2026 by the XtreemFS Authors, see AUTHORS file
+ *
+ * Licensed under the BSD License, see LICENSE file for details.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <boost/bind.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/thread/thread.hpp>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "util/log_ring_buffer.h"
+#include "util/logging.h"
+
+using namespace std;
+using namespace xtreemfs::util;
+
+namespace xtreemfs {
+
+namespace {
+
+void LogMessages(Logging* logging, int thread_number, int count) {
+  for (int i = 0; i < count; i++) {
+    logging->getLog(LEVEL_DEBUG) << "thread " << thread_number
+        << " message " << i << endl;
+  }
+}
+
+void LogAndFlush(Logging* logging, int thread_number, int count) {
+  for (int i = 0; i < count; i++) {
+    logging->getLog(LEVEL_DEBUG) << "thread " << thread_number
+        << " message " << i << endl;
+    logging->Flush();
+  }
+}
+
+void LogWithoutEndl(Logging* logging) {
+  logging->getLog(LEVEL_INFO) << "last message of the thread";
+}
+
+vector<string> SplitLines(const string& text) {
+  vector<string> lines;
+  istringstream stream(text);
+  string line;
+  while (getline(stream, line)) {
+    lines.push_back(line);
+  }
+  return lines;
+}
+
+}  // namespace
+
+TEST(LogRingBufferTest, DropsMessagesIfFull) {
+  LogRingBuffer ring_buffer(2);
+  boost::posix_time::ptime now
+      = boost::posix_time::microsec_clock::universal_time();
+  string message = "first";
+
+  EXPECT_TRUE(ring_buffer.TryPush(LEVEL_INFO, now, &message));
+  EXPECT_TRUE(message.empty());
+  message = "second";
+  EXPECT_TRUE(ring_buffer.TryPush(LEVEL_DEBUG, now, &message));
+  message = "third";
+  EXPECT_FALSE(ring_buffer.TryPush(LEVEL_DEBUG, now, &message));
+  EXPECT_EQ(1, ring_buffer.TakeDroppedCount());
+  EXPECT_EQ(0, ring_buffer.TakeDroppedCount());
+
+  ASSERT_TRUE(ring_buffer.Front() != NULL);
+  EXPECT_EQ(LEVEL_INFO, ring_buffer.Front()->level);
+  EXPECT_EQ("first", ring_buffer.Front()->message);
+  ring_buffer.Pop();
+  EXPECT_EQ("second", ring_buffer.Front()->message);
+  ring_buffer.Pop();
+  EXPECT_TRUE(ring_buffer.Front() == NULL);
+  EXPECT_TRUE(ring_buffer.empty());
+
+  // Space is available again.
+  message = "fourth";
+  EXPECT_TRUE(ring_buffer.TryPush(LEVEL_DEBUG, now, &message));
+  EXPECT_EQ("fourth", ring_buffer.Front()->message);
+}
+
+/** Messages of concurrent threads are written as separate lines. */
+TEST(LoggingTest, MessagesOfThreadsDoNotInterleave) {
+  ostringstream* output = new ostringstream();
+  Logging logging(LEVEL_DEBUG, output);
+  const int kThreads = 4;
+  const int kMessagesPerThread = 200;
+
+  boost::thread_group threads;
+  for (int i = 0; i < kThreads; i++) {
+    threads.create_thread(
+        boost::bind(&LogMessages, &logging, i, kMessagesPerThread));
+  }
+  threads.join_all();
+  logging.Flush();
+
+  vector<string> lines = SplitLines(output->str());
+  // The ring buffer of each thread is large enough for all its messages.
+  ASSERT_EQ(0, logging.dropped_messages());
+  ASSERT_EQ(kThreads * kMessagesPerThread, lines.size());
+  vector<int> next_message(kThreads, 0);
+  for (size_t i = 0; i < lines.size(); i++) {
+    EXPECT_EQ("[ D | ", lines[i].substr(0, 6));
+    size_t pos = lines[i].find(" ] thread ");
+    ASSERT_NE(string::npos, pos) << lines[i];
+    istringstream message(lines[i].substr(pos + 10));
+    int thread_number, message_number;
+    string word;
+    message >> thread_number >> word >> message_number;
+    // Messages of one thread keep their order.
+    EXPECT_EQ(next_message[thread_number], message_number);
+    next_message[thread_number] = message_number + 1;
+  }
+}
+
+/** A message without std::endl is completed by the next call of getLog(). */
+TEST(LoggingTest, MessageWithoutEndl) {
+  ostringstream* output = new ostringstream();
+  Logging logging(LEVEL_INFO, output);
+
+  logging.getLog(LEVEL_WARN) << "first " << hex << 255;
+  logging.getLog(LEVEL_INFO) << "second " << 255;
+  logging.Flush();
+
+  vector<string> lines = SplitLines(output->str());
+  ASSERT_EQ(2, lines.size());
+  EXPECT_EQ("[ W | ", lines[0].substr(0, 6));
+  EXPECT_NE(string::npos, lines[0].find(" ] first ff"));
+  // Modifiers of the previous message are reset.
+  EXPECT_NE(string::npos, lines[1].find(" ] second 255"));
+}
+
+/** Concurrent Flush() calls return once their messages were written. */
+TEST(LoggingTest, ConcurrentFlushes) {
+  ostringstream* output = new ostringstream();
+  Logging logging(LEVEL_DEBUG, output);
+  const int kThreads = 4;
+  const int kMessagesPerThread = 50;
+
+  logging.Flush();
+  boost::thread_group threads;
+  for (int i = 0; i < kThreads; i++) {
+    threads.create_thread(
+        boost::bind(&LogAndFlush, &logging, i, kMessagesPerThread));
+  }
+  threads.join_all();
+
+  EXPECT_EQ(kThreads * kMessagesPerThread, SplitLines(output->str()).size());
+}
+
+/** The pending message of an exited thread is written by Flush(). */
+TEST(LoggingTest, MessageOfExitedThread) {
+  ostringstream* output = new ostringstream();
+  Logging logging(LEVEL_INFO, output);
+
+  boost::thread thread(boost::bind(&LogWithoutEndl, &logging));
+  thread.join();
+  logging.Flush();
+
+  vector<string> lines = SplitLines(output->str());
+  ASSERT_EQ(1, lines.size());
+  EXPECT_NE(string::npos, lines[0].find(" ] last message of the thread"));
+}
+
+}  // namespace xtreemfs
@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2026 by the XtreemFS Authors, see AUTHORS file
+ *
+ * Licensed under the BSD License, see LICENSE file for details.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <boost/bind.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/thread/thread.hpp>
+#include <vector>
+
+#include "util/mpsc_queue.h"
+
+using namespace std;
+using namespace xtreemfs::util;
+
+namespace xtreemfs {
+
+namespace {
+
+const int kProducers = 4;
+const int kElementsPerProducer = 100000;
+
+void Produce(MPSCQueue<int>* queue, int producer) {
+  for (int i = 0; i < kElementsPerProducer; i++) {
+    queue->Enqueue(producer * kElementsPerProducer + i);
+  }
+}
+
+void DequeueOne(MPSCQueue<int>* queue, int* result) {
+  *result = queue->Dequeue();
+}
+
+}  // namespace
+
+TEST(MPSCQueueTest, FIFOWithOneProducer) {
+  MPSCQueue<int> queue;
+  for (int i = 0; i < 10; i++) {
+    queue.Enqueue(i);
+  }
+  for (int i = 0; i < 10; i++) {
+    EXPECT_EQ(i, queue.Dequeue());
+  }
+}
+
+TEST(MPSCQueueTest, KeepsOrderPerProducer) {
+  MPSCQueue<int> queue;
+  boost::thread_group producers;
+  for (int p = 0; p < kProducers; p++) {
+    producers.create_thread(boost::bind(&Produce, &queue, p));
+  }
+
+  vector<int> next(kProducers, 0);
+  for (int i = 0; i < kProducers * kElementsPerProducer; i++) {
+    int value = queue.Dequeue();
+    int producer = value / kElementsPerProducer;
+    ASSERT_EQ(next[producer], value % kElementsPerProducer);
+    next[producer]++;
+  }
+  producers.join_all();
+
+  for (int p = 0; p < kProducers; p++) {
+    EXPECT_EQ(kElementsPerProducer, next[p]);
+  }
+}
+
+TEST(MPSCQueueTest, EnqueueWakesUpBlockedConsumer) {
+  MPSCQueue<int> queue;
+  int result = 0;
+  boost::thread consumer(boost::bind(&DequeueOne, &queue, &result));
+  boost::this_thread::sleep(boost::posix_time::milliseconds(50));
+
+  queue.Enqueue(42);
+  consumer.join();
+  EXPECT_EQ(42, result);
+}
+
+TEST(MPSCQueueTest, DequeueIsInterruptible) {
+  MPSCQueue<int> queue;
+  int result = 0;
+  boost::thread consumer(boost::bind(&DequeueOne, &queue, &result));
+  boost::this_thread::sleep(boost::posix_time::milliseconds(50));
+
+  consumer.interrupt();
+  consumer.join();
+  EXPECT_EQ(0, result);
+
+  // The queue is still usable afterwards.
+  queue.Enqueue(1);
+  EXPECT_EQ(1, queue.Dequeue());
+}
+
+}  // namespace xtreemfs